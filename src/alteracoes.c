@@ -0,0 +1,259 @@
+#define _POSIX_C_SOURCE 200809L
+#include "alteracoes.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define REGISTROS_POR_LEITURA 256
+#define LIMITE_PENDENTES_RETIDAS 1024 // Acima disso o buffer de pendentes é liberado após gravar
+
+void nome_arquivo_alteracoes(const char *arquivo, char *destino, size_t tamanho) {
+    snprintf(destino, tamanho, "%s.log", arquivo);
+}
+
+// pread/pwrite até completar
+static int ler_completo(int fd, void *destino, size_t tamanho, off_t posicao) {
+    unsigned char *p = (unsigned char*)destino;
+    while (tamanho > 0) {
+        ssize_t lidos = pread(fd, p, tamanho, posicao);
+        if (lidos <= 0) {
+            return 0;
+        }
+        p += lidos;
+        tamanho -= (size_t)lidos;
+        posicao += lidos;
+    }
+    return 1;
+}
+
+static int escrever_completo(int fd, const void *origem, size_t tamanho, off_t posicao) {
+    const unsigned char *p = (const unsigned char*)origem;
+    while (tamanho > 0) {
+        ssize_t escritos = pwrite(fd, p, tamanho, posicao);
+        if (escritos <= 0) {
+            return 0;
+        }
+        p += escritos;
+        tamanho -= (size_t)escritos;
+        posicao += escritos;
+    }
+    return 1;
+}
+
+// Validar o cabeçalho e contar os registros completos (um registro incompleto
+// no final, de uma gravação interrompida, é ignorado); retorna -1 se inválido
+static long contar_registros(int fd) {
+    struct stat info;
+    CabecalhoAlteracoes cabecalho;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(cabecalho) ||
+        !ler_completo(fd, &cabecalho, sizeof(cabecalho), 0) ||
+        memcmp(cabecalho.assinatura, ASSINATURA_ALTERACOES, sizeof(cabecalho.assinatura)) != 0 ||
+        cabecalho.versao != VERSAO_ALTERACOES) {
+        return -1;
+    }
+    return (long)((info.st_size - (off_t)sizeof(cabecalho)) / (off_t)sizeof(RegistroAlteracao));
+}
+
+static off_t posicao_registro(long indice) {
+    return (off_t)sizeof(CabecalhoAlteracoes) + (off_t)indice * (off_t)sizeof(RegistroAlteracao);
+}
+
+int acrescentar_alteracoes(const char *arquivo, const RegistroAlteracao *registros, int quantidade) {
+    if (!arquivo || (quantidade > 0 && !registros)) {
+        return 0;
+    }
+    if (quantidade <= 0) {
+        return 1;
+    }
+
+    char caminho[512];
+    nome_arquivo_alteracoes(arquivo, caminho, sizeof(caminho));
+    int fd = open(caminho, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Erro ao abrir registro de alterações: %s\n", caminho);
+        return 0;
+    }
+
+    // Registro novo: gravar o cabeçalho
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size == 0) {
+        CabecalhoAlteracoes cabecalho;
+        memset(&cabecalho, 0, sizeof(cabecalho));
+        memcpy(cabecalho.assinatura, ASSINATURA_ALTERACOES, sizeof(cabecalho.assinatura));
+        cabecalho.versao = VERSAO_ALTERACOES;
+        if (!escrever_completo(fd, &cabecalho, sizeof(cabecalho), 0)) {
+            fprintf(stderr, "Erro ao escrever registro de alterações\n");
+            close(fd);
+            return 0;
+        }
+    }
+
+    long gravados = contar_registros(fd);
+    if (gravados < 0) {
+        fprintf(stderr, "Erro: registro de alterações inválido: %s\n", caminho);
+        close(fd);
+        return 0;
+    }
+    off_t fim = posicao_registro(gravados);
+    if (ftruncate(fd, fim) != 0) {
+        fprintf(stderr, "Erro ao ajustar registro de alterações\n");
+        close(fd);
+        return 0;
+    }
+
+    uint64_t ultima = 0;
+    if (gravados > 0) {
+        RegistroAlteracao registro;
+        if (!ler_completo(fd, &registro, sizeof(registro), posicao_registro(gravados - 1))) {
+            fprintf(stderr, "Erro ao ler registro de alterações\n");
+            close(fd);
+            return 0;
+        }
+        ultima = registro.sequencia;
+    }
+
+    // Pulados: já gravados por uma tentativa anterior interrompida
+    int primeiro = 0;
+    while (primeiro < quantidade && registros[primeiro].sequencia <= ultima) {
+        primeiro++;
+    }
+    int ok = 1;
+    if (primeiro < quantidade && registros[primeiro].sequencia > ultima + 1 &&
+        registros[primeiro].tipo != ALTERACAO_REINICIO) {
+        // Lacuna: alterações salvas que nunca chegaram ao registro
+        RegistroAlteracao reinicio;
+        memset(&reinicio, 0, sizeof(reinicio));
+        reinicio.sequencia = registros[primeiro].sequencia - 1;
+        reinicio.tipo = ALTERACAO_REINICIO;
+        ok = escrever_completo(fd, &reinicio, sizeof(reinicio), fim);
+        fim += (off_t)sizeof(reinicio);
+    }
+    ok = ok && escrever_completo(fd, &registros[primeiro],
+                                 (size_t)(quantidade - primeiro) * sizeof(RegistroAlteracao), fim) &&
+         fsync(fd) == 0;
+    close(fd);
+
+    if (!ok) {
+        fprintf(stderr, "Erro ao escrever registro de alterações\n");
+    }
+    return ok;
+}
+
+int gravar_alteracoes(ListaContatos *lista, const char *arquivo) {
+    if (!lista || !arquivo) {
+        return 0;
+    }
+    if (lista->num_alteracoes == 0) {
+        return 1;
+    }
+    if (!acrescentar_alteracoes(arquivo, lista->alteracoes, lista->num_alteracoes)) {
+        return 0;
+    }
+
+    lista->num_alteracoes = 0;
+    if (lista->capacidade_alteracoes > LIMITE_PENDENTES_RETIDAS) {
+        free(lista->alteracoes);
+        lista->alteracoes = NULL;
+        lista->capacidade_alteracoes = 0;
+    }
+    return 1;
+}
+
+int registrar_reinicio(const char *arquivo, uint64_t sequencia) {
+    if (!arquivo) {
+        return 0;
+    }
+    RegistroAlteracao reinicio;
+    memset(&reinicio, 0, sizeof(reinicio));
+    reinicio.sequencia = sequencia;
+    reinicio.tipo = ALTERACAO_REINICIO;
+    return acrescentar_alteracoes(arquivo, &reinicio, 1);
+}
+
+long ler_alteracoes_desde(const char *arquivo, uint64_t desde,
+                          int (*visitar)(const RegistroAlteracao *registro, void *contexto), void *contexto) {
+    if (!arquivo || !visitar) {
+        return -1;
+    }
+
+    char caminho[512];
+    nome_arquivo_alteracoes(arquivo, caminho, sizeof(caminho));
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return 0; // Nenhuma alteração registrada ainda
+    }
+
+    long registros = contar_registros(fd);
+    if (registros < 0) {
+        fprintf(stderr, "Erro: registro de alterações inválido: %s\n", caminho);
+        close(fd);
+        return -1;
+    }
+
+    // Primeiro registro com sequência maior que "desde" (as sequências são crescentes)
+    long inicio = 0;
+    long fim = registros;
+    while (inicio < fim) {
+        long meio = inicio + (fim - inicio) / 2;
+        RegistroAlteracao registro;
+        if (!ler_completo(fd, &registro, sizeof(registro), posicao_registro(meio))) {
+            close(fd);
+            return -1;
+        }
+        if (registro.sequencia <= desde) {
+            inicio = meio + 1;
+        } else {
+            fim = meio;
+        }
+    }
+
+    RegistroAlteracao *buffer = (RegistroAlteracao*)malloc(REGISTROS_POR_LEITURA * sizeof(RegistroAlteracao));
+    if (!buffer) {
+        fprintf(stderr, "Erro ao alocar memória para leitura do registro de alterações\n");
+        close(fd);
+        return -1;
+    }
+
+    long visitados = 0;
+    int continuar = 1;
+    for (long i = inicio; i < registros && continuar; i += REGISTROS_POR_LEITURA) {
+        long n = registros - i < REGISTROS_POR_LEITURA ? registros - i : REGISTROS_POR_LEITURA;
+        if (!ler_completo(fd, buffer, (size_t)n * sizeof(RegistroAlteracao), posicao_registro(i))) {
+            visitados = -1;
+            break;
+        }
+        for (long j = 0; j < n && continuar; j++) {
+            continuar = visitar(&buffer[j], contexto);
+            visitados++;
+        }
+    }
+
+    free(buffer);
+    close(fd);
+    return visitados;
+}
+
+const char* nome_alteracao(int tipo) {
+    switch (tipo) {
+        case ALTERACAO_ADICAO: return "adicao";
+        case ALTERACAO_EDICAO: return "edicao";
+        case ALTERACAO_EXCLUSAO: return "exclusao";
+        case ALTERACAO_REINICIO: return "reinicio";
+        case ALTERACAO_ATRIBUTO: return "atributo";
+        default: return "desconhecida";
+    }
+}
+
+static int imprimir_alteracao(const RegistroAlteracao *registro, void *contexto) {
+    FILE *saida = (FILE*)contexto;
+    fprintf(saida, "%llu\t%s\t%d\t%s\t%s\t%s\n", (unsigned long long)registro->sequencia,
+            nome_alteracao(registro->tipo), registro->id, registro->nome, registro->telefone, registro->email);
+    return 1;
+}
+
+// Uma alteração por linha, separada por tabulações: sequência, tipo, id, nome, telefone, email
+long listar_alteracoes(const char *arquivo, uint64_t desde, FILE *saida) {
+    return ler_alteracoes_desde(arquivo, desde, imprimir_alteracao, saida ? saida : stdout);
+}
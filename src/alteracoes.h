@@ -0,0 +1,44 @@
+#ifndef ALTERACOES_H
+#define ALTERACOES_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "contato.h"
+
+// Registro de alterações em "<arquivo>.log": cabeçalho seguido de registros de
+// tamanho fixo em ordem de sequência, só acrescentados (nunca reescritos)
+// Quem espelha os contatos lê apenas o que mudou desde a última sequência que viu
+#define ASSINATURA_ALTERACOES "CLOG"
+#define VERSAO_ALTERACOES 1
+
+typedef struct {
+    char assinatura[4];
+    uint32_t versao;
+} CabecalhoAlteracoes;
+
+void nome_arquivo_alteracoes(const char *arquivo, char *destino, size_t tamanho);
+
+// Acrescentar as alterações pendentes da lista (chamada por salvar_contatos)
+// Se faltam sequências no registro (arquivo apagado, falha anterior), um reinício é gravado antes
+// Retorna 1 em sucesso; em erro as pendentes são mantidas para o próximo salvamento
+int gravar_alteracoes(ListaContatos *lista, const char *arquivo);
+
+// Acrescentar registros já numerados ao final (criado se não existe), com fsync
+// Registros já presentes (sequência não maior que a última gravada) são pulados;
+// uma lacuna antes do primeiro novo vira um reinício
+int acrescentar_alteracoes(const char *arquivo, const RegistroAlteracao *registros, int quantidade);
+
+// Gravar um reinício (arquivo de dados substituído por inteiro fora da lista, ex.: mesclagem)
+int registrar_reinicio(const char *arquivo, uint64_t sequencia);
+
+// Visitar as alterações com sequência maior que "desde" (busca binária até o ponto de partida)
+// O visitante retorna 0 para parar; retorna quantas foram visitadas ou -1 em erro
+long ler_alteracoes_desde(const char *arquivo, uint64_t desde,
+                          int (*visitar)(const RegistroAlteracao *registro, void *contexto), void *contexto);
+
+// Listar as alterações desde uma sequência (uma por linha)
+long listar_alteracoes(const char *arquivo, uint64_t desde, FILE *saida);
+
+const char* nome_alteracao(int tipo);
+
+#endif
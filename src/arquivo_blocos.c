@@ -0,0 +1,394 @@
+#define _POSIX_C_SOURCE 200809L
+#include "arquivo_blocos.h"
+#include "utils/crc32c.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Tarefa compartilhada pelas threads de carga: cada uma pega o próximo bloco livre
+typedef struct {
+    ListaContatos *lista;
+    int fd;
+    off_t inicio_dados;
+    int quantidade;
+    const uint32_t *crcs;
+    uint32_t num_blocos;
+    atomic_uint proximo_bloco;
+    unsigned char *corrompidos;     // Um byte por bloco, escrito só pela thread que o leu
+    atomic_int erros;
+} CargaBlocos;
+
+// Quantidade de contatos do bloco (o último pode estar incompleto)
+static int contatos_no_bloco(int quantidade, uint32_t bloco) {
+    int restante = quantidade - (int)bloco * CONTATOS_POR_BLOCO;
+    return restante < CONTATOS_POR_BLOCO ? restante : CONTATOS_POR_BLOCO;
+}
+
+// pread até completar (leituras podem retornar menos que o pedido)
+static int ler_completo(int fd, void *destino, size_t tamanho, off_t posicao) {
+    unsigned char *p = (unsigned char*)destino;
+    while (tamanho > 0) {
+        ssize_t lidos = pread(fd, p, tamanho, posicao);
+        if (lidos <= 0) {
+            return 0;
+        }
+        p += lidos;
+        tamanho -= (size_t)lidos;
+        posicao += lidos;
+    }
+    return 1;
+}
+
+int arquivo_em_blocos(FILE *fp) {
+    char assinatura[4];
+    return fp && ler_completo(fileno(fp), assinatura, sizeof(assinatura), 0) &&
+           memcmp(assinatura, ASSINATURA_BLOCOS, sizeof(assinatura)) == 0;
+}
+
+int gravar_em_blocos(FILE *fp, ListaContatos *lista) {
+    if (!fp || !lista) {
+        return 0;
+    }
+
+    uint32_t num_blocos = (uint32_t)((lista->quantidade + CONTATOS_POR_BLOCO - 1) / CONTATOS_POR_BLOCO);
+    uint32_t *crcs = (uint32_t*)calloc(num_blocos > 0 ? num_blocos : 1, sizeof(uint32_t));
+    if (!crcs) {
+        fprintf(stderr, "Erro ao alocar memória para a tabela de blocos\n");
+        return 0;
+    }
+    for (uint32_t b = 0; b < num_blocos; b++) {
+        crcs[b] = crc32c(0, lista->segmentos[b], contatos_no_bloco(lista->quantidade, b) * sizeof(Contato));
+    }
+
+    CabecalhoBlocos cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, ASSINATURA_BLOCOS, sizeof(cabecalho.assinatura));
+    cabecalho.versao = VERSAO_BLOCOS;
+    cabecalho.quantidade = lista->quantidade;
+    cabecalho.contatos_por_bloco = CONTATOS_POR_BLOCO;
+    cabecalho.num_blocos = num_blocos;
+    cabecalho.crc_tabela = crc32c(0, crcs, num_blocos * sizeof(uint32_t));
+    cabecalho.sequencia = lista->sequencia;
+
+    int ok = fwrite(&cabecalho, sizeof(cabecalho), 1, fp) == 1 &&
+             (num_blocos == 0 || fwrite(crcs, sizeof(uint32_t), num_blocos, fp) == num_blocos);
+    for (uint32_t b = 0; b < num_blocos && ok; b++) {
+        size_t n = (size_t)contatos_no_bloco(lista->quantidade, b);
+        ok = fwrite(lista->segmentos[b], sizeof(Contato), n, fp) == n;
+    }
+
+    free(crcs);
+    return ok;
+}
+
+// Thread de carga: ler e verificar blocos até acabarem
+static void* carregar_blocos(void *arg) {
+    CargaBlocos *carga = (CargaBlocos*)arg;
+    uint32_t bloco;
+    while ((bloco = atomic_fetch_add(&carga->proximo_bloco, 1)) < carga->num_blocos) {
+        size_t tamanho = contatos_no_bloco(carga->quantidade, bloco) * sizeof(Contato);
+        off_t posicao = carga->inicio_dados + (off_t)bloco * CONTATOS_POR_BLOCO * (off_t)sizeof(Contato);
+        Contato *segmento = carga->lista->segmentos[bloco];
+
+        if (!ler_completo(carga->fd, segmento, tamanho, posicao) ||
+            crc32c(0, segmento, tamanho) != carga->crcs[bloco]) {
+            carga->corrompidos[bloco] = 1;
+            atomic_fetch_add(&carga->erros, 1);
+        }
+    }
+    return NULL;
+}
+
+// Número de threads: núcleos disponíveis, limitado ao máximo e ao número de blocos
+static int threads_de_carga(uint32_t num_blocos) {
+    long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = nucleos > 0 ? (int)nucleos : 1;
+    if (threads > MAX_THREADS_CARGA) {
+        threads = MAX_THREADS_CARGA;
+    }
+    if ((uint32_t)threads > num_blocos) {
+        threads = num_blocos > 0 ? (int)num_blocos : 1;
+    }
+    return threads;
+}
+
+// O cabeçalho da versão 2 é o da versão 3 sem a sequência
+uint32_t* ler_cabecalho_blocos(int fd, CabecalhoBlocos *cabecalho, off_t *inicio_dados) {
+    struct stat info;
+    size_t tamanho_v2 = offsetof(CabecalhoBlocos, sequencia);
+    memset(cabecalho, 0, sizeof(*cabecalho));
+    if (!ler_completo(fd, cabecalho, tamanho_v2, 0) || fstat(fd, &info) != 0 ||
+        (cabecalho->versao == VERSAO_BLOCOS &&
+         !ler_completo(fd, &cabecalho->sequencia, sizeof(cabecalho->sequencia), (off_t)tamanho_v2))) {
+        fprintf(stderr, "Erro ao ler cabeçalho do arquivo de contatos\n");
+        return NULL;
+    }
+    size_t tamanho_cabecalho = cabecalho->versao == VERSAO_BLOCOS ? sizeof(*cabecalho) : tamanho_v2;
+
+    uint32_t num_blocos_esperado = cabecalho->quantidade >= 0
+        ? (uint32_t)((cabecalho->quantidade + CONTATOS_POR_BLOCO - 1) / CONTATOS_POR_BLOCO) : 0;
+    if ((cabecalho->versao != VERSAO_BLOCOS && cabecalho->versao != VERSAO_BLOCOS_SEM_SEQUENCIA) ||
+        cabecalho->quantidade < 0 ||
+        cabecalho->contatos_por_bloco != CONTATOS_POR_BLOCO || cabecalho->num_blocos != num_blocos_esperado) {
+        fprintf(stderr, "Erro: cabeçalho do arquivo de contatos inválido\n");
+        return NULL;
+    }
+
+    *inicio_dados = (off_t)tamanho_cabecalho + (off_t)cabecalho->num_blocos * (off_t)sizeof(uint32_t);
+    off_t tamanho_esperado = *inicio_dados + (off_t)cabecalho->quantidade * (off_t)sizeof(Contato);
+    if (info.st_size != tamanho_esperado) {
+        fprintf(stderr, "Erro: tamanho do arquivo de contatos inconsistente (%lld bytes, esperado %lld)\n",
+                (long long)info.st_size, (long long)tamanho_esperado);
+        return NULL;
+    }
+
+    uint32_t *crcs = (uint32_t*)malloc((cabecalho->num_blocos > 0 ? cabecalho->num_blocos : 1) * sizeof(uint32_t));
+    if (!crcs) {
+        fprintf(stderr, "Erro ao alocar memória para a tabela de blocos\n");
+        return NULL;
+    }
+    if (!ler_completo(fd, crcs, cabecalho->num_blocos * sizeof(uint32_t), (off_t)tamanho_cabecalho) ||
+        crc32c(0, crcs, cabecalho->num_blocos * sizeof(uint32_t)) != cabecalho->crc_tabela) {
+        fprintf(stderr, "Erro: tabela de blocos do arquivo de contatos corrompida\n");
+        free(crcs);
+        return NULL;
+    }
+    return crcs;
+}
+
+int ler_em_blocos(FILE *fp, ListaContatos *lista) {
+    if (!fp || !lista) {
+        return 0;
+    }
+    int fd = fileno(fp);
+
+    CabecalhoBlocos cabecalho;
+    off_t inicio_dados;
+    uint32_t *crcs = ler_cabecalho_blocos(fd, &cabecalho, &inicio_dados);
+    if (!crcs) {
+        return 0;
+    }
+    unsigned char *corrompidos = (unsigned char*)calloc(cabecalho.num_blocos > 0 ? cabecalho.num_blocos : 1, 1);
+    if (!corrompidos) {
+        fprintf(stderr, "Erro ao alocar memória para a tabela de blocos\n");
+        free(crcs);
+        return 0;
+    }
+
+    if (!reservar_contatos(lista, cabecalho.quantidade > 0 ? cabecalho.quantidade : 1)) {
+        free(crcs);
+        free(corrompidos);
+        return 0;
+    }
+
+    CargaBlocos carga;
+    carga.lista = lista;
+    carga.fd = fd;
+    carga.inicio_dados = inicio_dados;
+    carga.quantidade = cabecalho.quantidade;
+    carga.crcs = crcs;
+    carga.num_blocos = cabecalho.num_blocos;
+    carga.corrompidos = corrompidos;
+    atomic_init(&carga.proximo_bloco, 0);
+    atomic_init(&carga.erros, 0);
+
+    // A thread atual também carrega; as demais são criadas conforme os núcleos
+    int num_threads = threads_de_carga(cabecalho.num_blocos);
+    pthread_t threads[MAX_THREADS_CARGA];
+    int criadas = 0;
+    for (int i = 1; i < num_threads; i++) {
+        if (pthread_create(&threads[criadas], NULL, carregar_blocos, &carga) == 0) {
+            criadas++;
+        }
+    }
+    carregar_blocos(&carga);
+    for (int i = 0; i < criadas; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    int erros = atomic_load(&carga.erros);
+    for (uint32_t b = 0; b < cabecalho.num_blocos && erros > 0; b++) {
+        if (corrompidos[b]) {
+            int primeiro = (int)b * CONTATOS_POR_BLOCO;
+            fprintf(stderr, "Erro: bloco %u corrompido (contatos nas posições %d a %d)\n",
+                    b, primeiro, primeiro + contatos_no_bloco(cabecalho.quantidade, b) - 1);
+        }
+    }
+
+    free(crcs);
+    free(corrompidos);
+    if (erros > 0) {
+        return 0;
+    }
+    lista->quantidade = cabecalho.quantidade;
+    lista->sequencia = cabecalho.sequencia;
+    return 1;
+}
+
+LeitorContatos* abrir_leitor_contatos(const char *arquivo) {
+    FILE *fp = arquivo ? fopen(arquivo, "rb") : NULL;
+    if (!fp) {
+        fprintf(stderr, "Erro ao abrir arquivo de contatos: %s\n", arquivo ? arquivo : "(nulo)");
+        return NULL;
+    }
+    bloquear_leitura(fp);
+
+    LeitorContatos *leitor = (LeitorContatos*)calloc(1, sizeof(LeitorContatos));
+    Contato *bloco = (Contato*)malloc(CONTATOS_POR_BLOCO * sizeof(Contato));
+    if (!leitor || !bloco) {
+        fprintf(stderr, "Erro ao alocar memória para leitura do arquivo\n");
+        free(leitor);
+        free(bloco);
+        fclose(fp);
+        return NULL;
+    }
+    leitor->fp = fp;
+    leitor->bloco = bloco;
+
+    if (arquivo_em_blocos(fp)) {
+        CabecalhoBlocos cabecalho;
+        leitor->crcs = ler_cabecalho_blocos(fileno(fp), &cabecalho, &leitor->inicio_dados);
+        if (!leitor->crcs) {
+            fprintf(stderr, "Erro: arquivo de contatos corrompido: %s\n", arquivo);
+            fechar_leitor_contatos(leitor);
+            return NULL;
+        }
+        leitor->em_blocos = 1;
+        leitor->quantidade = cabecalho.quantidade;
+        leitor->sequencia = cabecalho.sequencia;
+    } else {
+        // Formato antigo: quantidade seguida do array; arquivo vazio = nenhum contato
+        struct stat info;
+        int32_t quantidade = 0;
+        if (fstat(fileno(fp), &info) == 0 && info.st_size >= (off_t)sizeof(quantidade) &&
+            (!ler_completo(fileno(fp), &quantidade, sizeof(quantidade), 0) || quantidade < 0 ||
+             (off_t)sizeof(quantidade) + (off_t)quantidade * (off_t)sizeof(Contato) > info.st_size)) {
+            fprintf(stderr, "Erro: arquivo de contatos inválido: %s\n", arquivo);
+            fechar_leitor_contatos(leitor);
+            return NULL;
+        }
+        leitor->quantidade = quantidade;
+        leitor->inicio_dados = (off_t)sizeof(quantidade);
+    }
+    return leitor;
+}
+
+const Contato* proximo_contato(LeitorContatos *leitor) {
+    if (!leitor || leitor->erro) {
+        return NULL;
+    }
+    if (leitor->posicao >= leitor->no_bloco) {
+        uint32_t bloco = leitor->proximo_bloco;
+        int restantes = leitor->quantidade - (int)bloco * CONTATOS_POR_BLOCO;
+        if (restantes <= 0) {
+            return NULL;
+        }
+        int n = restantes < CONTATOS_POR_BLOCO ? restantes : CONTATOS_POR_BLOCO;
+        size_t tamanho = (size_t)n * sizeof(Contato);
+        off_t posicao = leitor->inicio_dados + (off_t)bloco * CONTATOS_POR_BLOCO * (off_t)sizeof(Contato);
+        if (!ler_completo(fileno(leitor->fp), leitor->bloco, tamanho, posicao) ||
+            (leitor->em_blocos && crc32c(0, leitor->bloco, tamanho) != leitor->crcs[bloco])) {
+            int primeiro = (int)bloco * CONTATOS_POR_BLOCO;
+            fprintf(stderr, "Erro: bloco %u corrompido (contatos nas posições %d a %d)\n",
+                    bloco, primeiro, primeiro + n - 1);
+            leitor->erro = 1;
+            return NULL;
+        }
+        leitor->no_bloco = n;
+        leitor->posicao = 0;
+        leitor->proximo_bloco++;
+    }
+    return &leitor->bloco[leitor->posicao++];
+}
+
+void fechar_leitor_contatos(LeitorContatos *leitor) {
+    if (!leitor) {
+        return;
+    }
+    fclose(leitor->fp);
+    free(leitor->crcs);
+    free(leitor->bloco);
+    free(leitor);
+}
+
+EscritorBlocos* abrir_escritor_blocos(FILE *fp, int32_t quantidade, uint64_t sequencia) {
+    if (!fp || quantidade < 0) {
+        return NULL;
+    }
+
+    EscritorBlocos *escritor = (EscritorBlocos*)calloc(1, sizeof(EscritorBlocos));
+    uint32_t num_blocos = (uint32_t)((quantidade + CONTATOS_POR_BLOCO - 1) / CONTATOS_POR_BLOCO);
+    uint32_t *crcs = (uint32_t*)calloc(num_blocos > 0 ? num_blocos : 1, sizeof(uint32_t));
+    Contato *bloco = (Contato*)malloc(CONTATOS_POR_BLOCO * sizeof(Contato));
+    if (!escritor || !crcs || !bloco) {
+        fprintf(stderr, "Erro ao alocar memória para gravação em blocos\n");
+        free(escritor);
+        free(crcs);
+        free(bloco);
+        return NULL;
+    }
+
+    memcpy(escritor->cabecalho.assinatura, ASSINATURA_BLOCOS, sizeof(escritor->cabecalho.assinatura));
+    escritor->cabecalho.versao = VERSAO_BLOCOS;
+    escritor->cabecalho.quantidade = quantidade;
+    escritor->cabecalho.contatos_por_bloco = CONTATOS_POR_BLOCO;
+    escritor->cabecalho.num_blocos = num_blocos;
+    escritor->cabecalho.sequencia = sequencia;
+    escritor->fp = fp;
+    escritor->crcs = crcs;
+    escritor->bloco = bloco;
+
+    // Os blocos começam depois do cabeçalho e da tabela, preenchidos no fechamento
+    if (fseeko(fp, (off_t)sizeof(CabecalhoBlocos) + (off_t)num_blocos * (off_t)sizeof(uint32_t), SEEK_SET) != 0) {
+        fprintf(stderr, "Erro ao posicionar gravação em blocos\n");
+        free(escritor->crcs);
+        free(escritor->bloco);
+        free(escritor);
+        return NULL;
+    }
+    return escritor;
+}
+
+// Gravar o bloco acumulado e guardar seu CRC
+static int descarregar_bloco(EscritorBlocos *escritor) {
+    if (escritor->no_bloco == 0) {
+        return 1;
+    }
+    size_t n = (size_t)escritor->no_bloco;
+    escritor->crcs[escritor->bloco_atual++] = crc32c(0, escritor->bloco, n * sizeof(Contato));
+    escritor->no_bloco = 0;
+    return fwrite(escritor->bloco, sizeof(Contato), n, escritor->fp) == n;
+}
+
+int escrever_contato_bloco(EscritorBlocos *escritor, const Contato *contato) {
+    if (!escritor || !contato || escritor->escritos >= escritor->cabecalho.quantidade) {
+        return 0;
+    }
+    escritor->bloco[escritor->no_bloco++] = *contato;
+    escritor->escritos++;
+    return escritor->no_bloco < CONTATOS_POR_BLOCO || descarregar_bloco(escritor);
+}
+
+int fechar_escritor_blocos(EscritorBlocos *escritor) {
+    if (!escritor) {
+        return 0;
+    }
+
+    int ok = escritor->escritos == escritor->cabecalho.quantidade && descarregar_bloco(escritor);
+    if (ok) {
+        uint32_t num_blocos = escritor->cabecalho.num_blocos;
+        escritor->cabecalho.crc_tabela = crc32c(0, escritor->crcs, num_blocos * sizeof(uint32_t));
+        ok = fseeko(escritor->fp, 0, SEEK_SET) == 0 &&
+             fwrite(&escritor->cabecalho, sizeof(escritor->cabecalho), 1, escritor->fp) == 1 &&
+             (num_blocos == 0 || fwrite(escritor->crcs, sizeof(uint32_t), num_blocos, escritor->fp) == num_blocos);
+    }
+
+    free(escritor->crcs);
+    free(escritor->bloco);
+    free(escritor);
+    return ok;
+}
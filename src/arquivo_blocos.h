@@ -0,0 +1,78 @@
+#ifndef ARQUIVO_BLOCOS_H
+#define ARQUIVO_BLOCOS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include "contato.h"
+
+// Formato em blocos do arquivo de contatos:
+//   cabeçalho | CRC32C de cada bloco | blocos de CONTATOS_POR_BLOCO contatos
+// Um bloco corresponde a um segmento da lista, então é lido direto no segmento
+#define ASSINATURA_BLOCOS "CTB2"
+#define VERSAO_BLOCOS 3
+#define VERSAO_BLOCOS_SEM_SEQUENCIA 2   // Ainda lida: cabeçalho termina antes da sequência
+#define CONTATOS_POR_BLOCO TAMANHO_SEGMENTO
+#define MAX_THREADS_CARGA 8
+
+typedef struct {
+    char assinatura[4];
+    uint32_t versao;
+    int32_t quantidade;
+    uint32_t contatos_por_bloco;
+    uint32_t num_blocos;
+    uint32_t crc_tabela;        // CRC32C da tabela de CRCs dos blocos
+    uint64_t sequencia;         // Última alteração incluída (registro de alterações); desde a versão 3
+} CabecalhoBlocos;
+
+// Verificar se o arquivo aberto está no formato em blocos (senão é o formato antigo)
+int arquivo_em_blocos(FILE *fp);
+
+// Gravar a lista no formato em blocos
+int gravar_em_blocos(FILE *fp, ListaContatos *lista);
+
+// Ler e validar cabeçalho e tabela de CRCs de um arquivo em blocos
+// Devolve a tabela alocada (liberar com free) e o início dos blocos; NULL em erro
+uint32_t* ler_cabecalho_blocos(int fd, CabecalhoBlocos *cabecalho, off_t *inicio_dados);
+
+// Ler os blocos em paralelo verificando cada CRC; a lista deve estar vazia
+// Retorna 1 se tudo foi lido e verificado, 0 em erro (blocos corrompidos são informados)
+int ler_em_blocos(FILE *fp, ListaContatos *lista);
+
+// Leitura sequencial de um arquivo de contatos (em blocos ou no formato antigo)
+// com um bloco em memória por vez, para percorrer arquivos maiores que a memória
+typedef struct {
+    FILE *fp;
+    int em_blocos;
+    int32_t quantidade;
+    uint64_t sequencia;
+    off_t inicio_dados;
+    uint32_t *crcs;             // Só no formato em blocos
+    Contato *bloco;
+    int no_bloco;               // Contatos carregados no bloco atual
+    int posicao;                // Próximo contato do bloco atual
+    uint32_t proximo_bloco;
+    int erro;                   // 1 se a leitura parou por erro ou corrupção
+} LeitorContatos;
+
+LeitorContatos* abrir_leitor_contatos(const char *arquivo);
+const Contato* proximo_contato(LeitorContatos *leitor); // NULL no fim (ou em erro: ver leitor->erro)
+void fechar_leitor_contatos(LeitorContatos *leitor);
+
+// Gravação sequencial no formato em blocos quando a quantidade é conhecida antes
+// Os blocos são gravados à medida que enchem; cabeçalho e tabela de CRCs no final
+typedef struct {
+    FILE *fp;
+    CabecalhoBlocos cabecalho;
+    uint32_t *crcs;
+    Contato *bloco;
+    int no_bloco;
+    uint32_t bloco_atual;
+    int32_t escritos;
+} EscritorBlocos;
+
+EscritorBlocos* abrir_escritor_blocos(FILE *fp, int32_t quantidade, uint64_t sequencia);
+int escrever_contato_bloco(EscritorBlocos *escritor, const Contato *contato);
+int fechar_escritor_blocos(EscritorBlocos *escritor); // Retorna 1 se gravou exatamente a quantidade anunciada
+
+#endif
@@ -0,0 +1,225 @@
+#include "arvore_bk.h"
+#include "utils/string_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IDS_INICIAIS 2
+#define PILHA_INICIAL 64
+
+// Criar árvore vazia
+ArvoreBK* criar_arvore_bk() {
+    ArvoreBK *arvore = (ArvoreBK*)malloc(sizeof(ArvoreBK));
+    if (!arvore) {
+        fprintf(stderr, "Erro ao alocar memória para a árvore BK\n");
+        return NULL;
+    }
+    arvore->raiz = NULL;
+    arvore->num_nos = 0;
+    return arvore;
+}
+
+// Liberar um nó e toda a sua subárvore
+static void liberar_no(NoBK *no) {
+    while (no) {
+        NoBK *irmao = no->proximo_irmao;
+        liberar_no(no->primeiro_filho);
+        free(no->palavra);
+        free(no->ids);
+        free(no);
+        no = irmao;
+    }
+}
+
+// Remover todos os nós
+void limpar_arvore_bk(ArvoreBK *arvore) {
+    if (arvore) {
+        liberar_no(arvore->raiz);
+        arvore->raiz = NULL;
+        arvore->num_nos = 0;
+    }
+}
+
+// Liberar memória da árvore
+void liberar_arvore_bk(ArvoreBK *arvore) {
+    if (arvore) {
+        limpar_arvore_bk(arvore);
+        free(arvore);
+    }
+}
+
+// Criar nó para uma palavra
+static NoBK* criar_no(const char *palavra, int distancia) {
+    NoBK *no = (NoBK*)malloc(sizeof(NoBK));
+    if (!no) {
+        return NULL;
+    }
+
+    size_t tamanho = strlen(palavra) + 1;
+    no->palavra = (char*)malloc(tamanho);
+    no->ids = (int*)malloc(IDS_INICIAIS * sizeof(int));
+    if (!no->palavra || !no->ids) {
+        free(no->palavra);
+        free(no->ids);
+        free(no);
+        return NULL;
+    }
+    memcpy(no->palavra, palavra, tamanho);
+    no->quantidade = 0;
+    no->capacidade = IDS_INICIAIS;
+    no->distancia = distancia;
+    no->primeiro_filho = NULL;
+    no->proximo_irmao = NULL;
+    return no;
+}
+
+// Adicionar ID ao nó (ignora repetição: o mesmo nome pode repetir a palavra)
+static int adicionar_id(NoBK *no, int id) {
+    for (int i = no->quantidade - 1; i >= 0 && no->ids[i] >= id; i--) {
+        if (no->ids[i] == id) {
+            return 1;
+        }
+    }
+
+    if (no->quantidade >= no->capacidade) {
+        int nova_capacidade = no->capacidade * 2;
+        int *novos_ids = (int*)realloc(no->ids, nova_capacidade * sizeof(int));
+        if (!novos_ids) {
+            return 0;
+        }
+        no->ids = novos_ids;
+        no->capacidade = nova_capacidade;
+    }
+
+    // Manter IDs ordenados (IDs novos são sempre os maiores)
+    int pos = no->quantidade;
+    while (pos > 0 && no->ids[pos - 1] > id) {
+        no->ids[pos] = no->ids[pos - 1];
+        pos--;
+    }
+    no->ids[pos] = id;
+    no->quantidade++;
+    return 1;
+}
+
+// Filho do nó na distância informada (cada distância tem no máximo um filho)
+static NoBK* filho_na_distancia(NoBK *no, int distancia) {
+    for (NoBK *filho = no->primeiro_filho; filho; filho = filho->proximo_irmao) {
+        if (filho->distancia == distancia) {
+            return filho;
+        }
+    }
+    return NULL;
+}
+
+// Associar um ID a uma palavra
+int arvore_bk_inserir(ArvoreBK *arvore, const char *palavra, int id) {
+    if (!arvore || !palavra || palavra[0] == '\0') {
+        return 0;
+    }
+
+    if (!arvore->raiz) {
+        arvore->raiz = criar_no(palavra, 0);
+        if (!arvore->raiz) {
+            return 0;
+        }
+        arvore->num_nos++;
+        return adicionar_id(arvore->raiz, id);
+    }
+
+    NoBK *no = arvore->raiz;
+    while (1) {
+        int distancia = distancia_levenshtein(palavra, no->palavra);
+        if (distancia == 0) {
+            return adicionar_id(no, id);
+        }
+
+        NoBK *filho = filho_na_distancia(no, distancia);
+        if (!filho) {
+            filho = criar_no(palavra, distancia);
+            if (!filho) {
+                return 0;
+            }
+            filho->proximo_irmao = no->primeiro_filho;
+            no->primeiro_filho = filho;
+            arvore->num_nos++;
+            return adicionar_id(filho, id);
+        }
+        no = filho;
+    }
+}
+
+// Desassociar um ID de uma palavra
+// O nó permanece na árvore (mesmo sem IDs) pois roteia a busca dos seus filhos
+int arvore_bk_remover(ArvoreBK *arvore, const char *palavra, int id) {
+    if (!arvore || !palavra || palavra[0] == '\0') {
+        return 0;
+    }
+
+    NoBK *no = arvore->raiz;
+    while (no) {
+        int distancia = distancia_levenshtein(palavra, no->palavra);
+        if (distancia == 0) {
+            for (int i = 0; i < no->quantidade; i++) {
+                if (no->ids[i] == id) {
+                    memmove(&no->ids[i], &no->ids[i + 1], (no->quantidade - i - 1) * sizeof(int));
+                    no->quantidade--;
+                    return 1;
+                }
+            }
+            return 0;
+        }
+        no = filho_na_distancia(no, distancia);
+    }
+    return 0;
+}
+
+// Buscar palavras a até distancia_maxima edições da palavra informada
+// Pela desigualdade triangular, só os filhos com distância em [d - k, d + k]
+// podem conter resultados. Retorna o número de distâncias calculadas.
+int arvore_bk_buscar(ArvoreBK *arvore, const char *palavra, int distancia_maxima,
+                     VisitanteBK visitante, void *contexto) {
+    if (!arvore || !arvore->raiz || !palavra || !visitante) {
+        return 0;
+    }
+
+    int capacidade = PILHA_INICIAL;
+    int topo = 0;
+    NoBK **pilha = (NoBK**)malloc(capacidade * sizeof(NoBK*));
+    if (!pilha) {
+        return 0;
+    }
+    pilha[topo++] = arvore->raiz;
+
+    int calculos = 0;
+    while (topo > 0) {
+        NoBK *no = pilha[--topo];
+        int distancia = distancia_levenshtein(palavra, no->palavra);
+        calculos++;
+
+        if (distancia <= distancia_maxima && no->quantidade > 0) {
+            visitante(no, distancia, contexto);
+        }
+
+        for (NoBK *filho = no->primeiro_filho; filho; filho = filho->proximo_irmao) {
+            if (filho->distancia < distancia - distancia_maxima ||
+                filho->distancia > distancia + distancia_maxima) {
+                continue;
+            }
+            if (topo >= capacidade) {
+                int nova_capacidade = capacidade * 2;
+                NoBK **nova_pilha = (NoBK**)realloc(pilha, nova_capacidade * sizeof(NoBK*));
+                if (!nova_pilha) {
+                    free(pilha);
+                    return calculos;
+                }
+                pilha = nova_pilha;
+                capacidade = nova_capacidade;
+            }
+            pilha[topo++] = filho;
+        }
+    }
+
+    free(pilha);
+    return calculos;
+}
@@ -0,0 +1,37 @@
+#ifndef ARVORE_BK_H
+#define ARVORE_BK_H
+
+#include <stddef.h>
+
+// Nó da árvore BK: uma palavra, os IDs que a contêm e os filhos por distância
+typedef struct NoBK {
+    char *palavra;
+    int *ids;
+    int quantidade;
+    int capacidade;
+    int distancia;                // Distância até a palavra do nó pai
+    struct NoBK *primeiro_filho;
+    struct NoBK *proximo_irmao;
+} NoBK;
+
+// Árvore BK (Burkhard-Keller) sobre a distância de Levenshtein
+typedef struct {
+    NoBK *raiz;
+    size_t num_nos;
+} ArvoreBK;
+
+// Função chamada para cada nó dentro da distância buscada
+typedef void (*VisitanteBK)(const NoBK *no, int distancia, void *contexto);
+
+// Funções de gerenciamento da árvore
+ArvoreBK* criar_arvore_bk();
+void liberar_arvore_bk(ArvoreBK *arvore);
+void limpar_arvore_bk(ArvoreBK *arvore);
+
+// Operações sobre a árvore
+int arvore_bk_inserir(ArvoreBK *arvore, const char *palavra, int id);
+int arvore_bk_remover(ArvoreBK *arvore, const char *palavra, int id);
+int arvore_bk_buscar(ArvoreBK *arvore, const char *palavra, int distancia_maxima,
+                     VisitanteBK visitante, void *contexto);
+
+#endif
@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // flock()
+
+#include "bloqueio.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Bloquear a base para escrita (espera se outro processo estiver escrevendo)
+int bloquear_escrita(const char *arquivo) {
+    if (!arquivo) {
+        return -1;
+    }
+
+    char caminho[512];
+    snprintf(caminho, sizeof(caminho), "%s.lock", arquivo);
+
+    int fd = open(caminho, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Erro ao abrir arquivo de bloqueio: %s\n", caminho);
+        return -1;
+    }
+
+    // Tentar sem esperar primeiro para poder avisar o usuário
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        if (errno == EWOULDBLOCK) {
+            fprintf(stderr, "Aguardando outro processo liberar a base de dados...\n");
+        }
+        while (flock(fd, LOCK_EX) != 0) {
+            if (errno != EINTR) {
+                fprintf(stderr, "Erro ao bloquear a base de dados: %s\n", strerror(errno));
+                close(fd);
+                return -1;
+            }
+        }
+    }
+    return fd;
+}
+
+// Liberar bloqueio obtido com bloquear_escrita
+void liberar_bloqueio(int fd) {
+    if (fd >= 0) {
+        flock(fd, LOCK_UN);
+        close(fd);
+    }
+}
+
+// Bloqueio compartilhado sobre o arquivo de dados aberto
+// Salvamentos publicam um novo arquivo por rename(), então leitores nunca
+// esperam por eles; o bloqueio protege contra escritas no próprio arquivo
+int bloquear_leitura(FILE *fp) {
+    if (!fp) {
+        return 0;
+    }
+    while (flock(fileno(fp), LOCK_SH) != 0) {
+        if (errno != EINTR) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Nome do arquivo temporário usado antes do rename (único por processo)
+void nome_arquivo_temporario(const char *arquivo, char *destino, size_t tamanho) {
+    snprintf(destino, tamanho, "%s.tmp.%ld", arquivo, (long)getpid());
+}
+
+// Garantir que os dados chegaram ao disco antes do rename
+int gravar_em_disco(FILE *fp) {
+    if (fflush(fp) != 0) {
+        return 0;
+    }
+    return fsync(fileno(fp)) == 0;
+}
+
+static void preencher_assinatura(const struct stat *st, AssinaturaArquivo *assinatura) {
+    assinatura->existe = 1;
+    assinatura->dispositivo = (unsigned long long)st->st_dev;
+    assinatura->inode = (unsigned long long)st->st_ino;
+    assinatura->tamanho = (long long)st->st_size;
+    assinatura->modificacao_seg = (long long)st->st_mtim.tv_sec;
+    assinatura->modificacao_nseg = (long long)st->st_mtim.tv_nsec;
+}
+
+// Assinatura do arquivo no caminho (existe = 0 se não existir)
+int obter_assinatura_arquivo(const char *arquivo, AssinaturaArquivo *assinatura) {
+    memset(assinatura, 0, sizeof(*assinatura));
+    struct stat st;
+    if (!arquivo || stat(arquivo, &st) != 0) {
+        return 0;
+    }
+    preencher_assinatura(&st, assinatura);
+    return 1;
+}
+
+// Assinatura do arquivo já aberto (a versão que foi de fato lida)
+int obter_assinatura_aberto(FILE *fp, AssinaturaArquivo *assinatura) {
+    memset(assinatura, 0, sizeof(*assinatura));
+    struct stat st;
+    if (!fp || fstat(fileno(fp), &st) != 0) {
+        return 0;
+    }
+    preencher_assinatura(&st, assinatura);
+    return 1;
+}
+
+int assinaturas_iguais(const AssinaturaArquivo *a, const AssinaturaArquivo *b) {
+    return a->existe == b->existe &&
+           a->dispositivo == b->dispositivo &&
+           a->inode == b->inode &&
+           a->tamanho == b->tamanho &&
+           a->modificacao_seg == b->modificacao_seg &&
+           a->modificacao_nseg == b->modificacao_nseg;
+}
@@ -0,0 +1,33 @@
+#ifndef BLOQUEIO_H
+#define BLOQUEIO_H
+
+#include <stdio.h>
+
+// Identidade de uma versão do arquivo de dados (muda a cada salvamento)
+typedef struct {
+    int existe;
+    unsigned long long dispositivo;
+    unsigned long long inode;
+    long long tamanho;
+    long long modificacao_seg;
+    long long modificacao_nseg;
+} AssinaturaArquivo;
+
+// Bloqueio de escrita: exclusivo entre processos durante carregar -> alterar -> salvar
+// Usa flock() em "<arquivo>.lock"; retorna o descritor (ou -1 em erro)
+int bloquear_escrita(const char *arquivo);
+void liberar_bloqueio(int fd);
+
+// Bloqueio compartilhado de leitura sobre o arquivo aberto (liberado no fclose)
+int bloquear_leitura(FILE *fp);
+
+// Publicação atômica: grava em arquivo temporário e renomeia sobre o original
+void nome_arquivo_temporario(const char *arquivo, char *destino, size_t tamanho);
+int gravar_em_disco(FILE *fp);
+
+// Assinaturas para detectar alteração por outro processo
+int obter_assinatura_arquivo(const char *arquivo, AssinaturaArquivo *assinatura);
+int obter_assinatura_aberto(FILE *fp, AssinaturaArquivo *assinatura);
+int assinaturas_iguais(const AssinaturaArquivo *a, const AssinaturaArquivo *b);
+
+#endif
@@ -0,0 +1,181 @@
+#include "cache_consultas.h"
+#include "indice.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BALDES_INICIAIS 64
+
+CacheConsultas* criar_cache_consultas(size_t limite) {
+    CacheConsultas *cache = (CacheConsultas*)calloc(1, sizeof(CacheConsultas));
+    if (!cache) {
+        fprintf(stderr, "Erro ao alocar memória para o cache de consultas\n");
+        return NULL;
+    }
+    cache->baldes = (EntradaCache**)calloc(BALDES_INICIAIS, sizeof(EntradaCache*));
+    if (!cache->baldes) {
+        fprintf(stderr, "Erro ao alocar memória para o cache de consultas\n");
+        free(cache);
+        return NULL;
+    }
+    cache->num_baldes = BALDES_INICIAIS;
+    cache->limite = limite > 0 ? limite : MEMORIA_CACHE_CONSULTAS_PADRAO;
+    return cache;
+}
+
+// Remover todas as entradas mantendo os baldes e os contadores
+void limpar_cache_consultas(CacheConsultas *cache) {
+    if (!cache) {
+        return;
+    }
+    EntradaCache *entrada = cache->mais_recente;
+    while (entrada) {
+        EntradaCache *proxima = entrada->proxima;
+        free(entrada);
+        entrada = proxima;
+    }
+    memset(cache->baldes, 0, cache->num_baldes * sizeof(EntradaCache*));
+    cache->num_entradas = 0;
+    cache->mais_recente = NULL;
+    cache->menos_recente = NULL;
+    cache->bytes = 0;
+}
+
+void liberar_cache_consultas(CacheConsultas *cache) {
+    if (cache) {
+        limpar_cache_consultas(cache);
+        free(cache->baldes);
+        free(cache);
+    }
+}
+
+static void desligar_lru(CacheConsultas *cache, EntradaCache *entrada) {
+    if (entrada->anterior) {
+        entrada->anterior->proxima = entrada->proxima;
+    } else {
+        cache->mais_recente = entrada->proxima;
+    }
+    if (entrada->proxima) {
+        entrada->proxima->anterior = entrada->anterior;
+    } else {
+        cache->menos_recente = entrada->anterior;
+    }
+}
+
+static void ligar_no_inicio(CacheConsultas *cache, EntradaCache *entrada) {
+    entrada->anterior = NULL;
+    entrada->proxima = cache->mais_recente;
+    if (cache->mais_recente) {
+        cache->mais_recente->anterior = entrada;
+    } else {
+        cache->menos_recente = entrada;
+    }
+    cache->mais_recente = entrada;
+}
+
+// Tirar a entrada do balde e da lista LRU e liberá-la
+static void remover_entrada(CacheConsultas *cache, EntradaCache *entrada) {
+    EntradaCache **elo = &cache->baldes[entrada->hash % cache->num_baldes];
+    while (*elo != entrada) {
+        elo = &(*elo)->proxima_balde;
+    }
+    *elo = entrada->proxima_balde;
+    desligar_lru(cache, entrada);
+    cache->bytes -= entrada->bytes;
+    cache->num_entradas--;
+    free(entrada);
+}
+
+// Dobrar o número de baldes quando o fator de carga passa de 1
+static void redimensionar_cache(CacheConsultas *cache) {
+    size_t novo_num = cache->num_baldes * 2;
+    EntradaCache **novos = (EntradaCache**)calloc(novo_num, sizeof(EntradaCache*));
+    if (!novos) {
+        return; // Continua funcionando, só com cadeias mais longas
+    }
+    for (EntradaCache *entrada = cache->mais_recente; entrada; entrada = entrada->proxima) {
+        size_t balde = entrada->hash % novo_num;
+        entrada->proxima_balde = novos[balde];
+        novos[balde] = entrada;
+    }
+    free(cache->baldes);
+    cache->baldes = novos;
+    cache->num_baldes = novo_num;
+}
+
+static EntradaCache* procurar_entrada(CacheConsultas *cache, const char *consulta, unsigned long hash) {
+    EntradaCache *entrada = cache->baldes[hash % cache->num_baldes];
+    while (entrada && (entrada->hash != hash || strcmp(entrada->consulta, consulta) != 0)) {
+        entrada = entrada->proxima_balde;
+    }
+    return entrada;
+}
+
+const int* cache_consultar(CacheConsultas *cache, const char *consulta, unsigned long geracao, int *quantidade) {
+    if (!cache || !consulta || !quantidade) {
+        return NULL;
+    }
+    EntradaCache *entrada = procurar_entrada(cache, consulta, hash_string(consulta));
+    if (entrada && entrada->geracao != geracao) {
+        // Calculada antes de alguma alteração da lista
+        remover_entrada(cache, entrada);
+        cache->invalidadas++;
+        entrada = NULL;
+    }
+    if (!entrada) {
+        cache->faltas++;
+        return NULL;
+    }
+    desligar_lru(cache, entrada);
+    ligar_no_inicio(cache, entrada);
+    cache->acertos++;
+    *quantidade = entrada->quantidade;
+    return entrada->ids;
+}
+
+int cache_guardar(CacheConsultas *cache, const char *consulta, unsigned long geracao, const int *ids, int quantidade) {
+    if (!cache || !consulta || quantidade < 0 || (quantidade > 0 && !ids)) {
+        return 0;
+    }
+    size_t tamanho_consulta = strlen(consulta) + 1;
+    size_t bytes = sizeof(EntradaCache) + (size_t)quantidade * sizeof(int) + tamanho_consulta;
+    if (bytes > cache->limite / 4) {
+        return 0;
+    }
+
+    unsigned long hash = hash_string(consulta);
+    EntradaCache *existente = procurar_entrada(cache, consulta, hash);
+    if (existente) {
+        remover_entrada(cache, existente);
+    }
+    while (cache->bytes + bytes > cache->limite && cache->menos_recente) {
+        remover_entrada(cache, cache->menos_recente);
+        cache->descartes++;
+    }
+
+    EntradaCache *entrada = (EntradaCache*)malloc(bytes);
+    if (!entrada) {
+        return 0;
+    }
+    entrada->hash = hash;
+    entrada->geracao = geracao;
+    entrada->quantidade = quantidade;
+    entrada->bytes = bytes;
+    entrada->ids = (int*)(entrada + 1);
+    entrada->consulta = (char*)(entrada->ids + quantidade);
+    if (quantidade > 0) {
+        memcpy(entrada->ids, ids, (size_t)quantidade * sizeof(int));
+    }
+    memcpy(entrada->consulta, consulta, tamanho_consulta);
+
+    if (cache->num_entradas >= cache->num_baldes) {
+        redimensionar_cache(cache);
+    }
+    size_t balde = hash % cache->num_baldes;
+    entrada->proxima_balde = cache->baldes[balde];
+    cache->baldes[balde] = entrada;
+    ligar_no_inicio(cache, entrada);
+    cache->bytes += bytes;
+    cache->num_entradas++;
+    return 1;
+}
@@ -0,0 +1,51 @@
+#ifndef CACHE_CONSULTAS_H
+#define CACHE_CONSULTAS_H
+
+#include <stddef.h>
+
+// Cache LRU de consultas: texto da consulta -> IDs encontrados, limitado em bytes
+// Cada entrada guarda a geração da lista em que foi calculada; qualquer alteração
+// da lista incrementa a geração, então invalidar tudo não custa nada: uma entrada
+// de geração antiga é descartada quando consultada (ou quando sai pelo LRU)
+#define MEMORIA_CACHE_CONSULTAS_PADRAO ((size_t)4 * 1024 * 1024)
+
+typedef struct EntradaCache {
+    unsigned long hash;
+    unsigned long geracao;
+    int quantidade;
+    size_t bytes;                    // Contabilizados no limite (entrada, IDs e consulta)
+    int *ids;                        // Na mesma alocação da entrada, seguidos da consulta
+    char *consulta;
+    struct EntradaCache *proxima_balde;
+    struct EntradaCache *anterior;   // Lista LRU: mais recente no início
+    struct EntradaCache *proxima;
+} EntradaCache;
+
+typedef struct {
+    EntradaCache **baldes;
+    size_t num_baldes;
+    size_t num_entradas;
+    EntradaCache *mais_recente;
+    EntradaCache *menos_recente;
+    size_t bytes;
+    size_t limite;
+    unsigned long acertos;
+    unsigned long faltas;
+    unsigned long descartes;         // Entradas removidas pelo limite de memória
+    unsigned long invalidadas;       // Entradas de gerações antigas encontradas
+} CacheConsultas;
+
+// Funções de gerenciamento do cache (limite 0 = MEMORIA_CACHE_CONSULTAS_PADRAO)
+CacheConsultas* criar_cache_consultas(size_t limite);
+void liberar_cache_consultas(CacheConsultas *cache);
+void limpar_cache_consultas(CacheConsultas *cache);
+
+// IDs guardados para a consulta na geração dada (válidos até a próxima chamada
+// que altere o cache) ou NULL em falta; conta acertos e faltas
+const int* cache_consultar(CacheConsultas *cache, const char *consulta, unsigned long geracao, int *quantidade);
+
+// Guardar o resultado da consulta, descartando as menos usadas até caber
+// Resultados maiores que um quarto do limite não são guardados (retorna 0)
+int cache_guardar(CacheConsultas *cache, const char *consulta, unsigned long geracao, const int *ids, int quantidade);
+
+#endif
@@ -0,0 +1,630 @@
+#include "comparacao.h"
+#include "arquivo_blocos.h"
+#include "alteracoes.h"
+#include "bloqueio.h"
+#include "ordenacao_externa.h"
+#include "utils/string_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LADO_A 0
+#define LADO_B 1
+
+#define EVENTO_SO_A 1
+#define EVENTO_SO_B 2
+#define EVENTO_MESMO_ID 3
+
+// Registro sem par por ID, à espera do casamento por email
+// Passa por duas ordenações externas: por (email, lado, ID), que numera os
+// registros de cada lado com o mesmo email, e por (email, posição, lado), que
+// deixa o i-ésimo de "a" ao lado do i-ésimo de "b": casar só olha o registro anterior
+typedef struct {
+    Contato contato;
+    char email[MAX_EMAIL];      // Email normalizado
+    int32_t lado;
+    int32_t colisao;            // O ID existe no outro arquivo com outra pessoa
+    int32_t posicao;            // Ordem entre os do mesmo lado com o mesmo email
+} Candidato;
+
+// Decisão da mesclagem sobre um registro sem par por ID, ordenada por (lado, ID)
+// e lida junto com a segunda passada
+#define DECISAO_SUBSTITUIR 1    // "a" casado por email: campos de "b" com o ID de "a"
+#define DECISAO_PULAR 2         // "b" casado por email: já gravado no lugar do par
+#define DECISAO_ADIAR 3         // "b" em colisão sem par: vai para o fim com um ID novo
+
+typedef struct {
+    int32_t lado;
+    int32_t id;
+    int32_t decisao;
+    int32_t id_par;             // SUBSTITUIR: ID do contato de "b" (atributos)
+    Contato contato;            // SUBSTITUIR: contato de "b"; ADIAR: o próprio
+} Decisao;
+
+typedef void (*EventoJuncao)(int evento, const Contato *a, const Contato *b, void *contexto);
+
+// Mesmo contato: ao menos um de email, telefone ou nome normalizado coincide
+static int mesmo_contato(const Contato *a, const Contato *b) {
+    char chave_a[MAX_NOME], chave_b[MAX_NOME];
+    if (normalizar_email(a->email, chave_a, sizeof(chave_a))[0] &&
+        strcmp(chave_a, normalizar_email(b->email, chave_b, sizeof(chave_b))) == 0) {
+        return 1;
+    }
+    if (normalizar_telefone(a->telefone, chave_a, sizeof(chave_a))[0] &&
+        strcmp(chave_a, normalizar_telefone(b->telefone, chave_b, sizeof(chave_b))) == 0) {
+        return 1;
+    }
+    return normalizar_nome(a->nome, chave_a, sizeof(chave_a))[0] &&
+           strcmp(chave_a, normalizar_nome(b->nome, chave_b, sizeof(chave_b))) == 0;
+}
+
+static int campos_iguais(const Contato *a, const Contato *b) {
+    return strcmp(a->nome, b->nome) == 0 && strcmp(a->telefone, b->telefone) == 0 &&
+           strcmp(a->email, b->email) == 0;
+}
+
+// Próximo contato ativo, exigindo IDs crescentes (a junção depende disso)
+static const Contato* avancar(LeitorContatos *leitor, int *ultimo_id, int *ok) {
+    const Contato *contato;
+    while ((contato = proximo_contato(leitor)) && !contato->ativo) {
+    }
+    if (contato) {
+        if (contato->id <= *ultimo_id) {
+            fprintf(stderr, "Erro: arquivo fora da ordem de ID (ID %d após %d)\n", contato->id, *ultimo_id);
+            *ok = 0;
+            return NULL;
+        }
+        *ultimo_id = contato->id;
+    }
+    return contato;
+}
+
+// Junção por ID dos dois arquivos, um bloco de cada em memória
+// Informa o maior ID e a maior sequência dos dois arquivos
+static int juntar_por_id(const char *arquivo_a, const char *arquivo_b, EventoJuncao evento, void *contexto,
+                         int *maior_id, uint64_t *sequencia) {
+    LeitorContatos *a = abrir_leitor_contatos(arquivo_a);
+    LeitorContatos *b = a ? abrir_leitor_contatos(arquivo_b) : NULL;
+    if (!a || !b) {
+        fechar_leitor_contatos(a);
+        return 0;
+    }
+
+    int ok = 1;
+    int ultimo_a = 0, ultimo_b = 0;
+    const Contato *ca = avancar(a, &ultimo_a, &ok);
+    const Contato *cb = avancar(b, &ultimo_b, &ok);
+    while ((ca || cb) && ok) {
+        if (ca && cb && ca->id == cb->id) {
+            evento(EVENTO_MESMO_ID, ca, cb, contexto);
+            ca = avancar(a, &ultimo_a, &ok);
+            cb = avancar(b, &ultimo_b, &ok);
+        } else if (ca && (!cb || ca->id < cb->id)) {
+            evento(EVENTO_SO_A, ca, NULL, contexto);
+            ca = avancar(a, &ultimo_a, &ok);
+        } else {
+            evento(EVENTO_SO_B, NULL, cb, contexto);
+            cb = avancar(b, &ultimo_b, &ok);
+        }
+    }
+    ok = ok && !a->erro && !b->erro;
+
+    if (maior_id) {
+        *maior_id = ultimo_a > ultimo_b ? ultimo_a : ultimo_b;
+    }
+    if (sequencia) {
+        *sequencia = a->sequencia > b->sequencia ? a->sequencia : b->sequencia;
+    }
+    fechar_leitor_contatos(a);
+    fechar_leitor_contatos(b);
+    return ok;
+}
+
+// Primeira passada: contagens, alterações por ID e candidatos ao casamento por email
+typedef struct {
+    ResultadoComparacao *resultado;
+    FILE *saida;
+    long mesmo_id;              // Pares de mesmo ID e mesmo contato (um registro na mesclagem)
+    long so_b_sem_par;
+    OrdenacaoExterna *por_email;
+    OrdenacaoExterna *pares;
+    OrdenacaoExterna *decisoes; // Só na mesclagem
+    Candidato anterior;         // Último numerado (por_email) ou à espera do par (pares)
+    int tem_anterior;
+    int ok;
+} Classificacao;
+
+static void adicionar_candidato(Classificacao *c, const Contato *contato, int lado, int colisao) {
+    Candidato candidato;
+    memset(&candidato, 0, sizeof(candidato));
+    candidato.contato = *contato;
+    normalizar_email(contato->email, candidato.email, sizeof(candidato.email));
+    candidato.lado = lado;
+    candidato.colisao = colisao;
+    if (c->ok && !acrescentar_registro(c->por_email, &candidato)) {
+        c->ok = 0;
+    }
+}
+
+static void adicionar_decisao(Classificacao *c, int lado, int id, int decisao, int id_par, const Contato *contato) {
+    if (!c->decisoes) {
+        return;
+    }
+    Decisao d;
+    memset(&d, 0, sizeof(d));
+    d.lado = lado;
+    d.id = id;
+    d.decisao = decisao;
+    d.id_par = id_par;
+    if (contato) {
+        d.contato = *contato;
+    }
+    if (c->ok && !acrescentar_registro(c->decisoes, &d)) {
+        c->ok = 0;
+    }
+}
+
+static void imprimir_diferencas(FILE *saida, const Contato *a, const Contato *b) {
+    if (a->id == b->id) {
+        fprintf(saida, "~ %d", a->id);
+    } else {
+        fprintf(saida, "~ %d -> %d (mesmo email)", a->id, b->id);
+    }
+    if (strcmp(a->nome, b->nome) != 0) {
+        fprintf(saida, "  nome: \"%s\" -> \"%s\"", a->nome, b->nome);
+    }
+    if (strcmp(a->telefone, b->telefone) != 0) {
+        fprintf(saida, "  telefone: \"%s\" -> \"%s\"", a->telefone, b->telefone);
+    }
+    if (strcmp(a->email, b->email) != 0) {
+        fprintf(saida, "  email: \"%s\" -> \"%s\"", a->email, b->email);
+    }
+    fprintf(saida, "\n");
+}
+
+static void classificar(int evento, const Contato *a, const Contato *b, void *contexto) {
+    Classificacao *c = (Classificacao*)contexto;
+    switch (evento) {
+        case EVENTO_MESMO_ID:
+            if (mesmo_contato(a, b)) {
+                c->mesmo_id++;
+                if (campos_iguais(a, b)) {
+                    c->resultado->iguais++;
+                } else {
+                    c->resultado->alterados++;
+                    if (c->saida) {
+                        imprimir_diferencas(c->saida, a, b);
+                    }
+                }
+            } else {
+                c->resultado->colisoes++;
+                adicionar_candidato(c, a, LADO_A, 1);
+                adicionar_candidato(c, b, LADO_B, 1);
+            }
+            break;
+        case EVENTO_SO_A:
+            adicionar_candidato(c, a, LADO_A, 0);
+            break;
+        case EVENTO_SO_B:
+            adicionar_candidato(c, b, LADO_B, 0);
+            break;
+    }
+}
+
+static int comparar_ids(int a, int b) {
+    return (a > b) - (a < b);
+}
+
+static int comparar_por_email(const void *x, const void *y) {
+    const Candidato *a = (const Candidato*)x;
+    const Candidato *b = (const Candidato*)y;
+    int r = strcmp(a->email, b->email);
+    if (r != 0) {
+        return r;
+    }
+    if (a->lado != b->lado) {
+        return a->lado - b->lado;
+    }
+    return comparar_ids(a->contato.id, b->contato.id);
+}
+
+static int comparar_pares(const void *x, const void *y) {
+    const Candidato *a = (const Candidato*)x;
+    const Candidato *b = (const Candidato*)y;
+    int r = strcmp(a->email, b->email);
+    if (r != 0) {
+        return r;
+    }
+    if (a->posicao != b->posicao) {
+        return a->posicao - b->posicao;
+    }
+    return a->lado - b->lado;
+}
+
+static int comparar_decisoes(const void *x, const void *y) {
+    const Decisao *a = (const Decisao*)x;
+    const Decisao *b = (const Decisao*)y;
+    if (a->lado != b->lado) {
+        return a->lado - b->lado;
+    }
+    return comparar_ids(a->id, b->id);
+}
+
+// Saída da ordenação por (email, lado, ID): numerar os de cada lado com o mesmo email
+static int numerar_candidato(const void *registro, void *contexto) {
+    Classificacao *c = (Classificacao*)contexto;
+    Candidato candidato = *(const Candidato*)registro;
+    if (c->tem_anterior && candidato.lado == c->anterior.lado && strcmp(candidato.email, c->anterior.email) == 0) {
+        candidato.posicao = c->anterior.posicao + 1;
+    } else {
+        candidato.posicao = 0;
+    }
+    c->anterior = candidato;
+    c->tem_anterior = 1;
+    return acrescentar_registro(c->pares, &candidato);
+}
+
+static void registrar_par(Classificacao *c, const Candidato *a, const Candidato *b) {
+    ResultadoComparacao *resultado = c->resultado;
+    resultado->casados_por_email++;
+    resultado->alterados += !campos_iguais(&a->contato, &b->contato) || a->contato.id != b->contato.id;
+    if (c->saida) {
+        imprimir_diferencas(c->saida, &a->contato, &b->contato);
+    }
+    adicionar_decisao(c, LADO_A, a->contato.id, DECISAO_SUBSTITUIR, b->contato.id, &b->contato);
+    adicionar_decisao(c, LADO_B, b->contato.id, DECISAO_PULAR, a->contato.id, NULL);
+}
+
+static void registrar_sem_par(Classificacao *c, const Candidato *x) {
+    const Contato *contato = &x->contato;
+    if (x->lado == LADO_A) {
+        c->resultado->removidos++;
+        if (c->saida) {
+            fprintf(c->saida, "- %d  %s | %s | %s\n", contato->id, contato->nome, contato->telefone, contato->email);
+        }
+        return;
+    }
+    c->resultado->adicionados++;
+    c->so_b_sem_par++;
+    if (c->saida) {
+        fprintf(c->saida, "+ %d  %s | %s | %s\n", contato->id, contato->nome, contato->telefone, contato->email);
+    }
+    if (x->colisao) {
+        adicionar_decisao(c, LADO_B, contato->id, DECISAO_ADIAR, 0, contato);
+    }
+}
+
+// Saída da ordenação por (email, posição, lado): um "a" seguido do "b" de mesmo
+// email e posição é um par; o resto fica sem par
+static int casar_candidato(const void *registro, void *contexto) {
+    Classificacao *c = (Classificacao*)contexto;
+    const Candidato *atual = (const Candidato*)registro;
+    if (c->tem_anterior) {
+        const Candidato *anterior = &c->anterior;
+        if (anterior->lado == LADO_A && atual->lado == LADO_B && anterior->email[0] &&
+            anterior->posicao == atual->posicao && strcmp(anterior->email, atual->email) == 0) {
+            registrar_par(c, anterior, atual);
+            c->tem_anterior = 0;
+            return c->ok;
+        }
+        registrar_sem_par(c, anterior);
+    }
+    c->anterior = *atual;
+    c->tem_anterior = 1;
+    return c->ok;
+}
+
+static void liberar_classificacao(Classificacao *c) {
+    liberar_ordenacao_externa(c->por_email);
+    liberar_ordenacao_externa(c->pares);
+    liberar_ordenacao_externa(c->decisoes);
+    c->por_email = c->pares = c->decisoes = NULL;
+}
+
+// Primeira passada completa: junção, casamento por email e contagens finais
+// Na mesclagem (com_decisoes), as decisões ficam em c->decisoes, ainda por emitir
+// "temporario" é o prefixo dos arquivos das ordenações externas
+static int analisar_arquivos(const char *arquivo_a, const char *arquivo_b, FILE *saida,
+                             ResultadoComparacao *resultado, Classificacao *c, int com_decisoes,
+                             const char *temporario, int *maior_id, uint64_t *sequencia) {
+    memset(resultado, 0, sizeof(*resultado));
+    memset(c, 0, sizeof(*c));
+    c->resultado = resultado;
+    c->saida = saida;
+    c->ok = 1;
+
+    // A memória se divide entre as ordenações que acumulam ao mesmo tempo
+    char prefixo[600];
+    snprintf(prefixo, sizeof(prefixo), "%s.email", temporario);
+    c->por_email = iniciar_ordenacao_externa(sizeof(Candidato), comparar_por_email, MEMORIA_COMPARACAO_PADRAO / 2, prefixo);
+    snprintf(prefixo, sizeof(prefixo), "%s.pares", temporario);
+    c->pares = iniciar_ordenacao_externa(sizeof(Candidato), comparar_pares, MEMORIA_COMPARACAO_PADRAO / 4, prefixo);
+    if (com_decisoes) {
+        snprintf(prefixo, sizeof(prefixo), "%s.decisoes", temporario);
+        c->decisoes = iniciar_ordenacao_externa(sizeof(Decisao), comparar_decisoes, MEMORIA_COMPARACAO_PADRAO / 4, prefixo);
+    }
+    if (!c->por_email || !c->pares || (com_decisoes && !c->decisoes)) {
+        return 0;
+    }
+
+    if (!juntar_por_id(arquivo_a, arquivo_b, classificar, c, maior_id, sequencia)) {
+        return 0;
+    }
+    if (!c->ok) {
+        fprintf(stderr, "Erro ao guardar os registros sem par por ID\n");
+        return 0;
+    }
+
+    c->tem_anterior = 0;
+    int ok = concluir_ordenacao_externa(c->por_email, numerar_candidato, c);
+    c->tem_anterior = 0;
+    ok = ok && concluir_ordenacao_externa(c->pares, casar_candidato, c);
+    if (ok && c->tem_anterior) {
+        registrar_sem_par(c, &c->anterior);
+    }
+    if (!ok || !c->ok) {
+        fprintf(stderr, "Erro ao casar os registros por email\n");
+        return 0;
+    }
+
+    // Mesclagem: um registro por par de mesmo ID, um por candidato de "a" e um por candidato de "b" sem par
+    long candidatos_a = resultado->removidos + resultado->casados_por_email;
+    resultado->total_mesclado = c->mesmo_id + candidatos_a + c->so_b_sem_par;
+    return 1;
+}
+
+int comparar_arquivos(const char *arquivo_a, const char *arquivo_b, FILE *saida, ResultadoComparacao *resultado) {
+    if (!arquivo_a || !arquivo_b || !resultado) {
+        return 0;
+    }
+    char temporario[512];
+    nome_arquivo_temporario(arquivo_b, temporario, sizeof(temporario));
+    Classificacao classificacao;
+    int ok = analisar_arquivos(arquivo_a, arquivo_b, saida, resultado, &classificacao, 0, temporario, NULL, NULL);
+    liberar_classificacao(&classificacao);
+    return ok;
+}
+
+// Decisões de um lado, lidas em ordem de ID do arquivo temporário
+typedef struct {
+    FILE *fp;
+    long restantes;
+    Decisao atual;
+    int tem_atual;
+} CursorDecisoes;
+
+static int abrir_cursor_decisoes(CursorDecisoes *cursor, const char *caminho, long inicio, long quantidade) {
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->fp = fopen(caminho, "rb");
+    if (!cursor->fp || fseek(cursor->fp, inicio * (long)sizeof(Decisao), SEEK_SET) != 0) {
+        fprintf(stderr, "Erro ao ler arquivo temporário: %s\n", caminho);
+        return 0;
+    }
+    cursor->restantes = quantidade;
+    return 1;
+}
+
+static void fechar_cursor_decisoes(CursorDecisoes *cursor) {
+    if (cursor->fp) {
+        fclose(cursor->fp);
+        cursor->fp = NULL;
+    }
+}
+
+// Próxima decisão do lado (NULL no fim)
+static const Decisao* proxima_decisao(CursorDecisoes *cursor, int *ok) {
+    if (cursor->restantes <= 0) {
+        cursor->tem_atual = 0;
+        return NULL;
+    }
+    if (fread(&cursor->atual, sizeof(Decisao), 1, cursor->fp) != 1) {
+        *ok = 0;
+        cursor->tem_atual = 0;
+        return NULL;
+    }
+    cursor->restantes--;
+    cursor->tem_atual = 1;
+    return &cursor->atual;
+}
+
+// Decisão sobre o ID, se houver; os IDs chegam em ordem crescente
+static const Decisao* decisao_para(CursorDecisoes *cursor, int id, int *ok) {
+    while (cursor->tem_atual && cursor->atual.id < id) {
+        proxima_decisao(cursor, ok);
+    }
+    return cursor->tem_atual && cursor->atual.id == id ? &cursor->atual : NULL;
+}
+
+// Segunda passada: gravar a união em ordem de ID; colisões de "b" sem par vão para o fim com IDs novos
+typedef struct {
+    EscritorBlocos *escritor;
+    CursorDecisoes decisoes_a;
+    CursorDecisoes decisoes_b;
+    const ExtensoesContatos *extensoes_a;
+    const ExtensoesContatos *extensoes_b;
+    ExtensoesContatos *extensoes;   // Atributos do destino (criados sob demanda)
+    int ok;
+} Mesclagem;
+
+// Copiar os atributos de um contato de origem para o ID gravado no destino
+static void copiar_atributos(Mesclagem *m, const ExtensoesContatos *origem, int id_origem, int id) {
+    int inicio;
+    int n = id_origem > 0 ? faixa_extensoes(origem, id_origem, &inicio) : 0;
+    if (n > 0 && !m->extensoes) {
+        m->extensoes = criar_extensoes();
+    }
+    for (int i = 0; i < n && m->ok; i++) {
+        const AtributoExtensao *atributo = &origem->atributos[inicio + i];
+        if (!m->extensoes ||
+            !definir_extensao(m->extensoes, id, origem->nomes_chaves[atributo->chave], VALOR_EXTENSAO(origem, atributo))) {
+            fprintf(stderr, "Erro ao mesclar os atributos do contato %d\n", id);
+            m->ok = 0;
+        }
+    }
+}
+
+// Gravar o contato com o ID do destino e os atributos das origens (os de "b"
+// prevalecem na mesma chave); id_a/id_b = 0 quando o lado não contribui
+static void escrever(Mesclagem *m, const Contato *contato, int id, int id_a, int id_b) {
+    Contato copia = *contato;
+    copia.id = id;
+    copia.ativo = 1;
+    if (m->ok && !escrever_contato_bloco(m->escritor, &copia)) {
+        m->ok = 0;
+    }
+    copiar_atributos(m, m->extensoes_a, id_a, id);
+    copiar_atributos(m, m->extensoes_b, id_b, id);
+}
+
+static void mesclar_so_a(Mesclagem *m, const Contato *a) {
+    const Decisao *d = decisao_para(&m->decisoes_a, a->id, &m->ok);
+    if (d && d->decisao == DECISAO_SUBSTITUIR) {
+        escrever(m, &d->contato, a->id, a->id, d->id_par); // Mesmo email: campos de "b", ID de "a"
+    } else {
+        escrever(m, a, a->id, a->id, 0);
+    }
+}
+
+static void mesclar_so_b(Mesclagem *m, const Contato *b) {
+    const Decisao *d = decisao_para(&m->decisoes_b, b->id, &m->ok);
+    if (d) {
+        return; // Já gravado com o ID do contato casado em "a", ou adiado para o fim
+    }
+    escrever(m, b, b->id, 0, b->id);
+}
+
+static void mesclar_evento(int evento, const Contato *a, const Contato *b, void *contexto) {
+    Mesclagem *m = (Mesclagem*)contexto;
+    switch (evento) {
+        case EVENTO_MESMO_ID:
+            if (mesmo_contato(a, b)) {
+                escrever(m, b, b->id, a->id, b->id);
+            } else {
+                mesclar_so_a(m, a);
+                mesclar_so_b(m, b);
+            }
+            break;
+        case EVENTO_SO_A:
+            mesclar_so_a(m, a);
+            break;
+        case EVENTO_SO_B:
+            mesclar_so_b(m, b);
+            break;
+    }
+}
+
+// Decisões ordenadas gravadas em sequência: primeiro as de "a", depois as de "b"
+typedef struct {
+    FILE *fp;
+    long lado_a;
+} GravacaoDecisoes;
+
+static int gravar_decisao(const void *registro, void *contexto) {
+    GravacaoDecisoes *g = (GravacaoDecisoes*)contexto;
+    const Decisao *d = (const Decisao*)registro;
+    g->lado_a += d->lado == LADO_A;
+    return fwrite(d, sizeof(Decisao), 1, g->fp) == 1;
+}
+
+int mesclar_arquivos(const char *arquivo_a, const char *arquivo_b, const char *destino, ResultadoComparacao *resultado) {
+    if (!arquivo_a || !arquivo_b || !destino || !resultado) {
+        return 0;
+    }
+
+    // O destino pode ser um dos arquivos de origem: bloqueado como qualquer escrita
+    int fd_bloqueio = bloquear_escrita(destino);
+    if (fd_bloqueio < 0) {
+        fprintf(stderr, "Erro ao bloquear %s para escrita\n", destino);
+        return 0;
+    }
+
+    // Atributos das duas origens (arquivos esparsos, lidos inteiros)
+    ExtensoesContatos *extensoes_a = NULL;
+    ExtensoesContatos *extensoes_b = NULL;
+    if (!carregar_extensoes(arquivo_a, &extensoes_a) || !carregar_extensoes(arquivo_b, &extensoes_b)) {
+        liberar_extensoes(extensoes_a);
+        liberar_bloqueio(fd_bloqueio);
+        return 0;
+    }
+
+    char temporario[512];
+    nome_arquivo_temporario(destino, temporario, sizeof(temporario));
+    Classificacao classificacao;
+    int maior_id = 0;
+    uint64_t sequencia = 0;
+    int ok = analisar_arquivos(arquivo_a, arquivo_b, NULL, resultado, &classificacao, 1, temporario,
+                               &maior_id, &sequencia);
+
+    // Decisões em ordem de (lado, ID), num arquivo lido por dois cursores
+    char caminho_decisoes[600];
+    snprintf(caminho_decisoes, sizeof(caminho_decisoes), "%s.mesclagem", temporario);
+    GravacaoDecisoes gravacao = { NULL, 0 };
+    long total_decisoes = classificacao.decisoes ? classificacao.decisoes->total : 0;
+    if (ok) {
+        gravacao.fp = fopen(caminho_decisoes, "wb");
+        ok = gravacao.fp && concluir_ordenacao_externa(classificacao.decisoes, gravar_decisao, &gravacao);
+        if (gravacao.fp && fclose(gravacao.fp) != 0) {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "Erro ao gravar arquivo temporário: %s\n", caminho_decisoes);
+        }
+    }
+    liberar_classificacao(&classificacao);
+
+    Mesclagem mesclagem;
+    memset(&mesclagem, 0, sizeof(mesclagem));
+    mesclagem.extensoes_a = extensoes_a;
+    mesclagem.extensoes_b = extensoes_b;
+    ok = ok && abrir_cursor_decisoes(&mesclagem.decisoes_a, caminho_decisoes, 0, gravacao.lado_a) &&
+         abrir_cursor_decisoes(&mesclagem.decisoes_b, caminho_decisoes, gravacao.lado_a, total_decisoes - gravacao.lado_a);
+    mesclagem.ok = ok;
+    proxima_decisao(&mesclagem.decisoes_a, &mesclagem.ok);
+    proxima_decisao(&mesclagem.decisoes_b, &mesclagem.ok);
+
+    FILE *fp = ok ? fopen(temporario, "wb") : NULL;
+    // A sequência avança: o conteúdo mesclado não está em nenhum registro de alterações
+    mesclagem.escritor = fp ? abrir_escritor_blocos(fp, (int32_t)resultado->total_mesclado, sequencia + 1) : NULL;
+    ok = ok && mesclagem.escritor && juntar_por_id(arquivo_a, arquivo_b, mesclar_evento, &mesclagem, NULL, NULL);
+
+    // Colisões de "b" sem par, em ordem de ID, com IDs novos
+    CursorDecisoes adiados;
+    memset(&adiados, 0, sizeof(adiados));
+    ok = ok && abrir_cursor_decisoes(&adiados, caminho_decisoes, gravacao.lado_a, total_decisoes - gravacao.lado_a);
+    const Decisao *d;
+    while (ok && mesclagem.ok && (d = proxima_decisao(&adiados, &mesclagem.ok)) != NULL) {
+        if (d->decisao == DECISAO_ADIAR) {
+            escrever(&mesclagem, &d->contato, ++maior_id, 0, d->id);
+        }
+    }
+    fechar_cursor_decisoes(&adiados);
+    fechar_cursor_decisoes(&mesclagem.decisoes_a);
+    fechar_cursor_decisoes(&mesclagem.decisoes_b);
+    remove(caminho_decisoes);
+
+    ok = ok && mesclagem.ok;
+    if (mesclagem.escritor) {
+        ok = fechar_escritor_blocos(mesclagem.escritor) && ok;
+    }
+    ok = ok && gravar_em_disco(fp);
+    if (fp) {
+        fclose(fp);
+    }
+    // Os atributos são publicados antes dos contatos, como em salvar_contatos
+    ok = ok && salvar_extensoes(mesclagem.extensoes, destino);
+    if (ok && rename(temporario, destino) != 0) {
+        fprintf(stderr, "Erro ao publicar arquivo: %s\n", destino);
+        ok = 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar arquivo mesclado: %s\n", destino);
+        remove(temporario);
+    } else if (!registrar_reinicio(destino, sequencia + 1)) {
+        fprintf(stderr, "Aviso: registro de alterações de %s não atualizado\n", destino);
+    }
+
+    liberar_extensoes(mesclagem.extensoes);
+    liberar_extensoes(extensoes_a);
+    liberar_extensoes(extensoes_b);
+    liberar_bloqueio(fd_bloqueio);
+    return ok;
+}
@@ -0,0 +1,35 @@
+#ifndef COMPARACAO_H
+#define COMPARACAO_H
+
+#include <stdio.h>
+#include "contato.h"
+
+// Comparação e mesclagem de dois arquivos de contatos (ex.: cópia da equipe de campo x central)
+// Junção por ID em uma passada sobre os dois arquivos, que já estão ordenados por ID,
+// lendo um bloco de cada por vez. Mesmo ID com outra pessoa (nenhum de email,
+// telefone ou nome coincide) é uma colisão; registros sem par por ID são então
+// casados pelo email normalizado com ordenações externas (ordenacao_externa.h),
+// então a memória fica limitada mesmo com muitas diferenças
+// As linhas + e - e os casados por email saem na ordem dos emails normalizados
+#define MEMORIA_COMPARACAO_PADRAO ((size_t)64 * 1024 * 1024)  // Dividida entre as ordenações
+typedef struct {
+    long iguais;
+    long alterados;          // Mesmo contato com campos diferentes (por ID ou por email)
+    long adicionados;        // Só no segundo arquivo
+    long removidos;          // Só no primeiro arquivo
+    long colisoes;           // Mesmo ID, contatos diferentes
+    long casados_por_email;  // IDs diferentes, mesmo email
+    long total_mesclado;
+} ResultadoComparacao;
+
+// Listar as diferenças de "a" para "b" (linhas +, - e ~); saida pode ser NULL (só contagens)
+// Retorna 1 em sucesso, 0 em erro
+int comparar_arquivos(const char *arquivo_a, const char *arquivo_b, FILE *saida, ResultadoComparacao *resultado);
+
+// Gravar em "destino" a união dos dois arquivos: nada é removido, a versão de "b"
+// prevalece nos contatos alterados e contatos de "b" com ID em colisão recebem IDs novos
+// Os atributos extras ("<arquivo>.ext") acompanham os contatos; num contato presente
+// nos dois, os de "b" prevalecem na mesma chave
+int mesclar_arquivos(const char *arquivo_a, const char *arquivo_b, const char *destino, ResultadoComparacao *resultado);
+
+#endif
@@ -1,9 +1,19 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "contato.h"
+#include "arquivo_blocos.h"
+#include "alteracoes.h"
+#include "utils/string_utils.h"
 
-#define CAPACIDADE_INICIAL 10
+#define DIRETORIO_INICIAL 4
+#define MAX_PALAVRAS_CONSULTA 8
+#define LIMITE_INDICES_PARALELOS 20000 // A partir daqui, cada índice é reconstruído em sua thread
+#define LIMITE_ATUALIZACAO_INCREMENTAL 1024 // Operações em lote: acima disso, os índices são reconstruídos
+#define MIN_EXCLUIDOS_COMPACTACAO TAMANHO_SEGMENTO // Excluídos tolerados entre salvamentos...
+#define FRACAO_EXCLUIDOS_COMPACTACAO 4      // ...ou até 1/4 dos registros, o que for maior
 #define ARQUIVO_DADOS "contatos.dat"
 
 // Criar lista vazia
@@ -13,259 +23,1739 @@ ListaContatos* criar_lista() {
         fprintf(stderr, "Erro ao alocar memória para a lista\n");
         return NULL;
     }
-    // Alocando memória inicial para contatos
-    lista->contatos = (Contato*)malloc(CAPACIDADE_INICIAL * sizeof(Contato));
-    if (!lista->contatos) {
-        fprintf(stderr, "Erro ao alocar memória para contatos\n");
+    lista->segmentos = NULL;
+    lista->num_segmentos = 0;
+    lista->capacidade_diretorio = 0;
+    lista->quantidade = 0; // Inicia com 0, indicando a lista vazia
+    lista->excluidos = 0;
+    lista->capacidade = 0;
+    lista->sequencia = 0;
+    lista->alteracoes = NULL;
+    lista->num_alteracoes = 0;
+    lista->capacidade_alteracoes = 0;
+    
+    // Alocando o primeiro segmento para contatos
+    if (!reservar_contatos(lista, 1)) {
+        free(lista);
+        return NULL;
+    }
+    
+    lista->indice_telefone = criar_indice_hash(0);
+    lista->indice_dominio = criar_indice_hash(0);
+    lista->indice_nomes = criar_arvore_bk();
+    lista->indice_prefixo = NULL;
+    lista->cache_consultas = NULL;
+    lista->filtro_unicidade = criar_filtro_bloom(0);
+    lista->extensoes = NULL;
+    lista->geracao = 0;
+    memset(&lista->assinatura, 0, sizeof(lista->assinatura));
+    if (!lista->indice_telefone || !lista->indice_dominio || !lista->indice_nomes || !lista->filtro_unicidade) {
+        liberar_lista(lista);
+        return NULL;
+    }
+    return lista;
+}
+
+// Liberar memória da lista
+void liberar_lista(ListaContatos *lista) {
+    if (lista) {
+        for (int i = 0; i < lista->num_segmentos; i++) {
+            free(lista->segmentos[i]);
+        }
+        free(lista->segmentos);
+        liberar_indice_hash(lista->indice_telefone);
+        liberar_indice_hash(lista->indice_dominio);
+        liberar_arvore_bk(lista->indice_nomes);
+        liberar_indice_prefixo(lista->indice_prefixo);
+        liberar_cache_consultas(lista->cache_consultas);
+        liberar_filtro_bloom(lista->filtro_unicidade);
+        liberar_extensoes(lista->extensoes);
+        free(lista->alteracoes);
         free(lista);
+    }
+}
+
+// Inserir (ou remover) cada palavra do nome normalizado no índice de nomes
+static void indexar_nome(ListaContatos *lista, const char *nome, int id, int inserir) {
+    char normalizado[MAX_NOME];
+    normalizar_nome(nome, normalizado, sizeof(normalizado));
+    
+    // Nome normalizado tem palavras separadas por exatamente um espaço
+    char *palavra = normalizado;
+    while (*palavra) {
+        char *espaco = strchr(palavra, ' ');
+        if (espaco) {
+            *espaco = '\0';
+        }
+        if (inserir) {
+            arvore_bk_inserir(lista->indice_nomes, palavra, id);
+        } else {
+            arvore_bk_remover(lista->indice_nomes, palavra, id);
+        }
+        if (!espaco) {
+            break;
+        }
+        palavra = espaco + 1;
+    }
+}
+
+// Inserir (ou remover) o telefone e o email normalizados no filtro de unicidade
+static void filtrar_contato(ListaContatos *lista, const Contato *contato, int inserir) {
+    char chave[MAX_EMAIL];
+    if (inserir) {
+        filtro_bloom_adicionar(lista->filtro_unicidade, normalizar_telefone(contato->telefone, chave, sizeof(chave)));
+        filtro_bloom_adicionar(lista->filtro_unicidade, normalizar_email(contato->email, chave, sizeof(chave)));
+    } else {
+        filtro_bloom_remover(lista->filtro_unicidade, normalizar_telefone(contato->telefone, chave, sizeof(chave)));
+        filtro_bloom_remover(lista->filtro_unicidade, normalizar_email(contato->email, chave, sizeof(chave)));
+    }
+}
+
+// Refazer o filtro com folga para o dobro dos contatos atuais (também função de
+// thread); sem memória, o filtro antigo fica, só com mais falsos positivos
+static void* indexar_unicidade(void *arg) {
+    ListaContatos *lista = (ListaContatos*)arg;
+    FiltroBloom *antigo = lista->filtro_unicidade;
+    lista->filtro_unicidade = criar_filtro_bloom(4L * lista->quantidade); // Até duas chaves por contato
+    if (!lista->filtro_unicidade) {
+        lista->filtro_unicidade = antigo;
+        return NULL;
+    }
+    liberar_filtro_bloom(antigo);
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (contato->ativo) {
+            filtrar_contato(lista, contato, 1);
+        }
+    }
+    return NULL;
+}
+
+// Depois de inserir: acima da capacidade planejada, os falsos positivos crescem rápido
+static void manter_capacidade_filtro(ListaContatos *lista) {
+    if (lista->filtro_unicidade && lista->filtro_unicidade->chaves > lista->filtro_unicidade->capacidade) {
+        indexar_unicidade(lista);
+    }
+}
+
+// Garantir capacidade para pelo menos 'quantidade' contatos
+// Só o diretório de ponteiros é realocado; os segmentos existentes não se movem
+int reservar_contatos(ListaContatos *lista, int quantidade) {
+    if (!lista) {
+        return 0;
+    }
+    
+    int necessarios = (quantidade + MASCARA_SEGMENTO) >> BITS_SEGMENTO;
+    if (necessarios > lista->capacidade_diretorio) {
+        int nova_capacidade = lista->capacidade_diretorio > 0 ? lista->capacidade_diretorio : DIRETORIO_INICIAL;
+        while (nova_capacidade < necessarios) {
+            nova_capacidade *= 2;
+        }
+        Contato **novo_diretorio = (Contato**)realloc(lista->segmentos, nova_capacidade * sizeof(Contato*));
+        if (!novo_diretorio) {
+            fprintf(stderr, "Erro ao expandir a lista de contatos\n");
+            return 0;
+        }
+        lista->segmentos = novo_diretorio;
+        lista->capacidade_diretorio = nova_capacidade;
+    }
+    
+    while (lista->num_segmentos < necessarios) {
+        Contato *segmento = (Contato*)malloc(TAMANHO_SEGMENTO * sizeof(Contato));
+        if (!segmento) {
+            fprintf(stderr, "Erro ao expandir a lista de contatos\n");
+            return 0;
+        }
+        lista->segmentos[lista->num_segmentos++] = segmento;
+        lista->capacidade += TAMANHO_SEGMENTO;
+    }
+    return 1;
+}
+
+// Liberar segmentos vazios no final, mantendo um de folga para não oscilar
+// entre alocar e liberar quando inclusões e exclusões se alternam na fronteira
+static void liberar_segmentos_livres(ListaContatos *lista) {
+    int usados = (lista->quantidade + MASCARA_SEGMENTO) >> BITS_SEGMENTO;
+    int manter = usados + 1;
+    while (lista->num_segmentos > manter) {
+        free(lista->segmentos[--lista->num_segmentos]);
+        lista->capacidade -= TAMANHO_SEGMENTO;
+    }
+}
+
+// Anotar uma alteração com a próxima sequência (gravada no registro ao salvar)
+// Sem memória, as pendentes viram um único reinício: quem sincroniza recarrega tudo
+static void registrar_alteracao(ListaContatos *lista, int tipo, const Contato *contato) {
+    if (lista->num_alteracoes >= lista->capacidade_alteracoes) {
+        int nova_capacidade = lista->capacidade_alteracoes > 0 ? lista->capacidade_alteracoes * 2 : 16;
+        RegistroAlteracao *novas = (RegistroAlteracao*)realloc(lista->alteracoes,
+                                                               nova_capacidade * sizeof(RegistroAlteracao));
+        if (!novas) {
+            fprintf(stderr, "Aviso: sem memória para o registro de alterações\n");
+            lista->num_alteracoes = 0;
+            if (lista->capacidade_alteracoes == 0) {
+                return;
+            }
+            tipo = ALTERACAO_REINICIO;
+            contato = NULL;
+        } else {
+            lista->alteracoes = novas;
+            lista->capacidade_alteracoes = nova_capacidade;
+        }
+    }
+    
+    RegistroAlteracao *registro = &lista->alteracoes[lista->num_alteracoes++];
+    memset(registro, 0, sizeof(RegistroAlteracao));
+    registro->sequencia = ++lista->sequencia;
+    registro->tipo = tipo;
+    if (contato) {
+        registro->id = contato->id;
+        if (tipo != ALTERACAO_EXCLUSAO) {
+            memcpy(registro->nome, contato->nome, MAX_NOME);
+            memcpy(registro->telefone, contato->telefone, MAX_TELEFONE);
+            memcpy(registro->email, contato->email, MAX_EMAIL);
+        }
+    }
+}
+
+// Levar ao índice de prefixos uma alteração que acabou de avançar a geração da
+// lista: sai o ID (se "remover") e entra o contato "novo" (se não for NULL)
+// Só um índice em dia até a alteração anterior é mantido; um atrasado, sem
+// memória ou com pendências demais é descartado e reconstruído na próxima consulta
+static void manter_indice_prefixo(ListaContatos *lista, int remover, const Contato *novo) {
+    IndicePrefixo *indice = lista->indice_prefixo;
+    if (!indice) {
+        return;
+    }
+    int ok = indice->geracao + 1 == lista->geracao;
+    if (ok && remover) {
+        ok = indice_prefixo_remover_id(indice, remover);
+    }
+    if (ok && novo) {
+        char nome[MAX_NOME];
+        char email[MAX_EMAIL];
+        ok = indice_prefixo_inserir(indice, novo->id, normalizar_nome(novo->nome, nome, sizeof(nome)),
+                                    normalizar_email(novo->email, email, sizeof(email)));
+    }
+    if (!ok || indice_prefixo_precisa_reconstruir(indice)) {
+        liberar_indice_prefixo(indice);
+        lista->indice_prefixo = NULL;
+        return;
+    }
+    indice->geracao = lista->geracao;
+}
+
+// Gerar próximo ID disponível
+// Os IDs são crescentes na lista, então o maior é o do último contato (O(1))
+static int gerar_id(ListaContatos *lista) {
+    return lista->quantidade > 0 ? CONTATO_EM(lista, lista->quantidade - 1)->id + 1 : 1;
+}
+
+// Adicionar novo contato
+int adicionar_contato(ListaContatos *lista, const char *nome, const char *telefone, const char *email) {
+    if (!lista || !nome || !telefone || !email) {
+        return -1;
+    }
+    
+    if (lista->quantidade >= lista->capacidade) {
+        if (!reservar_contatos(lista, lista->quantidade + 1)) {
+            return -1;
+        }
+    }
+    
+    Contato *novo = CONTATO_EM(lista, lista->quantidade);
+    novo->id = gerar_id(lista);
+    strncpy(novo->nome, nome, MAX_NOME - 1);
+    novo->nome[MAX_NOME - 1] = '\0';
+    strncpy(novo->telefone, telefone, MAX_TELEFONE - 1);
+    novo->telefone[MAX_TELEFONE - 1] = '\0';
+    strncpy(novo->email, email, MAX_EMAIL - 1);
+    novo->email[MAX_EMAIL - 1] = '\0';
+    novo->ativo = 1;
+    
+    char chave[MAX_EMAIL];
+    indice_inserir(lista->indice_telefone, normalizar_telefone(novo->telefone, chave, sizeof(chave)), novo->id);
+    indice_inserir(lista->indice_dominio, normalizar_dominio(novo->email, chave, sizeof(chave)), novo->id);
+    indexar_nome(lista, novo->nome, novo->id, 1);
+    filtrar_contato(lista, novo, 1);
+    registrar_alteracao(lista, ALTERACAO_ADICAO, novo);
+    
+    lista->quantidade++;
+    lista->geracao++;
+    manter_indice_prefixo(lista, 0, novo);
+    manter_capacidade_filtro(lista);
+    return novo->id;
+}
+
+// Posição do contato com o ID (busca binária), ativo ou não; -1 se não existe
+// Os IDs são sempre crescentes na lista: novos contatos recebem max_id + 1 e são
+// anexados ao final, e a compactação preserva a ordem relativa.
+int posicao_contato(ListaContatos *lista, int id) {
+    if (!lista) {
+        return -1;
+    }
+    
+    int inicio = 0;
+    int fim = lista->quantidade - 1;
+    while (inicio <= fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        int atual = CONTATO_EM(lista, meio)->id;
+        if (atual == id) {
+            return meio;
+        }
+        if (atual < id) {
+            inicio = meio + 1;
+        } else {
+            fim = meio - 1;
+        }
+    }
+    return -1;
+}
+
+// Buscar contato por ID (busca binária)
+Contato* buscar_contato_por_id(ListaContatos *lista, int id) {
+    if (!lista) {
+        printf("Erro ao buscar contato: lista inválida\n");
+        return NULL;
+    }
+    
+    int posicao = posicao_contato(lista, id);
+    if (posicao < 0 || !CONTATO_EM(lista, posicao)->ativo) {
+        return NULL;
+    }
+    return CONTATO_EM(lista, posicao);
+}
+
+// Trocar os campos informados (NULL ou vazio mantém o atual) e registrar a edição
+// Com indexar = 0 os índices não são tocados: quem chama os reconstrói no final
+static void aplicar_edicao(ListaContatos *lista, Contato *contato, const char *nome, const char *telefone,
+                           const char *email, int indexar) {
+    int id = contato->id;
+    if (indexar) {
+        filtrar_contato(lista, contato, 0);
+    }
+    if (nome && strlen(nome) > 0) { // Se o nome não for NULL ou vazio
+        if (indexar) {
+            indexar_nome(lista, contato->nome, id, 0);
+        }
+        strncpy(contato->nome, nome, MAX_NOME - 1);
+        contato->nome[MAX_NOME - 1] = '\0';
+        if (indexar) {
+            indexar_nome(lista, contato->nome, id, 1);
+        }
+    }
+    
+    if (telefone && strlen(telefone) > 0) { // Se o telefone não for NULL ou vazio
+        char chave[MAX_TELEFONE];
+        if (indexar) {
+            indice_remover(lista->indice_telefone, normalizar_telefone(contato->telefone, chave, sizeof(chave)), id);
+        }
+        strncpy(contato->telefone, telefone, MAX_TELEFONE - 1);
+        contato->telefone[MAX_TELEFONE - 1] = '\0';
+        if (indexar) {
+            indice_inserir(lista->indice_telefone, normalizar_telefone(contato->telefone, chave, sizeof(chave)), id);
+        }
+    }
+    
+    if (email && strlen(email) > 0) { // Se o email não for NULL ou vazio
+        char chave[MAX_EMAIL];
+        if (indexar) {
+            indice_remover(lista->indice_dominio, normalizar_dominio(contato->email, chave, sizeof(chave)), id);
+        }
+        strncpy(contato->email, email, MAX_EMAIL - 1);
+        contato->email[MAX_EMAIL - 1] = '\0';
+        if (indexar) {
+            indice_inserir(lista->indice_dominio, normalizar_dominio(contato->email, chave, sizeof(chave)), id);
+        }
+    }
+    
+    if (indexar) {
+        filtrar_contato(lista, contato, 1);
+    }
+    registrar_alteracao(lista, ALTERACAO_EDICAO, contato);
+}
+
+// Editar contato existente
+int editar_contato(ListaContatos *lista, int id, const char *nome, const char *telefone, const char *email) {
+    Contato *contato = buscar_contato_por_id(lista, id);
+    if (!contato) {
+        printf("Contato com ID %d não encontrado para edição.\n", id);
+        return 0;
+    }
+    
+    aplicar_edicao(lista, contato, nome, telefone, email, 1);
+    lista->geracao++;
+    manter_indice_prefixo(lista, id, contato);
+    return 1; // Edição bem sucedida, retornando o valor 1 para a função 'editar_contato'
+}
+
+// Tirar o contato de todos os índices mantidos a cada alteração
+static void desindexar_contato(ListaContatos *lista, const Contato *contato) {
+    char chave[MAX_EMAIL];
+    indice_remover(lista->indice_telefone,
+                   normalizar_telefone(contato->telefone, chave, sizeof(chave)), contato->id);
+    indice_remover(lista->indice_dominio,
+                   normalizar_dominio(contato->email, chave, sizeof(chave)), contato->id);
+    indexar_nome(lista, contato->nome, contato->id, 0);
+    filtrar_contato(lista, contato, 0);
+}
+
+// Excluir contato: o registro só é marcado (ativo = 0) e sai dos índices, sem
+// mover os seguintes; a remoção física fica para compactar_lista
+int excluir_contato(ListaContatos *lista, int id) {
+    if (!lista) {
+        return 0;
+    }
+    
+    // Encontrar índice do contato
+    int indice = posicao_contato(lista, id);
+    if (indice == -1 || !CONTATO_EM(lista, indice)->ativo) {
+        return 0;
+    }
+    
+    Contato *contato = CONTATO_EM(lista, indice);
+    desindexar_contato(lista, contato);
+    remover_extensoes_contato(lista->extensoes, contato->id);
+    registrar_alteracao(lista, ALTERACAO_EXCLUSAO, contato);
+    contato->ativo = 0;
+    lista->excluidos++;
+    
+    // Muitos excluídos deixam buscas e salvamentos percorrendo registros mortos
+    if (lista->excluidos > MIN_EXCLUIDOS_COMPACTACAO &&
+        lista->excluidos > lista->quantidade / FRACAO_EXCLUIDOS_COMPACTACAO) {
+        compactar_lista(lista);
+    }
+    
+    lista->geracao++;
+    manter_indice_prefixo(lista, id, NULL);
+    return 1;
+}
+
+// Gravar a imagem do contato no registro e devolvê-lo aos índices
+static void reativar_contato(ListaContatos *lista, Contato *novo, const Contato *contato) {
+    *novo = *contato;
+    novo->ativo = 1;
+    
+    char chave[MAX_EMAIL];
+    indice_inserir(lista->indice_telefone, normalizar_telefone(novo->telefone, chave, sizeof(chave)), novo->id);
+    indice_inserir(lista->indice_dominio, normalizar_dominio(novo->email, chave, sizeof(chave)), novo->id);
+    indexar_nome(lista, novo->nome, novo->id, 1);
+    filtrar_contato(lista, novo, 1);
+    registrar_alteracao(lista, ALTERACAO_ADICAO, novo);
+    
+    lista->geracao++;
+    manter_indice_prefixo(lista, novo->id, novo);
+    manter_capacidade_filtro(lista);
+}
+
+// Reinserir um contato com o ID que já tinha (desfazer exclusões)
+// Um excluído ainda não compactado é reativado no próprio registro; senão a ordem
+// por ID é mantida deslocando os contatos seguintes, segmento a segmento
+int restaurar_contato(ListaContatos *lista, const Contato *contato) {
+    if (!lista || !contato || contato->id <= 0) {
+        return 0;
+    }
+    int posicao = posicao_contato(lista, contato->id);
+    if (posicao != -1) {
+        if (CONTATO_EM(lista, posicao)->ativo) {
+            return 0;
+        }
+        lista->excluidos--;
+        reativar_contato(lista, CONTATO_EM(lista, posicao), contato);
+        return 1;
+    }
+    if (lista->quantidade >= lista->capacidade && !reservar_contatos(lista, lista->quantidade + 1)) {
+        return 0;
+    }
+    
+    // Primeira posição com ID maior (busca binária)
+    posicao = 0;
+    int fim = lista->quantidade;
+    while (posicao < fim) {
+        int meio = posicao + (fim - posicao) / 2;
+        if (CONTATO_EM(lista, meio)->id < contato->id) {
+            posicao = meio + 1;
+        } else {
+            fim = meio;
+        }
+    }
+    
+    // Abrir espaço: o último de cada segmento passa ao início do seguinte
+    for (int i = lista->quantidade; i > posicao; ) {
+        int inicio_segmento = i & ~MASCARA_SEGMENTO;
+        int primeiro = inicio_segmento > posicao ? inicio_segmento : posicao;
+        Contato *segmento = lista->segmentos[i >> BITS_SEGMENTO];
+        memmove(&segmento[(primeiro & MASCARA_SEGMENTO) + 1],
+                &segmento[primeiro & MASCARA_SEGMENTO],
+                (i - primeiro) * sizeof(Contato));
+        if (primeiro > posicao) {
+            segmento[0] = *CONTATO_EM(lista, primeiro - 1);
+        }
+        i = primeiro - 1;
+    }
+    
+    lista->quantidade++;
+    reativar_contato(lista, CONTATO_EM(lista, posicao), contato);
+    return 1;
+}
+
+// Cursor sobre a lista para podar_extensoes: os IDs chegam em ordem crescente
+typedef struct {
+    ListaContatos *lista;
+    int posicao;
+} CursorContatos;
+
+static int contato_presente(void *contexto, int id) {
+    CursorContatos *cursor = (CursorContatos*)contexto;
+    while (cursor->posicao < cursor->lista->quantidade && CONTATO_EM(cursor->lista, cursor->posicao)->id < id) {
+        cursor->posicao++;
+    }
+    return cursor->posicao < cursor->lista->quantidade && CONTATO_EM(cursor->lista, cursor->posicao)->id == id &&
+           CONTATO_EM(cursor->lista, cursor->posicao)->ativo;
+}
+
+// Descartar os atributos de contatos que saíram da lista (um ID reaproveitado
+// não pode herdá-los)
+static void podar_atributos(ListaContatos *lista) {
+    if (lista->extensoes) {
+        CursorContatos cursor = { lista, 0 };
+        podar_extensoes(lista->extensoes, contato_presente, &cursor);
+    }
+}
+
+// Remover fisicamente todos os contatos inativos (ativo = 0) em uma única passada
+// Usa dois ponteiros (leitura/escrita) em vez de um memmove por remoção
+// Os excluídos já saíram dos índices e do registro de alterações em
+// excluir_contato, e os índices guardam IDs: nada precisa ser refeito, e a
+// geração não muda (o conteúdo visível é o mesmo)
+int compactar_lista(ListaContatos *lista) {
+    if (!lista || lista->excluidos == 0) {
+        return 0;
+    }
+    
+    int escrita = 0;
+    for (int leitura = 0; leitura < lista->quantidade; leitura++) {
+        Contato *contato = CONTATO_EM(lista, leitura);
+        if (!contato->ativo) {
+            continue;
+        }
+        if (escrita != leitura) {
+            *CONTATO_EM(lista, escrita) = *contato;
+        }
+        escrita++;
+    }
+    
+    int removidos = lista->quantidade - escrita;
+    lista->quantidade = escrita;
+    lista->excluidos = 0;
+    liberar_segmentos_livres(lista);
+    return removidos;
+}
+
+// Interpretar "campo:valor"; o valor é guardado já normalizado como o campo
+int analisar_criterio(const char *texto, CriterioContatos *criterio) {
+    if (!texto || !criterio) {
+        return 0;
+    }
+    const char *dois_pontos = strchr(texto, ':');
+    if (!dois_pontos) {
+        return 0;
+    }
+    char campo[16];
+    size_t tamanho = (size_t)(dois_pontos - texto);
+    if (tamanho == 0 || tamanho >= sizeof(campo)) {
+        return 0;
+    }
+    memcpy(campo, texto, tamanho);
+    campo[tamanho] = '\0';
+    const char *valor = dois_pontos + 1;
+    
+    if (strcmp(campo, "nome") == 0) {
+        criterio->campo = CRITERIO_NOME;
+        normalizar_nome(valor, criterio->valor, sizeof(criterio->valor));
+    } else if (strcmp(campo, "telefone") == 0) {
+        criterio->campo = CRITERIO_TELEFONE;
+        normalizar_telefone(valor, criterio->valor, sizeof(criterio->valor));
+    } else if (strcmp(campo, "email") == 0) {
+        criterio->campo = CRITERIO_EMAIL;
+        normalizar_email(valor, criterio->valor, sizeof(criterio->valor));
+    } else if (strcmp(campo, "dominio") == 0) {
+        criterio->campo = CRITERIO_DOMINIO;
+        normalizar_email(valor[0] == '@' ? valor + 1 : valor, criterio->valor, sizeof(criterio->valor));
+    } else {
+        return 0;
+    }
+    // Valor vazio escolheria todos os contatos: exigido explicitamente em outro lugar
+    return criterio->valor[0] != '\0';
+}
+
+int contato_atende_criterio(const Contato *contato, const CriterioContatos *criterio) {
+    char campo[MAX_EMAIL];
+    switch (criterio->campo) {
+        case CRITERIO_NOME:
+            return strstr(normalizar_nome(contato->nome, campo, sizeof(campo)), criterio->valor) != NULL;
+        case CRITERIO_TELEFONE:
+            return strstr(normalizar_telefone(contato->telefone, campo, sizeof(campo)), criterio->valor) != NULL;
+        case CRITERIO_EMAIL:
+            return strstr(normalizar_email(contato->email, campo, sizeof(campo)), criterio->valor) != NULL;
+        case CRITERIO_DOMINIO:
+            return strcmp(normalizar_dominio(contato->email, campo, sizeof(campo)), criterio->valor) == 0;
+        default:
+            return 0;
+    }
+}
+
+int contar_onde(ListaContatos *lista, const CriterioContatos *criterio) {
+    if (!lista || !criterio) {
+        return 0;
+    }
+    int quantidade = 0;
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (contato->ativo && contato_atende_criterio(contato, criterio)) {
+            quantidade++;
+        }
+    }
+    return quantidade;
+}
+
+// Uma passada com dois ponteiros (leitura/escrita), como compactar_lista: os
+// contatos que ficam são copiados uma vez para a posição final, e os excluídos
+// antes ainda na lista saem junto
+int excluir_onde(ListaContatos *lista, const CriterioContatos *criterio) {
+    if (!lista || !criterio) {
+        return -1;
+    }
+    
+    int escrita = 0;
+    int removidos = 0;
+    for (int leitura = 0; leitura < lista->quantidade; leitura++) {
+        Contato *contato = CONTATO_EM(lista, leitura);
+        if (!contato->ativo) {
+            continue;
+        }
+        if (contato_atende_criterio(contato, criterio)) {
+            // Muitas remoções: mais barato reconstruir os índices no final
+            if (removidos < LIMITE_ATUALIZACAO_INCREMENTAL) {
+                desindexar_contato(lista, contato);
+            }
+            registrar_alteracao(lista, ALTERACAO_EXCLUSAO, contato);
+            removidos++;
+            continue;
+        }
+        if (escrita != leitura) {
+            *CONTATO_EM(lista, escrita) = *contato;
+        }
+        escrita++;
+    }
+    
+    lista->quantidade = escrita;
+    lista->excluidos = 0;
+    liberar_segmentos_livres(lista);
+    if (removidos == 0) {
+        return 0;
+    }
+    lista->geracao++;
+    podar_atributos(lista);
+    if (removidos > LIMITE_ATUALIZACAO_INCREMENTAL) {
+        reconstruir_indices(lista);
+    }
+    return removidos;
+}
+
+// Mesma regra de editar_contato: campos NULL ou vazios ficam como estão
+int editar_onde(ListaContatos *lista, const CriterioContatos *criterio,
+                const char *nome, const char *telefone, const char *email) {
+    if (!lista || !criterio) {
+        return -1;
+    }
+    
+    int editados = 0;
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (contato->ativo && contato_atende_criterio(contato, criterio)) {
+            aplicar_edicao(lista, contato, nome, telefone, email, editados < LIMITE_ATUALIZACAO_INCREMENTAL);
+            editados++;
+        }
+    }
+    
+    if (editados == 0) {
+        return 0;
+    }
+    lista->geracao++;
+    if (editados > LIMITE_ATUALIZACAO_INCREMENTAL) {
+        reconstruir_indices(lista);
+    }
+    return editados;
+}
+
+// Listar todos os contatos ativos
+void listar_contatos(ListaContatos *lista) {
+    if (!lista || lista->quantidade == 0) {
+        printf("Nenhum contato cadastrado.\n");
+        return;
+    }
+    
+    int count = 0;
+    printf("\n%-5s %-30s %-20s %-30s\n", "ID", "Nome", "Telefone", "Email");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (contato->ativo) {
+            printf("%-5d %-30s %-20s %-30s\n",
+                   contato->id,
+                   contato->nome,
+                   contato->telefone,
+                   contato->email);
+            count++;
+        }
+    }
+    
+    if (count == 0) {
+        printf("Nenhum contato ativo encontrado.\n");
+    } else {
+        printf("\nTotal: %d contato(s)\n", count);
+    }
+}
+
+// Varredura de buscar_contatos, guardada no cache com a geração atual da lista
+int buscar_ids_contatos(ListaContatos *lista, const char *termo, int **ids) {
+    if (!lista || !termo || !ids) {
+        return -1;
+    }
+    *ids = NULL;
+    if (!lista->cache_consultas) {
+        lista->cache_consultas = criar_cache_consultas(0);
+    }
+    
+    int quantidade = 0;
+    const int *guardados = cache_consultar(lista->cache_consultas, termo, lista->geracao, &quantidade);
+    if (guardados) {
+        *ids = (int*)malloc((size_t)(quantidade > 0 ? quantidade : 1) * sizeof(int));
+        if (!*ids) {
+            return -1;
+        }
+        memcpy(*ids, guardados, (size_t)quantidade * sizeof(int));
+        return quantidade;
+    }
+    
+    int capacidade = 16;
+    int *encontrados = (int*)malloc(capacidade * sizeof(int));
+    if (!encontrados) {
+        fprintf(stderr, "Erro ao alocar memória para a busca\n");
+        return -1;
+    }
+    // Atributos também estão em ordem de ID: um cursor anda junto com os contatos
+    const ExtensoesContatos *extensoes = lista->extensoes;
+    int atributo = 0;
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        int em_atributo = 0;
+        while (extensoes && atributo < extensoes->quantidade && extensoes->atributos[atributo].id <= contato->id) {
+            const AtributoExtensao *atual = &extensoes->atributos[atributo++];
+            if (atual->id == contato->id && strstr(VALOR_EXTENSAO(extensoes, atual), termo)) {
+                em_atributo = 1;
+            }
+        }
+        if (contato->ativo &&
+            (strstr(contato->nome, termo) ||
+             strstr(contato->telefone, termo) ||
+             strstr(contato->email, termo) ||
+             em_atributo)) {
+            if (quantidade == capacidade) {
+                capacidade *= 2;
+                int *maior = (int*)realloc(encontrados, capacidade * sizeof(int));
+                if (!maior) {
+                    fprintf(stderr, "Erro ao alocar memória para a busca\n");
+                    free(encontrados);
+                    return -1;
+                }
+                encontrados = maior;
+            }
+            encontrados[quantidade++] = contato->id;
+        }
+    }
+    
+    cache_guardar(lista->cache_consultas, termo, lista->geracao, encontrados, quantidade);
+    *ids = encontrados;
+    return quantidade;
+}
+
+// Buscar contatos por termo (nome, telefone, email ou atributos)
+void buscar_contatos(ListaContatos *lista, const char *termo) {
+    int *ids = NULL;
+    int count = buscar_ids_contatos(lista, termo, &ids);
+    if (count < 0) {
+        printf("Nenhum contato encontrado.\n");
+        return;
+    }
+    
+    printf("\n%-5s %-30s %-20s %-30s\n", "ID", "Nome", "Telefone", "Email");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < count; i++) {
+        Contato *contato = buscar_contato_por_id(lista, ids[i]);
+        printf("%-5d %-30s %-20s %-30s\n",
+               contato->id,
+               contato->nome,
+               contato->telefone,
+               contato->email);
+    }
+    free(ids);
+    
+    if (count == 0) {
+        printf("Nenhum contato encontrado com o termo '%s'.\n", termo);
+    } else {
+        printf("\nTotal: %d contato(s) encontrado(s)\n", count);
+    }
+}
+
+// Atributos opcionais: só contatos existentes; a geração muda porque a busca por
+// termo (e o cache dela) olha também os atributos, e quem espelha pelo registro
+// de alterações é avisado. Definir o valor que já está não conta como alteração
+int definir_atributo(ListaContatos *lista, int id, const char *chave, const char *valor) {
+    Contato *contato = lista ? buscar_contato_por_id(lista, id) : NULL;
+    char nome_chave[MAX_CHAVE_EXTENSAO];
+    if (!contato || !normalizar_chave_extensao(chave, nome_chave, sizeof(nome_chave))) {
+        return 0;
+    }
+    const char *atual = obter_extensao(lista->extensoes, id, chave);
+    if (strcmp(atual ? atual : "", valor ? valor : "") == 0) {
+        return 1;
+    }
+    if (!lista->extensoes) {
+        lista->extensoes = criar_extensoes();
+        if (!lista->extensoes) {
+            return 0;
+        }
+    }
+    if (!definir_extensao(lista->extensoes, id, chave, valor)) {
+        return 0;
+    }
+    registrar_alteracao(lista, ALTERACAO_ATRIBUTO, contato);
+    lista->geracao++;
+    return 1;
+}
+
+const char* obter_atributo(ListaContatos *lista, int id, const char *chave) {
+    return lista ? obter_extensao(lista->extensoes, id, chave) : NULL;
+}
+
+void listar_atributos(ListaContatos *lista, int id) {
+    if (!lista) {
+        return;
+    }
+    int inicio = 0;
+    int quantidade = faixa_extensoes(lista->extensoes, id, &inicio);
+    if (quantidade == 0) {
+        printf("Nenhum atributo extra.\n");
+        return;
+    }
+    const ExtensoesContatos *extensoes = lista->extensoes;
+    for (int i = inicio; i < inicio + quantidade; i++) {
+        const AtributoExtensao *atributo = &extensoes->atributos[i];
+        printf("  %-20s %s\n", extensoes->nomes_chaves[atributo->chave], VALOR_EXTENSAO(extensoes, atributo));
+    }
+}
+
+void buscar_por_atributo(ListaContatos *lista, const char *chave, const char *trecho) {
+    if (!lista || !chave) {
+        return;
+    }
+    char nome_chave[MAX_CHAVE_EXTENSAO];
+    if (!normalizar_chave_extensao(chave, nome_chave, sizeof(nome_chave))) {
+        printf("Nome de atributo inválido: '%s'\n", chave);
+        return;
+    }
+    const ExtensoesContatos *extensoes = lista->extensoes;
+    int indice = indice_chave_extensao(extensoes, nome_chave);
+    if (indice < 0 || extensoes->usos[indice] == 0) {
+        printf("Nenhum contato tem o atributo '%s'.\n", nome_chave);
+        return;
+    }
+    
+    char procurado[MAX_VALOR_EXTENSAO];
+    char valor[MAX_VALOR_EXTENSAO];
+    normalizar_nome(trecho ? trecho : "", procurado, sizeof(procurado));
+    
+    printf("\n%-5s %-30s %-20s %-30s\n", "ID", "Nome", "Telefone", nome_chave);
+    printf("--------------------------------------------------------------------------------\n");
+    int count = 0;
+    for (int i = 0; i < extensoes->quantidade; i++) {
+        const AtributoExtensao *atributo = &extensoes->atributos[i];
+        if (atributo->chave != indice ||
+            !strstr(normalizar_nome(VALOR_EXTENSAO(extensoes, atributo), valor, sizeof(valor)), procurado)) {
+            continue;
+        }
+        Contato *contato = buscar_contato_por_id(lista, atributo->id);
+        if (contato && contato->ativo) {
+            printf("%-5d %-30s %-20s %-30s\n",
+                   contato->id,
+                   contato->nome,
+                   contato->telefone,
+                   VALOR_EXTENSAO(extensoes, atributo));
+            count++;
+        }
+    }
+    
+    if (count == 0) {
+        printf("Nenhum contato com %s contendo '%s'.\n", nome_chave, trecho ? trecho : "");
+    } else {
+        printf("\nTotal: %d contato(s) encontrado(s)\n", count);
+    }
+}
+
+// Preencher cada índice a partir dos contatos (funções de thread: recebem a lista)
+static void* indexar_telefones(void *arg) {
+    ListaContatos *lista = (ListaContatos*)arg;
+    char chave[MAX_TELEFONE];
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (contato->ativo) {
+            indice_inserir(lista->indice_telefone,
+                           normalizar_telefone(contato->telefone, chave, sizeof(chave)),
+                           contato->id);
+        }
+    }
+    return NULL;
+}
+
+static void* indexar_dominios(void *arg) {
+    ListaContatos *lista = (ListaContatos*)arg;
+    char chave[MAX_EMAIL];
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (contato->ativo) {
+            indice_inserir(lista->indice_dominio,
+                           normalizar_dominio(contato->email, chave, sizeof(chave)),
+                           contato->id);
+        }
+    }
+    return NULL;
+}
+
+static void* indexar_nomes(void *arg) {
+    ListaContatos *lista = (ListaContatos*)arg;
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (contato->ativo) {
+            indexar_nome(lista, contato->nome, contato->id, 1);
+        }
+    }
+    return NULL;
+}
+
+// Reconstruir índices a partir do array de contatos; o filtro de unicidade pode
+// ter vindo pronto do disco (carga) e então não é refeito
+static int montar_indices(ListaContatos *lista, int refazer_filtro) {
+    if (!lista) {
+        return 0;
+    }
+    
+    if (!lista->indice_telefone) {
+        // Dimensionar os baldes para a quantidade carregada evita rehash
+        lista->indice_telefone = criar_indice_hash(lista->quantidade > 0 ? (size_t)lista->quantidade : 0);
+        if (!lista->indice_telefone) {
+            return 0;
+        }
+    } else {
+        limpar_indice_hash(lista->indice_telefone);
+    }
+    
+    if (!lista->indice_dominio) {
+        lista->indice_dominio = criar_indice_hash(0); // Poucos domínios distintos
+        if (!lista->indice_dominio) {
+            return 0;
+        }
+    } else {
+        limpar_indice_hash(lista->indice_dominio);
+    }
+    
+    if (!lista->indice_nomes) {
+        lista->indice_nomes = criar_arvore_bk();
+        if (!lista->indice_nomes) {
+            return 0;
+        }
+    } else {
+        limpar_arvore_bk(lista->indice_nomes);
+    }
+    
+    // Os índices são independentes: em listas grandes, telefone, domínio e filtro
+    // são preenchidos em threads próprias enquanto esta thread monta os nomes
+    pthread_t threads[3];
+    int criadas = 0;
+    if (lista->quantidade >= LIMITE_INDICES_PARALELOS) {
+        if (pthread_create(&threads[criadas], NULL, indexar_telefones, lista) == 0) {
+            criadas++;
+        } else {
+            indexar_telefones(lista);
+        }
+        if (pthread_create(&threads[criadas], NULL, indexar_dominios, lista) == 0) {
+            criadas++;
+        } else {
+            indexar_dominios(lista);
+        }
+        if (refazer_filtro) {
+            if (pthread_create(&threads[criadas], NULL, indexar_unicidade, lista) == 0) {
+                criadas++;
+            } else {
+                indexar_unicidade(lista);
+            }
+        }
+    } else {
+        indexar_telefones(lista);
+        indexar_dominios(lista);
+        if (refazer_filtro) {
+            indexar_unicidade(lista);
+        }
+    }
+    indexar_nomes(lista);
+    
+    for (int i = 0; i < criadas; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return 1;
+}
+
+int reconstruir_indices(ListaContatos *lista) {
+    return montar_indices(lista, 1);
+}
+
+// Confirmar um email pelo índice de domínios: só os contatos do mesmo domínio
+static int buscar_email(ListaContatos *lista, const char *email) {
+    char chave[MAX_EMAIL];
+    EntradaIndice *entrada = indice_buscar(lista->indice_dominio, normalizar_dominio(email, chave, sizeof(chave)));
+    for (int i = 0; entrada && i < entrada->quantidade; i++) {
+        Contato *contato = buscar_contato_por_id(lista, entrada->ids[i]);
+        if (contato && strcmp(normalizar_email(contato->email, chave, sizeof(chave)), email) == 0) {
+            return contato->id;
+        }
+    }
+    return 0;
+}
+
+int buscar_duplicado(ListaContatos *lista, const char *telefone, const char *email) {
+    if (!lista) {
+        return 0;
+    }
+    FiltroBloom *filtro = lista->filtro_unicidade;
+    char chave[MAX_EMAIL];
+    
+    // Sem filtro (falta de memória ao refazê-lo), toda chave é confirmada nos índices
+    if (telefone && normalizar_telefone(telefone, chave, sizeof(chave))[0] &&
+        (!filtro || filtro_bloom_contem(filtro, chave))) {
+        EntradaIndice *entrada = indice_buscar(lista->indice_telefone, chave);
+        if (entrada && entrada->quantidade > 0) {
+            return entrada->ids[0];
+        }
+        if (filtro) {
+            filtro->falsos_positivos++;
+        }
+    }
+    if (email && normalizar_email(email, chave, sizeof(chave))[0] &&
+        (!filtro || filtro_bloom_contem(filtro, chave))) {
+        int id = buscar_email(lista, chave);
+        if (id > 0) {
+            return id;
+        }
+        if (filtro) {
+            filtro->falsos_positivos++;
+        }
+    }
+    return 0;
+}
+
+int adicionar_contato_unico(ListaContatos *lista, const char *nome, const char *telefone, const char *email,
+                            int *existente) {
+    int id = buscar_duplicado(lista, telefone, email);
+    if (existente) {
+        *existente = id;
+    }
+    if (id > 0) {
+        return 0;
+    }
+    return adicionar_contato(lista, nome, telefone, email);
+}
+
+// Buscar primeiro contato com o telefone informado (busca reversa O(1) pelo índice)
+Contato* buscar_contato_por_telefone(ListaContatos *lista, const char *telefone) {
+    if (!lista || !telefone) {
+        return NULL;
+    }
+    
+    char chave[MAX_TELEFONE];
+    EntradaIndice *entrada = indice_buscar(lista->indice_telefone,
+                                           normalizar_telefone(telefone, chave, sizeof(chave)));
+    if (!entrada || entrada->quantidade == 0) {
+        return NULL;
+    }
+    return buscar_contato_por_id(lista, entrada->ids[0]);
+}
+
+// Buscar e exibir todos os contatos com o telefone informado (qualquer formatação)
+void buscar_por_telefone(ListaContatos *lista, const char *telefone) {
+    if (!lista || !telefone) {
+        printf("Nenhum contato encontrado.\n");
+        return;
+    }
+    
+    char chave[MAX_TELEFONE];
+    normalizar_telefone(telefone, chave, sizeof(chave));
+    EntradaIndice *entrada = indice_buscar(lista->indice_telefone, chave);
+    
+    int count = 0;
+    printf("\n%-5s %-30s %-20s %-30s\n", "ID", "Nome", "Telefone", "Email");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; entrada && i < entrada->quantidade; i++) {
+        Contato *contato = buscar_contato_por_id(lista, entrada->ids[i]);
+        if (contato) {
+            printf("%-5d %-30s %-20s %-30s\n",
+                   contato->id, contato->nome, contato->telefone, contato->email);
+            count++;
+        }
+    }
+    
+    if (count == 0) {
+        printf("Nenhum contato encontrado com o telefone '%s'.\n", telefone);
+    } else {
+        printf("\nTotal: %d contato(s) encontrado(s)\n", count);
+    }
+}
+
+// Buscar e exibir todos os contatos de um domínio ("cliente.com" ou "@cliente.com")
+void buscar_por_dominio(ListaContatos *lista, const char *dominio) {
+    if (!lista || !dominio) {
+        printf("Nenhum contato encontrado.\n");
+        return;
+    }
+    
+    // Aceitar o domínio com ou sem '@' reaproveitando a normalização do email
+    char email[MAX_EMAIL];
+    char chave[MAX_EMAIL];
+    snprintf(email, sizeof(email), "%s%s", strchr(dominio, '@') ? "" : "@", dominio);
+    EntradaIndice *entrada = indice_buscar(lista->indice_dominio,
+                                           normalizar_dominio(email, chave, sizeof(chave)));
+    
+    int count = 0;
+    printf("\n%-5s %-30s %-20s %-30s\n", "ID", "Nome", "Telefone", "Email");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; entrada && i < entrada->quantidade; i++) {
+        Contato *contato = buscar_contato_por_id(lista, entrada->ids[i]);
+        if (contato) {
+            printf("%-5d %-30s %-20s %-30s\n",
+                   contato->id, contato->nome, contato->telefone, contato->email);
+            count++;
+        }
+    }
+    
+    if (count == 0) {
+        printf("Nenhum contato encontrado no domínio '%s'.\n", chave);
+    } else {
+        printf("\nTotal: %d contato(s) encontrado(s)\n", count);
+    }
+}
+
+// Ocorrência de uma palavra da consulta em um contato
+typedef struct {
+    int id;
+    int palavra;   // Índice da palavra na consulta
+    int distancia;
+} OcorrenciaAproximada;
+
+// Acumulador das ocorrências encontradas na árvore BK
+typedef struct {
+    OcorrenciaAproximada *itens;
+    int quantidade;
+    int capacidade;
+    int palavra_atual;
+} ColetorAproximado;
+
+static void coletar_ocorrencias(const NoBK *no, int distancia, void *contexto) {
+    ColetorAproximado *coletor = (ColetorAproximado*)contexto;
+    
+    if (coletor->quantidade + no->quantidade > coletor->capacidade) {
+        int nova_capacidade = coletor->capacidade * 2;
+        while (nova_capacidade < coletor->quantidade + no->quantidade) {
+            nova_capacidade *= 2;
+        }
+        OcorrenciaAproximada *novos = (OcorrenciaAproximada*)realloc(
+            coletor->itens, nova_capacidade * sizeof(OcorrenciaAproximada));
+        if (!novos) {
+            return;
+        }
+        coletor->itens = novos;
+        coletor->capacidade = nova_capacidade;
+    }
+    
+    for (int i = 0; i < no->quantidade; i++) {
+        OcorrenciaAproximada *item = &coletor->itens[coletor->quantidade++];
+        item->id = no->ids[i];
+        item->palavra = coletor->palavra_atual;
+        item->distancia = distancia;
+    }
+}
+
+static int comparar_ocorrencias(const void *a, const void *b) {
+    const OcorrenciaAproximada *oa = (const OcorrenciaAproximada*)a;
+    const OcorrenciaAproximada *ob = (const OcorrenciaAproximada*)b;
+    if (oa->id != ob->id) return oa->id - ob->id;
+    if (oa->palavra != ob->palavra) return oa->palavra - ob->palavra;
+    return oa->distancia - ob->distancia;
+}
+
+static int comparar_resultados_aproximados(const void *a, const void *b) {
+    const OcorrenciaAproximada *oa = (const OcorrenciaAproximada*)a;
+    const OcorrenciaAproximada *ob = (const OcorrenciaAproximada*)b;
+    if (oa->distancia != ob->distancia) return oa->distancia - ob->distancia;
+    return oa->id - ob->id;
+}
+
+// Busca tolerante a erros de digitação: cada palavra da consulta deve estar a até
+// distancia_maxima edições de alguma palavra do nome. Resultados ordenados pela
+// soma das distâncias. Usa a árvore BK para não calcular a distância contra todos.
+void buscar_aproximado(ListaContatos *lista, const char *consulta, int distancia_maxima) {
+    if (!lista || !consulta || !lista->indice_nomes) {
+        printf("Nenhum contato encontrado.\n");
+        return;
+    }
+    
+    char normalizada[MAX_NOME];
+    normalizar_nome(consulta, normalizada, sizeof(normalizada));
+    
+    ColetorAproximado coletor = {NULL, 0, 64, 0};
+    coletor.itens = (OcorrenciaAproximada*)malloc(coletor.capacidade * sizeof(OcorrenciaAproximada));
+    if (!coletor.itens) {
+        fprintf(stderr, "Erro ao alocar memória para a busca\n");
+        return;
+    }
+    
+    int num_palavras = 0;
+    int calculos = 0;
+    char *palavra = normalizada;
+    while (*palavra && num_palavras < MAX_PALAVRAS_CONSULTA) {
+        char *espaco = strchr(palavra, ' ');
+        if (espaco) {
+            *espaco = '\0';
+        }
+        coletor.palavra_atual = num_palavras++;
+        calculos += arvore_bk_buscar(lista->indice_nomes, palavra, distancia_maxima,
+                                     coletar_ocorrencias, &coletor);
+        if (!espaco) {
+            break;
+        }
+        palavra = espaco + 1;
+    }
+    
+    // Agrupar por contato: menor distância de cada palavra, todas precisam aparecer
+    qsort(coletor.itens, coletor.quantidade, sizeof(OcorrenciaAproximada), comparar_ocorrencias);
+    int resultados = 0;
+    for (int i = 0; i < coletor.quantidade; ) {
+        int id = coletor.itens[i].id;
+        int palavras = 0;
+        int total = 0;
+        while (i < coletor.quantidade && coletor.itens[i].id == id) {
+            int palavra = coletor.itens[i].palavra;
+            palavras++;
+            total += coletor.itens[i].distancia; // Primeira ocorrência é a de menor distância
+            while (i < coletor.quantidade && coletor.itens[i].id == id && coletor.itens[i].palavra == palavra) {
+                i++;
+            }
+        }
+        if (palavras == num_palavras) {
+            coletor.itens[resultados].id = id;
+            coletor.itens[resultados].distancia = total;
+            resultados++;
+        }
+    }
+    qsort(coletor.itens, resultados, sizeof(OcorrenciaAproximada), comparar_resultados_aproximados);
+    
+    int count = 0;
+    printf("\n%-5s %-5s %-30s %-20s %-30s\n", "Dist", "ID", "Nome", "Telefone", "Email");
+    printf("--------------------------------------------------------------------------------------\n");
+    for (int i = 0; i < resultados; i++) {
+        Contato *contato = buscar_contato_por_id(lista, coletor.itens[i].id);
+        if (contato) {
+            printf("%-5d %-5d %-30s %-20s %-30s\n", coletor.itens[i].distancia,
+                   contato->id, contato->nome, contato->telefone, contato->email);
+            count++;
+        }
+    }
+    
+    if (count == 0) {
+        printf("Nenhum contato encontrado próximo de '%s'.\n", consulta);
+    } else {
+        printf("\nTotal: %d contato(s) encontrado(s) (%d comparações no índice)\n", count, calculos);
+    }
+    
+    free(coletor.itens);
+}
+
+// Construir o índice de prefixos: uma entrada por palavra do nome e uma pelo email
+// Cada palavra aponta para o meio do nome normalizado, então "sil" encontra "ana silva"
+static IndicePrefixo* construir_indice_prefixo(ListaContatos *lista) {
+    char nome[MAX_NOME];
+    char email[MAX_EMAIL];
+    
+    // Primeira passada: dimensionar entradas e área de chaves
+    int num_entradas = 0;
+    size_t tamanho_area = 0;
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (!contato->ativo) {
+            continue;
+        }
+        normalizar_nome(contato->nome, nome, sizeof(nome));
+        normalizar_email(contato->email, email, sizeof(email));
+        tamanho_area += strlen(nome) + strlen(email) + 2;
+        num_entradas += 2;
+        for (const char *p = nome; *p; p++) {
+            num_entradas += *p == ' ';
+        }
+    }
+    
+    IndicePrefixo *indice = criar_indice_prefixo(num_entradas, tamanho_area);
+    if (!indice) {
         return NULL;
     }
     
-    lista->quantidade = 0; // Inicia com 0, indicando a lista vazia
-    lista->capacidade = CAPACIDADE_INICIAL; // Define a capacidade inicial da lista
-    return lista;
+    // Segunda passada: guardar chaves e apontar as entradas
+    for (int i = 0; i < lista->quantidade; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (!contato->ativo) {
+            continue;
+        }
+        int id = contato->id;
+        
+        const char *chave = indice_prefixo_guardar(indice, normalizar_nome(contato->nome, nome, sizeof(nome)));
+        indice_prefixo_adicionar(indice, chave, id);
+        for (const char *p = chave; *p; p++) {
+            if (*p == ' ') {
+                indice_prefixo_adicionar(indice, p + 1, id);
+            }
+        }
+        
+        chave = indice_prefixo_guardar(indice, normalizar_email(contato->email, email, sizeof(email)));
+        indice_prefixo_adicionar(indice, chave, id);
+    }
+    
+    indice_prefixo_ordenar(indice);
+    indice->geracao = lista->geracao;
+    return indice;
 }
 
-// Liberar memória da lista
-void liberar_lista(ListaContatos *lista) {
-    if (lista) {
-        if (lista->contatos) {
-            free(lista->contatos);
+// Reconstruir o índice de prefixos se a lista mudou sem passar pela manutenção
+// incremental (alterações em lote, recarga) desde a última construção
+static int atualizar_indice_prefixo(ListaContatos *lista) {
+    if (!lista->indice_prefixo || lista->indice_prefixo->geracao != lista->geracao) {
+        liberar_indice_prefixo(lista->indice_prefixo);
+        lista->indice_prefixo = construir_indice_prefixo(lista);
+        if (!lista->indice_prefixo) {
+            return 0;
         }
-        free(lista);
     }
+    return 1;
 }
 
-// Expandir capacidade da lista quando necessário
-static int expandir_lista(ListaContatos *lista) {
-    int nova_capacidade = lista->capacidade * 2;
-    Contato *novos_contatos = (Contato*)realloc(lista->contatos, nova_capacidade * sizeof(Contato));
+// Sugerir contatos cujo nome (qualquer palavra) ou email começa com o prefixo
+// Adições, edições e exclusões atualizam o índice; ele só é reconstruído depois
+// de alterações em lote ou de pendências demais
+int sugerir_contatos(ListaContatos *lista, const char *prefixo, int *ids, int max) {
+    if (!lista || !prefixo) {
+        return 0;
+    }
     
-    if (!novos_contatos) {
-        fprintf(stderr, "Erro ao expandir a lista de contatos\n");
+    if (!atualizar_indice_prefixo(lista)) {
         return 0;
     }
     
-    lista->contatos = novos_contatos;
-    lista->capacidade = nova_capacidade;
-    return 1;
+    char normalizado[MAX_NOME];
+    normalizar_nome(prefixo, normalizado, sizeof(normalizado));
+    return indice_prefixo_sugerir(lista->indice_prefixo, normalizado, ids, max);
 }
 
-// Gerar próximo ID disponível
-static int gerar_id(ListaContatos *lista) {
-    int max_id = 0;
-    for (int i = 0; i < lista->quantidade; i++) {
-        if (lista->contatos[i].id > max_id) {
-            max_id = lista->contatos[i].id;
+// ==================== Busca por relevância ====================
+
+// Termo em cada forma normalizada usada pelos campos
+typedef struct {
+    char nome[MAX_NOME];
+    char email[MAX_EMAIL];
+    char telefone[MAX_TELEFONE];    // Vazio se o termo não parece um telefone
+} TermoBusca;
+
+// Só dígitos e pontuação de telefone: "ana 11" não deve casar com todo DDD 11
+static int parece_telefone(const char *termo) {
+    int digitos = 0;
+    for (const char *p = termo; *p; p++) {
+        if (*p >= '0' && *p <= '9') {
+            digitos++;
+        } else if (!strchr(" +-().", *p)) {
+            return 0;
         }
     }
-    return max_id + 1;
+    return digitos > 0;
 }
 
-// Adicionar novo contato
-int adicionar_contato(ListaContatos *lista, const char *nome, const char *telefone, const char *email) {
-    if (!lista || !nome || !telefone || !email) {
-        return -1;
+// 3 = campo igual ao termo, 2 = campo ou uma de suas palavras começa com ele, 1 = trecho
+static int casamento_texto(const char *campo, const char *termo) {
+    if (!termo[0]) {
+        return 0;
     }
-    
-    if (lista->quantidade >= lista->capacidade) {
-        if (!expandir_lista(lista)) {
-            return -1;
-        }
+    if (strcmp(campo, termo) == 0) {
+        return 3;
     }
-    
-    Contato *novo = &lista->contatos[lista->quantidade];
-    novo->id = gerar_id(lista);
-    strncpy(novo->nome, nome, MAX_NOME - 1);
-    novo->nome[MAX_NOME - 1] = '\0';
-    strncpy(novo->telefone, telefone, MAX_TELEFONE - 1);
-    novo->telefone[MAX_TELEFONE - 1] = '\0';
-    strncpy(novo->email, email, MAX_EMAIL - 1);
-    novo->email[MAX_EMAIL - 1] = '\0';
-    novo->ativo = 1;
-    
-    lista->quantidade++;
-    return novo->id;
+    const char *p = strstr(campo, termo);
+    if (!p) {
+        return 0;
+    }
+    do {
+        if (p == campo || p[-1] == ' ') {
+            return 2;
+        }
+        p = strstr(p + 1, termo);
+    } while (p);
+    return 1;
 }
 
-// Buscar contato por ID
-Contato* buscar_contato_por_id(ListaContatos *lista, int id) {
-    if (!lista) {
-        printf("Erro ao buscar contato: lista inválida\n");
-        return NULL;
+static int relevancia_contato(const Contato *contato, const TermoBusca *termo) {
+    static const int por_nome[4] = { 0, RELEVANCIA_NOME_TRECHO, RELEVANCIA_NOME_PREFIXO, RELEVANCIA_NOME_EXATO };
+    static const int por_email[4] = { 0, RELEVANCIA_EMAIL_TRECHO, RELEVANCIA_EMAIL_PREFIXO, RELEVANCIA_EMAIL_EXATO };
+    char campo[MAX_EMAIL];
+    int relevancia = por_nome[casamento_texto(normalizar_nome(contato->nome, campo, sizeof(campo)), termo->nome)];
+    if (relevancia == RELEVANCIA_NOME_EXATO) {
+        return relevancia;
     }
-    
-    for (int i = 0; i < lista->quantidade; i++) {
-        if (lista->contatos[i].id == id && lista->contatos[i].ativo) {
-            return &lista->contatos[i];
+    int email = por_email[casamento_texto(normalizar_email(contato->email, campo, sizeof(campo)), termo->email)];
+    relevancia = email > relevancia ? email : relevancia;
+    if (termo->telefone[0] && relevancia < RELEVANCIA_TELEFONE_EXATO) {
+        normalizar_telefone(contato->telefone, campo, sizeof(campo));
+        if (strcmp(campo, termo->telefone) == 0) {
+            relevancia = RELEVANCIA_TELEFONE_EXATO;
+        } else if (relevancia < RELEVANCIA_TELEFONE_TRECHO && strstr(campo, termo->telefone)) {
+            relevancia = RELEVANCIA_TELEFONE_TRECHO;
         }
     }
-    return NULL;
+    return relevancia;
 }
 
-// Editar contato existente
-int editar_contato(ListaContatos *lista, int id, const char *nome, const char *telefone, const char *email) {
-    Contato *contato = buscar_contato_por_id(lista, id);
-    if (!contato) {
-        printf("Contato com ID %d não encontrado para edição.\n", id);
-        return 0;
+// a é pior que b: menos relevante ou, empatado, de ID maior
+static int resultado_pior(const ResultadoBusca *a, const ResultadoBusca *b) {
+    return a->relevancia < b->relevancia || (a->relevancia == b->relevancia && a->id > b->id);
+}
+
+// Heap de mínimo limitado a k: a raiz é o pior dos melhores encontrados até agora
+static void oferecer_resultado(ResultadoBusca *heap, int *tamanho, int k, int id, int relevancia) {
+    ResultadoBusca novo = { id, relevancia };
+    int posicao;
+    if (*tamanho < k) {
+        // Subir a partir do fim
+        posicao = (*tamanho)++;
+        while (posicao > 0 && resultado_pior(&novo, &heap[(posicao - 1) / 2])) {
+            heap[posicao] = heap[(posicao - 1) / 2];
+            posicao = (posicao - 1) / 2;
+        }
+        heap[posicao] = novo;
+        return;
     }
-    
-    if (nome && strlen(nome) > 0) { // Se o nome não for NULL ou vazio
-        strncpy(contato->nome, nome, MAX_NOME - 1);
-        contato->nome[MAX_NOME - 1] = '\0';
+    if (!resultado_pior(&heap[0], &novo)) {
+        return;
     }
-    
-    if (telefone && strlen(telefone) > 0) { // Se o telefone não for NULL ou vazio
-        strncpy(contato->telefone, telefone, MAX_TELEFONE - 1);
-        contato->telefone[MAX_TELEFONE - 1] = '\0';
+    // Trocar a raiz e descer
+    posicao = 0;
+    while (1) {
+        int filho = 2 * posicao + 1;
+        if (filho >= k) {
+            break;
+        }
+        if (filho + 1 < k && resultado_pior(&heap[filho + 1], &heap[filho])) {
+            filho++;
+        }
+        if (!resultado_pior(&heap[filho], &novo)) {
+            break;
+        }
+        heap[posicao] = heap[filho];
+        posicao = filho;
     }
-    
-    if (email && strlen(email) > 0) { // Se o email não for NULL ou vazio
-        strncpy(contato->email, email, MAX_EMAIL - 1);
-        contato->email[MAX_EMAIL - 1] = '\0';
+    heap[posicao] = novo;
+}
+
+static int comparar_resultados(const void *a, const void *b) {
+    const ResultadoBusca *ra = (const ResultadoBusca*)a;
+    const ResultadoBusca *rb = (const ResultadoBusca*)b;
+    if (ra->relevancia != rb->relevancia) {
+        return rb->relevancia - ra->relevancia;
     }
-    
-    return 1; // Edição bem sucedida, retornando o valor 1 para a função 'editar_contato'
+    return (ra->id > rb->id) - (ra->id < rb->id);
 }
 
-// Excluir contato (remoção física com compactação)
-int excluir_contato(ListaContatos *lista, int id) {
-    if (!lista) {
+// Avaliar um contato candidato uma única vez (o mapa marca as posições já vistas)
+static void avaliar_candidato(ListaContatos *lista, int id, const TermoBusca *termo, unsigned char *vistos,
+                              ResultadoBusca *heap, int *tamanho, int k) {
+    int posicao = posicao_contato(lista, id);
+    if (posicao < 0 || (vistos[posicao >> 3] & (1 << (posicao & 7)))) {
+        return;
+    }
+    vistos[posicao >> 3] |= (unsigned char)(1 << (posicao & 7));
+    const Contato *contato = CONTATO_EM(lista, posicao);
+    int relevancia = contato->ativo ? relevancia_contato(contato, termo) : 0;
+    if (relevancia > 0) {
+        oferecer_resultado(heap, tamanho, k, id, relevancia);
+    }
+}
+
+// Primeiro os candidatos dos índices (prefixos de nomes e emails, telefone exato),
+// que cobrem toda relevância acima de RELEVANCIA_NOME_TRECHO; a varredura só roda
+// se ainda houver vaga ou se um trecho ainda puder entrar nos k melhores
+int buscar_relevantes(ListaContatos *lista, const char *termo, ResultadoBusca *resultados, int k) {
+    if (!lista || !termo || !resultados || k <= 0) {
+        return -1;
+    }
+    TermoBusca busca;
+    normalizar_nome(termo, busca.nome, sizeof(busca.nome));
+    normalizar_email(termo, busca.email, sizeof(busca.email));
+    busca.telefone[0] = '\0';
+    if (parece_telefone(termo)) {
+        normalizar_telefone(termo, busca.telefone, sizeof(busca.telefone));
+    }
+    if (!busca.nome[0] && !busca.email[0] && !busca.telefone[0]) {
         return 0;
     }
-    
-    // Encontrar índice do contato
-    int indice = -1;
-    for (int i = 0; i < lista->quantidade; i++) {
-        if (lista->contatos[i].id == id && lista->contatos[i].ativo) {
-            indice = i;
+
+    unsigned char *vistos = (unsigned char*)calloc((size_t)lista->quantidade / 8 + 1, 1);
+    if (!vistos || !atualizar_indice_prefixo(lista)) {
+        free(vistos);
+        return -1;
+    }
+    int tamanho = 0;
+
+    // O índice guarda nomes com normalizar_nome e emails com normalizar_email
+    const IndicePrefixo *indice = lista->indice_prefixo;
+    const char *chaves[2] = { busca.nome, busca.email };
+    for (int c = 0; c < 2; c++) {
+        if (c == 1 && strcmp(busca.email, busca.nome) == 0) {
             break;
         }
+        CursorPrefixo cursor;
+        indice_prefixo_iniciar(indice, chaves[c], &cursor);
+        const EntradaPrefixo *entrada;
+        while ((entrada = indice_prefixo_proxima(&cursor)) != NULL) {
+            avaliar_candidato(lista, entrada->id, &busca, vistos, resultados, &tamanho, k);
+        }
     }
-    
-    if (indice == -1) {
-        return 0;
-    }
-    
-    // Deslocar elementos usando memmove para manter ordem compacta
-    if (indice < lista->quantidade - 1) {
-        memmove(&lista->contatos[indice], 
-                &lista->contatos[indice + 1],
-                (lista->quantidade - indice - 1) * sizeof(Contato));
+    if (busca.telefone[0]) {
+        EntradaIndice *entrada = indice_buscar(lista->indice_telefone, busca.telefone);
+        for (int i = 0; entrada && i < entrada->quantidade; i++) {
+            avaliar_candidato(lista, entrada->ids[i], &busca, vistos, resultados, &tamanho, k);
+        }
     }
-    
-    lista->quantidade--;
-    
-    // Realocar para liberar espaço se necessário (quando muito vazio)
-    if (lista->quantidade > 0 && lista->capacidade > CAPACIDADE_INICIAL * 2 
-        && lista->quantidade < lista->capacidade / 2) {
-        int nova_capacidade = lista->capacidade / 2;
-        Contato *novo_array = (Contato*)realloc(lista->contatos, nova_capacidade * sizeof(Contato));
-        if (novo_array) {
-            lista->contatos = novo_array;
-            lista->capacidade = nova_capacidade;
+
+    // Varredura em ordem de ID: empates perdem para quem já está no heap, então
+    // ela para assim que o pior dos k tem a relevância máxima de um trecho
+    for (int i = 0; i < lista->quantidade; i++) {
+        if (tamanho == k && resultados[0].relevancia >= RELEVANCIA_NOME_TRECHO) {
+            break;
+        }
+        if (vistos[i >> 3] & (1 << (i & 7))) {
+            continue;
+        }
+        const Contato *contato = CONTATO_EM(lista, i);
+        int relevancia = contato->ativo ? relevancia_contato(contato, &busca) : 0;
+        if (relevancia > 0) {
+            oferecer_resultado(resultados, &tamanho, k, contato->id, relevancia);
         }
     }
-    
-    return 1;
+
+    free(vistos);
+    qsort(resultados, (size_t)tamanho, sizeof(ResultadoBusca), comparar_resultados);
+    return tamanho;
 }
 
-// Listar todos os contatos ativos
-void listar_contatos(ListaContatos *lista) {
-    if (!lista || lista->quantidade == 0) {
-        printf("Nenhum contato cadastrado.\n");
+const char* descrever_relevancia(int relevancia) {
+    switch (relevancia) {
+        case RELEVANCIA_NOME_EXATO: return "nome exato";
+        case RELEVANCIA_EMAIL_EXATO: return "email exato";
+        case RELEVANCIA_TELEFONE_EXATO: return "telefone exato";
+        case RELEVANCIA_NOME_PREFIXO: return "início do nome";
+        case RELEVANCIA_EMAIL_PREFIXO: return "início do email";
+        case RELEVANCIA_NOME_TRECHO: return "trecho do nome";
+        case RELEVANCIA_EMAIL_TRECHO: return "trecho do email";
+        case RELEVANCIA_TELEFONE_TRECHO: return "trecho do telefone";
+        default: return "";
+    }
+}
+
+// Exibir só os k mais relevantes (saída limitada mesmo para termos comuns)
+void buscar_contatos_relevantes(ListaContatos *lista, const char *termo, int k) {
+    ResultadoBusca *resultados = k > 0 ? (ResultadoBusca*)malloc((size_t)k * sizeof(ResultadoBusca)) : NULL;
+    int n = resultados ? buscar_relevantes(lista, termo, resultados, k) : -1;
+    if (n < 0) {
+        fprintf(stderr, "Erro ao buscar contatos\n");
+        free(resultados);
         return;
     }
-    
-    int count = 0;
-    printf("\n%-5s %-30s %-20s %-30s\n", "ID", "Nome", "Telefone", "Email");
-    printf("--------------------------------------------------------------------------------\n");
-    
-    for (int i = 0; i < lista->quantidade; i++) {
-        if (lista->contatos[i].ativo) {
-            printf("%-5d %-30s %-20s %-30s\n",
-                   lista->contatos[i].id,
-                   lista->contatos[i].nome,
-                   lista->contatos[i].telefone,
-                   lista->contatos[i].email);
-            count++;
-        }
+    if (n == 0) {
+        printf("Nenhum contato encontrado com o termo '%s'.\n", termo);
+        free(resultados);
+        return;
     }
     
-    if (count == 0) {
-        printf("Nenhum contato ativo encontrado.\n");
-    } else {
-        printf("\nTotal: %d contato(s)\n", count);
+    printf("\n%-5s %-30s %-20s %-30s %s\n", "ID", "Nome", "Telefone", "Email", "Casamento");
+    printf("----------------------------------------------------------------------------------------------------\n");
+    for (int i = 0; i < n; i++) {
+        Contato *contato = buscar_contato_por_id(lista, resultados[i].id);
+        printf("%-5d %-30s %-20s %-30s %s\n",
+               contato->id,
+               contato->nome,
+               contato->telefone,
+               contato->email,
+               descrever_relevancia(resultados[i].relevancia));
     }
+    printf("\nOs %d contato(s) mais relevante(s)\n", n);
+    free(resultados);
 }
 
-// Buscar contatos por termo (nome, telefone ou email)
-void buscar_contatos(ListaContatos *lista, const char *termo) {
-    if (!lista || !termo) {
-        printf("Nenhum contato encontrado.\n");
+// Ordenar domínios por quantidade (decrescente) e depois por nome
+static int comparar_entradas_por_quantidade(const void *a, const void *b) {
+    const EntradaIndice *ea = *(const EntradaIndice * const *)a;
+    const EntradaIndice *eb = *(const EntradaIndice * const *)b;
+    if (ea->quantidade != eb->quantidade) {
+        return eb->quantidade - ea->quantidade;
+    }
+    return strcmp(ea->chave, eb->chave);
+}
+
+// Relatório de contatos por domínio de email (uma passada sobre o índice)
+void listar_dominios(ListaContatos *lista) {
+    if (!lista || !lista->indice_dominio || lista->indice_dominio->num_chaves == 0) {
+        printf("Nenhum domínio cadastrado.\n");
         return;
     }
     
-    int count = 0;
-    printf("\n%-5s %-30s %-20s %-30s\n", "ID", "Nome", "Telefone", "Email");
-    printf("--------------------------------------------------------------------------------\n");
+    IndiceHash *indice = lista->indice_dominio;
+    EntradaIndice **entradas = (EntradaIndice**)malloc(indice->num_chaves * sizeof(EntradaIndice*));
+    if (!entradas) {
+        fprintf(stderr, "Erro ao alocar memória para o relatório\n");
+        return;
+    }
     
-    for (int i = 0; i < lista->quantidade; i++) {
-        if (lista->contatos[i].ativo) {
-            if (strstr(lista->contatos[i].nome, termo) ||
-                strstr(lista->contatos[i].telefone, termo) ||
-                strstr(lista->contatos[i].email, termo)) {
-                printf("%-5d %-30s %-20s %-30s\n",
-                       lista->contatos[i].id,
-                       lista->contatos[i].nome,
-                       lista->contatos[i].telefone,
-                       lista->contatos[i].email);
-                count++;
-            }
+    size_t n = 0;
+    for (size_t i = 0; i < indice->num_baldes; i++) {
+        for (EntradaIndice *entrada = indice->baldes[i]; entrada; entrada = entrada->proxima) {
+            entradas[n++] = entrada;
         }
     }
+    qsort(entradas, n, sizeof(EntradaIndice*), comparar_entradas_por_quantidade);
     
-    if (count == 0) {
-        printf("Nenhum contato encontrado com o termo '%s'.\n", termo);
-    } else {
-        printf("\nTotal: %d contato(s) encontrado(s)\n", count);
+    int total = 0;
+    printf("\n%-51s %10s\n", "Domínio", "Contatos"); // +1: "í" ocupa 2 bytes
+    printf("--------------------------------------------------------------\n");
+    for (size_t i = 0; i < n; i++) {
+        printf("%-50s %10d\n", entradas[i]->chave, entradas[i]->quantidade);
+        total += entradas[i]->quantidade;
     }
+    printf("\nTotal: %zu domínio(s), %d contato(s)\n", n, total);
+    
+    free(entradas);
 }
 
 // Salvar contatos em arquivo binário
+// Grava em um arquivo temporário e publica com rename(): leitores concorrentes
+// sempre veem a versão anterior completa ou a nova completa, nunca uma parcial
 int salvar_contatos(ListaContatos *lista, const char *arquivo) {
     if (!lista || !arquivo) {
         return 0;
     }
     
-    FILE *fp = fopen(arquivo, "wb");
+    // Atributos antes dos contatos: uma queda entre os dois deixa atributos de
+    // contatos que o arquivo ainda não tem, e esses são descartados na carga
+    if (!salvar_extensoes(lista->extensoes, arquivo)) {
+        fprintf(stderr, "Erro ao gravar atributos dos contatos\n");
+        return 0;
+    }
+    
+    char temporario[512];
+    nome_arquivo_temporario(arquivo, temporario, sizeof(temporario));
+    
+    FILE *fp = fopen(temporario, "wb");
     if (!fp) {
-        fprintf(stderr, "Erro ao abrir arquivo para escrita: %s\n", arquivo);
+        fprintf(stderr, "Erro ao abrir arquivo para escrita: %s\n", temporario);
         return 0;
     }
     
-    // Escrever quantidade de contatos
-    if (fwrite(&lista->quantidade, sizeof(int), 1, fp) != 1) {
-        fprintf(stderr, "Erro ao escrever quantidade de contatos\n");
+    // Escrever contatos em blocos, cada um com seu CRC32C
+    if (!gravar_em_blocos(fp, lista)) {
+        fprintf(stderr, "Erro ao escrever contatos\n");
         fclose(fp);
+        remove(temporario);
         return 0;
     }
     
-    // Escrever array de contatos
-    if (lista->quantidade > 0) {
-        if (fwrite(lista->contatos, sizeof(Contato), lista->quantidade, fp) != (size_t)lista->quantidade) {
-            fprintf(stderr, "Erro ao escrever contatos\n");
-            fclose(fp);
+    if (!gravar_em_disco(fp)) {
+        fprintf(stderr, "Erro ao gravar contatos em disco\n");
+        fclose(fp);
+        remove(temporario);
+        return 0;
+    }
+    fclose(fp);
+    
+    if (rename(temporario, arquivo) != 0) {
+        fprintf(stderr, "Erro ao publicar arquivo: %s\n", arquivo);
+        remove(temporario);
+        return 0;
+    }
+    
+    obter_assinatura_arquivo(arquivo, &lista->assinatura);
+    
+    // O filtro vale só para esta versão do arquivo (se faltar, a carga o refaz)
+    if (lista->filtro_unicidade &&
+        !salvar_filtro_bloom(lista->filtro_unicidade, arquivo, &lista->assinatura)) {
+        fprintf(stderr, "Aviso: filtro de unicidade não gravado (será refeito na próxima carga)\n");
+    }
+    
+    // Depois de publicar: quem lê o registro nunca vê alterações que não foram salvas
+    if (!gravar_alteracoes(lista, arquivo)) {
+        fprintf(stderr, "Aviso: registro de alterações não atualizado (nova tentativa no próximo salvamento)\n");
+    }
+    return 1;
+}
+
+// Ler o formato antigo (quantidade seguida do array de contatos)
+// Retorna 1 se leu, 0 se o arquivo está incompleto e -1 em falta de memória
+static int ler_formato_antigo(FILE *fp, long file_size, ListaContatos *lista) {
+    int quantidade;
+    if (fread(&quantidade, sizeof(int), 1, fp) != 1 || quantidade < 0) {
+        fprintf(stderr, "Erro ao ler quantidade de contatos\n");
+        return 0;
+    }
+    
+    // Calcular número de contatos baseado no tamanho do arquivo
+    size_t expected_size = sizeof(int) + ((size_t)quantidade * sizeof(Contato));
+    if (quantidade > 0 && (size_t)file_size != expected_size) {
+        fprintf(stderr, "Aviso: Tamanho do arquivo inconsistente\n");
+    }
+    
+    // Alocar os segmentos necessários (ao menos um, como em criar_lista)
+    if (!reservar_contatos(lista, quantidade > 0 ? quantidade : 1)) {
+        fprintf(stderr, "Erro ao alocar memória para %d contatos\n", quantidade);
+        return -1;
+    }
+    
+    // Ler contatos segmento a segmento
+    while (lista->quantidade < quantidade) {
+        int n = quantidade - lista->quantidade < TAMANHO_SEGMENTO ? quantidade - lista->quantidade : TAMANHO_SEGMENTO;
+        size_t lidos = fread(lista->segmentos[lista->quantidade >> BITS_SEGMENTO], sizeof(Contato), n, fp);
+        if (lidos != (size_t)n) {
+            fprintf(stderr, "Erro: esperado %d contatos, lidos %zu\n", quantidade, lista->quantidade + lidos);
             return 0;
         }
+        lista->quantidade += n;
     }
-    
-    fclose(fp);
     return 1;
 }
 
-// Carregar contatos de arquivo binário usando fseek/ftell
+// Carregar contatos de arquivo binário (formato em blocos ou antigo)
 ListaContatos* carregar_contatos(const char *arquivo) {
     if (!arquivo) {
         return criar_lista();
@@ -277,6 +1767,11 @@ ListaContatos* carregar_contatos(const char *arquivo) {
         return criar_lista();
     }
     
+    // O arquivo aberto é um snapshot estável: salvamentos criam um novo arquivo
+    bloquear_leitura(fp);
+    AssinaturaArquivo assinatura;
+    obter_assinatura_aberto(fp, &assinatura);
+    
     // Descobrir tamanho do arquivo
     if (fseek(fp, 0, SEEK_END) != 0) {
         fprintf(stderr, "Erro ao buscar final do arquivo\n");
@@ -303,58 +1798,125 @@ ListaContatos* carregar_contatos(const char *arquivo) {
         fclose(fp);
         return NULL;
     }
+    lista->segmentos = NULL;
+    lista->num_segmentos = 0;
+    lista->capacidade_diretorio = 0;
+    lista->excluidos = 0;
+    lista->capacidade = 0;
+    lista->indice_telefone = NULL;
+    lista->indice_dominio = NULL;
+    lista->indice_nomes = NULL;
+    lista->indice_prefixo = NULL;
+    lista->cache_consultas = NULL;
+    lista->filtro_unicidade = NULL;
+    lista->extensoes = NULL;
+    lista->geracao = 0;
+    lista->assinatura = assinatura;
+    lista->sequencia = 0;
+    lista->alteracoes = NULL;
+    lista->num_alteracoes = 0;
+    lista->capacidade_alteracoes = 0;
     
-    // Ler quantidade de contatos
-    if (fread(&lista->quantidade, sizeof(int), 1, fp) != 1) {
-        fprintf(stderr, "Erro ao ler quantidade de contatos\n");
-        free(lista);
-        fclose(fp);
-        return criar_lista();
-    }
-    
-    if (lista->quantidade == 0) {
-        lista->contatos = (Contato*)malloc(CAPACIDADE_INICIAL * sizeof(Contato));
-        if (!lista->contatos) {
-            fprintf(stderr, "Erro ao alocar memória inicial\n");
-            free(lista);
+    // Formato em blocos: leitura paralela com verificação de CRC de cada bloco
+    // Corrupção não vira lista vazia: salvar por cima apagaria os contatos
+    lista->quantidade = 0;
+    if (arquivo_em_blocos(fp)) {
+        if (!ler_em_blocos(fp, lista)) {
+            fprintf(stderr, "Erro: arquivo de contatos corrompido: %s\n", arquivo);
+            liberar_lista(lista);
             fclose(fp);
             return NULL;
         }
-        lista->capacidade = CAPACIDADE_INICIAL;
-        fclose(fp);
-        return lista;
+    } else {
+        int resultado = ler_formato_antigo(fp, file_size, lista);
+        if (resultado <= 0) {
+            liberar_lista(lista);
+            fclose(fp);
+            return resultado == 0 ? criar_lista() : NULL;
+        }
     }
     
-    // Calcular número de contatos baseado no tamanho do arquivo
-    size_t expected_size = sizeof(int) + (lista->quantidade * sizeof(Contato));
-    if ((size_t)file_size != expected_size) {
-        fprintf(stderr, "Aviso: Tamanho do arquivo inconsistente\n");
+    fclose(fp);
+    
+    // Excluídos que foram salvos antes de uma compactação
+    for (int i = 0; i < lista->quantidade; i++) {
+        if (!CONTATO_EM(lista, i)->ativo) {
+            lista->excluidos++;
+        }
     }
     
-    // Alocar memória exata para os contatos
-    lista->capacidade = lista->quantidade > CAPACIDADE_INICIAL ? lista->quantidade : CAPACIDADE_INICIAL;
-    lista->contatos = (Contato*)malloc(lista->capacidade * sizeof(Contato));
-    if (!lista->contatos) {
-        fprintf(stderr, "Erro ao alocar memória para %d contatos\n", lista->quantidade);
-        free(lista);
-        fclose(fp);
+    // Atributos corrompidos não são descartados em silêncio: salvar apagaria o arquivo
+    if (!carregar_extensoes(arquivo, &lista->extensoes)) {
+        liberar_lista(lista);
         return NULL;
     }
+    podar_atributos(lista);
     
-    // Ler array de contatos
-    size_t lidos = fread(lista->contatos, sizeof(Contato), lista->quantidade, fp);
-    if (lidos != (size_t)lista->quantidade) {
-        fprintf(stderr, "Erro: esperado %d contatos, lidos %zu\n", lista->quantidade, lidos);
-        free(lista->contatos);
-        free(lista);
-        fclose(fp);
-        return criar_lista();
+    // Filtro gravado junto com esta versão do arquivo: não precisa ser refeito
+    lista->filtro_unicidade = carregar_filtro_bloom(arquivo, &assinatura);
+    if (!montar_indices(lista, lista->filtro_unicidade == NULL)) {
+        liberar_lista(lista);
+        return NULL;
     }
-    
-    fclose(fp);
     return lista;
 }
 
+// Recarregar a lista se outro processo salvou o arquivo desde a última leitura
+// Retorna 1 se recarregou, 0 se já estava atualizada e -1 em erro
+int recarregar_se_alterada(ListaContatos *lista, const char *arquivo) {
+    if (!lista || !arquivo) {
+        return -1;
+    }
+    
+    AssinaturaArquivo atual;
+    obter_assinatura_arquivo(arquivo, &atual);
+    if (assinaturas_iguais(&atual, &lista->assinatura)) {
+        return 0;
+    }
+    
+    ListaContatos *nova = carregar_contatos(arquivo);
+    if (!nova) {
+        return -1;
+    }
+    
+    substituir_lista(lista, nova);
+    return 1;
+}
+
+// Trocar o conteúdo da lista pelo de outra (que é liberada), mantendo o mesmo
+// ponteiro para quem já o referencia
+// Os atributos vêm com a nova lista (do ".ext" do arquivo ou da seção do
+// snapshot): os atuais não são herdados, já que a ausência deles na nova é a
+// versão gravada, não uma falta
+void substituir_lista(ListaContatos *lista, ListaContatos *nova) {
+    unsigned long geracao = lista->geracao;
+    ListaContatos antiga = *lista;
+    *lista = *nova;
+    *nova = antiga;
+    lista->geracao = geracao + 1;
+    
+    // Conteúdo sem sequência ou com uma sequência mais antiga (snapshot, arquivo de
+    // versão anterior): a numeração não volta, e quem sincroniza pelo registro de
+    // alterações precisa recarregar tudo
+    if (lista->sequencia < nova->sequencia) {
+        lista->sequencia = nova->sequencia;
+        registrar_alteracao(lista, ALTERACAO_REINICIO, NULL);
+    }
+    liberar_lista(nova);
+}
+
+// Texto livre dos atributos: entre aspas, com aspas internas duplicadas
+static void escrever_valor_csv(FILE *fp, const char *valor) {
+    fputc('"', fp);
+    for (const char *p = valor; *p; p++) {
+        if (*p == '"') {
+            fputc('"', fp);
+        }
+        fputc(*p, fp);
+    }
+    fputc('"', fp);
+}
+
 // Exportar contatos para arquivo CSV
 int exportar_csv(ListaContatos *lista, const char *arquivo) {
     if (!lista || !arquivo) {
@@ -367,18 +1929,47 @@ int exportar_csv(ListaContatos *lista, const char *arquivo) {
         return 0;
     }
     
-    // Escrever cabeçalho
-    fprintf(fp, "ID,Nome,Telefone,Email,Status\n");
+    // Escrever cabeçalho: uma coluna por atributo que algum contato tem
+    const ExtensoesContatos *extensoes = lista->extensoes;
+    int num_chaves = extensoes ? extensoes->num_chaves : 0;
+    fprintf(fp, "ID,Nome,Telefone,Email,Status");
+    for (int c = 0; c < num_chaves; c++) {
+        if (extensoes->usos[c] > 0) {
+            fprintf(fp, ",%s", extensoes->nomes_chaves[c]);
+        }
+    }
+    fputc('\n', fp);
     
     // Escrever dados
+    int atributo = 0;
     for (int i = 0; i < lista->quantidade; i++) {
-        if (lista->contatos[i].ativo) {
-            fprintf(fp, "%d,\"%s\",\"%s\",\"%s\",Ativo\n",
-                    lista->contatos[i].id,
-                    lista->contatos[i].nome,
-                    lista->contatos[i].telefone,
-                    lista->contatos[i].email);
+        Contato *contato = CONTATO_EM(lista, i);
+        if (contato->ativo) {
+            fprintf(fp, "%d,\"%s\",\"%s\",\"%s\",Ativo",
+                    contato->id,
+                    contato->nome,
+                    contato->telefone,
+                    contato->email);
+        }
+        // Atributos em ordem de (ID, chave): os do contato vêm em ordem de coluna
+        while (extensoes && atributo < extensoes->quantidade && extensoes->atributos[atributo].id < contato->id) {
+            atributo++;
+        }
+        if (!contato->ativo) {
+            continue;
+        }
+        for (int c = 0; c < num_chaves; c++) {
+            if (extensoes->usos[c] == 0) {
+                continue;
+            }
+            fputc(',', fp);
+            if (atributo < extensoes->quantidade && extensoes->atributos[atributo].id == contato->id &&
+                extensoes->atributos[atributo].chave == c) {
+                escrever_valor_csv(fp, VALOR_EXTENSAO(extensoes, &extensoes->atributos[atributo]));
+                atributo++;
+            }
         }
+        fputc('\n', fp);
     }
     
     fclose(fp);
@@ -411,19 +2002,21 @@ void analisar_memoria(ListaContatos *lista) {
         return;
     }
     
-    size_t memoria_lista = sizeof(ListaContatos);
-    size_t memoria_array = lista->capacidade * sizeof(Contato);
+    size_t memoria_lista = sizeof(ListaContatos) + lista->capacidade_diretorio * sizeof(Contato*);
+    size_t memoria_array = (size_t)lista->capacidade * sizeof(Contato);
     size_t memoria_usada = lista->quantidade * sizeof(Contato);
     size_t memoria_total = memoria_lista + memoria_array;
     
     printf("\n=== Análise de Memória ===\n");
-    printf("Contatos ativos:       %d\n", lista->quantidade);
-    printf("Capacidade alocada:    %d\n", lista->capacidade);
+    printf("Contatos ativos:       %d\n", CONTATOS_ATIVOS(lista));
+    printf("Excluídos a compactar: %d\n", lista->excluidos);
+    printf("Capacidade alocada:    %d (%d segmento(s) de %d)\n",
+           lista->capacidade, lista->num_segmentos, TAMANHO_SEGMENTO);
     printf("Taxa de ocupação:      %.1f%%\n", 
            lista->capacidade > 0 ? (lista->quantidade * 100.0 / lista->capacidade) : 0);
     printf("\n");
     printf("Memória da estrutura:  %zu bytes\n", memoria_lista);
-    printf("Memória do array:      %zu bytes (%.2f KB)\n", 
+    printf("Memória dos segmentos: %zu bytes (%.2f KB)\n", 
            memoria_array, memoria_array / 1024.0);
     printf("Memória em uso:        %zu bytes (%.2f KB)\n", 
            memoria_usada, memoria_usada / 1024.0);
@@ -431,5 +2024,36 @@ void analisar_memoria(ListaContatos *lista) {
            memoria_array - memoria_usada, (memoria_array - memoria_usada) / 1024.0);
     printf("Memória total:         %zu bytes (%.2f KB)\n", 
            memoria_total, memoria_total / 1024.0);
+    
+    const CacheConsultas *cache = lista->cache_consultas;
+    if (cache) {
+        unsigned long consultas = cache->acertos + cache->faltas;
+        printf("\n");
+        printf("Cache de consultas:    %zu entrada(s), %.2f KB de %.2f KB\n",
+               cache->num_entradas, cache->bytes / 1024.0, cache->limite / 1024.0);
+        printf("Acertos / faltas:      %lu / %lu (%.1f%% de acertos)\n",
+               cache->acertos, cache->faltas, consultas > 0 ? cache->acertos * 100.0 / consultas : 0);
+        printf("Invalidadas / descartadas: %lu / %lu\n", cache->invalidadas, cache->descartes);
+    }
+    
+    const FiltroBloom *filtro = lista->filtro_unicidade;
+    if (filtro) {
+        printf("\n");
+        printf("Filtro de unicidade:   %ld chave(s) de %ld planejadas, %.2f KB\n",
+               filtro->chaves, filtro->capacidade, filtro->num_posicoes / 2 / 1024.0);
+        printf("Consultas / negativas: %lu / %lu (falsos positivos: %lu)\n",
+               filtro->consultas, filtro->negativas, filtro->falsos_positivos);
+    }
+    
+    const ExtensoesContatos *extensoes = lista->extensoes;
+    if (extensoes) {
+        size_t memoria_atributos = sizeof(ExtensoesContatos) +
+                                   (size_t)extensoes->capacidade * sizeof(AtributoExtensao) +
+                                   extensoes->capacidade_arena;
+        printf("\n");
+        printf("Atributos extras:      %d em %d chave(s), %.2f KB (%.2f KB de lixo na arena)\n",
+               extensoes->quantidade, extensoes->num_chaves, memoria_atributos / 1024.0,
+               extensoes->lixo / 1024.0);
+    }
     printf("\n");
 }
@@ -1,10 +1,35 @@
 #ifndef CONTATO_H
 #define CONTATO_H
 
+#include <stdint.h>
+#include "indice.h"
+#include "arvore_bk.h"
+#include "prefixo.h"
+#include "cache_consultas.h"
+#include "filtro_bloom.h"
+#include "extensoes.h"
+#include "bloqueio.h"
+
 #define MAX_NOME 100
 #define MAX_TELEFONE 20
 #define MAX_EMAIL 100
 
+// Armazenamento segmentado: segmentos de tamanho fixo e um diretório de ponteiros
+// Crescer ou encolher aloca/libera segmentos inteiros, sem copiar contatos
+// Exclusões só marcam o contato (ativo = 0); os registros excluídos saem da lista
+// em compactar_lista, chamada ao salvar ou quando passam de uma fração da lista
+// Estabilidade de ponteiros: um Contato* continua válido em adicionar_contato,
+// reservar_contatos, excluir_contato abaixo do limite de compactação e
+// restaurar_contato de um excluído ainda na lista, mas NÃO depois de
+// compactar_lista, excluir_onde ou de uma recarga, que movem os contatos
+// Quem precisa guardar uma referência entre alterações guarda o ID
+#define BITS_SEGMENTO 8
+#define TAMANHO_SEGMENTO (1 << BITS_SEGMENTO)
+#define MASCARA_SEGMENTO (TAMANHO_SEGMENTO - 1)
+
+// Acesso O(1) ao contato na posição i
+#define CONTATO_EM(lista, i) (&(lista)->segmentos[(i) >> BITS_SEGMENTO][(i) & MASCARA_SEGMENTO])
+
 typedef struct {
     int id;
     char nome[MAX_NOME];
@@ -13,29 +38,163 @@ typedef struct {
     int ativo; // 1 = ativo, 0 = excluído (soft delete)
 } Contato;
 
+// Registro de alterações: cada alteração recebe uma sequência global crescente
+#define ALTERACAO_ADICAO 1
+#define ALTERACAO_EDICAO 2
+#define ALTERACAO_EXCLUSAO 3
+#define ALTERACAO_REINICIO 4 // Conteúdo trocado sem registro (snapshot, versão antiga): sincronizar tudo
+#define ALTERACAO_ATRIBUTO 5 // Atributos do contato mudaram: reler os dele em "<arquivo>.ext"
+
+typedef struct {
+    uint64_t sequencia;
+    int32_t tipo;
+    int32_t id;
+    char nome[MAX_NOME];         // Imagem do contato após a alteração (vazia na exclusão)
+    char telefone[MAX_TELEFONE];
+    char email[MAX_EMAIL];
+} RegistroAlteracao;
+
 typedef struct {
-    Contato *contatos;
-    int quantidade;
-    int capacidade;
+    Contato **segmentos;         // Diretório: cada segmento guarda TAMANHO_SEGMENTO contatos
+    int num_segmentos;
+    int capacidade_diretorio;
+    int quantidade;              // Registros na lista, incluindo os excluídos
+    int excluidos;               // Registros com ativo = 0 ainda não compactados
+    int capacidade;              // num_segmentos * TAMANHO_SEGMENTO
+    IndiceHash *indice_telefone; // Telefone normalizado -> IDs
+    IndiceHash *indice_dominio;  // Domínio do email -> IDs
+    ArvoreBK *indice_nomes;      // Palavras do nome normalizado -> IDs (busca aproximada)
+    IndicePrefixo *indice_prefixo; // Nomes e emails ordenados (autocompletar), criado sob demanda
+    CacheConsultas *cache_consultas; // Termo -> IDs de buscar_contatos, criado sob demanda
+    FiltroBloom *filtro_unicidade; // Emails e telefones normalizados (checagem de duplicados)
+    ExtensoesContatos *extensoes; // Atributos opcionais por ID, criados sob demanda
+    unsigned long geracao;       // Incrementada a cada alteração dos contatos
+    AssinaturaArquivo assinatura; // Versão do arquivo carregada ou salva por último
+    uint64_t sequencia;          // Última sequência de alteração atribuída (gravada no arquivo)
+    RegistroAlteracao *alteracoes; // Alterações ainda não gravadas no registro de alterações
+    int num_alteracoes;
+    int capacidade_alteracoes;
 } ListaContatos;
 
+// Contatos ativos (os excluídos ficam na lista até a compactação)
+#define CONTATOS_ATIVOS(lista) ((lista)->quantidade - (lista)->excluidos)
+
 // Funções de gerenciamento da lista
 ListaContatos* criar_lista();
 void liberar_lista(ListaContatos *lista);
 int adicionar_contato(ListaContatos *lista, const char *nome, const char *telefone, const char *email);
 int editar_contato(ListaContatos *lista, int id, const char *nome, const char *telefone, const char *email);
 int excluir_contato(ListaContatos *lista, int id);
+
+// Unicidade: ID de um contato ativo com o mesmo telefone ou email (normalizados), ou 0
+// O filtro de Bloom responde a maioria dos "não existe" sem tocar nos contatos;
+// um "talvez" é confirmado pelo índice de telefones ou pelo de domínios
+int buscar_duplicado(ListaContatos *lista, const char *telefone, const char *email);
+
+// Adicionar só se nenhum contato tem o mesmo telefone ou email; retorna o novo ID,
+// 0 se já existe (o ID dele vai em *existente, se não for NULL) ou -1 em erro
+int adicionar_contato_unico(ListaContatos *lista, const char *nome, const char *telefone, const char *email,
+                            int *existente);
+// Reativa o registro do excluído no lugar; depois da compactação, reinsere na
+// posição do ID deslocando os seguintes
+int restaurar_contato(ListaContatos *lista, const Contato *contato);
+
+// Remover fisicamente os contatos excluídos (já desindexados e registrados);
+// retorna quantos saíram
+int compactar_lista(ListaContatos *lista);
+int reservar_contatos(ListaContatos *lista, int quantidade);
+int posicao_contato(ListaContatos *lista, int id);
 Contato* buscar_contato_por_id(ListaContatos *lista, int id);
 void listar_contatos(ListaContatos *lista);
 void buscar_contatos(ListaContatos *lista, const char *termo);
 
+// IDs dos contatos ativos cujo nome, telefone, email ou algum atributo contém o
+// termo (critério de buscar_contatos), em ordem de ID; consultas repetidas sem alterações entre elas
+// saem do cache. *ids é alocado (liberar com free); retorna a quantidade ou -1
+int buscar_ids_contatos(ListaContatos *lista, const char *termo, int **ids);
+
+// Busca por relevância: a melhor forma de casamento do termo com o contato
+// (exato > prefixo do campo ou de uma palavra > trecho; nome > email > telefone)
+#define RELEVANCIA_NOME_EXATO 8
+#define RELEVANCIA_EMAIL_EXATO 7
+#define RELEVANCIA_TELEFONE_EXATO 6
+#define RELEVANCIA_NOME_PREFIXO 5
+#define RELEVANCIA_EMAIL_PREFIXO 4
+#define RELEVANCIA_NOME_TRECHO 3
+#define RELEVANCIA_EMAIL_TRECHO 2
+#define RELEVANCIA_TELEFONE_TRECHO 1
+
+typedef struct {
+    int id;
+    int relevancia;
+} ResultadoBusca;
+
+// Os k contatos mais relevantes, do melhor para o pior (empates pelo menor ID)
+// Retorna quantos foram encontrados (até k) ou -1 em erro
+int buscar_relevantes(ListaContatos *lista, const char *termo, ResultadoBusca *resultados, int k);
+void buscar_contatos_relevantes(ListaContatos *lista, const char *termo, int k);
+const char* descrever_relevancia(int relevancia);
+
+// Operações em lote: um critério "campo:valor" escolhe os contatos, comparados
+// depois da mesma normalização dos índices
+//   nome:trecho     - trecho do nome (sem acentos e sem caixa)
+//   telefone:trecho - trecho do telefone normalizado (só dígitos)
+//   email:trecho    - trecho do email (sem caixa), ex.: email:@antiga.com
+//   dominio:nome    - domínio do email exatamente igual, ex.: dominio:antiga.com
+#define CRITERIO_NOME 1
+#define CRITERIO_TELEFONE 2
+#define CRITERIO_EMAIL 3
+#define CRITERIO_DOMINIO 4
+
+typedef struct {
+    int campo;
+    char valor[MAX_EMAIL];       // Já normalizado
+} CriterioContatos;
+
+// Retorna 1 se o texto é um critério válido (valor vazio não é aceito)
+int analisar_criterio(const char *texto, CriterioContatos *criterio);
+int contato_atende_criterio(const Contato *contato, const CriterioContatos *criterio);
+int contar_onde(ListaContatos *lista, const CriterioContatos *criterio);
+
+// Uma única passada sobre os contatos, com uma única mudança de geração: salvar
+// uma vez depois. Retornam quantos contatos foram excluídos/editados (-1 em erro)
+int excluir_onde(ListaContatos *lista, const CriterioContatos *criterio);
+int editar_onde(ListaContatos *lista, const CriterioContatos *criterio,
+                const char *nome, const char *telefone, const char *email);
+
+// Atributos opcionais (empresa, endereco, aniversario, notas...): o Contato não
+// cresce, cada atributo existe só nos contatos que o têm (extensoes.h)
+// Entram na busca por termo e viram colunas em exportar_csv; exclusões os removem
+// Retorna 1 se definiu (valor NULL ou vazio remove), 0 se o contato não existe ou
+// a chave/valor são inválidos
+int definir_atributo(ListaContatos *lista, int id, const char *chave, const char *valor);
+const char* obter_atributo(ListaContatos *lista, int id, const char *chave);
+void listar_atributos(ListaContatos *lista, int id);
+
+// Contatos cujo atributo chave contém o trecho (sem acentos e sem caixa; trecho
+// vazio = todos que têm o atributo); percorre só os atributos, não os contatos
+void buscar_por_atributo(ListaContatos *lista, const char *chave, const char *trecho);
+
+// Funções de busca indexada
+Contato* buscar_contato_por_telefone(ListaContatos *lista, const char *telefone);
+void buscar_por_telefone(ListaContatos *lista, const char *telefone);
+void buscar_por_dominio(ListaContatos *lista, const char *dominio);
+void buscar_aproximado(ListaContatos *lista, const char *consulta, int distancia_maxima);
+int sugerir_contatos(ListaContatos *lista, const char *prefixo, int *ids, int max);
+int reconstruir_indices(ListaContatos *lista);
+
 // Funções de persistência
 int salvar_contatos(ListaContatos *lista, const char *arquivo);
 ListaContatos* carregar_contatos(const char *arquivo);
+int recarregar_se_alterada(ListaContatos *lista, const char *arquivo);
+void substituir_lista(ListaContatos *lista, ListaContatos *nova);
 
 // Funções de exportação
 int exportar_csv(ListaContatos *lista, const char *arquivo);
 
+// Funções de relatório
+void listar_dominios(ListaContatos *lista);
+
 // Funções de teste e análise
 void gerar_contatos_teste(ListaContatos *lista, int quantidade);
 void analisar_memoria(ListaContatos *lista);
@@ -0,0 +1,408 @@
+#define _POSIX_C_SOURCE 200809L
+#include "contato_concorrente.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPACIDADE_INICIAL 10
+
+// Copiar campos para um contato novo, truncando como adicionar_contato
+static void preencher_contato(Contato *contato, int id, const char *nome, const char *telefone, const char *email) {
+    contato->id = id;
+    strncpy(contato->nome, nome, MAX_NOME - 1);
+    contato->nome[MAX_NOME - 1] = '\0';
+    strncpy(contato->telefone, telefone, MAX_TELEFONE - 1);
+    contato->telefone[MAX_TELEFONE - 1] = '\0';
+    strncpy(contato->email, email, MAX_EMAIL - 1);
+    contato->email[MAX_EMAIL - 1] = '\0';
+    contato->ativo = 1;
+}
+
+// Criar versão vazia com array de ponteiros próprio
+static InstantaneoContatos* criar_instantaneo(int capacidade) {
+    InstantaneoContatos *instantaneo = (InstantaneoContatos*)malloc(sizeof(InstantaneoContatos));
+    if (!instantaneo) {
+        return NULL;
+    }
+    instantaneo->itens = (_Atomic(Contato*)*)malloc(capacidade * sizeof(_Atomic(Contato*)));
+    if (!instantaneo->itens) {
+        free(instantaneo);
+        return NULL;
+    }
+    instantaneo->quantidade = 0;
+    instantaneo->capacidade = capacidade;
+    return instantaneo;
+}
+
+// Criar lista concorrente (opcionalmente copiando os contatos ativos de uma lista comum)
+ListaConcorrente* criar_lista_concorrente(ListaContatos *origem) {
+    ListaConcorrente *lista = (ListaConcorrente*)malloc(sizeof(ListaConcorrente));
+    if (!lista) {
+        fprintf(stderr, "Erro ao alocar memória para a lista concorrente\n");
+        return NULL;
+    }
+
+    int capacidade = (origem && origem->quantidade > CAPACIDADE_INICIAL) ? origem->quantidade : CAPACIDADE_INICIAL;
+    InstantaneoContatos *inicial = criar_instantaneo(capacidade);
+    if (!inicial || pthread_mutex_init(&lista->escrita, NULL) != 0) {
+        fprintf(stderr, "Erro ao alocar memória para a lista concorrente\n");
+        if (inicial) {
+            free(inicial->itens);
+            free(inicial);
+        }
+        free(lista);
+        return NULL;
+    }
+
+    lista->proximo_id = 1;
+    if (origem) {
+        for (int i = 0; i < origem->quantidade; i++) {
+            if (!CONTATO_EM(origem, i)->ativo) {
+                continue;
+            }
+            Contato *copia = (Contato*)malloc(sizeof(Contato));
+            if (!copia) {
+                fprintf(stderr, "Erro ao alocar memória para contato\n");
+                break;
+            }
+            *copia = *CONTATO_EM(origem, i);
+            atomic_init(&inicial->itens[inicial->quantidade], copia);
+            inicial->quantidade++;
+            if (copia->id >= lista->proximo_id) {
+                lista->proximo_id = copia->id + 1;
+            }
+        }
+    }
+
+    atomic_init(&lista->atual, inicial);
+    atomic_init(&lista->epoca_global, 1);
+    for (int i = 0; i < MAX_LEITORES; i++) {
+        atomic_init(&lista->leitores[i].epoca, 0);
+        atomic_init(&lista->leitores[i].em_uso, 0);
+    }
+    lista->retirados = NULL;
+    return lista;
+}
+
+// Liberar memória da lista (nenhuma thread pode estar usando a lista)
+void liberar_lista_concorrente(ListaConcorrente *lista) {
+    if (!lista) {
+        return;
+    }
+
+    InstantaneoContatos *atual = atomic_load(&lista->atual);
+    for (int i = 0; i < atual->quantidade; i++) {
+        free(atomic_load_explicit(&atual->itens[i], memory_order_relaxed));
+    }
+    free(atual->itens);
+    free(atual);
+
+    Retirado *retirado = lista->retirados;
+    while (retirado) {
+        Retirado *proximo = retirado->proximo;
+        free(retirado->ptr);
+        free(retirado);
+        retirado = proximo;
+    }
+
+    pthread_mutex_destroy(&lista->escrita);
+    free(lista);
+}
+
+// Copiar a versão atual para uma ListaContatos comum (para salvar_contatos, exportar_csv...)
+ListaContatos* exportar_lista_concorrente(ListaConcorrente *lista) {
+    if (!lista) {
+        return NULL;
+    }
+    ListaContatos *destino = criar_lista();
+    if (!destino) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&lista->escrita);
+    InstantaneoContatos *atual = atomic_load(&lista->atual);
+    if (!reservar_contatos(destino, atual->quantidade)) {
+        pthread_mutex_unlock(&lista->escrita);
+        liberar_lista(destino);
+        return NULL;
+    }
+    for (int i = 0; i < atual->quantidade; i++) {
+        *CONTATO_EM(destino, i) = *atomic_load(&atual->itens[i]);
+    }
+    destino->quantidade = atual->quantidade;
+    pthread_mutex_unlock(&lista->escrita);
+
+    reconstruir_indices(destino);
+    return destino;
+}
+
+// Ocupar um registro de leitor livre
+LeitorConcorrente* registrar_leitor(ListaConcorrente *lista) {
+    if (!lista) {
+        return NULL;
+    }
+    for (int i = 0; i < MAX_LEITORES; i++) {
+        int livre = 0;
+        if (atomic_compare_exchange_strong(&lista->leitores[i].em_uso, &livre, 1)) {
+            atomic_store(&lista->leitores[i].epoca, 0);
+            return &lista->leitores[i];
+        }
+    }
+    fprintf(stderr, "Erro: limite de %d leitores simultâneos atingido\n", MAX_LEITORES);
+    return NULL;
+}
+
+// Devolver o registro (fora de qualquer leitura)
+void remover_leitor(LeitorConcorrente *leitor) {
+    if (leitor) {
+        atomic_store(&leitor->epoca, 0);
+        atomic_store(&leitor->em_uso, 0);
+    }
+}
+
+// Entrar em uma leitura: anunciar a época antes de obter a versão atual
+// Um escritor só libera memória retirada em épocas anteriores a todas as anunciadas
+// (as operações são seq_cst: o anúncio não pode ser reordenado após as leituras)
+const InstantaneoContatos* iniciar_leitura(ListaConcorrente *lista, LeitorConcorrente *leitor) {
+    atomic_store(&leitor->epoca, atomic_load(&lista->epoca_global));
+    return atomic_load(&lista->atual);
+}
+
+// Sair da leitura: ponteiros obtidos deixam de ser válidos
+void finalizar_leitura(LeitorConcorrente *leitor) {
+    atomic_store(&leitor->epoca, 0);
+}
+
+// Buscar contato por ID na versão (busca binária, os IDs são crescentes)
+const Contato* buscar_id_instantaneo(const InstantaneoContatos *instantaneo, int id) {
+    if (!instantaneo) {
+        return NULL;
+    }
+    int inicio = 0;
+    int fim = instantaneo->quantidade - 1;
+    while (inicio <= fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        const Contato *contato = atomic_load(&instantaneo->itens[meio]);
+        if (contato->id == id) {
+            return contato;
+        }
+        if (contato->id < id) {
+            inicio = meio + 1;
+        } else {
+            fim = meio - 1;
+        }
+    }
+    return NULL;
+}
+
+// Buscar IDs cujo nome, telefone ou email contém o termo (mesmo critério de buscar_contatos)
+int buscar_termo_instantaneo(const InstantaneoContatos *instantaneo, const char *termo, int *ids, int max) {
+    if (!instantaneo || !termo || !ids || max <= 0) {
+        return 0;
+    }
+    int encontrados = 0;
+    for (int i = 0; i < instantaneo->quantidade && encontrados < max; i++) {
+        const Contato *contato = atomic_load(&instantaneo->itens[i]);
+        if (strstr(contato->nome, termo) ||
+            strstr(contato->telefone, termo) ||
+            strstr(contato->email, termo)) {
+            ids[encontrados++] = contato->id;
+        }
+    }
+    return encontrados;
+}
+
+// Retirar memória substituída (com o mutex de escrita)
+static void retirar(ListaConcorrente *lista, void *ptr, unsigned long epoca) {
+    Retirado *retirado = (Retirado*)malloc(sizeof(Retirado));
+    if (!retirado) {
+        // Sem como adiar a liberação com segurança: preferir vazar a liberar cedo
+        fprintf(stderr, "Erro ao alocar memória para reclamação\n");
+        return;
+    }
+    retirado->ptr = ptr;
+    retirado->epoca = epoca;
+    retirado->proximo = lista->retirados;
+    lista->retirados = retirado;
+}
+
+// Publicar nova versão e avançar a época; retorna a época em que a anterior foi retirada
+static unsigned long publicar(ListaConcorrente *lista, InstantaneoContatos *nova) {
+    InstantaneoContatos *anterior = atomic_exchange(&lista->atual, nova);
+    unsigned long epoca = atomic_fetch_add(&lista->epoca_global, 1);
+    retirar(lista, anterior, epoca);
+    return epoca;
+}
+
+// Liberar o que foi retirado antes da menor época anunciada pelos leitores
+static void reclamar(ListaConcorrente *lista) {
+    unsigned long minima = atomic_load(&lista->epoca_global);
+    for (int i = 0; i < MAX_LEITORES; i++) {
+        unsigned long epoca = atomic_load(&lista->leitores[i].epoca);
+        if (epoca != 0 && epoca < minima) {
+            minima = epoca;
+        }
+    }
+
+    Retirado **anterior = &lista->retirados;
+    while (*anterior) {
+        Retirado *retirado = *anterior;
+        if (retirado->epoca < minima) {
+            *anterior = retirado->proximo;
+            free(retirado->ptr);
+            free(retirado);
+        } else {
+            anterior = &retirado->proximo;
+        }
+    }
+}
+
+// Posição do ID na versão (com o mutex de escrita), ou -1
+static int posicao_por_id(const InstantaneoContatos *instantaneo, int id) {
+    int inicio = 0;
+    int fim = instantaneo->quantidade - 1;
+    while (inicio <= fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        int atual = atomic_load_explicit(&instantaneo->itens[meio], memory_order_relaxed)->id;
+        if (atual == id) {
+            return meio;
+        }
+        if (atual < id) {
+            inicio = meio + 1;
+        } else {
+            fim = meio - 1;
+        }
+    }
+    return -1;
+}
+
+// Adicionar contato: anexa no array compartilhado se houver espaço (leitores
+// antigos não enxergam além da sua quantidade), senão copia para um array maior
+int adicionar_contato_concorrente(ListaConcorrente *lista, const char *nome, const char *telefone, const char *email) {
+    if (!lista || !nome || !telefone || !email) {
+        return -1;
+    }
+
+    Contato *novo = (Contato*)malloc(sizeof(Contato));
+    if (!novo) {
+        fprintf(stderr, "Erro ao alocar memória para contato\n");
+        return -1;
+    }
+
+    pthread_mutex_lock(&lista->escrita);
+    InstantaneoContatos *atual = atomic_load(&lista->atual);
+    int expandir = atual->quantidade >= atual->capacidade;
+    InstantaneoContatos *nova = (InstantaneoContatos*)malloc(sizeof(InstantaneoContatos));
+    _Atomic(Contato*) *itens = expandir
+        ? (_Atomic(Contato*)*)malloc(atual->capacidade * 2 * sizeof(_Atomic(Contato*)))
+        : atual->itens;
+    if (!nova || !itens) {
+        pthread_mutex_unlock(&lista->escrita);
+        fprintf(stderr, "Erro ao alocar memória para a lista concorrente\n");
+        free(nova);
+        free(novo);
+        return -1;
+    }
+
+    int id = lista->proximo_id++;
+    preencher_contato(novo, id, nome, telefone, email);
+
+    if (expandir) {
+        for (int i = 0; i < atual->quantidade; i++) {
+            atomic_init(&itens[i], atomic_load_explicit(&atual->itens[i], memory_order_relaxed));
+        }
+    }
+    atomic_store(&itens[atual->quantidade], novo);
+    nova->itens = itens;
+    nova->quantidade = atual->quantidade + 1;
+    nova->capacidade = expandir ? atual->capacidade * 2 : atual->capacidade;
+
+    unsigned long epoca = publicar(lista, nova);
+    if (expandir) {
+        retirar(lista, atual->itens, epoca);
+    }
+    reclamar(lista);
+    pthread_mutex_unlock(&lista->escrita);
+    return id;
+}
+
+// Editar contato: cria uma nova versão do contato e troca o ponteiro atomicamente
+// Leitores veem a versão antiga inteira ou a nova inteira, nunca uma mistura
+int editar_contato_concorrente(ListaConcorrente *lista, int id, const char *nome, const char *telefone, const char *email) {
+    if (!lista) {
+        return 0;
+    }
+
+    Contato *nova_versao = (Contato*)malloc(sizeof(Contato));
+    if (!nova_versao) {
+        fprintf(stderr, "Erro ao alocar memória para contato\n");
+        return 0;
+    }
+
+    pthread_mutex_lock(&lista->escrita);
+    InstantaneoContatos *atual = atomic_load(&lista->atual);
+    int posicao = posicao_por_id(atual, id);
+    if (posicao < 0) {
+        pthread_mutex_unlock(&lista->escrita);
+        free(nova_versao);
+        return 0;
+    }
+
+    Contato *antiga = atomic_load_explicit(&atual->itens[posicao], memory_order_relaxed);
+    *nova_versao = *antiga;
+    if (nome && strlen(nome) > 0) {
+        strncpy(nova_versao->nome, nome, MAX_NOME - 1);
+        nova_versao->nome[MAX_NOME - 1] = '\0';
+    }
+    if (telefone && strlen(telefone) > 0) {
+        strncpy(nova_versao->telefone, telefone, MAX_TELEFONE - 1);
+        nova_versao->telefone[MAX_TELEFONE - 1] = '\0';
+    }
+    if (email && strlen(email) > 0) {
+        strncpy(nova_versao->email, email, MAX_EMAIL - 1);
+        nova_versao->email[MAX_EMAIL - 1] = '\0';
+    }
+
+    atomic_store(&atual->itens[posicao], nova_versao);
+    retirar(lista, antiga, atomic_fetch_add(&lista->epoca_global, 1));
+    reclamar(lista);
+    pthread_mutex_unlock(&lista->escrita);
+    return 1;
+}
+
+// Excluir contato: publica um array novo sem o contato (o compartilhado não pode
+// ser deslocado enquanto leitores o percorrem)
+int excluir_contato_concorrente(ListaConcorrente *lista, int id) {
+    if (!lista) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&lista->escrita);
+    InstantaneoContatos *atual = atomic_load(&lista->atual);
+    int posicao = posicao_por_id(atual, id);
+    if (posicao < 0) {
+        pthread_mutex_unlock(&lista->escrita);
+        return 0;
+    }
+
+    InstantaneoContatos *nova = criar_instantaneo(atual->capacidade);
+    if (!nova) {
+        pthread_mutex_unlock(&lista->escrita);
+        fprintf(stderr, "Erro ao alocar memória para a lista concorrente\n");
+        return 0;
+    }
+    for (int i = 0; i < atual->quantidade; i++) {
+        if (i != posicao) {
+            atomic_init(&nova->itens[nova->quantidade++],
+                        atomic_load_explicit(&atual->itens[i], memory_order_relaxed));
+        }
+    }
+
+    Contato *removido = atomic_load_explicit(&atual->itens[posicao], memory_order_relaxed);
+    unsigned long epoca = publicar(lista, nova);
+    retirar(lista, atual->itens, epoca);
+    retirar(lista, removido, epoca);
+    reclamar(lista);
+    pthread_mutex_unlock(&lista->escrita);
+    return 1;
+}
@@ -0,0 +1,63 @@
+#ifndef CONTATO_CONCORRENTE_H
+#define CONTATO_CONCORRENTE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "contato.h"
+
+#define MAX_LEITORES 128
+
+// Versão publicada da lista: array de ponteiros para contatos imutáveis, ordenado por ID
+// Leitores usam a versão sem bloqueio; cada contato nunca muda de endereço (handle estável)
+typedef struct {
+    _Atomic(Contato*) *itens;
+    int quantidade;
+    int capacidade;
+} InstantaneoContatos;
+
+// Registro de um leitor: época anunciada enquanto está dentro de uma leitura (0 = fora)
+typedef struct {
+    atomic_ulong epoca;
+    atomic_int em_uso;
+} LeitorConcorrente;
+
+// Memória substituída por um escritor, liberada quando nenhum leitor pode mais vê-la
+typedef struct Retirado {
+    void *ptr;
+    unsigned long epoca;
+    struct Retirado *proximo;
+} Retirado;
+
+// Lista de contatos para uso por várias threads
+// Leituras: sem bloqueio, estilo RCU com reclamação por épocas
+// Escritas: serializadas por mutex, publicam novas versões com operações atômicas
+typedef struct {
+    _Atomic(InstantaneoContatos*) atual;
+    atomic_ulong epoca_global;
+    LeitorConcorrente leitores[MAX_LEITORES];
+    pthread_mutex_t escrita;
+    Retirado *retirados;
+    int proximo_id;
+} ListaConcorrente;
+
+// Funções de gerenciamento da lista
+ListaConcorrente* criar_lista_concorrente(ListaContatos *origem);
+void liberar_lista_concorrente(ListaConcorrente *lista);
+ListaContatos* exportar_lista_concorrente(ListaConcorrente *lista);
+
+// Leitores: registrar uma vez por thread e envolver cada leitura em iniciar/finalizar
+LeitorConcorrente* registrar_leitor(ListaConcorrente *lista);
+void remover_leitor(LeitorConcorrente *leitor);
+const InstantaneoContatos* iniciar_leitura(ListaConcorrente *lista, LeitorConcorrente *leitor);
+void finalizar_leitura(LeitorConcorrente *leitor);
+
+// Consultas sobre uma versão (ponteiros válidos até finalizar_leitura)
+const Contato* buscar_id_instantaneo(const InstantaneoContatos *instantaneo, int id);
+int buscar_termo_instantaneo(const InstantaneoContatos *instantaneo, const char *termo, int *ids, int max);
+
+// Escritas (serializadas entre si, não bloqueiam leitores)
+int adicionar_contato_concorrente(ListaConcorrente *lista, const char *nome, const char *telefone, const char *email);
+int editar_contato_concorrente(ListaConcorrente *lista, int id, const char *nome, const char *telefone, const char *email);
+int excluir_contato_concorrente(ListaConcorrente *lista, int id);
+
+#endif
@@ -0,0 +1,225 @@
+#include "duplicados.h"
+#include "indice.h"
+#include "utils/string_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LIMITE_PARES_COMPLETOS 32 // Blocos até este tamanho comparam todos os pares
+#define JANELA_VIZINHOS 8         // Blocos maiores comparam só vizinhos ordenados por nome
+
+// Membro de um bloco de candidatos (mesmo email ou mesmo telefone)
+typedef struct {
+    int posicao;
+    char nome[MAX_NOME];
+} MembroBloco;
+
+// Par (grupo, posição) usado para listar os grupos em ordem
+typedef struct {
+    int raiz;
+    int posicao;
+} MembroGrupo;
+
+// Union-find: encontrar representante com compressão de caminho (halving)
+static int encontrar(int *pai, int x) {
+    while (pai[x] != x) {
+        pai[x] = pai[pai[x]];
+        x = pai[x];
+    }
+    return x;
+}
+
+static void unir(int *pai, int a, int b) {
+    int ra = encontrar(pai, a);
+    int rb = encontrar(pai, b);
+    if (ra != rb) {
+        // O menor índice (contato mais antigo) vira o representante
+        if (ra < rb) {
+            pai[rb] = ra;
+        } else {
+            pai[ra] = rb;
+        }
+    }
+}
+
+static int comparar_membros_por_nome(const void *a, const void *b) {
+    return strcmp(((const MembroBloco*)a)->nome, ((const MembroBloco*)b)->nome);
+}
+
+static int comparar_membros_grupo(const void *a, const void *b) {
+    const MembroGrupo *ma = (const MembroGrupo*)a;
+    const MembroGrupo *mb = (const MembroGrupo*)b;
+    if (ma->raiz != mb->raiz) {
+        return ma->raiz - mb->raiz;
+    }
+    return ma->posicao - mb->posicao;
+}
+
+// Comparar nomes apenas dentro de um bloco de candidatos
+static long processar_bloco(ListaContatos *lista, const EntradaIndice *entrada, int *pai, int distancia_maxima) {
+    MembroBloco *membros = (MembroBloco*)malloc(entrada->quantidade * sizeof(MembroBloco));
+    if (!membros) {
+        return 0;
+    }
+
+    int m = 0;
+    for (int i = 0; i < entrada->quantidade; i++) {
+        int posicao = posicao_contato(lista, entrada->ids[i]);
+        if (posicao >= 0 && CONTATO_EM(lista, posicao)->ativo) {
+            membros[m].posicao = posicao;
+            normalizar_nome(CONTATO_EM(lista, posicao)->nome, membros[m].nome, MAX_NOME);
+            m++;
+        }
+    }
+
+    // Blocos grandes (ex: telefone de central compartilhado) usam vizinhança
+    // ordenada para manter o custo linear no tamanho do bloco
+    int janela = m;
+    if (m > LIMITE_PARES_COMPLETOS) {
+        qsort(membros, m, sizeof(MembroBloco), comparar_membros_por_nome);
+        janela = JANELA_VIZINHOS;
+    }
+
+    long comparacoes = 0;
+    for (int i = 0; i < m; i++) {
+        for (int j = i + 1; j < m && j <= i + janela; j++) {
+            if (encontrar(pai, membros[i].posicao) == encontrar(pai, membros[j].posicao)) {
+                continue;
+            }
+            comparacoes++;
+            if (distancia_edicao_limitada(membros[i].nome, membros[j].nome, distancia_maxima) <= distancia_maxima) {
+                unir(pai, membros[i].posicao, membros[j].posicao);
+            }
+        }
+    }
+
+    free(membros);
+    return comparacoes;
+}
+
+// Processar todas as chaves de um índice que agrupam mais de um contato
+static long processar_indice(ListaContatos *lista, IndiceHash *indice, int *pai, int distancia_maxima) {
+    long comparacoes = 0;
+    for (size_t i = 0; i < indice->num_baldes; i++) {
+        for (EntradaIndice *entrada = indice->baldes[i]; entrada; entrada = entrada->proxima) {
+            if (entrada->quantidade > 1) {
+                comparacoes += processar_bloco(lista, entrada, pai, distancia_maxima);
+            }
+        }
+    }
+    return comparacoes;
+}
+
+// Detectar (e opcionalmente mesclar) contatos duplicados
+int detectar_duplicados(ListaContatos *lista, int distancia_maxima, int mesclar) {
+    if (!lista) {
+        return -1;
+    }
+    if (distancia_maxima < 0) {
+        distancia_maxima = DISTANCIA_NOME_PADRAO;
+    }
+
+    int n = lista->quantidade;
+    if (n < 2) {
+        printf("Nenhum contato duplicado encontrado.\n");
+        return 0;
+    }
+
+    int *pai = (int*)malloc(n * sizeof(int));
+    if (!pai) {
+        fprintf(stderr, "Erro ao alocar memória para detecção de duplicados\n");
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        pai[i] = i;
+    }
+
+    // Blocos por email normalizado (índice temporário)
+    IndiceHash *emails = criar_indice_hash((size_t)n);
+    if (!emails) {
+        free(pai);
+        return -1;
+    }
+    char chave[MAX_EMAIL];
+    for (int i = 0; i < n; i++) {
+        Contato *contato = CONTATO_EM(lista, i);
+        if (contato->ativo) {
+            indice_inserir(emails, normalizar_email(contato->email, chave, sizeof(chave)), contato->id);
+        }
+    }
+    long comparacoes = processar_indice(lista, emails, pai, distancia_maxima);
+    liberar_indice_hash(emails);
+
+    // Blocos por telefone normalizado (índice mantido pela lista)
+    comparacoes += processar_indice(lista, lista->indice_telefone, pai, distancia_maxima);
+
+    // Listar grupos com mais de um contato
+    int *tamanho = (int*)calloc(n, sizeof(int));
+    MembroGrupo *membros = (MembroGrupo*)malloc(n * sizeof(MembroGrupo));
+    if (!tamanho || !membros) {
+        fprintf(stderr, "Erro ao alocar memória para detecção de duplicados\n");
+        free(tamanho);
+        free(membros);
+        free(pai);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        tamanho[encontrar(pai, i)]++;
+    }
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        int raiz = encontrar(pai, i);
+        if (tamanho[raiz] > 1) {
+            membros[m].raiz = raiz;
+            membros[m].posicao = i;
+            m++;
+        }
+    }
+    qsort(membros, m, sizeof(MembroGrupo), comparar_membros_grupo);
+
+    int grupos = 0;
+    int duplicados = 0;
+    for (int i = 0; i < m; i++) {
+        Contato *contato = CONTATO_EM(lista, membros[i].posicao);
+        int primeiro = i == 0 || membros[i].raiz != membros[i - 1].raiz;
+        if (primeiro) {
+            grupos++;
+            printf("\nGrupo %d (%d contatos):\n", grupos, tamanho[membros[i].raiz]);
+        } else {
+            duplicados++;
+        }
+        printf("  %s %-5d %-30s %-20s %-30s\n", primeiro ? "*" : " ",
+               contato->id, contato->nome, contato->telefone, contato->email);
+    }
+
+    if (grupos == 0) {
+        printf("Nenhum contato duplicado encontrado.\n");
+    } else {
+        printf("\nTotal: %d grupo(s), %d contato(s) duplicado(s) (* = mantido ao mesclar)\n",
+               grupos, duplicados);
+    }
+    printf("Comparações de nome realizadas: %ld\n", comparacoes);
+
+    // Mesclar: manter o contato mais antigo de cada grupo e remover os demais
+    if (mesclar && duplicados > 0) {
+        // IDs primeiro: uma exclusão pode compactar a lista e mover as posições
+        int *excluir = pai;
+        int num_excluir = 0;
+        for (int i = 1; i < m; i++) {
+            if (membros[i].raiz == membros[i - 1].raiz) {
+                excluir[num_excluir++] = CONTATO_EM(lista, membros[i].posicao)->id;
+            }
+        }
+        int removidos = 0;
+        for (int i = 0; i < num_excluir; i++) {
+            removidos += excluir_contato(lista, excluir[i]);
+        }
+        printf("%d contato(s) duplicado(s) removido(s).\n", removidos);
+    }
+
+    free(tamanho);
+    free(membros);
+    free(pai);
+    return duplicados;
+}
@@ -0,0 +1,13 @@
+#ifndef DUPLICADOS_H
+#define DUPLICADOS_H
+
+#include "contato.h"
+
+#define DISTANCIA_NOME_PADRAO 2
+
+// Detectar contatos duplicados (mesmo email ou telefone e nomes parecidos)
+// Exibe os grupos encontrados; com mesclar != 0 mantém apenas o contato mais
+// antigo de cada grupo. Retorna a quantidade de contatos duplicados (ou -1 em erro).
+int detectar_duplicados(ListaContatos *lista, int distancia_maxima, int mesclar);
+
+#endif
@@ -0,0 +1,1121 @@
+#include "exportacao.h"
+#include "arquivo_blocos.h"
+#include "bloqueio.h"
+#include "ordenacao_externa.h"
+#include "utils/string_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Registro ordenado: chave normalizada calculada uma vez, seguida do contato
+typedef struct {
+    char chave[MAX_EMAIL];
+    Contato contato;
+} RegistroExportacao;
+
+typedef const Contato* (*FonteContatos)(void *fonte);
+
+typedef struct {
+    ListaContatos *lista;
+    int posicao;
+} FonteLista;
+
+static const Contato* proximo_da_lista(void *fonte) {
+    FonteLista *f = (FonteLista*)fonte;
+    if (f->posicao >= f->lista->quantidade) {
+        return NULL;
+    }
+    int posicao = f->posicao++;
+    return CONTATO_EM(f->lista, posicao);
+}
+
+static const Contato* proximo_do_arquivo(void *fonte) {
+    return proximo_contato((LeitorContatos*)fonte);
+}
+
+int ordem_exportacao(const char *campo) {
+    if (!campo) {
+        return -1;
+    }
+    if (strcmp(campo, "id") == 0) {
+        return ORDEM_ID;
+    }
+    if (strcmp(campo, "nome") == 0) {
+        return ORDEM_NOME;
+    }
+    if (strcmp(campo, "email") == 0) {
+        return ORDEM_EMAIL;
+    }
+    return -1;
+}
+
+static int comparar_registros(const void *a, const void *b) {
+    const RegistroExportacao *ra = (const RegistroExportacao*)a;
+    const RegistroExportacao *rb = (const RegistroExportacao*)b;
+    int c = strcmp(ra->chave, rb->chave);
+    if (c != 0) {
+        return c;
+    }
+    // Empates na ordem dos IDs, para a saída ser sempre a mesma
+    return (ra->contato.id > rb->contato.id) - (ra->contato.id < rb->contato.id);
+}
+
+static void escrever_campo_csv(FILE *fp, const char *valor) {
+    putc('"', fp);
+    for (const char *p = valor; *p; p++) {
+        if (*p == '"') {
+            putc('"', fp);
+        }
+        putc(*p, fp);
+    }
+    putc('"', fp);
+}
+
+typedef struct {
+    FILE *fp;
+    const ExtensoesContatos *extensoes; // Colunas extras (NULL = sem atributos)
+} SaidaCsv;
+
+// Uma coluna por atributo que algum contato tem, na ordem das chaves
+static void escrever_cabecalho_csv(const SaidaCsv *saida) {
+    fputs("ID,Nome,Telefone,Email,Status", saida->fp);
+    const ExtensoesContatos *extensoes = saida->extensoes;
+    for (int c = 0; extensoes && c < extensoes->num_chaves; c++) {
+        if (extensoes->usos[c] > 0) {
+            fprintf(saida->fp, ",%s", extensoes->nomes_chaves[c]);
+        }
+    }
+    putc('\n', saida->fp);
+}
+
+// Depois da ordenação os IDs saem fora de ordem: busca binária da faixa do contato
+static void escrever_atributos_csv(const SaidaCsv *saida, int id) {
+    const ExtensoesContatos *extensoes = saida->extensoes;
+    if (!extensoes) {
+        return;
+    }
+    int inicio = 0;
+    int fim = inicio + faixa_extensoes(extensoes, id, &inicio);
+    for (int c = 0; c < extensoes->num_chaves; c++) {
+        if (extensoes->usos[c] == 0) {
+            continue;
+        }
+        putc(',', saida->fp);
+        if (inicio < fim && extensoes->atributos[inicio].chave == c) {
+            escrever_campo_csv(saida->fp, VALOR_EXTENSAO(extensoes, &extensoes->atributos[inicio]));
+            inicio++;
+        }
+    }
+}
+
+static int escrever_linha_csv(const void *registro, void *contexto) {
+    const Contato *contato = &((const RegistroExportacao*)registro)->contato;
+    const SaidaCsv *saida = (const SaidaCsv*)contexto;
+    FILE *fp = saida->fp;
+    fprintf(fp, "%d,", contato->id);
+    escrever_campo_csv(fp, contato->nome);
+    putc(',', fp);
+    escrever_campo_csv(fp, contato->telefone);
+    putc(',', fp);
+    escrever_campo_csv(fp, contato->email);
+    fputs(",Ativo", fp);
+    escrever_atributos_csv(saida, contato->id);
+    return putc('\n', fp) != EOF;
+}
+
+static long exportar_ordenado(FonteContatos proximo, void *fonte, const ExtensoesContatos *extensoes,
+                              const char *arquivo, int ordem, size_t memoria) {
+    if (ordem != ORDEM_ID && ordem != ORDEM_NOME && ordem != ORDEM_EMAIL) {
+        fprintf(stderr, "Erro: ordem de exportação inválida\n");
+        return -1;
+    }
+    FILE *fp = fopen(arquivo, "w");
+    char *buffer = (char*)malloc(TAMANHO_BUFFER_EXPORTACAO);
+    if (!fp || !buffer) {
+        fprintf(stderr, "Erro ao criar arquivo CSV: %s\n", arquivo);
+        if (fp) {
+            fclose(fp);
+        }
+        free(buffer);
+        return -1;
+    }
+    setvbuf(fp, buffer, _IOFBF, TAMANHO_BUFFER_EXPORTACAO);
+    SaidaCsv saida = { fp, extensoes };
+    escrever_cabecalho_csv(&saida);
+
+    OrdenacaoExterna *ordenacao = NULL;
+    if (ordem != ORDEM_ID) {
+        char temporario[600];
+        nome_arquivo_temporario(arquivo, temporario, sizeof(temporario));
+        ordenacao = iniciar_ordenacao_externa(sizeof(RegistroExportacao), comparar_registros, memoria, temporario);
+    }
+
+    // Os contatos já estão em ordem de ID: sem ordenação, saem direto
+    long exportados = 0;
+    int ok = ordem == ORDEM_ID || ordenacao != NULL;
+    RegistroExportacao registro;
+    memset(&registro, 0, sizeof(registro));
+    const Contato *contato;
+    while (ok && (contato = proximo(fonte)) != NULL) {
+        if (!contato->ativo) {
+            continue;
+        }
+        registro.contato = *contato;
+        if (ordem == ORDEM_ID) {
+            ok = escrever_linha_csv(&registro, &saida);
+        } else {
+            if (ordem == ORDEM_NOME) {
+                normalizar_nome(contato->nome, registro.chave, sizeof(registro.chave));
+            } else {
+                normalizar_email(contato->email, registro.chave, sizeof(registro.chave));
+            }
+            ok = acrescentar_registro(ordenacao, &registro);
+        }
+        exportados++;
+    }
+    if (ok && ordenacao) {
+        ok = concluir_ordenacao_externa(ordenacao, escrever_linha_csv, &saida);
+    }
+    liberar_ordenacao_externa(ordenacao);
+
+    ok = fclose(fp) == 0 && ok;
+    free(buffer);
+    if (!ok) {
+        fprintf(stderr, "Erro ao exportar contatos para: %s\n", arquivo);
+        remove(arquivo);
+        return -1;
+    }
+    return exportados;
+}
+
+long exportar_csv_ordenado(ListaContatos *lista, const char *arquivo, int ordem, size_t memoria) {
+    if (!lista || !arquivo) {
+        return -1;
+    }
+    FonteLista fonte = { lista, 0 };
+    return exportar_ordenado(proximo_da_lista, &fonte, lista->extensoes, arquivo, ordem, memoria);
+}
+
+long exportar_arquivo_csv_ordenado(const char *arquivo_contatos, const char *arquivo, int ordem, size_t memoria) {
+    if (!arquivo_contatos || !arquivo) {
+        return -1;
+    }
+    // Os atributos são pequenos perto dos contatos: carregados inteiros
+    ExtensoesContatos *extensoes = NULL;
+    if (!carregar_extensoes(arquivo_contatos, &extensoes)) {
+        return -1;
+    }
+    LeitorContatos *leitor = abrir_leitor_contatos(arquivo_contatos);
+    if (!leitor) {
+        liberar_extensoes(extensoes);
+        return -1;
+    }
+    long exportados = exportar_ordenado(proximo_do_arquivo, leitor, extensoes, arquivo, ordem, memoria);
+    // Um bloco corrompido interrompe a leitura: a exportação ficaria incompleta
+    if (exportados >= 0 && leitor->erro) {
+        remove(arquivo);
+        exportados = -1;
+    }
+    fechar_leitor_contatos(leitor);
+    liberar_extensoes(extensoes);
+    return exportados;
+}
+
+// ==================== NDJSON ====================
+
+#define MAX_LINHA_NDJSON 2048   // Maior objeto exportado: campos escapados com folga
+
+// Saída com buffer próprio: cada contato é formatado direto no buffer, sem stdio por campo
+typedef struct {
+    FILE *fp;
+    char *dados;
+    size_t usado;
+    int ok;
+} SaidaBufferizada;
+
+static void descarregar_saida(SaidaBufferizada *saida) {
+    if (saida->ok && saida->usado > 0 && fwrite(saida->dados, 1, saida->usado, saida->fp) != saida->usado) {
+        saida->ok = 0;
+    }
+    saida->usado = 0;
+}
+
+static char* escrever_literal(char *p, const char *texto) {
+    while (*texto) {
+        *p++ = *texto++;
+    }
+    return p;
+}
+
+static char* escrever_inteiro(char *p, int valor) {
+    char digitos[12];
+    int n = 0;
+    unsigned int v = valor < 0 ? 0u - (unsigned int)valor : (unsigned int)valor;
+    do {
+        digitos[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (valor < 0) {
+        *p++ = '-';
+    }
+    while (n > 0) {
+        *p++ = digitos[--n];
+    }
+    return p;
+}
+
+static char* escrever_texto_json(char *p, const char *texto) {
+    static const char hexa[] = "0123456789abcdef";
+    *p++ = '"';
+    for (const unsigned char *c = (const unsigned char*)texto; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            *p++ = '\\';
+            *p++ = (char)*c;
+        } else if (*c < 0x20) {
+            p = escrever_literal(p, "\\u00");
+            *p++ = hexa[*c >> 4];
+            *p++ = hexa[*c & 0xF];
+        } else {
+            *p++ = (char)*c;
+        }
+    }
+    *p++ = '"';
+    return p;
+}
+
+long exportar_ndjson(ListaContatos *lista, const char *arquivo) {
+    if (!lista || !arquivo) {
+        return -1;
+    }
+    SaidaBufferizada saida = { fopen(arquivo, "wb"), (char*)malloc(TAMANHO_BUFFER_EXPORTACAO), 0, 1 };
+    if (!saida.fp || !saida.dados) {
+        fprintf(stderr, "Erro ao criar arquivo NDJSON: %s\n", arquivo);
+        if (saida.fp) {
+            fclose(saida.fp);
+        }
+        free(saida.dados);
+        return -1;
+    }
+
+    long exportados = 0;
+    for (int i = 0; i < lista->quantidade && saida.ok; i++) {
+        const Contato *contato = CONTATO_EM(lista, i);
+        if (!contato->ativo) {
+            continue;
+        }
+        if (TAMANHO_BUFFER_EXPORTACAO - saida.usado < MAX_LINHA_NDJSON) {
+            descarregar_saida(&saida);
+        }
+        char *p = saida.dados + saida.usado;
+        p = escrever_literal(p, "{\"id\":");
+        p = escrever_inteiro(p, contato->id);
+        p = escrever_literal(p, ",\"nome\":");
+        p = escrever_texto_json(p, contato->nome);
+        p = escrever_literal(p, ",\"telefone\":");
+        p = escrever_texto_json(p, contato->telefone);
+        p = escrever_literal(p, ",\"email\":");
+        p = escrever_texto_json(p, contato->email);
+        p = escrever_literal(p, "}\n");
+        saida.usado = (size_t)(p - saida.dados);
+        exportados++;
+    }
+    descarregar_saida(&saida);
+
+    int ok = fclose(saida.fp) == 0 && saida.ok;
+    free(saida.dados);
+    if (!ok) {
+        fprintf(stderr, "Erro ao exportar contatos para: %s\n", arquivo);
+        remove(arquivo);
+        return -1;
+    }
+    return exportados;
+}
+
+static char* pular_espacos(char *p, const char *fim) {
+    while (p < fim && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        p++;
+    }
+    return p;
+}
+
+static int ler_hexa4(const char *p, const char *fim, unsigned int *valor) {
+    if (fim - p < 4) {
+        return 0;
+    }
+    unsigned int v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9') {
+            v |= (unsigned int)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            v |= (unsigned int)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            v |= (unsigned int)(c - 'A' + 10);
+        } else {
+            return 0;
+        }
+    }
+    *valor = v;
+    return 1;
+}
+
+static char* codificar_utf8(char *p, unsigned int codigo) {
+    if (codigo < 0x80) {
+        *p++ = (char)codigo;
+    } else if (codigo < 0x800) {
+        *p++ = (char)(0xC0 | (codigo >> 6));
+        *p++ = (char)(0x80 | (codigo & 0x3F));
+    } else if (codigo < 0x10000) {
+        *p++ = (char)(0xE0 | (codigo >> 12));
+        *p++ = (char)(0x80 | ((codigo >> 6) & 0x3F));
+        *p++ = (char)(0x80 | (codigo & 0x3F));
+    } else {
+        *p++ = (char)(0xF0 | (codigo >> 18));
+        *p++ = (char)(0x80 | ((codigo >> 12) & 0x3F));
+        *p++ = (char)(0x80 | ((codigo >> 6) & 0x3F));
+        *p++ = (char)(0x80 | (codigo & 0x3F));
+    }
+    return p;
+}
+
+// Texto JSON entre aspas decodificado no próprio buffer (a forma decodificada
+// nunca é maior que a escapada); devolve o início, terminado em '\0', ou NULL
+static char* ler_texto_json(char **cursor, const char *fim) {
+    char *p = *cursor;
+    if (p >= fim || *p != '"') {
+        return NULL;
+    }
+    char *inicio = ++p;
+    char *destino = p;
+    while (p < fim) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"') {
+            *destino = '\0';
+            *cursor = p + 1;
+            return inicio;
+        }
+        if (c < 0x20) {
+            return NULL;
+        }
+        if (c != '\\') {
+            *destino++ = *p++;
+            continue;
+        }
+        if (fim - p < 2) {
+            return NULL;
+        }
+        char escape = p[1];
+        p += 2;
+        switch (escape) {
+            case '"': *destino++ = '"'; break;
+            case '\\': *destino++ = '\\'; break;
+            case '/': *destino++ = '/'; break;
+            case 'b': *destino++ = '\b'; break;
+            case 'f': *destino++ = '\f'; break;
+            case 'n': *destino++ = '\n'; break;
+            case 'r': *destino++ = '\r'; break;
+            case 't': *destino++ = '\t'; break;
+            case 'u': {
+                unsigned int codigo;
+                if (!ler_hexa4(p, fim, &codigo)) {
+                    return NULL;
+                }
+                p += 4;
+                if (codigo >= 0xD800 && codigo <= 0xDBFF) {
+                    // Par substituto: a segunda metade vem em seguida como \uDC00-\uDFFF
+                    unsigned int baixo;
+                    if (fim - p < 6 || p[0] != '\\' || p[1] != 'u' || !ler_hexa4(p + 2, fim, &baixo) ||
+                        baixo < 0xDC00 || baixo > 0xDFFF) {
+                        return NULL;
+                    }
+                    codigo = 0x10000 + ((codigo - 0xD800) << 10) + (baixo - 0xDC00);
+                    p += 6;
+                } else if (codigo >= 0xDC00 && codigo <= 0xDFFF) {
+                    return NULL;
+                }
+                destino = codificar_utf8(destino, codigo);
+                break;
+            }
+            default:
+                return NULL;
+        }
+    }
+    return NULL;
+}
+
+// Pular um valor que não interessa (número, literal, texto, objeto ou lista)
+static int pular_valor_json(char **cursor, const char *fim) {
+    char *p = *cursor;
+    int profundidade = 0;
+    do {
+        p = pular_espacos(p, fim);
+        if (p >= fim) {
+            return 0;
+        }
+        if (*p == '"') {
+            if (!ler_texto_json(&p, fim)) {
+                return 0;
+            }
+        } else if (*p == '{' || *p == '[') {
+            profundidade++;
+            p++;
+        } else if (*p == '}' || *p == ']') {
+            if (profundidade == 0) {
+                return 0;
+            }
+            profundidade--;
+            p++;
+        } else if (profundidade > 0 && (*p == ',' || *p == ':')) {
+            p++;
+        } else {
+            char *inicio = p;
+            while (p < fim && ((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'z') ||
+                               *p == '-' || *p == '+' || *p == '.' || *p == 'E')) {
+                p++;
+            }
+            if (p == inicio) {
+                return 0;
+            }
+        }
+    } while (profundidade > 0);
+    *cursor = p;
+    return 1;
+}
+
+// Analisar um objeto em [p, fim); os campos apontam para o próprio buffer
+static int analisar_objeto_json(char *p, const char *fim, char **nome, char **telefone, char **email) {
+    *nome = *telefone = *email = NULL;
+    p = pular_espacos(p, fim);
+    if (p >= fim || *p != '{') {
+        return 0;
+    }
+    p = pular_espacos(p + 1, fim);
+    if (p < fim && *p == '}') {
+        return pular_espacos(p + 1, fim) == fim;
+    }
+    while (1) {
+        char *chave = ler_texto_json(&p, fim);
+        if (!chave) {
+            return 0;
+        }
+        p = pular_espacos(p, fim);
+        if (p >= fim || *p != ':') {
+            return 0;
+        }
+        p = pular_espacos(p + 1, fim);
+
+        char **campo = NULL;
+        if (strcmp(chave, "nome") == 0) {
+            campo = nome;
+        } else if (strcmp(chave, "telefone") == 0) {
+            campo = telefone;
+        } else if (strcmp(chave, "email") == 0) {
+            campo = email;
+        }
+        if (campo && p < fim && *p == '"') {
+            *campo = ler_texto_json(&p, fim);
+            if (!*campo) {
+                return 0;
+            }
+        } else if (!pular_valor_json(&p, fim)) {
+            return 0;
+        }
+
+        p = pular_espacos(p, fim);
+        if (p < fim && *p == ',') {
+            p = pular_espacos(p + 1, fim);
+            continue;
+        }
+        if (p < fim && *p == '}') {
+            return pular_espacos(p + 1, fim) == fim;
+        }
+        return 0;
+    }
+}
+
+static void rejeitar_linha(ResultadoImportacao *resultado, long numero, const char *motivo) {
+    resultado->rejeitados++;
+    if (resultado->rejeitados <= MAX_ERROS_INFORMADOS) {
+        fprintf(stderr, "Linha %ld: %s\n", numero, motivo);
+    }
+}
+
+// Acrescentar um registro importado; retorna 0 só em erro da lista (falta de memória)
+static int acrescentar_importado(ListaContatos *lista, const char *nome, const char *telefone, const char *email,
+                                 int somente_novos, ResultadoImportacao *resultado) {
+    int id = somente_novos ? adicionar_contato_unico(lista, nome, telefone, email, NULL)
+                           : adicionar_contato(lista, nome, telefone, email);
+    if (id < 0) {
+        return 0;
+    }
+    if (id == 0) {
+        resultado->duplicados++;
+    } else {
+        resultado->importados++;
+    }
+    return 1;
+}
+
+// Retorna 0 só em erro da lista (falta de memória)
+static int importar_linha_ndjson(ListaContatos *lista, char *inicio, char *fim, long numero,
+                                 int somente_novos, ResultadoImportacao *resultado) {
+    if (pular_espacos(inicio, fim) == fim) {
+        return 1;
+    }
+    resultado->registros++;
+    char *nome, *telefone, *email;
+    if (!analisar_objeto_json(inicio, fim, &nome, &telefone, &email)) {
+        rejeitar_linha(resultado, numero, "objeto JSON inválido");
+        return 1;
+    }
+    if (!nome || string_vazia(nome)) {
+        rejeitar_linha(resultado, numero, "contato sem nome");
+        return 1;
+    }
+    return acrescentar_importado(lista, nome, telefone ? telefone : "", email ? email : "",
+                                 somente_novos, resultado);
+}
+
+static long contar_quebras(const char *p, size_t tamanho) {
+    long n = 0;
+    const char *fim = p + tamanho;
+    while ((p = (const char*)memchr(p, '\n', (size_t)(fim - p))) != NULL) {
+        n++;
+        p++;
+    }
+    return n;
+}
+
+int importar_ndjson(ListaContatos *lista, const char *arquivo, int somente_novos, ResultadoImportacao *resultado) {
+    if (!lista || !arquivo || !resultado) {
+        return 0;
+    }
+    memset(resultado, 0, sizeof(*resultado));
+    FILE *fp = fopen(arquivo, "rb");
+    char *buffer = (char*)malloc(TAMANHO_BUFFER_IMPORTACAO);
+    if (!fp || !buffer) {
+        fprintf(stderr, "Erro ao abrir arquivo NDJSON: %s\n", arquivo);
+        if (fp) {
+            fclose(fp);
+        }
+        free(buffer);
+        return 0;
+    }
+
+    size_t usado = 0;           // Linha incompleta do bloco anterior, no início do buffer
+    long numero = 0;
+    int descartando = 0;        // Dentro de uma linha maior que o buffer
+    int inicio_arquivo = 1;
+    int ok = 1;
+    while (ok) {
+        size_t lidos = fread(buffer + usado, 1, TAMANHO_BUFFER_IMPORTACAO - usado, fp);
+        int fim_arquivo = lidos < TAMANHO_BUFFER_IMPORTACAO - usado;
+        if (fim_arquivo && ferror(fp)) {
+            fprintf(stderr, "Erro ao ler arquivo NDJSON: %s\n", arquivo);
+            ok = 0;
+            break;
+        }
+        // Uma linha por contato: reservar antes de inserir
+        long novas = contar_quebras(buffer + usado, lidos) + fim_arquivo;
+        if (!reservar_contatos(lista, lista->quantidade + (int)novas)) {
+            ok = 0;
+            break;
+        }
+
+        char *p = buffer;
+        char *limite = buffer + usado + lidos;
+        if (inicio_arquivo && limite - p >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) {
+            p += 3;             // BOM do UTF-8
+        }
+        inicio_arquivo = 0;
+        char *quebra;
+        while (ok && (quebra = (char*)memchr(p, '\n', (size_t)(limite - p))) != NULL) {
+            numero++;
+            if (descartando) {
+                descartando = 0;
+            } else {
+                ok = importar_linha_ndjson(lista, p, quebra, numero, somente_novos, resultado);
+            }
+            p = quebra + 1;
+        }
+
+        size_t resto = (size_t)(limite - p);
+        if (fim_arquivo) {
+            if (ok && resto > 0 && !descartando) {
+                ok = importar_linha_ndjson(lista, p, limite, ++numero, somente_novos, resultado);
+            }
+            break;
+        }
+        if (resto == TAMANHO_BUFFER_IMPORTACAO) {
+            // Linha maior que o buffer: rejeitada e ignorada até a próxima quebra
+            if (!descartando) {
+                resultado->registros++;
+                rejeitar_linha(resultado, numero + 1, "linha longa demais");
+                descartando = 1;
+            }
+            usado = 0;
+        } else {
+            memmove(buffer, p, resto);
+            usado = resto;
+        }
+    }
+
+    fclose(fp);
+    free(buffer);
+    if (resultado->rejeitados > MAX_ERROS_INFORMADOS) {
+        fprintf(stderr, "... e mais %ld linha(s) rejeitada(s)\n", resultado->rejeitados - MAX_ERROS_INFORMADOS);
+    }
+    return ok;
+}
+
+// ==================== vCard ====================
+
+#define MAX_CARTAO_VCARD 4096       // Maior cartão exportado, com escapes e dobras
+#define LARGURA_LINHA_VCARD 75      // Em bytes, sem o CRLF (RFC 6350, seção 3.2)
+
+static char* escapar_texto_vcard(char *p, const char *valor) {
+    for (const char *c = valor; *c; c++) {
+        if (*c == '\\' || *c == ',' || *c == ';') {
+            *p++ = '\\';
+            *p++ = *c;
+        } else if (*c == '\n') {
+            *p++ = '\\';
+            *p++ = 'n';
+        } else if (*c != '\r') {
+            *p++ = *c;
+        }
+    }
+    return p;
+}
+
+// Copiar a linha para a saída dobrando-a em 75 bytes sem partir caracteres UTF-8
+static char* dobrar_linha_vcard(char *p, const char *linha, const char *fim) {
+    size_t na_linha = 0;
+    while (linha < fim) {
+        unsigned char c = (unsigned char)*linha;
+        size_t largura = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+        if (largura > (size_t)(fim - linha)) {
+            largura = (size_t)(fim - linha);
+        }
+        if (na_linha + largura > LARGURA_LINHA_VCARD) {
+            p = escrever_literal(p, "\r\n ");
+            na_linha = 1;
+        }
+        memcpy(p, linha, largura);
+        p += largura;
+        linha += largura;
+        na_linha += largura;
+    }
+    return escrever_literal(p, "\r\n");
+}
+
+static char* escrever_propriedade_vcard(char *p, const char *propriedade, const char *valor) {
+    char linha[MAX_CARTAO_VCARD / 4];
+    char *fim = escrever_literal(linha, propriedade);
+    fim = escapar_texto_vcard(fim, valor);
+    return dobrar_linha_vcard(p, linha, fim);
+}
+
+// N: sobrenome;nome;nomes adicionais;prefixo;sufixo (a última palavra vira o sobrenome)
+static char* escrever_nome_estruturado(char *p, const char *nome) {
+    char linha[MAX_CARTAO_VCARD / 4];
+    char dados[MAX_NOME];
+    char *fim = escrever_literal(linha, "N:");
+    snprintf(dados, sizeof(dados), "%s", nome);
+    char *espaco = strrchr(dados, ' ');
+    if (espaco) {
+        *espaco = '\0';
+        fim = escapar_texto_vcard(fim, espaco + 1);
+        *fim++ = ';';
+        fim = escapar_texto_vcard(fim, dados);
+    } else {
+        *fim++ = ';';
+        fim = escapar_texto_vcard(fim, dados);
+    }
+    fim = escrever_literal(fim, ";;;");
+    return dobrar_linha_vcard(p, linha, fim);
+}
+
+long exportar_vcard(ListaContatos *lista, const char *arquivo, int versao) {
+    if (!lista || !arquivo) {
+        return -1;
+    }
+    if (versao != 3 && versao != 4) {
+        fprintf(stderr, "Erro: versão de vCard não suportada: %d (use 3 ou 4)\n", versao);
+        return -1;
+    }
+    SaidaBufferizada saida = { fopen(arquivo, "wb"), (char*)malloc(TAMANHO_BUFFER_EXPORTACAO), 0, 1 };
+    if (!saida.fp || !saida.dados) {
+        fprintf(stderr, "Erro ao criar arquivo vCard: %s\n", arquivo);
+        if (saida.fp) {
+            fclose(saida.fp);
+        }
+        free(saida.dados);
+        return -1;
+    }
+
+    long exportados = 0;
+    for (int i = 0; i < lista->quantidade && saida.ok; i++) {
+        const Contato *contato = CONTATO_EM(lista, i);
+        if (!contato->ativo) {
+            continue;
+        }
+        if (TAMANHO_BUFFER_EXPORTACAO - saida.usado < MAX_CARTAO_VCARD) {
+            descarregar_saida(&saida);
+        }
+        char *p = saida.dados + saida.usado;
+        p = escrever_literal(p, versao == 3 ? "BEGIN:VCARD\r\nVERSION:3.0\r\n" : "BEGIN:VCARD\r\nVERSION:4.0\r\n");
+        p = escrever_propriedade_vcard(p, "FN:", contato->nome);
+        p = escrever_nome_estruturado(p, contato->nome);
+        if (contato->telefone[0]) {
+            p = escrever_propriedade_vcard(p, versao == 3 ? "TEL;TYPE=CELL:" : "TEL;VALUE=text;TYPE=cell:",
+                                           contato->telefone);
+        }
+        if (contato->email[0]) {
+            p = escrever_propriedade_vcard(p, versao == 3 ? "EMAIL;TYPE=INTERNET:" : "EMAIL:", contato->email);
+        }
+        p = escrever_literal(p, "END:VCARD\r\n");
+        saida.usado = (size_t)(p - saida.dados);
+        exportados++;
+    }
+    descarregar_saida(&saida);
+
+    int ok = fclose(saida.fp) == 0 && saida.ok;
+    free(saida.dados);
+    if (!ok) {
+        fprintf(stderr, "Erro ao exportar contatos para: %s\n", arquivo);
+        remove(arquivo);
+        return -1;
+    }
+    return exportados;
+}
+
+// Cartão em leitura; os campos são copiados porque um cartão pode atravessar
+// vários blocos lidos (o buffer é reaproveitado)
+typedef struct {
+    int aberto;
+    long linha;                 // Onde o cartão começou, para as mensagens
+    char nome[MAX_NOME];
+    char nome_estruturado[MAX_NOME];
+    char telefone[MAX_TELEFONE];
+    char email[MAX_EMAIL];
+    int telefone_preferido;
+    int email_preferido;
+} CartaoVcard;
+
+static int minuscula(int c) {
+    return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+// Comparações sem diferenciar maiúsculas (nomes de propriedades e parâmetros)
+static int igual_sem_caixa(const char *a, const char *b) {
+    while (*a && minuscula((unsigned char)*a) == minuscula((unsigned char)*b)) {
+        a++;
+        b++;
+    }
+    return *a == '\0' && *b == '\0';
+}
+
+static int comeca_sem_caixa(const char *texto, const char *prefixo) {
+    while (*prefixo && minuscula((unsigned char)*texto) == minuscula((unsigned char)*prefixo)) {
+        texto++;
+        prefixo++;
+    }
+    return *prefixo == '\0';
+}
+
+static int contem_sem_caixa(const char *texto, const char *procurado) {
+    for (; *texto; texto++) {
+        if (comeca_sem_caixa(texto, procurado)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Copiar truncando sem partir um caractere UTF-8
+static void copiar_campo(char *destino, size_t tamanho, const char *origem) {
+    size_t n = strlen(origem);
+    if (n >= tamanho) {
+        n = tamanho - 1;
+        while (n > 0 && ((unsigned char)origem[n] & 0xC0) == 0x80) {
+            n--;
+        }
+    }
+    memcpy(destino, origem, n);
+    destino[n] = '\0';
+}
+
+// Remover os escapes de um valor de texto no lugar (quebras de linha viram espaços)
+static char* desescapar_vcard(char *valor) {
+    char *destino = valor;
+    for (char *c = valor; *c; c++) {
+        if (*c == '\\' && c[1]) {
+            c++;
+            *destino++ = (*c == 'n' || *c == 'N') ? ' ' : *c;
+        } else {
+            *destino++ = *c;
+        }
+    }
+    *destino = '\0';
+    return trim_string(valor);
+}
+
+// N: montar "prefixo nome adicionais sobrenome sufixo" a partir dos componentes
+static void compor_nome_estruturado(char *valor, char *destino, size_t tamanho) {
+    char *componentes[5] = { NULL, NULL, NULL, NULL, NULL };
+    int n = 0;
+    componentes[n++] = valor;
+    for (char *c = valor; *c; c++) {
+        if (*c == '\\' && c[1]) {
+            c++;
+        } else if (*c == ';') {
+            *c = '\0';
+            if (n == 5) {
+                break;
+            }
+            componentes[n++] = c + 1;
+        }
+    }
+    static const int ordem[5] = { 3, 1, 2, 0, 4 };
+    size_t usado = 0;
+    destino[0] = '\0';
+    for (int i = 0; i < 5; i++) {
+        char *parte = componentes[ordem[i]];
+        if (!parte || !*desescapar_vcard(parte)) {
+            continue;
+        }
+        int escritos = snprintf(destino + usado, tamanho - usado, "%s%s", usado > 0 ? " " : "", parte);
+        if (escritos < 0 || (size_t)escritos >= tamanho - usado) {
+            break;
+        }
+        usado += (size_t)escritos;
+    }
+}
+
+// Concluir o cartão aberto; retorna 0 só em erro da lista
+static int concluir_cartao(ListaContatos *lista, CartaoVcard *cartao, int somente_novos,
+                           ResultadoImportacao *resultado) {
+    cartao->aberto = 0;
+    const char *nome = cartao->nome[0] ? cartao->nome : cartao->nome_estruturado;
+    if (!nome[0]) {
+        rejeitar_linha(resultado, cartao->linha, "cartão sem nome (FN ou N)");
+        return 1;
+    }
+    return acrescentar_importado(lista, nome, cartao->telefone, cartao->email, somente_novos, resultado);
+}
+
+// Uma linha lógica (já desdobrada): [grupo.]NOME[;parâmetros]:valor
+static int processar_linha_vcard(ListaContatos *lista, CartaoVcard *cartao, char *linha, long numero,
+                                 int somente_novos, ResultadoImportacao *resultado) {
+    // O nome termina no primeiro ':' fora de aspas (parâmetros podem ter aspas)
+    char *separador = linha;
+    int entre_aspas = 0;
+    while (*separador && (*separador != ':' || entre_aspas)) {
+        if (*separador == '"') {
+            entre_aspas = !entre_aspas;
+        }
+        separador++;
+    }
+    if (!*separador) {
+        return 1;               // Linha sem valor: ignorada
+    }
+    *separador = '\0';
+    char *valor = separador + 1;
+    char *parametros = strchr(linha, ';');
+    if (parametros) {
+        *parametros++ = '\0';
+    } else {
+        parametros = "";
+    }
+    char *ponto = strrchr(linha, '.');
+    char *propriedade = ponto ? ponto + 1 : linha;
+
+    if (igual_sem_caixa(propriedade, "BEGIN")) {
+        if (igual_sem_caixa(trim_string(valor), "VCARD")) {
+            if (cartao->aberto) {
+                rejeitar_linha(resultado, cartao->linha, "cartão sem END:VCARD");
+            }
+            memset(cartao, 0, sizeof(*cartao));
+            cartao->aberto = 1;
+            cartao->linha = numero;
+            resultado->registros++;
+        }
+        return 1;
+    }
+    if (!cartao->aberto) {
+        return 1;
+    }
+    if (igual_sem_caixa(propriedade, "END")) {
+        return concluir_cartao(lista, cartao, somente_novos, resultado);
+    }
+
+    if (igual_sem_caixa(propriedade, "FN")) {
+        copiar_campo(cartao->nome, sizeof(cartao->nome), desescapar_vcard(valor));
+    } else if (igual_sem_caixa(propriedade, "N")) {
+        compor_nome_estruturado(valor, cartao->nome_estruturado, sizeof(cartao->nome_estruturado));
+    } else if (igual_sem_caixa(propriedade, "TEL")) {
+        // O preferido (TYPE=pref no 3.0, PREF=n no 4.0) vence; senão fica o primeiro
+        int preferido = contem_sem_caixa(parametros, "pref");
+        valor = desescapar_vcard(valor);
+        if (comeca_sem_caixa(valor, "tel:")) {
+            valor += 4;
+        }
+        if (*valor && (!cartao->telefone[0] || (preferido && !cartao->telefone_preferido))) {
+            copiar_campo(cartao->telefone, sizeof(cartao->telefone), valor);
+            cartao->telefone_preferido = preferido;
+        }
+    } else if (igual_sem_caixa(propriedade, "EMAIL")) {
+        int preferido = contem_sem_caixa(parametros, "pref");
+        valor = desescapar_vcard(valor);
+        if (*valor && (!cartao->email[0] || (preferido && !cartao->email_preferido))) {
+            copiar_campo(cartao->email, sizeof(cartao->email), valor);
+            cartao->email_preferido = preferido;
+        }
+    }
+    return 1;
+}
+
+// Juntar as continuações (quebra seguida de espaço ou tabulação) no lugar
+static char* desdobrar_linha_vcard(char *inicio, char *fim, long *quebras) {
+    char *destino = inicio;
+    for (char *c = inicio; c < fim; c++) {
+        if (*c == '\r' && c + 1 < fim && c[1] == '\n') {
+            continue;
+        }
+        if (*c == '\n') {
+            (*quebras)++;
+            c++;                // O espaço da continuação
+            continue;
+        }
+        *destino++ = *c;
+    }
+    while (destino > inicio && (destino[-1] == '\r' || destino[-1] == ' ' || destino[-1] == '\t')) {
+        destino--;
+    }
+    *destino = '\0';
+    return inicio;
+}
+
+static long contar_cartoes(const char *p, size_t tamanho, int inicio_de_linha) {
+    long n = 0;
+    const char *fim = p + tamanho;
+    while (p < fim) {
+        if (inicio_de_linha && (size_t)(fim - p) >= 11 && comeca_sem_caixa(p, "BEGIN:VCARD")) {
+            n++;
+        }
+        p = (const char*)memchr(p, '\n', (size_t)(fim - p));
+        if (!p) {
+            break;
+        }
+        p++;
+        inicio_de_linha = 1;
+    }
+    return n;
+}
+
+int importar_vcard(ListaContatos *lista, const char *arquivo, int somente_novos, ResultadoImportacao *resultado) {
+    if (!lista || !arquivo || !resultado) {
+        return 0;
+    }
+    memset(resultado, 0, sizeof(*resultado));
+    FILE *fp = fopen(arquivo, "rb");
+    char *buffer = (char*)malloc(TAMANHO_BUFFER_IMPORTACAO + 1); // + '\0' da última linha
+    if (!fp || !buffer) {
+        fprintf(stderr, "Erro ao abrir arquivo vCard: %s\n", arquivo);
+        if (fp) {
+            fclose(fp);
+        }
+        free(buffer);
+        return 0;
+    }
+
+    CartaoVcard cartao;
+    memset(&cartao, 0, sizeof(cartao));
+    size_t usado = 0;
+    long numero = 0;
+    int descartando = 0;
+    int inicio_arquivo = 1;
+    int ok = 1;
+    while (ok) {
+        size_t lidos = fread(buffer + usado, 1, TAMANHO_BUFFER_IMPORTACAO - usado, fp);
+        int fim_arquivo = lidos < TAMANHO_BUFFER_IMPORTACAO - usado;
+        if (fim_arquivo && ferror(fp)) {
+            fprintf(stderr, "Erro ao ler arquivo vCard: %s\n", arquivo);
+            ok = 0;
+            break;
+        }
+        // Um contato por BEGIN:VCARD: reservar antes de inserir
+        long novos = contar_cartoes(buffer + usado, lidos, usado == 0 || buffer[usado - 1] == '\n');
+        if (novos > 0 && !reservar_contatos(lista, lista->quantidade + (int)novos)) {
+            ok = 0;
+            break;
+        }
+
+        char *p = buffer;
+        char *limite = buffer + usado + lidos;
+        if (inicio_arquivo && limite - p >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) {
+            p += 3;
+        }
+        inicio_arquivo = 0;
+        while (ok && p < limite) {
+            // A linha lógica termina na quebra que não é seguida de espaço ou tabulação;
+            // uma quebra no fim do bloco só é decidida com o próximo bloco
+            char *procura = p;
+            char *quebra;
+            int completa = 0;
+            while ((quebra = (char*)memchr(procura, '\n', (size_t)(limite - procura))) != NULL) {
+                if (quebra + 1 < limite && (quebra[1] == ' ' || quebra[1] == '\t')) {
+                    procura = quebra + 1;
+                    continue;
+                }
+                completa = quebra + 1 < limite || fim_arquivo;
+                break;
+            }
+            if (!quebra && fim_arquivo) {
+                quebra = limite;
+                completa = 1;
+            }
+            if (!completa) {
+                break;
+            }
+            long quebras = 0;
+            desdobrar_linha_vcard(p, quebra, &quebras);
+            numero += 1 + quebras;
+            if (descartando) {
+                descartando = 0;
+            } else if (*p) {
+                ok = processar_linha_vcard(lista, &cartao, p, numero - quebras, somente_novos, resultado);
+            }
+            p = quebra < limite ? quebra + 1 : limite;
+        }
+
+        if (fim_arquivo) {
+            break;
+        }
+        size_t resto = (size_t)(limite - p);
+        if (resto == TAMANHO_BUFFER_IMPORTACAO) {
+            // Linha maior que o buffer (ex.: foto embutida): ignorada até a próxima linha lógica;
+            // o último byte fica para decidir se a linha continua
+            if (!descartando) {
+                fprintf(stderr, "Linha %ld: linha longa demais (ignorada)\n", numero + 1);
+                descartando = 1;
+            }
+            buffer[0] = buffer[TAMANHO_BUFFER_IMPORTACAO - 1];
+            usado = 1;
+        } else {
+            memmove(buffer, p, resto);
+            usado = resto;
+        }
+    }
+    if (ok && cartao.aberto) {
+        rejeitar_linha(resultado, cartao.linha, "cartão sem END:VCARD");
+    }
+
+    fclose(fp);
+    free(buffer);
+    if (resultado->rejeitados > MAX_ERROS_INFORMADOS) {
+        fprintf(stderr, "... e mais %ld cartão(ões) rejeitado(s)\n", resultado->rejeitados - MAX_ERROS_INFORMADOS);
+    }
+    return ok;
+}
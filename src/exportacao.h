@@ -0,0 +1,64 @@
+#ifndef EXPORTACAO_H
+#define EXPORTACAO_H
+
+#include <stddef.h>
+#include "contato.h"
+
+// Formatos de troca de contatos
+//   CSV   - exportação ordenada por nome ou email com memória previsível: ordena
+//           em memória quando os contatos cabem no limite configurado; senão grava
+//           corridas ordenadas em arquivos temporários e as funde (ordenacao_externa.h).
+//           Campos entre aspas com aspas internas duplicadas (RFC 4180); depois
+//           de Status, uma coluna por atributo opcional em uso (extensoes.h)
+//   NDJSON - um objeto JSON por linha: {"id":1,"nome":"...","telefone":"...","email":"..."}
+//   vCard  - cartões 3.0 ou 4.0 (.vcf) com FN/N, TEL e EMAIL; linhas dobradas em 75 bytes
+#define ORDEM_ID 0
+#define ORDEM_NOME 1
+#define ORDEM_EMAIL 2
+
+#define MEMORIA_EXPORTACAO_PADRAO ((size_t)64 * 1024 * 1024)
+#define TAMANHO_BUFFER_EXPORTACAO (1 << 20)   // Buffer de escrita
+
+// "id", "nome" ou "email" (como em --ordenar); -1 se desconhecido
+int ordem_exportacao(const char *campo);
+
+// Exportar os contatos ativos da lista na ordem pedida; retorna quantos foram exportados (-1 em erro)
+long exportar_csv_ordenado(ListaContatos *lista, const char *arquivo, int ordem, size_t memoria);
+
+// Mesmo, lendo um arquivo de contatos bloco a bloco (sem carregá-lo na memória)
+long exportar_arquivo_csv_ordenado(const char *arquivo_contatos, const char *arquivo, int ordem, size_t memoria);
+
+#define ARQUIVO_NDJSON_PADRAO "data/contatos.ndjson"
+#define ARQUIVO_VCARD_PADRAO "data/contatos.vcf"
+
+// Importações acrescentam contatos com IDs novos (o "id" de origem é ignorado)
+// Com somente_novos, registros cujo telefone ou email já existe na lista (ou
+// apareceu antes no mesmo arquivo) são pulados (adicionar_contato_unico)
+#define TAMANHO_BUFFER_IMPORTACAO (4 << 20)   // Também o tamanho máximo de uma linha
+#define MAX_ERROS_INFORMADOS 10               // Linhas rejeitadas informadas individualmente
+
+typedef struct {
+    long registros;             // Linhas não vazias (NDJSON) ou cartões (vCard) lidos
+    long importados;
+    long rejeitados;            // Linhas inválidas, sem nome ou maiores que o buffer
+    long duplicados;            // Pulados por somente_novos
+} ResultadoImportacao;
+
+// Exportar os contatos ativos em NDJSON; retorna quantos foram exportados (-1 em erro)
+long exportar_ndjson(ListaContatos *lista, const char *arquivo);
+
+// Importar NDJSON: leitura em blocos grandes e análise no próprio buffer, sem
+// alocação por linha ou campo; capacidade da lista reservada a cada bloco lido
+// Campos desconhecidos são ignorados; "nome" é obrigatório. Retorna 1 se o
+// arquivo foi lido até o fim (linhas rejeitadas não contam como erro)
+int importar_ndjson(ListaContatos *lista, const char *arquivo, int somente_novos, ResultadoImportacao *resultado);
+
+// Exportar os contatos ativos como vCard na versão 3 (3.0) ou 4 (4.0); retorna quantos (-1 em erro)
+long exportar_vcard(ListaContatos *lista, const char *arquivo, int versao);
+
+// Importar um .vcf (3.0 ou 4.0) em uma passada, com o mesmo buffer da importação
+// NDJSON; cada cartão vira um contato: FN (ou N), o TEL e o EMAIL preferidos
+// (PREF) ou os primeiros. Retorna 1 se o arquivo foi lido até o fim
+int importar_vcard(ListaContatos *lista, const char *arquivo, int somente_novos, ResultadoImportacao *resultado);
+
+#endif
@@ -0,0 +1,455 @@
+#include "extensoes.h"
+#include "bloqueio.h"
+#include "utils/crc32c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ATRIBUTOS_INICIAIS 16
+#define ARENA_INICIAL 1024
+#define LIXO_MINIMO 4096 // Abaixo disso a arena não é compactada
+
+ExtensoesContatos* criar_extensoes(void) {
+    ExtensoesContatos *extensoes = (ExtensoesContatos*)calloc(1, sizeof(ExtensoesContatos));
+    if (!extensoes) {
+        fprintf(stderr, "Erro ao alocar memória para os atributos\n");
+    }
+    return extensoes;
+}
+
+void liberar_extensoes(ExtensoesContatos *extensoes) {
+    if (extensoes) {
+        free(extensoes->atributos);
+        free(extensoes->arena);
+        free(extensoes);
+    }
+}
+
+int normalizar_chave_extensao(const char *chave, char *destino, size_t tamanho) {
+    if (!chave || !destino || tamanho == 0) {
+        return 0;
+    }
+    size_t n = 0;
+    for (const char *p = chave; *p; p++) {
+        char c = *p;
+        if (c >= 'A' && c <= 'Z') {
+            c = (char)(c - 'A' + 'a');
+        }
+        if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_') ||
+            n + 1 >= tamanho || n + 1 >= MAX_CHAVE_EXTENSAO) {
+            destino[0] = '\0';
+            return 0;
+        }
+        destino[n++] = c;
+    }
+    destino[n] = '\0';
+    return n > 0;
+}
+
+int indice_chave_extensao(const ExtensoesContatos *extensoes, const char *chave) {
+    if (!extensoes || !chave) {
+        return -1;
+    }
+    for (int i = 0; i < extensoes->num_chaves; i++) {
+        if (strcmp(extensoes->nomes_chaves[i], chave) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Primeira posição com (id, chave) maior ou igual; *encontrado se é igual
+static int localizar(const ExtensoesContatos *extensoes, int id, int chave, int *encontrado) {
+    int inicio = 0;
+    int fim = extensoes->quantidade;
+    while (inicio < fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        const AtributoExtensao *atributo = &extensoes->atributos[meio];
+        if (atributo->id < id || (atributo->id == id && atributo->chave < chave)) {
+            inicio = meio + 1;
+        } else {
+            fim = meio;
+        }
+    }
+    *encontrado = inicio < extensoes->quantidade && extensoes->atributos[inicio].id == id &&
+                  extensoes->atributos[inicio].chave == chave;
+    return inicio;
+}
+
+// Copiar o valor para o fim da arena; retorna o deslocamento ou -1
+static long acrescentar_valor(ExtensoesContatos *extensoes, const char *valor, size_t tamanho) {
+    if (extensoes->usado + tamanho + 1 > UINT32_MAX) {
+        return -1;
+    }
+    if (extensoes->usado + tamanho + 1 > extensoes->capacidade_arena) {
+        size_t capacidade = extensoes->capacidade_arena > 0 ? extensoes->capacidade_arena : ARENA_INICIAL;
+        while (capacidade < extensoes->usado + tamanho + 1) {
+            capacidade *= 2;
+        }
+        char *arena = (char*)realloc(extensoes->arena, capacidade);
+        if (!arena) {
+            fprintf(stderr, "Erro ao alocar memória para os atributos\n");
+            return -1;
+        }
+        extensoes->arena = arena;
+        extensoes->capacidade_arena = capacidade;
+    }
+    long deslocamento = (long)extensoes->usado;
+    memcpy(extensoes->arena + extensoes->usado, valor, tamanho + 1);
+    extensoes->usado += tamanho + 1;
+    return deslocamento;
+}
+
+static void remover_posicao(ExtensoesContatos *extensoes, int posicao) {
+    AtributoExtensao *atributo = &extensoes->atributos[posicao];
+    extensoes->lixo += atributo->tamanho + 1u;
+    extensoes->usos[atributo->chave]--;
+    memmove(atributo, atributo + 1, (size_t)(extensoes->quantidade - posicao - 1) * sizeof(AtributoExtensao));
+    extensoes->quantidade--;
+}
+
+// Compactar quando mais da metade da arena é lixo
+static void manter_arena(ExtensoesContatos *extensoes) {
+    if (extensoes->lixo > LIXO_MINIMO && extensoes->lixo * 2 > extensoes->usado) {
+        compactar_extensoes(extensoes);
+    }
+}
+
+int definir_extensao(ExtensoesContatos *extensoes, int id, const char *chave, const char *valor) {
+    char nome[MAX_CHAVE_EXTENSAO];
+    if (!extensoes || id <= 0 || !normalizar_chave_extensao(chave, nome, sizeof(nome))) {
+        return 0;
+    }
+    size_t tamanho = valor ? strlen(valor) : 0;
+    if (tamanho >= MAX_VALOR_EXTENSAO) {
+        return 0;
+    }
+
+    int indice = indice_chave_extensao(extensoes, nome);
+    int encontrado = 0;
+    int posicao = indice >= 0 ? localizar(extensoes, id, indice, &encontrado) : 0;
+    if (tamanho == 0) {
+        if (encontrado) {
+            remover_posicao(extensoes, posicao);
+            manter_arena(extensoes);
+        }
+        return 1;
+    }
+
+    if (indice < 0) {
+        if (extensoes->num_chaves >= MAX_CHAVES_EXTENSAO) {
+            fprintf(stderr, "Erro: limite de %d nomes de atributo atingido\n", MAX_CHAVES_EXTENSAO);
+            return 0;
+        }
+        indice = extensoes->num_chaves++;
+        memcpy(extensoes->nomes_chaves[indice], nome, sizeof(nome));
+        posicao = localizar(extensoes, id, indice, &encontrado);
+    }
+    if (!encontrado && extensoes->quantidade == extensoes->capacidade) {
+        int capacidade = extensoes->capacidade > 0 ? extensoes->capacidade * 2 : ATRIBUTOS_INICIAIS;
+        AtributoExtensao *atributos = (AtributoExtensao*)realloc(extensoes->atributos,
+                                                                 (size_t)capacidade * sizeof(AtributoExtensao));
+        if (!atributos) {
+            fprintf(stderr, "Erro ao alocar memória para os atributos\n");
+            return 0;
+        }
+        extensoes->atributos = atributos;
+        extensoes->capacidade = capacidade;
+    }
+
+    // O valor pode vir da própria arena (obter_extensao), que pode ser realocada
+    char copia[MAX_VALOR_EXTENSAO];
+    memcpy(copia, valor, tamanho + 1);
+    long deslocamento = acrescentar_valor(extensoes, copia, tamanho);
+    if (deslocamento < 0) {
+        return 0;
+    }
+
+    AtributoExtensao *atributo = &extensoes->atributos[posicao];
+    if (encontrado) {
+        extensoes->lixo += atributo->tamanho + 1u;
+    } else {
+        memmove(atributo + 1, atributo, (size_t)(extensoes->quantidade - posicao) * sizeof(AtributoExtensao));
+        extensoes->quantidade++;
+        extensoes->usos[indice]++;
+        atributo->id = id;
+        atributo->chave = (uint16_t)indice;
+    }
+    atributo->tamanho = (uint16_t)tamanho;
+    atributo->deslocamento = (uint32_t)deslocamento;
+    manter_arena(extensoes);
+    return 1;
+}
+
+const char* obter_extensao(const ExtensoesContatos *extensoes, int id, const char *chave) {
+    char nome[MAX_CHAVE_EXTENSAO];
+    if (!extensoes || !normalizar_chave_extensao(chave, nome, sizeof(nome))) {
+        return NULL;
+    }
+    int indice = indice_chave_extensao(extensoes, nome);
+    if (indice < 0) {
+        return NULL;
+    }
+    int encontrado;
+    int posicao = localizar(extensoes, id, indice, &encontrado);
+    return encontrado ? VALOR_EXTENSAO(extensoes, &extensoes->atributos[posicao]) : NULL;
+}
+
+int faixa_extensoes(const ExtensoesContatos *extensoes, int id, int *inicio) {
+    if (!extensoes || !inicio) {
+        return 0;
+    }
+    int encontrado;
+    int primeira = localizar(extensoes, id, 0, &encontrado);
+    int ultima = primeira;
+    while (ultima < extensoes->quantidade && extensoes->atributos[ultima].id == id) {
+        ultima++;
+    }
+    *inicio = primeira;
+    return ultima - primeira;
+}
+
+int remover_extensoes_contato(ExtensoesContatos *extensoes, int id) {
+    int inicio;
+    int quantidade = faixa_extensoes(extensoes, id, &inicio);
+    if (quantidade == 0) {
+        return 0;
+    }
+    for (int i = inicio; i < inicio + quantidade; i++) {
+        extensoes->lixo += extensoes->atributos[i].tamanho + 1u;
+        extensoes->usos[extensoes->atributos[i].chave]--;
+    }
+    memmove(&extensoes->atributos[inicio], &extensoes->atributos[inicio + quantidade],
+            (size_t)(extensoes->quantidade - inicio - quantidade) * sizeof(AtributoExtensao));
+    extensoes->quantidade -= quantidade;
+    manter_arena(extensoes);
+    return quantidade;
+}
+
+int podar_extensoes(ExtensoesContatos *extensoes, int (*manter)(void *contexto, int id), void *contexto) {
+    if (!extensoes || !manter) {
+        return 0;
+    }
+    int escrita = 0;
+    int ultimo_id = 0;
+    int manter_ultimo = 0;
+    for (int leitura = 0; leitura < extensoes->quantidade; leitura++) {
+        AtributoExtensao *atributo = &extensoes->atributos[leitura];
+        if (leitura == 0 || atributo->id != ultimo_id) {
+            ultimo_id = atributo->id;
+            manter_ultimo = manter(contexto, ultimo_id);
+        }
+        if (!manter_ultimo) {
+            extensoes->lixo += atributo->tamanho + 1u;
+            extensoes->usos[atributo->chave]--;
+            continue;
+        }
+        if (escrita != leitura) {
+            extensoes->atributos[escrita] = *atributo;
+        }
+        escrita++;
+    }
+    int removidos = extensoes->quantidade - escrita;
+    extensoes->quantidade = escrita;
+    manter_arena(extensoes);
+    return removidos;
+}
+
+int compactar_extensoes(ExtensoesContatos *extensoes) {
+    if (!extensoes) {
+        return 0;
+    }
+    if (extensoes->lixo == 0) {
+        return 1;
+    }
+    size_t tamanho = extensoes->usado - extensoes->lixo;
+    char *arena = (char*)malloc(tamanho > 0 ? tamanho : 1);
+    if (!arena) {
+        return 0; // Continua funcionando, só com o lixo
+    }
+    size_t usado = 0;
+    for (int i = 0; i < extensoes->quantidade; i++) {
+        AtributoExtensao *atributo = &extensoes->atributos[i];
+        memcpy(arena + usado, VALOR_EXTENSAO(extensoes, atributo), atributo->tamanho + 1u);
+        atributo->deslocamento = (uint32_t)usado;
+        usado += atributo->tamanho + 1u;
+    }
+    free(extensoes->arena);
+    extensoes->arena = arena;
+    extensoes->usado = usado;
+    extensoes->capacidade_arena = tamanho > 0 ? tamanho : 1;
+    extensoes->lixo = 0;
+    return 1;
+}
+
+void nome_arquivo_extensoes(const char *arquivo, char *destino, size_t tamanho) {
+    snprintf(destino, tamanho, "%s.ext", arquivo);
+}
+
+// Cópia do atributo com o deslocamento que o valor terá no arquivo
+static AtributoExtensao atributo_gravado(const AtributoExtensao *atributo, size_t deslocamento) {
+    AtributoExtensao copia = *atributo;
+    copia.deslocamento = (uint32_t)deslocamento;
+    return copia;
+}
+
+// Gravado já sem lixo: valores na ordem dos atributos, com os deslocamentos
+// recalculados na cópia. A estrutura não é alterada, então pode ser lida por
+// outras threads durante o salvamento; quem compacta é quem altera (manter_arena)
+int salvar_extensoes(const ExtensoesContatos *extensoes, const char *arquivo) {
+    if (!arquivo) {
+        return 0;
+    }
+
+    char caminho[512];
+    char temporario[520];
+    nome_arquivo_extensoes(arquivo, caminho, sizeof(caminho));
+    if (!extensoes || extensoes->quantidade == 0) {
+        remove(caminho); // Um arquivo antigo traria de volta atributos removidos
+        return 1;
+    }
+    nome_arquivo_temporario(caminho, temporario, sizeof(temporario));
+
+    size_t bytes_chaves = (size_t)extensoes->num_chaves * MAX_CHAVE_EXTENSAO;
+    uint32_t crc = crc32c(0, extensoes->nomes_chaves, bytes_chaves);
+    size_t bytes_valores = 0;
+    for (int i = 0; i < extensoes->quantidade; i++) {
+        AtributoExtensao gravado = atributo_gravado(&extensoes->atributos[i], bytes_valores);
+        crc = crc32c(crc, &gravado, sizeof(gravado));
+        bytes_valores += extensoes->atributos[i].tamanho + 1u;
+    }
+    for (int i = 0; i < extensoes->quantidade; i++) {
+        const AtributoExtensao *atributo = &extensoes->atributos[i];
+        crc = crc32c(crc, VALOR_EXTENSAO(extensoes, atributo), atributo->tamanho + 1u);
+    }
+
+    CabecalhoExtensoes cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, ASSINATURA_EXTENSOES, sizeof(cabecalho.assinatura));
+    cabecalho.versao = VERSAO_EXTENSOES;
+    cabecalho.num_chaves = (uint32_t)extensoes->num_chaves;
+    cabecalho.quantidade = (uint32_t)extensoes->quantidade;
+    cabecalho.bytes_valores = bytes_valores;
+    cabecalho.crc = crc;
+
+    FILE *fp = fopen(temporario, "wb");
+    if (!fp) {
+        fprintf(stderr, "Erro ao abrir arquivo para escrita: %s\n", temporario);
+        return 0;
+    }
+    int ok = fwrite(&cabecalho, sizeof(cabecalho), 1, fp) == 1 &&
+             fwrite(extensoes->nomes_chaves, 1, bytes_chaves, fp) == bytes_chaves;
+    size_t deslocamento = 0;
+    for (int i = 0; ok && i < extensoes->quantidade; i++) {
+        AtributoExtensao gravado = atributo_gravado(&extensoes->atributos[i], deslocamento);
+        ok = fwrite(&gravado, sizeof(gravado), 1, fp) == 1;
+        deslocamento += gravado.tamanho + 1u;
+    }
+    for (int i = 0; ok && i < extensoes->quantidade; i++) {
+        const AtributoExtensao *atributo = &extensoes->atributos[i];
+        ok = fwrite(VALOR_EXTENSAO(extensoes, atributo), 1, atributo->tamanho + 1u, fp) == atributo->tamanho + 1u;
+    }
+    if (!ok || !gravar_em_disco(fp)) {
+        fprintf(stderr, "Erro ao gravar atributos: %s\n", temporario);
+        fclose(fp);
+        remove(temporario);
+        return 0;
+    }
+    fclose(fp);
+    // Diferente do filtro, os atributos não podem ser refeitos: gravados em disco antes de publicar
+    if (rename(temporario, caminho) != 0) {
+        fprintf(stderr, "Erro ao publicar arquivo: %s\n", caminho);
+        remove(temporario);
+        return 0;
+    }
+    return 1;
+}
+
+// Ordem estrita por (id, chave), chaves e valores dentro dos limites
+static int atributos_validos(const ExtensoesContatos *extensoes) {
+    for (int i = 0; i < extensoes->num_chaves; i++) {
+        if (memchr(extensoes->nomes_chaves[i], '\0', MAX_CHAVE_EXTENSAO) == NULL) {
+            return 0;
+        }
+    }
+    for (int i = 0; i < extensoes->quantidade; i++) {
+        const AtributoExtensao *atributo = &extensoes->atributos[i];
+        if (atributo->id <= 0 || atributo->chave >= extensoes->num_chaves ||
+            atributo->tamanho >= MAX_VALOR_EXTENSAO ||
+            (size_t)atributo->deslocamento + atributo->tamanho >= extensoes->usado ||
+            extensoes->arena[atributo->deslocamento + atributo->tamanho] != '\0') {
+            return 0;
+        }
+        if (i > 0) {
+            const AtributoExtensao *anterior = &extensoes->atributos[i - 1];
+            if (anterior->id > atributo->id || (anterior->id == atributo->id && anterior->chave >= atributo->chave)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+int carregar_extensoes(const char *arquivo, ExtensoesContatos **extensoes) {
+    if (!arquivo || !extensoes) {
+        return 0;
+    }
+    *extensoes = NULL;
+
+    char caminho[512];
+    nome_arquivo_extensoes(arquivo, caminho, sizeof(caminho));
+    FILE *fp = fopen(caminho, "rb");
+    if (!fp) {
+        return 1;
+    }
+
+    CabecalhoExtensoes cabecalho;
+    if (fread(&cabecalho, sizeof(cabecalho), 1, fp) != 1 ||
+        memcmp(cabecalho.assinatura, ASSINATURA_EXTENSOES, sizeof(cabecalho.assinatura)) != 0 ||
+        cabecalho.versao != VERSAO_EXTENSOES ||
+        cabecalho.num_chaves > MAX_CHAVES_EXTENSAO ||
+        cabecalho.quantidade > INT32_MAX / sizeof(AtributoExtensao) ||
+        cabecalho.bytes_valores > UINT32_MAX) {
+        fprintf(stderr, "Erro: arquivo de atributos inválido: %s\n", caminho);
+        fclose(fp);
+        return 0;
+    }
+
+    ExtensoesContatos *lidas = criar_extensoes();
+    size_t bytes_chaves = (size_t)cabecalho.num_chaves * MAX_CHAVE_EXTENSAO;
+    size_t bytes_atributos = (size_t)cabecalho.quantidade * sizeof(AtributoExtensao);
+    size_t bytes_valores = (size_t)cabecalho.bytes_valores;
+    if (lidas) {
+        lidas->atributos = (AtributoExtensao*)malloc(bytes_atributos > 0 ? bytes_atributos : 1);
+        lidas->arena = (char*)malloc(bytes_valores > 0 ? bytes_valores : 1);
+    }
+    int ok = lidas && lidas->atributos && lidas->arena &&
+             fread(lidas->nomes_chaves, 1, bytes_chaves, fp) == bytes_chaves &&
+             fread(lidas->atributos, 1, bytes_atributos, fp) == bytes_atributos &&
+             fread(lidas->arena, 1, bytes_valores, fp) == bytes_valores;
+    fclose(fp);
+    if (ok) {
+        uint32_t crc = crc32c(0, lidas->nomes_chaves, bytes_chaves);
+        crc = crc32c(crc, lidas->atributos, bytes_atributos);
+        ok = crc32c(crc, lidas->arena, bytes_valores) == cabecalho.crc;
+    }
+    if (ok) {
+        lidas->num_chaves = (int)cabecalho.num_chaves;
+        lidas->quantidade = (int)cabecalho.quantidade;
+        lidas->capacidade = lidas->quantidade;
+        lidas->usado = bytes_valores;
+        lidas->capacidade_arena = bytes_valores > 0 ? bytes_valores : 1;
+        ok = atributos_validos(lidas);
+    }
+    if (!ok) {
+        fprintf(stderr, "Erro: arquivo de atributos corrompido: %s\n", caminho);
+        liberar_extensoes(lidas);
+        return 0;
+    }
+
+    for (int i = 0; i < lidas->quantidade; i++) {
+        lidas->usos[lidas->atributos[i].chave]++;
+    }
+    *extensoes = lidas;
+    return 1;
+}
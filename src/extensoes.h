@@ -0,0 +1,93 @@
+#ifndef EXTENSOES_H
+#define EXTENSOES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Atributos opcionais dos contatos (empresa, endereço, aniversário, notas...)
+// guardados fora do Contato: só os contatos que os têm pagam por eles
+// Os valores ficam numa arena de texto; um array ordenado por (ID, chave) aponta
+// para eles, então os atributos de um contato são uma faixa contígua (busca
+// binária) e uma varredura em ordem de ID anda junto com a lista de contatos
+#define MAX_CHAVE_EXTENSAO 32    // Nome do atributo (letras minúsculas, dígitos e '_'), com o terminador
+#define MAX_VALOR_EXTENSAO 256   // Valor, com o terminador
+#define MAX_CHAVES_EXTENSAO 64   // Nomes de atributo distintos
+
+// Persistidos em "<arquivo>.ext" junto com o arquivo de contatos
+#define ASSINATURA_EXTENSOES "CEXT"
+#define VERSAO_EXTENSOES 1
+
+typedef struct {
+    int32_t id;
+    uint16_t chave;              // Posição em nomes_chaves
+    uint16_t tamanho;            // Bytes do valor, sem o terminador
+    uint32_t deslocamento;       // Início do valor na arena (terminado em '\0')
+} AtributoExtensao;
+
+typedef struct {
+    AtributoExtensao *atributos; // Ordenados por (id, chave)
+    int quantidade;
+    int capacidade;
+    char *arena;                 // Valores; os substituídos ou removidos viram lixo
+    size_t usado;
+    size_t capacidade_arena;
+    size_t lixo;                 // Bytes que nenhum atributo referencia mais
+    char nomes_chaves[MAX_CHAVES_EXTENSAO][MAX_CHAVE_EXTENSAO];
+    int usos[MAX_CHAVES_EXTENSAO]; // Atributos com cada chave (0 = nenhum contato a usa)
+    int num_chaves;
+} ExtensoesContatos;
+
+typedef struct {
+    char assinatura[4];
+    uint32_t versao;
+    uint32_t num_chaves;
+    uint32_t quantidade;
+    uint64_t bytes_valores;
+    uint32_t crc;                // CRC32C das chaves, dos atributos e dos valores
+    uint32_t reservado;
+} CabecalhoExtensoes;
+
+#define VALOR_EXTENSAO(extensoes, atributo) ((extensoes)->arena + (atributo)->deslocamento)
+
+// Funções de gerenciamento
+ExtensoesContatos* criar_extensoes(void);
+void liberar_extensoes(ExtensoesContatos *extensoes);
+
+// Nome normalizado (minúsculas) em destino; 0 se vazio, longo demais ou com
+// caracteres fora de letras, dígitos e '_'
+int normalizar_chave_extensao(const char *chave, char *destino, size_t tamanho);
+
+// Posição da chave (já normalizada) em nomes_chaves ou -1
+int indice_chave_extensao(const ExtensoesContatos *extensoes, const char *chave);
+
+// Definir o atributo do contato; valor NULL ou vazio remove. Retorna 1 em
+// sucesso, 0 se a chave ou o valor são inválidos ou falta memória
+int definir_extensao(ExtensoesContatos *extensoes, int id, const char *chave, const char *valor);
+const char* obter_extensao(const ExtensoesContatos *extensoes, int id, const char *chave);
+
+// Faixa dos atributos do contato: quantidade e, em *inicio, a primeira posição
+int faixa_extensoes(const ExtensoesContatos *extensoes, int id, int *inicio);
+
+// Remover os atributos de um contato; retorna quantos foram removidos
+int remover_extensoes_contato(ExtensoesContatos *extensoes, int id);
+
+// Manter só os atributos cujo ID manter() aceita, em uma passada com dois ponteiros
+// (exclusões em lote). manter() é chamada em ordem crescente de ID, uma vez por ID
+// Retorna quantos atributos foram removidos
+int podar_extensoes(ExtensoesContatos *extensoes, int (*manter)(void *contexto, int id), void *contexto);
+
+// Reescrever a arena sem lixo
+int compactar_extensoes(ExtensoesContatos *extensoes);
+
+void nome_arquivo_extensoes(const char *arquivo, char *destino, size_t tamanho);
+
+// Gravar os atributos do arquivo de contatos (publicação atômica, sem o lixo da
+// arena e sem alterar a estrutura); sem atributos, o arquivo é removido
+// Retorna 1 em sucesso
+int salvar_extensoes(const ExtensoesContatos *extensoes, const char *arquivo);
+
+// Ler os atributos do arquivo de contatos; *extensoes fica NULL se não há arquivo
+// Retorna 0 se o arquivo existe mas está corrompido (os atributos não são descartados)
+int carregar_extensoes(const char *arquivo, ExtensoesContatos **extensoes);
+
+#endif
@@ -0,0 +1,202 @@
+#include "filtro_bloom.h"
+#include "utils/crc32c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_POSICOES 1024
+#define CONTADOR_SATURADO 15
+
+FiltroBloom* criar_filtro_bloom(long capacidade) {
+    if (capacidade < 1) {
+        capacidade = 1;
+    }
+    uint64_t num_posicoes = MIN_POSICOES;
+    while (num_posicoes < (uint64_t)capacidade * POSICOES_POR_CHAVE) {
+        num_posicoes <<= 1;
+    }
+
+    FiltroBloom *filtro = (FiltroBloom*)calloc(1, sizeof(FiltroBloom));
+    if (!filtro) {
+        fprintf(stderr, "Erro ao alocar memória para o filtro de Bloom\n");
+        return NULL;
+    }
+    filtro->contadores = (uint8_t*)calloc((size_t)(num_posicoes / 2), 1);
+    if (!filtro->contadores) {
+        fprintf(stderr, "Erro ao alocar memória para o filtro de Bloom\n");
+        free(filtro);
+        return NULL;
+    }
+    filtro->num_posicoes = num_posicoes;
+    filtro->num_hashes = NUM_HASHES_FILTRO;
+    // Com a potência de 2 arredondada para cima, cabem mais chaves na mesma taxa
+    filtro->capacidade = (long)(num_posicoes / POSICOES_POR_CHAVE);
+    return filtro;
+}
+
+void liberar_filtro_bloom(FiltroBloom *filtro) {
+    if (filtro) {
+        free(filtro->contadores);
+        free(filtro);
+    }
+}
+
+// Hash duplo: posição i = h1 + i * h2 (h2 ímpar percorre todas as posições)
+static void hashes_chave(const char *chave, uint64_t *h1, uint64_t *h2) {
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a de 64 bits
+    while (*chave) {
+        hash ^= (unsigned char)*chave++;
+        hash *= 1099511628211ULL;
+    }
+    *h1 = hash;
+    // Mistura do splitmix64 para uma segunda sequência independente
+    hash += 0x9E3779B97F4A7C15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+    *h2 = (hash ^ (hash >> 31)) | 1;
+}
+
+static int ler_contador(const FiltroBloom *filtro, uint64_t posicao) {
+    uint8_t byte = filtro->contadores[posicao >> 1];
+    return (posicao & 1) ? byte >> 4 : byte & 0x0F;
+}
+
+static void somar_contador(FiltroBloom *filtro, uint64_t posicao, int delta) {
+    int valor = ler_contador(filtro, posicao);
+    if (valor == CONTADOR_SATURADO || (delta < 0 && valor == 0)) {
+        return;
+    }
+    valor += delta;
+    uint8_t *byte = &filtro->contadores[posicao >> 1];
+    *byte = (posicao & 1) ? (uint8_t)((*byte & 0x0F) | (valor << 4)) : (uint8_t)((*byte & 0xF0) | valor);
+}
+
+static void alterar_chave(FiltroBloom *filtro, const char *chave, int delta) {
+    if (!filtro || !chave || !chave[0]) {
+        return;
+    }
+    uint64_t h1, h2;
+    hashes_chave(chave, &h1, &h2);
+    uint64_t mascara = filtro->num_posicoes - 1;
+    for (int i = 0; i < filtro->num_hashes; i++) {
+        somar_contador(filtro, (h1 + (uint64_t)i * h2) & mascara, delta);
+    }
+    filtro->chaves += delta;
+}
+
+void filtro_bloom_adicionar(FiltroBloom *filtro, const char *chave) {
+    alterar_chave(filtro, chave, 1);
+}
+
+// Remover só chaves que foram adicionadas (senão contadores de outras chaves caem)
+void filtro_bloom_remover(FiltroBloom *filtro, const char *chave) {
+    alterar_chave(filtro, chave, -1);
+}
+
+int filtro_bloom_contem(FiltroBloom *filtro, const char *chave) {
+    if (!filtro || !chave || !chave[0]) {
+        return 0;
+    }
+    filtro->consultas++;
+    uint64_t h1, h2;
+    hashes_chave(chave, &h1, &h2);
+    uint64_t mascara = filtro->num_posicoes - 1;
+    for (int i = 0; i < filtro->num_hashes; i++) {
+        if (ler_contador(filtro, (h1 + (uint64_t)i * h2) & mascara) == 0) {
+            filtro->negativas++;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void nome_arquivo_filtro(const char *arquivo, char *destino, size_t tamanho) {
+    snprintf(destino, tamanho, "%s.filtro", arquivo);
+}
+
+int salvar_filtro_bloom(const FiltroBloom *filtro, const char *arquivo, const AssinaturaArquivo *contatos) {
+    if (!filtro || !arquivo || !contatos) {
+        return 0;
+    }
+
+    char caminho[512];
+    char temporario[520];
+    nome_arquivo_filtro(arquivo, caminho, sizeof(caminho));
+    nome_arquivo_temporario(caminho, temporario, sizeof(temporario));
+
+    CabecalhoFiltro cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, ASSINATURA_FILTRO, sizeof(cabecalho.assinatura));
+    cabecalho.versao = VERSAO_FILTRO;
+    cabecalho.num_hashes = (uint32_t)filtro->num_hashes;
+    cabecalho.num_posicoes = filtro->num_posicoes;
+    cabecalho.chaves = filtro->chaves;
+    cabecalho.capacidade = filtro->capacidade;
+    cabecalho.contatos = *contatos;
+    size_t tamanho = (size_t)(filtro->num_posicoes / 2);
+    cabecalho.crc = crc32c(0, filtro->contadores, tamanho);
+
+    FILE *fp = fopen(temporario, "wb");
+    if (!fp) {
+        fprintf(stderr, "Erro ao abrir arquivo para escrita: %s\n", temporario);
+        return 0;
+    }
+    if (fwrite(&cabecalho, sizeof(cabecalho), 1, fp) != 1 ||
+        fwrite(filtro->contadores, 1, tamanho, fp) != tamanho ||
+        fclose(fp) != 0) {
+        fprintf(stderr, "Erro ao gravar filtro: %s\n", temporario);
+        remove(temporario);
+        return 0;
+    }
+    // Sem fsync: um filtro perdido numa queda só custa uma reconstrução na carga
+    if (rename(temporario, caminho) != 0) {
+        fprintf(stderr, "Erro ao publicar arquivo: %s\n", caminho);
+        remove(temporario);
+        return 0;
+    }
+    return 1;
+}
+
+FiltroBloom* carregar_filtro_bloom(const char *arquivo, const AssinaturaArquivo *contatos) {
+    if (!arquivo || !contatos || !contatos->existe) {
+        return NULL;
+    }
+
+    char caminho[512];
+    nome_arquivo_filtro(arquivo, caminho, sizeof(caminho));
+    FILE *fp = fopen(caminho, "rb");
+    if (!fp) {
+        return NULL;
+    }
+
+    CabecalhoFiltro cabecalho;
+    if (fread(&cabecalho, sizeof(cabecalho), 1, fp) != 1 ||
+        memcmp(cabecalho.assinatura, ASSINATURA_FILTRO, sizeof(cabecalho.assinatura)) != 0 ||
+        cabecalho.versao != VERSAO_FILTRO ||
+        !assinaturas_iguais(&cabecalho.contatos, contatos) ||
+        cabecalho.num_posicoes < MIN_POSICOES ||
+        (cabecalho.num_posicoes & (cabecalho.num_posicoes - 1)) != 0 ||
+        cabecalho.num_hashes == 0 || cabecalho.num_hashes > 32 ||
+        cabecalho.chaves < 0) {
+        fclose(fp);
+        return NULL;
+    }
+
+    FiltroBloom *filtro = (FiltroBloom*)calloc(1, sizeof(FiltroBloom));
+    size_t tamanho = (size_t)(cabecalho.num_posicoes / 2);
+    uint8_t *contadores = (uint8_t*)malloc(tamanho);
+    int ok = filtro && contadores && fread(contadores, 1, tamanho, fp) == tamanho &&
+             crc32c(0, contadores, tamanho) == cabecalho.crc;
+    fclose(fp);
+    if (!ok) {
+        free(contadores);
+        free(filtro);
+        return NULL;
+    }
+    filtro->contadores = contadores;
+    filtro->num_posicoes = cabecalho.num_posicoes;
+    filtro->num_hashes = (int)cabecalho.num_hashes;
+    filtro->chaves = (long)cabecalho.chaves;
+    filtro->capacidade = (long)cabecalho.capacidade;
+    return filtro;
+}
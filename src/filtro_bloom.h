@@ -0,0 +1,60 @@
+#ifndef FILTRO_BLOOM_H
+#define FILTRO_BLOOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bloqueio.h"
+
+// Filtro de Bloom com contadores de 4 bits (permite remover chaves)
+// "Não contém" é sempre exato; "contém" pode ser falso positivo (~1% na capacidade
+// planejada) e precisa ser confirmado. Um contador que chega a 15 fica saturado e
+// nunca mais é decrementado: só aumenta falsos positivos, nunca cria falsos negativos
+#define POSICOES_POR_CHAVE 10
+#define NUM_HASHES_FILTRO 7
+
+// Persistido em "<arquivo>.filtro", válido só para a versão do arquivo de contatos
+// cuja assinatura está no cabeçalho (senão o filtro é reconstruído na carga)
+#define ASSINATURA_FILTRO "CBLM"
+#define VERSAO_FILTRO 1
+
+typedef struct {
+    uint8_t *contadores;         // Duas posições por byte
+    uint64_t num_posicoes;       // Potência de 2
+    int num_hashes;
+    long chaves;                 // Chaves presentes
+    long capacidade;             // Chaves para a taxa de falsos positivos planejada
+    unsigned long consultas;     // Estatísticas desde a criação ou carga
+    unsigned long negativas;     // Respondidas sem confirmação
+    unsigned long falsos_positivos; // Positivos que a confirmação desmentiu (contados por quem confirma)
+} FiltroBloom;
+
+typedef struct {
+    char assinatura[4];
+    uint32_t versao;
+    uint32_t num_hashes;
+    uint32_t crc;                // CRC32C dos contadores
+    uint64_t num_posicoes;
+    int64_t chaves;
+    int64_t capacidade;
+    AssinaturaArquivo contatos;  // Versão do arquivo de contatos descrita pelo filtro
+} CabecalhoFiltro;
+
+// Funções de gerenciamento do filtro
+FiltroBloom* criar_filtro_bloom(long capacidade);
+void liberar_filtro_bloom(FiltroBloom *filtro);
+
+// Operações sobre chaves (strings já normalizadas; vazias são ignoradas)
+void filtro_bloom_adicionar(FiltroBloom *filtro, const char *chave);
+void filtro_bloom_remover(FiltroBloom *filtro, const char *chave);
+int filtro_bloom_contem(FiltroBloom *filtro, const char *chave);
+
+void nome_arquivo_filtro(const char *arquivo, char *destino, size_t tamanho);
+
+// Gravar o filtro do arquivo de contatos (publicação atômica); retorna 1 em sucesso
+int salvar_filtro_bloom(const FiltroBloom *filtro, const char *arquivo, const AssinaturaArquivo *contatos);
+
+// Ler o filtro do arquivo de contatos; NULL se não existe, está corrompido ou
+// descreve outra versão do arquivo de contatos
+FiltroBloom* carregar_filtro_bloom(const char *arquivo, const AssinaturaArquivo *contatos);
+
+#endif
@@ -0,0 +1,573 @@
+#define _POSIX_C_SOURCE 200809L
+#include "gerador.h"
+#include "utils/string_utils.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Gerador pseudoaleatório próprio (splitmix64): rand() muda entre bibliotecas C,
+// e a mesma semente precisa gerar a mesma carga em qualquer máquina
+typedef struct {
+    uint64_t estado;
+} GeradorAleatorio;
+
+static uint64_t proximo_aleatorio(GeradorAleatorio *g) {
+    uint64_t z = (g->estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Inteiro uniforme em [0, n)
+static uint32_t aleatorio_ate(GeradorAleatorio *g, uint32_t n) {
+    return (uint32_t)(((proximo_aleatorio(g) >> 32) * (uint64_t)n) >> 32);
+}
+
+// Real uniforme em [0, 1)
+static double aleatorio_real(GeradorAleatorio *g) {
+    return (double)(proximo_aleatorio(g) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static const char *PRIMEIROS_NOMES[] = {
+    "Maria", "José", "Ana", "João", "Antônio", "Francisco", "Carlos", "Paulo", "Pedro", "Lucas",
+    "Luíza", "Luiz", "Marcos", "Luís", "Gabriel", "Rafael", "Márcia", "Daniel", "Marcelo", "Bruno",
+    "Eduardo", "Felipe", "Raimundo", "Rodrigo", "Fernanda", "Patrícia", "Aline", "Sandra", "Camila", "Amanda",
+    "Bruna", "Jéssica", "Letícia", "Júlia", "Luciana", "Vanessa", "Mariana", "Gabriela", "Vitória", "Larissa",
+    "Cláudia", "Beatriz", "Adriana", "Simone", "Conceição", "Sebastião", "Thaís", "Cecília", "Mônica", "Sérgio",
+    "Fábio", "Vinícius", "Otávio", "Caio", "Flávia", "Débora", "Natália", "Tânia", "Renê", "Inês"
+};
+
+static const char *SOBRENOMES[] = {
+    "Silva", "Santos", "Oliveira", "Souza", "Rodrigues", "Ferreira", "Alves", "Pereira", "Lima", "Gomes",
+    "Costa", "Ribeiro", "Martins", "Carvalho", "Almeida", "Lopes", "Soares", "Fernandes", "Vieira", "Barbosa",
+    "Rocha", "Dias", "Nascimento", "Andrade", "Moreira", "Nunes", "Marques", "Machado", "Mendes", "Freitas",
+    "Cardoso", "Ramos", "Gonçalves", "Santana", "Teixeira", "Araújo", "Brandão", "Conceição", "Magalhães", "Simões",
+    "Assunção", "Guimarães", "Falcão", "Galvão", "Romão", "Leão", "Damião", "Estevão", "Monção", "Aragão"
+};
+
+static const char *PARTICULAS[] = { "da", "de", "do", "dos", "das" };
+
+// Em ordem de popularidade: a posição k recebe peso 1/k^s
+static const char *DOMINIOS[] = {
+    "gmail.com", "hotmail.com", "yahoo.com.br", "outlook.com", "uol.com.br", "bol.com.br", "terra.com.br",
+    "icloud.com", "live.com", "ig.com.br", "globo.com", "msn.com", "r7.com", "yahoo.com", "zipmail.com.br",
+    "usp.br", "unicamp.br", "empresa.com.br", "petrobras.com.br", "itau-unibanco.com.br", "bb.com.br",
+    "correios.com.br", "prefeitura.sp.gov.br", "ufrj.br", "ufmg.br", "sebrae.com.br", "natura.net",
+    "ambev.com.br", "vale.com", "embraer.com.br"
+};
+
+static const char *DDDS[] = {
+    "11", "21", "31", "41", "51", "61", "71", "81", "85", "19", "27", "48", "62", "92", "91",
+    "12", "13", "15", "16", "17", "24", "32", "34", "43", "47", "53", "65", "67", "79", "83", "84", "98"
+};
+
+#define NUM_ELEMENTOS(v) ((int)(sizeof(v) / sizeof((v)[0])))
+#define NUM_FORMATOS_TELEFONE 5
+#define MAX_SUGESTOES_TRACE 5
+
+// Distribuições acumuladas de Zipf para domínios e DDDs
+typedef struct {
+    GeradorAleatorio aleatorio;
+    double acumulado_dominios[NUM_ELEMENTOS(DOMINIOS)];
+    double acumulado_ddds[NUM_ELEMENTOS(DDDS)];
+} ContextoGerador;
+
+static void preparar_zipf(double *acumulado, int n, double expoente) {
+    double soma = 0;
+    for (int k = 0; k < n; k++) {
+        soma += 1.0 / pow(k + 1, expoente);
+        acumulado[k] = soma;
+    }
+    for (int k = 0; k < n; k++) {
+        acumulado[k] /= soma;
+    }
+}
+
+// Primeira posição com acumulado > u (busca binária)
+static int amostrar_zipf(GeradorAleatorio *g, const double *acumulado, int n) {
+    double u = aleatorio_real(g);
+    int inicio = 0;
+    int fim = n - 1;
+    while (inicio < fim) {
+        int meio = (inicio + fim) / 2;
+        if (acumulado[meio] > u) {
+            fim = meio;
+        } else {
+            inicio = meio + 1;
+        }
+    }
+    return inicio;
+}
+
+static void iniciar_contexto(ContextoGerador *contexto, uint64_t semente, double expoente_zipf) {
+    contexto->aleatorio.estado = semente;
+    preparar_zipf(contexto->acumulado_dominios, NUM_ELEMENTOS(DOMINIOS), expoente_zipf);
+    preparar_zipf(contexto->acumulado_ddds, NUM_ELEMENTOS(DDDS), 1.0);
+}
+
+void configuracao_gerador_padrao(ConfiguracaoGerador *configuracao, uint64_t semente) {
+    if (!configuracao) {
+        return;
+    }
+    configuracao->semente = semente;
+    configuracao->taxa_duplicados = TAXA_DUPLICADOS_PADRAO;
+    configuracao->expoente_zipf = EXPOENTE_ZIPF_PADRAO;
+}
+
+// Formatar DDD + número (10 ou 11 dígitos) em um dos formatos comuns
+// Todos têm a mesma forma normalizada, como no cadastro real
+static void formatar_telefone(const char *digitos, int formato, char *destino, size_t tamanho) {
+    size_t len = strlen(digitos);
+    int prefixo = (int)len - 6; // Dígitos do número antes do hífen
+    const char *numero = digitos + 2;
+    switch (formato) {
+        case 0:
+            snprintf(destino, tamanho, "(%.2s) %.*s-%s", digitos, prefixo, numero, numero + prefixo);
+            break;
+        case 1:
+            snprintf(destino, tamanho, "%s", digitos);
+            break;
+        case 2:
+            snprintf(destino, tamanho, "+55 %.2s %.*s-%s", digitos, prefixo, numero, numero + prefixo);
+            break;
+        case 3:
+            snprintf(destino, tamanho, "0%.2s %.*s-%s", digitos, prefixo, numero, numero + prefixo);
+            break;
+        default:
+            snprintf(destino, tamanho, "%.2s-%.*s-%s", digitos, prefixo, numero, numero + prefixo);
+            break;
+    }
+}
+
+static void gerar_telefone(ContextoGerador *contexto, char *destino, size_t tamanho) {
+    GeradorAleatorio *g = &contexto->aleatorio;
+    char digitos[16];
+    const char *ddd = DDDS[amostrar_zipf(g, contexto->acumulado_ddds, NUM_ELEMENTOS(DDDS))];
+    if (aleatorio_ate(g, 100) < 80) {
+        // Celular: 9 + 8 dígitos
+        snprintf(digitos, sizeof(digitos), "%s9%u%07u", ddd, 6 + aleatorio_ate(g, 4), aleatorio_ate(g, 10000000));
+    } else {
+        snprintf(digitos, sizeof(digitos), "%s%u%07u", ddd, 2 + aleatorio_ate(g, 4), aleatorio_ate(g, 10000000));
+    }
+    formatar_telefone(digitos, (int)aleatorio_ate(g, NUM_FORMATOS_TELEFONE), destino, tamanho);
+}
+
+// Email a partir do nome: joao.silva, joaosilva, jsilva, joao_silva85...
+static void gerar_email(ContextoGerador *contexto, const char *nome, char *destino, size_t tamanho) {
+    GeradorAleatorio *g = &contexto->aleatorio;
+    char normalizado[MAX_NOME];
+    normalizar_nome(nome, normalizado, sizeof(normalizado));
+
+    char primeiro[MAX_NOME];
+    const char *espaco = strchr(normalizado, ' ');
+    size_t len_primeiro = espaco ? (size_t)(espaco - normalizado) : strlen(normalizado);
+    memcpy(primeiro, normalizado, len_primeiro);
+    primeiro[len_primeiro] = '\0';
+    const char *ultimo = strrchr(normalizado, ' ');
+    ultimo = ultimo ? ultimo + 1 : normalizado;
+
+    char local[MAX_EMAIL];
+    switch (aleatorio_ate(g, 5)) {
+        case 0: snprintf(local, sizeof(local), "%.40s.%.40s", primeiro, ultimo); break;
+        case 1: snprintf(local, sizeof(local), "%.40s%.40s", primeiro, ultimo); break;
+        case 2: snprintf(local, sizeof(local), "%c%.40s", primeiro[0], ultimo); break;
+        case 3: snprintf(local, sizeof(local), "%.40s_%.40s", primeiro, ultimo); break;
+        default: snprintf(local, sizeof(local), "%.40s", primeiro); break;
+    }
+
+    // Nomes comuns se repetem: metade dos emails leva um número
+    const char *dominio = DOMINIOS[amostrar_zipf(g, contexto->acumulado_dominios, NUM_ELEMENTOS(DOMINIOS))];
+    if (aleatorio_ate(g, 2)) {
+        snprintf(destino, tamanho, "%.60s%u@%s", local, aleatorio_ate(g, 10000), dominio);
+    } else {
+        snprintf(destino, tamanho, "%.60s@%s", local, dominio);
+    }
+}
+
+static void gerar_nome(ContextoGerador *contexto, char *destino, size_t tamanho) {
+    GeradorAleatorio *g = &contexto->aleatorio;
+    // Sobrenomes sorteados com viés para os mais comuns (mínimo de dois sorteios)
+    uint32_t s1 = aleatorio_ate(g, NUM_ELEMENTOS(SOBRENOMES));
+    uint32_t s2 = aleatorio_ate(g, NUM_ELEMENTOS(SOBRENOMES));
+    const char *sobrenome = SOBRENOMES[s1 < s2 ? s1 : s2];
+
+    int len = snprintf(destino, tamanho, "%s", PRIMEIROS_NOMES[aleatorio_ate(g, NUM_ELEMENTOS(PRIMEIROS_NOMES))]);
+    if (aleatorio_ate(g, 100) < 20) {
+        len += snprintf(destino + len, tamanho - len, " %s", PRIMEIROS_NOMES[aleatorio_ate(g, NUM_ELEMENTOS(PRIMEIROS_NOMES))]);
+    }
+    if (aleatorio_ate(g, 100) < 60) {
+        len += snprintf(destino + len, tamanho - len, " %s", SOBRENOMES[aleatorio_ate(g, NUM_ELEMENTOS(SOBRENOMES))]);
+    }
+    if (aleatorio_ate(g, 100) < 15) {
+        len += snprintf(destino + len, tamanho - len, " %s", PARTICULAS[aleatorio_ate(g, NUM_ELEMENTOS(PARTICULAS))]);
+    }
+    snprintf(destino + len, tamanho - len, " %s", sobrenome);
+}
+
+static int eh_particula(const char *palavra, size_t len) {
+    for (int i = 0; i < NUM_ELEMENTOS(PARTICULAS); i++) {
+        if (strlen(PARTICULAS[i]) == len && strncmp(PARTICULAS[i], palavra, len) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Variação do nome de uma pessoa já cadastrada, como aparece em cadastros duplicados
+static void variar_nome(GeradorAleatorio *g, const char *original, char *destino, size_t tamanho) {
+    snprintf(destino, tamanho, "%s", original);
+    size_t len = strlen(destino);
+    switch (aleatorio_ate(g, 4)) {
+        case 0: {
+            // Sem acentos, com iniciais maiúsculas
+            normalizar_nome(original, destino, tamanho);
+            for (char *p = destino; *p; ) {
+                size_t palavra = strcspn(p, " ");
+                if (!eh_particula(p, palavra)) {
+                    *p = (char)toupper((unsigned char)*p);
+                }
+                p += palavra;
+                p += (*p == ' ');
+            }
+            break;
+        }
+        case 1:
+            // Tudo em maiúsculas (só ASCII: os bytes UTF-8 dos acentos ficam como estão)
+            for (char *p = destino; *p; p++) {
+                *p = (char)toupper((unsigned char)*p);
+            }
+            break;
+        case 2:
+            // Erro de digitação: duas letras ASCII vizinhas trocadas
+            for (int tentativa = 0; tentativa < 8 && len > 2; tentativa++) {
+                size_t i = 1 + aleatorio_ate(g, (uint32_t)(len - 2));
+                if (isalpha((unsigned char)destino[i]) && isalpha((unsigned char)destino[i + 1]) &&
+                    destino[i] != destino[i + 1]) {
+                    char c = destino[i];
+                    destino[i] = destino[i + 1];
+                    destino[i + 1] = c;
+                    break;
+                }
+            }
+            break;
+        default: {
+            // Sem o último sobrenome
+            char *ultimo = strrchr(destino, ' ');
+            if (ultimo && strchr(destino, ' ') != ultimo) {
+                *ultimo = '\0';
+            }
+            break;
+        }
+    }
+}
+
+static void variar_email(GeradorAleatorio *g, const char *original, char *destino, size_t tamanho) {
+    snprintf(destino, tamanho, "%s", original);
+    if (aleatorio_ate(g, 100) < 30) {
+        // Mesmo endereço digitado com maiúsculas
+        destino[0] = (char)toupper((unsigned char)destino[0]);
+        for (char *p = strchr(destino, '@'); p && *p; p++) {
+            *p = (char)toupper((unsigned char)*p);
+        }
+    }
+}
+
+long gerar_contatos_realistas(ListaContatos *lista, long quantidade, const ConfiguracaoGerador *configuracao) {
+    if (!lista || quantidade <= 0 || !configuracao) {
+        return -1;
+    }
+    if (quantidade > (long)(INT32_MAX - TAMANHO_SEGMENTO) - lista->quantidade ||
+        !reservar_contatos(lista, lista->quantidade + (int)quantidade)) {
+        fprintf(stderr, "Erro ao reservar memória para %ld contatos\n", quantidade);
+        return -1;
+    }
+
+    ContextoGerador contexto;
+    iniciar_contexto(&contexto, configuracao->semente, configuracao->expoente_zipf);
+    GeradorAleatorio *g = &contexto.aleatorio;
+
+    char nome[MAX_NOME];
+    char telefone[MAX_TELEFONE];
+    char email[MAX_EMAIL];
+    int inicio = lista->quantidade;
+    long gerados = 0;
+    for (; gerados < quantidade; gerados++) {
+        int anteriores = lista->quantidade - inicio;
+        if (anteriores > 0 && aleatorio_real(g) < configuracao->taxa_duplicados) {
+            // A mesma pessoa de novo: nome variado, telefone em outro formato, email igual ou não
+            int posicao = inicio + (int)aleatorio_ate(g, (uint32_t)anteriores);
+            Contato original = *CONTATO_EM(lista, posicao);
+            variar_nome(g, original.nome, nome, sizeof(nome));
+            char digitos[MAX_TELEFONE];
+            normalizar_telefone(original.telefone, digitos, sizeof(digitos));
+            formatar_telefone(digitos, (int)aleatorio_ate(g, NUM_FORMATOS_TELEFONE), telefone, sizeof(telefone));
+            if (aleatorio_ate(g, 100) < 70) {
+                variar_email(g, original.email, email, sizeof(email));
+            } else {
+                gerar_email(&contexto, original.nome, email, sizeof(email));
+            }
+        } else {
+            gerar_nome(&contexto, nome, sizeof(nome));
+            gerar_telefone(&contexto, telefone, sizeof(telefone));
+            gerar_email(&contexto, nome, email, sizeof(email));
+        }
+
+        if (adicionar_contato(lista, nome, telefone, email) < 0) {
+            break;
+        }
+    }
+    return gerados;
+}
+
+int gerar_trace(ListaContatos *lista, const char *arquivo, long operacoes, int percentual_leitura, uint64_t semente) {
+    if (!lista || !arquivo || operacoes < 0) {
+        return 0;
+    }
+
+    // Alvos: posições dos contatos ativos; excluídos pelo trace ficam marcados
+    int *alvos = (int*)malloc((lista->quantidade > 0 ? lista->quantidade : 1) * sizeof(int));
+    char *excluido = (char*)calloc(lista->quantidade > 0 ? lista->quantidade : 1, 1);
+    if (!alvos || !excluido) {
+        fprintf(stderr, "Erro ao alocar memória para o trace\n");
+        free(alvos);
+        free(excluido);
+        return 0;
+    }
+    int num_alvos = 0;
+    for (int i = 0; i < lista->quantidade; i++) {
+        if (CONTATO_EM(lista, i)->ativo) {
+            alvos[num_alvos++] = i;
+        }
+    }
+
+    FILE *fp = fopen(arquivo, "w");
+    if (!fp) {
+        fprintf(stderr, "Erro ao criar trace: %s\n", arquivo);
+        free(alvos);
+        free(excluido);
+        return 0;
+    }
+
+    ContextoGerador contexto;
+    iniciar_contexto(&contexto, semente, EXPOENTE_ZIPF_PADRAO);
+    GeradorAleatorio *g = &contexto.aleatorio;
+
+    char nome[MAX_NOME];
+    char telefone[MAX_TELEFONE];
+    char email[MAX_EMAIL];
+    for (long i = 0; i < operacoes; i++) {
+        const Contato *alvo = NULL;
+        int posicao = -1;
+        if (num_alvos > 0) {
+            posicao = alvos[aleatorio_ate(g, (uint32_t)num_alvos)];
+            alvo = CONTATO_EM(lista, posicao);
+        }
+
+        uint32_t sorteio = aleatorio_ate(g, 100);
+        if ((int)sorteio < percentual_leitura && alvo) {
+            // Leituras: 60% por ID, 30% por telefone (em qualquer formato), 10% por prefixo
+            uint32_t leitura = aleatorio_ate(g, 10);
+            if (leitura < 6) {
+                fprintf(fp, "I\t%d\n", alvo->id);
+            } else if (leitura < 9) {
+                char digitos[MAX_TELEFONE];
+                normalizar_telefone(alvo->telefone, digitos, sizeof(digitos));
+                formatar_telefone(digitos, (int)aleatorio_ate(g, NUM_FORMATOS_TELEFONE), telefone, sizeof(telefone));
+                fprintf(fp, "T\t%s\n", telefone);
+            } else {
+                normalizar_nome(alvo->nome, nome, sizeof(nome));
+                fprintf(fp, "P\t%.3s\n", nome);
+            }
+            continue;
+        }
+
+        // Escritas: 50% adições, 30% edições, 20% exclusões (edição e exclusão só em quem existe)
+        uint32_t escrita = aleatorio_ate(g, 10);
+        if (escrita >= 5 && alvo && !excluido[posicao]) {
+            if (escrita < 8) {
+                gerar_telefone(&contexto, telefone, sizeof(telefone));
+                fprintf(fp, "E\t%d\t%s\n", alvo->id, telefone);
+            } else {
+                fprintf(fp, "X\t%d\n", alvo->id);
+                excluido[posicao] = 1;
+            }
+        } else {
+            gerar_nome(&contexto, nome, sizeof(nome));
+            gerar_telefone(&contexto, telefone, sizeof(telefone));
+            gerar_email(&contexto, nome, email, sizeof(email));
+            fprintf(fp, "A\t%s\t%s\t%s\n", nome, telefone, email);
+        }
+    }
+
+    int ok = fclose(fp) == 0;
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar trace: %s\n", arquivo);
+    }
+    free(alvos);
+    free(excluido);
+    return ok;
+}
+
+// Próximo campo separado por tabulação (terminado no lugar); NULL se não há mais
+static char* proximo_campo(char **cursor) {
+    char *campo = *cursor;
+    if (!campo) {
+        return NULL;
+    }
+    char *tab = strchr(campo, '\t');
+    if (tab) {
+        *tab = '\0';
+        *cursor = tab + 1;
+    } else {
+        *cursor = NULL;
+    }
+    return campo;
+}
+
+static double segundos_desde(const struct timespec *inicio) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double)(agora.tv_sec - inicio->tv_sec) + (agora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+// Executar uma linha do trace; retorna o tipo ou -1 se inválida
+static int executar_operacao(ListaContatos *lista, char *linha, ResultadoTrace *resultado) {
+    if (linha[0] == '\0' || linha[1] != '\t') {
+        return -1;
+    }
+    char *cursor = linha + 2;
+
+    switch (linha[0]) {
+        case 'I': {
+            Contato *contato = buscar_contato_por_id(lista, atoi(cursor));
+            resultado->encontrados += contato && contato->ativo;
+            return TRACE_BUSCA_ID;
+        }
+        case 'T':
+            resultado->encontrados += buscar_contato_por_telefone(lista, cursor) != NULL;
+            return TRACE_BUSCA_TELEFONE;
+        case 'P': {
+            int ids[MAX_SUGESTOES_TRACE];
+            resultado->encontrados += sugerir_contatos(lista, cursor, ids, MAX_SUGESTOES_TRACE) > 0;
+            return TRACE_PREFIXO;
+        }
+        case 'A': {
+            char *nome = proximo_campo(&cursor);
+            char *telefone = proximo_campo(&cursor);
+            char *email = proximo_campo(&cursor);
+            if (!email) {
+                return -1;
+            }
+            resultado->falhas += adicionar_contato(lista, nome, telefone, email) < 0;
+            return TRACE_ADICAO;
+        }
+        case 'E': {
+            char *id = proximo_campo(&cursor);
+            char *telefone = proximo_campo(&cursor);
+            if (!telefone) {
+                return -1;
+            }
+            resultado->falhas += !editar_contato(lista, atoi(id), NULL, telefone, NULL);
+            return TRACE_EDICAO;
+        }
+        case 'X':
+            resultado->falhas += !excluir_contato(lista, atoi(cursor));
+            return TRACE_EXCLUSAO;
+        default:
+            return -1;
+    }
+}
+
+int reproduzir_trace(ListaContatos *lista, const char *arquivo, ResultadoTrace *resultado) {
+    if (!lista || !arquivo || !resultado) {
+        return 0;
+    }
+    memset(resultado, 0, sizeof(*resultado));
+
+    FILE *fp = fopen(arquivo, "rb");
+    if (!fp) {
+        fprintf(stderr, "Erro ao abrir trace: %s\n", arquivo);
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long tamanho = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *conteudo = tamanho >= 0 ? (char*)malloc((size_t)tamanho + 1) : NULL;
+    if (!conteudo || fread(conteudo, 1, (size_t)tamanho, fp) != (size_t)tamanho) {
+        fprintf(stderr, "Erro ao ler trace: %s\n", arquivo);
+        free(conteudo);
+        fclose(fp);
+        return 0;
+    }
+    fclose(fp);
+    conteudo[tamanho] = '\0';
+
+    struct timespec inicio_total;
+    clock_gettime(CLOCK_MONOTONIC, &inicio_total);
+    for (char *linha = conteudo; linha && *linha; ) {
+        char *fim = strchr(linha, '\n');
+        if (fim) {
+            *fim = '\0';
+        }
+
+        struct timespec inicio;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        int tipo = executar_operacao(lista, linha, resultado);
+        if (tipo >= 0) {
+            resultado->segundos[tipo] += segundos_desde(&inicio);
+            resultado->operacoes[tipo]++;
+        } else {
+            resultado->invalidas++;
+        }
+        linha = fim ? fim + 1 : NULL;
+    }
+    resultado->segundos_total = segundos_desde(&inicio_total);
+
+    free(conteudo);
+    return 1;
+}
+
+// Texto alinhado à esquerda em "largura" colunas (printf conta bytes, não caracteres acentuados)
+static void imprimir_coluna(const char *texto, int largura) {
+    int caracteres = 0;
+    for (const unsigned char *p = (const unsigned char*)texto; *p; p++) {
+        caracteres += (*p & 0xC0) != 0x80;
+    }
+    printf("%s%*s", texto, largura > caracteres ? largura - caracteres : 0, "");
+}
+
+void imprimir_resultado_trace(const ResultadoTrace *resultado) {
+    static const char *nomes[NUM_TIPOS_TRACE] = {
+        "Busca por ID", "Busca por telefone", "Autocompletar", "Adição", "Edição", "Exclusão"
+    };
+    if (!resultado) {
+        return;
+    }
+
+    long total = 0;
+    imprimir_coluna("Operação", 20);
+    printf(" %10s %12s ", "Quantidade", "Tempo (ms)");
+    imprimir_coluna("   Operações/s", 14);
+    printf("      µs/op\n");
+    for (int t = 0; t < NUM_TIPOS_TRACE; t++) {
+        long n = resultado->operacoes[t];
+        double s = resultado->segundos[t];
+        total += n;
+        if (n == 0) {
+            continue;
+        }
+        imprimir_coluna(nomes[t], 20);
+        printf(" %10ld %12.2f %14.0f %10.2f\n", n, s * 1000.0,
+               s > 0 ? n / s : 0.0, s * 1e6 / n);
+    }
+    printf("\nTotal: %ld operações em %.3f s (%.0f operações/s)\n", total, resultado->segundos_total,
+           resultado->segundos_total > 0 ? total / resultado->segundos_total : 0.0);
+    printf("Leituras com resultado: %ld | Escritas recusadas: %ld", resultado->encontrados, resultado->falhas);
+    if (resultado->invalidas > 0) {
+        printf(" | Linhas inválidas: %ld", resultado->invalidas);
+    }
+    printf("\n");
+}
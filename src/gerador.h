@@ -0,0 +1,59 @@
+#ifndef GERADOR_H
+#define GERADOR_H
+
+#include <stdint.h>
+#include "contato.h"
+
+// Carga sintética para medições: contatos com distribuições parecidas com as
+// reais (nomes brasileiros acentuados, domínios de email com distribuição de
+// Zipf, telefones em vários formatos, duplicados) e traces de operações
+// mistas de leitura e escrita. Mesma semente = mesmos dados em qualquer máquina
+typedef struct {
+    uint64_t semente;
+    double taxa_duplicados;     // Fração (0 a 1) de contatos que repetem uma pessoa já gerada, com variações
+    double expoente_zipf;       // Concentração dos domínios (1.0 ~ distribuição real de provedores)
+} ConfiguracaoGerador;
+
+#define EXPOENTE_ZIPF_PADRAO 1.1
+#define TAXA_DUPLICADOS_PADRAO 0.05
+
+void configuracao_gerador_padrao(ConfiguracaoGerador *configuracao, uint64_t semente);
+
+// Acrescentar "quantidade" contatos sintéticos; retorna quantos foram gerados (-1 em erro)
+long gerar_contatos_realistas(ListaContatos *lista, long quantidade, const ConfiguracaoGerador *configuracao);
+
+// Trace de operações: uma por linha, campos separados por tabulação
+//   I <id>                       busca por ID
+//   T <telefone>                 busca reversa por telefone
+//   P <prefixo>                  sugestões de autocompletar
+//   A <nome> <telefone> <email>  adição
+//   E <id> <telefone>            edição do telefone
+//   X <id>                       exclusão
+#define TRACE_BUSCA_ID 0
+#define TRACE_BUSCA_TELEFONE 1
+#define TRACE_PREFIXO 2
+#define TRACE_ADICAO 3
+#define TRACE_EDICAO 4
+#define TRACE_EXCLUSAO 5
+#define NUM_TIPOS_TRACE 6
+
+// Gravar um trace com alvos tirados da lista (sem alterá-la); percentual_leitura de 0 a 100
+// Edições e exclusões nunca miram um contato excluído antes no próprio trace
+int gerar_trace(ListaContatos *lista, const char *arquivo, long operacoes, int percentual_leitura, uint64_t semente);
+
+typedef struct {
+    long operacoes[NUM_TIPOS_TRACE];
+    double segundos[NUM_TIPOS_TRACE];
+    long encontrados;           // Leituras que acharam ao menos um contato
+    long falhas;                // Escritas recusadas pela lista
+    long invalidas;             // Linhas que não são operações reconhecidas
+    double segundos_total;
+} ResultadoTrace;
+
+// Reproduzir um trace contra a lista, medindo o tempo de cada tipo de operação
+// O arquivo é lido inteiro antes, então a medição não inclui E/S
+int reproduzir_trace(ListaContatos *lista, const char *arquivo, ResultadoTrace *resultado);
+
+void imprimir_resultado_trace(const ResultadoTrace *resultado);
+
+#endif
@@ -0,0 +1,609 @@
+#include "historico.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Cabeçalho do arquivo de histórico, seguido dos deltas (tipo, campos, id, tamanho, dados)
+typedef struct {
+    char assinatura[4];
+    uint32_t versao;
+    AssinaturaArquivo banco;    // Versão do arquivo de dados a que o histórico se aplica
+    int32_t quantidade;
+    int32_t aplicados;
+} CabecalhoHistorico;
+
+static const int campos_ordem[] = { CAMPO_NOME, CAMPO_TELEFONE, CAMPO_EMAIL };
+static const size_t tamanhos_campo[] = { MAX_NOME, MAX_TELEFONE, MAX_EMAIL };
+
+static char* campo_contato(Contato *contato, int campo) {
+    switch (campo) {
+        case CAMPO_NOME: return contato->nome;
+        case CAMPO_TELEFONE: return contato->telefone;
+        default: return contato->email;
+    }
+}
+
+static int guarda_antes(int tipo) {
+    return tipo != OPERACAO_ADICAO;
+}
+
+static int guarda_depois(int tipo) {
+    return tipo != OPERACAO_EXCLUSAO;
+}
+
+static void liberar_deltas(Historico *historico) {
+    for (int i = 0; i < historico->quantidade; i++) {
+        free(historico->deltas[(historico->inicio + i) % historico->capacidade].dados);
+    }
+    historico->inicio = 0;
+    historico->quantidade = 0;
+    historico->aplicados = 0;
+}
+
+// Descartar o histórico se a lista mudou sem passar por ele
+static void validar_historico(Historico *historico, ListaContatos *lista) {
+    if (historico->geracao != lista->geracao) {
+        liberar_deltas(historico);
+        historico->geracao = lista->geracao;
+    }
+}
+
+Historico* criar_historico(int capacidade, ListaContatos *lista) {
+    if (capacidade <= 0 || !lista) {
+        return NULL;
+    }
+
+    Historico *historico = (Historico*)calloc(1, sizeof(Historico));
+    if (!historico) {
+        fprintf(stderr, "Erro ao alocar memória para o histórico\n");
+        return NULL;
+    }
+    historico->deltas = (DeltaContato*)calloc(capacidade, sizeof(DeltaContato));
+    if (!historico->deltas) {
+        fprintf(stderr, "Erro ao alocar memória para o histórico\n");
+        free(historico);
+        return NULL;
+    }
+    historico->capacidade = capacidade;
+    historico->geracao = lista->geracao;
+    return historico;
+}
+
+void liberar_historico(Historico *historico) {
+    if (!historico) {
+        return;
+    }
+    liberar_deltas(historico);
+    free(historico->deltas);
+    free(historico);
+}
+
+// Texto com 1 byte de tamanho (cabe: campos, chaves e valores têm menos de 256 bytes)
+static unsigned char* escrever_texto(unsigned char *p, const char *texto) {
+    size_t n = strlen(texto);
+    *p++ = (unsigned char)n;
+    memcpy(p, texto, n);
+    return p + n;
+}
+
+// Ler um texto gravado por escrever_texto em destino (com o terminador)
+// NULL se não cabe em destino ou passa do fim dos dados
+static const unsigned char* ler_texto(const unsigned char *p, const unsigned char *fim, char *destino, size_t tamanho) {
+    if (!p || p >= fim || *p >= tamanho || (size_t)(fim - p - 1) < *p) {
+        return NULL;
+    }
+    size_t n = *p++;
+    memcpy(destino, p, n);
+    destino[n] = '\0';
+    return p + n;
+}
+
+// Atributos do contato na forma guardada pela exclusão; com destino NULL, só o tamanho
+static size_t codificar_atributos(const ExtensoesContatos *extensoes, int id, unsigned char *destino) {
+    int inicio;
+    int quantidade = faixa_extensoes(extensoes, id, &inicio);
+    size_t tamanho = 1;
+    unsigned char *p = destino;
+    if (p) {
+        *p++ = (unsigned char)quantidade;
+    }
+    for (int i = inicio; i < inicio + quantidade; i++) {
+        const AtributoExtensao *atributo = &extensoes->atributos[i];
+        const char *chave = extensoes->nomes_chaves[atributo->chave];
+        tamanho += 2 + strlen(chave) + atributo->tamanho;
+        if (p) {
+            p = escrever_texto(p, chave);
+            p = escrever_texto(p, VALOR_EXTENSAO(extensoes, atributo));
+        }
+    }
+    return tamanho;
+}
+
+// Montar o delta com as imagens dos campos indicados, seguidas de "extra"
+// (os atributos, com CAMPO_ATRIBUTOS)
+static int montar_delta(DeltaContato *delta, int tipo, int campos, int id, Contato *antes, Contato *depois,
+                        const unsigned char *extra, size_t tamanho_extra) {
+    size_t tamanho = tamanho_extra;
+    for (int c = 0; c < 3; c++) {
+        if (campos & campos_ordem[c]) {
+            if (guarda_antes(tipo)) {
+                tamanho += 1 + strlen(campo_contato(antes, campos_ordem[c]));
+            }
+            if (guarda_depois(tipo)) {
+                tamanho += 1 + strlen(campo_contato(depois, campos_ordem[c]));
+            }
+        }
+    }
+
+    unsigned char *dados = (unsigned char*)malloc(tamanho > 0 ? tamanho : 1);
+    if (!dados) {
+        return 0;
+    }
+
+    unsigned char *p = dados;
+    for (int c = 0; c < 3; c++) {
+        if (!(campos & campos_ordem[c])) {
+            continue;
+        }
+        for (int imagem = 0; imagem < 2; imagem++) {
+            if ((imagem == 0 && !guarda_antes(tipo)) || (imagem == 1 && !guarda_depois(tipo))) {
+                continue;
+            }
+            p = escrever_texto(p, campo_contato(imagem == 0 ? antes : depois, campos_ordem[c]));
+        }
+    }
+    if (tamanho_extra > 0) {
+        memcpy(p, extra, tamanho_extra);
+    }
+
+    delta->tipo = (uint8_t)tipo;
+    delta->campos = (uint8_t)campos;
+    delta->id = id;
+    delta->tamanho = (uint16_t)tamanho;
+    delta->dados = dados;
+    return 1;
+}
+
+// Reconstruir as imagens antes/depois (campos fora do delta ficam vazios) e, em
+// *atributos (se não for NULL), o início dos atributos
+// Retorna 0 se os dados não correspondem aos campos (arquivo corrompido)
+static int ler_imagens(const DeltaContato *delta, Contato *antes, Contato *depois, const unsigned char **atributos) {
+    memset(antes, 0, sizeof(Contato));
+    memset(depois, 0, sizeof(Contato));
+    antes->id = depois->id = delta->id;
+
+    const unsigned char *p = delta->dados;
+    const unsigned char *fim = delta->dados + delta->tamanho;
+    for (int c = 0; c < 3; c++) {
+        if (!(delta->campos & campos_ordem[c])) {
+            continue;
+        }
+        for (int imagem = 0; imagem < 2; imagem++) {
+            if ((imagem == 0 && !guarda_antes(delta->tipo)) || (imagem == 1 && !guarda_depois(delta->tipo))) {
+                continue;
+            }
+            p = ler_texto(p, fim, campo_contato(imagem == 0 ? antes : depois, campos_ordem[c]), tamanhos_campo[c]);
+            if (!p) {
+                return 0;
+            }
+        }
+    }
+    if (atributos) {
+        *atributos = p;
+    }
+
+    // Atributos só verificados aqui; quem os aplica os lê de novo a partir de *atributos
+    if (delta->tipo == OPERACAO_ATRIBUTO && !(delta->campos & CAMPO_ATRIBUTOS)) {
+        return 0;
+    }
+    if (delta->campos & CAMPO_ATRIBUTOS) {
+        char chave[MAX_CHAVE_EXTENSAO];
+        char valor[MAX_VALOR_EXTENSAO];
+        if (delta->tipo == OPERACAO_ATRIBUTO) {
+            p = ler_texto(p, fim, chave, sizeof(chave));
+            p = ler_texto(p, fim, valor, sizeof(valor));
+            p = ler_texto(p, fim, valor, sizeof(valor));
+        } else if (delta->tipo == OPERACAO_EXCLUSAO && p < fim) {
+            int quantidade = *p++;
+            for (int i = 0; i < quantidade && p; i++) {
+                p = ler_texto(p, fim, chave, sizeof(chave));
+                p = ler_texto(p, fim, valor, sizeof(valor));
+            }
+        } else {
+            return 0;
+        }
+    }
+    return p == fim;
+}
+
+// Acrescentar um delta: descarta os que poderiam ser refeitos e, com o anel cheio, o mais antigo
+static void registrar_delta(Historico *historico, ListaContatos *lista, DeltaContato *delta) {
+    while (historico->quantidade > historico->aplicados) {
+        historico->quantidade--;
+        free(historico->deltas[(historico->inicio + historico->quantidade) % historico->capacidade].dados);
+    }
+    if (historico->quantidade == historico->capacidade) {
+        free(historico->deltas[historico->inicio].dados);
+        historico->inicio = (historico->inicio + 1) % historico->capacidade;
+        historico->quantidade--;
+        historico->aplicados--;
+    }
+
+    historico->deltas[(historico->inicio + historico->quantidade) % historico->capacidade] = *delta;
+    historico->quantidade++;
+    historico->aplicados++;
+    historico->geracao = lista->geracao;
+}
+
+// Registrar a operação recém-aplicada; sem memória para o delta, o histórico é descartado
+static void registrar_operacao(Historico *historico, ListaContatos *lista, int tipo, int campos, int id,
+                               Contato *antes, Contato *depois, const unsigned char *extra, size_t tamanho_extra) {
+    DeltaContato delta;
+    if (montar_delta(&delta, tipo, campos, id, antes, depois, extra, tamanho_extra)) {
+        registrar_delta(historico, lista, &delta);
+    } else {
+        fprintf(stderr, "Aviso: sem memória para o histórico; desfazer indisponível\n");
+        liberar_deltas(historico);
+        historico->geracao = lista->geracao;
+    }
+}
+
+int adicionar_com_historico(Historico *historico, ListaContatos *lista,
+                            const char *nome, const char *telefone, const char *email) {
+    if (!historico) {
+        return adicionar_contato(lista, nome, telefone, email);
+    }
+    validar_historico(historico, lista);
+
+    int id = adicionar_contato(lista, nome, telefone, email);
+    if (id > 0) {
+        Contato depois = *buscar_contato_por_id(lista, id);
+        registrar_operacao(historico, lista, OPERACAO_ADICAO, CAMPO_NOME | CAMPO_TELEFONE | CAMPO_EMAIL,
+                           id, NULL, &depois, NULL, 0);
+    }
+    return id;
+}
+
+int editar_com_historico(Historico *historico, ListaContatos *lista, int id,
+                         const char *nome, const char *telefone, const char *email) {
+    Contato *contato = buscar_contato_por_id(lista, id);
+    if (!historico || !contato) {
+        return editar_contato(lista, id, nome, telefone, email);
+    }
+    validar_historico(historico, lista);
+
+    Contato antes = *contato;
+    if (!editar_contato(lista, id, nome, telefone, email)) {
+        return 0;
+    }
+    Contato depois = *buscar_contato_por_id(lista, id);
+
+    int campos = 0;
+    for (int c = 0; c < 3; c++) {
+        if (strcmp(campo_contato(&antes, campos_ordem[c]), campo_contato(&depois, campos_ordem[c])) != 0) {
+            campos |= campos_ordem[c];
+        }
+    }
+    if (campos) {
+        registrar_operacao(historico, lista, OPERACAO_EDICAO, campos, id, &antes, &depois, NULL, 0);
+    } else {
+        historico->geracao = lista->geracao; // Nada mudou de fato
+    }
+    return 1;
+}
+
+int excluir_com_historico(Historico *historico, ListaContatos *lista, int id) {
+    Contato *contato = buscar_contato_por_id(lista, id);
+    if (!historico || !contato) {
+        return excluir_contato(lista, id);
+    }
+    validar_historico(historico, lista);
+
+    // Atributos guardados antes de a exclusão removê-los, para voltarem ao desfazer
+    Contato antes = *contato;
+    int campos = CAMPO_NOME | CAMPO_TELEFONE | CAMPO_EMAIL;
+    unsigned char *atributos = NULL;
+    size_t tamanho_atributos = 0;
+    int inicio;
+    if (faixa_extensoes(lista->extensoes, id, &inicio) > 0) {
+        tamanho_atributos = codificar_atributos(lista->extensoes, id, NULL);
+        atributos = (unsigned char*)malloc(tamanho_atributos);
+        if (!atributos) {
+            fprintf(stderr, "Erro ao alocar memória para o histórico\n");
+            return 0;
+        }
+        codificar_atributos(lista->extensoes, id, atributos);
+        campos |= CAMPO_ATRIBUTOS;
+    }
+    if (!excluir_contato(lista, id)) {
+        free(atributos);
+        return 0;
+    }
+    registrar_operacao(historico, lista, OPERACAO_EXCLUSAO, campos, id, &antes, NULL, atributos, tamanho_atributos);
+    free(atributos);
+    return 1;
+}
+
+int definir_atributo_com_historico(Historico *historico, ListaContatos *lista, int id,
+                                   const char *chave, const char *valor) {
+    char nome_chave[MAX_CHAVE_EXTENSAO];
+    if (!historico || !lista || !normalizar_chave_extensao(chave, nome_chave, sizeof(nome_chave))) {
+        return definir_atributo(lista, id, chave, valor);
+    }
+    validar_historico(historico, lista);
+
+    const char *atual = obter_atributo(lista, id, nome_chave);
+    char antes[MAX_VALOR_EXTENSAO];
+    snprintf(antes, sizeof(antes), "%s", atual ? atual : "");
+    unsigned long geracao = lista->geracao;
+    if (!definir_atributo(lista, id, nome_chave, valor)) {
+        return 0;
+    }
+    if (lista->geracao == geracao) {
+        return 1; // Mesmo valor: nada a desfazer
+    }
+
+    unsigned char dados[3 + MAX_CHAVE_EXTENSAO + 2 * MAX_VALOR_EXTENSAO];
+    unsigned char *p = escrever_texto(dados, nome_chave);
+    p = escrever_texto(p, antes);
+    p = escrever_texto(p, valor ? valor : "");
+    registrar_operacao(historico, lista, OPERACAO_ATRIBUTO, CAMPO_ATRIBUTOS, id, NULL, NULL,
+                       dados, (size_t)(p - dados));
+    return 1;
+}
+
+// Aplicar os campos de uma imagem ao contato existente
+// editar_contato ignora campos vazios, então um campo que volta a ser vazio
+// exige trocar o registro inteiro (excluir e reinserir com o mesmo ID)
+static int aplicar_imagem(ListaContatos *lista, int id, int campos, Contato *imagem) {
+    Contato *contato = buscar_contato_por_id(lista, id);
+    if (!contato) {
+        return 0;
+    }
+
+    int campo_vazio = 0;
+    for (int c = 0; c < 3; c++) {
+        if ((campos & campos_ordem[c]) && campo_contato(imagem, campos_ordem[c])[0] == '\0') {
+            campo_vazio = 1;
+        }
+    }
+    if (!campo_vazio) {
+        return editar_contato(lista, id,
+                              (campos & CAMPO_NOME) ? imagem->nome : NULL,
+                              (campos & CAMPO_TELEFONE) ? imagem->telefone : NULL,
+                              (campos & CAMPO_EMAIL) ? imagem->email : NULL);
+    }
+
+    Contato completo = *contato;
+    for (int c = 0; c < 3; c++) {
+        if (campos & campos_ordem[c]) {
+            strcpy(campo_contato(&completo, campos_ordem[c]), campo_contato(imagem, campos_ordem[c]));
+        }
+    }
+    return excluir_contato(lista, id) && restaurar_contato(lista, &completo);
+}
+
+// Devolver ao contato restaurado os atributos guardados na exclusão
+static int restaurar_atributos(ListaContatos *lista, const DeltaContato *delta, const unsigned char *p) {
+    if (!(delta->campos & CAMPO_ATRIBUTOS)) {
+        return 1;
+    }
+    const unsigned char *fim = delta->dados + delta->tamanho;
+    char chave[MAX_CHAVE_EXTENSAO];
+    char valor[MAX_VALOR_EXTENSAO];
+    int quantidade = *p++;
+    for (int i = 0; i < quantidade; i++) {
+        p = ler_texto(p, fim, chave, sizeof(chave));
+        p = ler_texto(p, fim, valor, sizeof(valor));
+        if (!p || !definir_atributo(lista, delta->id, chave, valor)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Chave e valores antes/depois de uma operação de atributo
+static int aplicar_atributo(ListaContatos *lista, const DeltaContato *delta, const unsigned char *p, int desfazer) {
+    const unsigned char *fim = delta->dados + delta->tamanho;
+    char chave[MAX_CHAVE_EXTENSAO];
+    char antes[MAX_VALOR_EXTENSAO];
+    char depois[MAX_VALOR_EXTENSAO];
+    p = ler_texto(p, fim, chave, sizeof(chave));
+    p = ler_texto(p, fim, antes, sizeof(antes));
+    p = ler_texto(p, fim, depois, sizeof(depois));
+    return p && definir_atributo(lista, delta->id, chave, desfazer ? antes : depois);
+}
+
+// Aplicar um delta no sentido pedido (desfazer = voltar à imagem antes)
+static int aplicar_delta(ListaContatos *lista, const DeltaContato *delta, int desfazer) {
+    Contato antes, depois;
+    const unsigned char *atributos;
+    if (!ler_imagens(delta, &antes, &depois, &atributos)) {
+        return 0;
+    }
+
+    switch (delta->tipo) {
+        case OPERACAO_ADICAO:
+            return desfazer ? excluir_contato(lista, delta->id) : restaurar_contato(lista, &depois);
+        case OPERACAO_EXCLUSAO:
+            if (!desfazer) {
+                return excluir_contato(lista, delta->id);
+            }
+            return restaurar_contato(lista, &antes) && restaurar_atributos(lista, delta, atributos);
+        case OPERACAO_EDICAO:
+            return aplicar_imagem(lista, delta->id, delta->campos, desfazer ? &antes : &depois);
+        case OPERACAO_ATRIBUTO:
+            return aplicar_atributo(lista, delta, atributos, desfazer);
+        default:
+            return 0;
+    }
+}
+
+const DeltaContato* desfazer_operacao(Historico *historico, ListaContatos *lista) {
+    if (!historico || !lista) {
+        return NULL;
+    }
+    validar_historico(historico, lista);
+    if (historico->aplicados == 0) {
+        return NULL;
+    }
+
+    const DeltaContato *delta = &historico->deltas[(historico->inicio + historico->aplicados - 1) % historico->capacidade];
+    if (!aplicar_delta(lista, delta, 1)) {
+        fprintf(stderr, "Erro ao desfazer operação no contato %d; histórico descartado\n", delta->id);
+        liberar_deltas(historico);
+        historico->geracao = lista->geracao;
+        return NULL;
+    }
+    historico->aplicados--;
+    historico->geracao = lista->geracao;
+    return delta;
+}
+
+const DeltaContato* refazer_operacao(Historico *historico, ListaContatos *lista) {
+    if (!historico || !lista) {
+        return NULL;
+    }
+    validar_historico(historico, lista);
+    if (historico->aplicados == historico->quantidade) {
+        return NULL;
+    }
+
+    const DeltaContato *delta = &historico->deltas[(historico->inicio + historico->aplicados) % historico->capacidade];
+    if (!aplicar_delta(lista, delta, 0)) {
+        fprintf(stderr, "Erro ao refazer operação no contato %d; histórico descartado\n", delta->id);
+        liberar_deltas(historico);
+        historico->geracao = lista->geracao;
+        return NULL;
+    }
+    historico->aplicados++;
+    historico->geracao = lista->geracao;
+    return delta;
+}
+
+int operacoes_para_desfazer(Historico *historico, ListaContatos *lista) {
+    if (!historico || !lista) {
+        return 0;
+    }
+    validar_historico(historico, lista);
+    return historico->aplicados;
+}
+
+int operacoes_para_refazer(Historico *historico, ListaContatos *lista) {
+    if (!historico || !lista) {
+        return 0;
+    }
+    validar_historico(historico, lista);
+    return historico->quantidade - historico->aplicados;
+}
+
+const char* nome_operacao(int tipo) {
+    switch (tipo) {
+        case OPERACAO_ADICAO: return "adição";
+        case OPERACAO_EDICAO: return "edição";
+        case OPERACAO_EXCLUSAO: return "exclusão";
+        case OPERACAO_ATRIBUTO: return "atributo";
+        default: return "operação";
+    }
+}
+
+// Salvar o histórico para a versão atual do arquivo de dados (publicação atômica)
+int salvar_historico(Historico *historico, const char *arquivo, ListaContatos *lista) {
+    if (!historico || !arquivo || !lista) {
+        return 0;
+    }
+    validar_historico(historico, lista);
+
+    char temporario[512];
+    nome_arquivo_temporario(arquivo, temporario, sizeof(temporario));
+    FILE *fp = fopen(temporario, "wb");
+    if (!fp) {
+        fprintf(stderr, "Erro ao abrir arquivo para escrita: %s\n", temporario);
+        return 0;
+    }
+
+    CabecalhoHistorico cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, ASSINATURA_HISTORICO, sizeof(cabecalho.assinatura));
+    cabecalho.versao = VERSAO_HISTORICO;
+    cabecalho.banco = lista->assinatura;
+    cabecalho.quantidade = historico->quantidade;
+    cabecalho.aplicados = historico->aplicados;
+
+    int ok = fwrite(&cabecalho, sizeof(cabecalho), 1, fp) == 1;
+    for (int i = 0; i < historico->quantidade && ok; i++) {
+        DeltaContato *delta = &historico->deltas[(historico->inicio + i) % historico->capacidade];
+        ok = fwrite(&delta->tipo, sizeof(delta->tipo), 1, fp) == 1 &&
+             fwrite(&delta->campos, sizeof(delta->campos), 1, fp) == 1 &&
+             fwrite(&delta->id, sizeof(delta->id), 1, fp) == 1 &&
+             fwrite(&delta->tamanho, sizeof(delta->tamanho), 1, fp) == 1 &&
+             fwrite(delta->dados, 1, delta->tamanho, fp) == delta->tamanho;
+    }
+
+    if (!ok || !gravar_em_disco(fp)) {
+        fprintf(stderr, "Erro ao escrever histórico\n");
+        fclose(fp);
+        remove(temporario);
+        return 0;
+    }
+    fclose(fp);
+
+    if (rename(temporario, arquivo) != 0) {
+        fprintf(stderr, "Erro ao publicar arquivo: %s\n", arquivo);
+        remove(temporario);
+        return 0;
+    }
+    return 1;
+}
+
+// Carregar o histórico salvo; se não existe, está corrompido ou foi salvo para
+// outra versão do arquivo de dados, começa vazio
+Historico* carregar_historico(const char *arquivo, ListaContatos *lista) {
+    Historico *historico = criar_historico(CAPACIDADE_HISTORICO, lista);
+    if (!historico || !arquivo) {
+        return historico;
+    }
+
+    FILE *fp = fopen(arquivo, "rb");
+    if (!fp) {
+        return historico;
+    }
+
+    CabecalhoHistorico cabecalho;
+    if (fread(&cabecalho, sizeof(cabecalho), 1, fp) != 1 ||
+        memcmp(cabecalho.assinatura, ASSINATURA_HISTORICO, sizeof(cabecalho.assinatura)) != 0 ||
+        (cabecalho.versao != VERSAO_HISTORICO && cabecalho.versao != VERSAO_HISTORICO_SEM_ATRIBUTOS) ||
+        !assinaturas_iguais(&cabecalho.banco, &lista->assinatura) ||
+        cabecalho.quantidade < 0 || cabecalho.quantidade > historico->capacidade ||
+        cabecalho.aplicados < 0 || cabecalho.aplicados > cabecalho.quantidade) {
+        fclose(fp);
+        return historico;
+    }
+
+    for (int i = 0; i < cabecalho.quantidade; i++) {
+        DeltaContato delta;
+        Contato antes, depois;
+        delta.dados = NULL;
+        int ok = fread(&delta.tipo, sizeof(delta.tipo), 1, fp) == 1 &&
+                 fread(&delta.campos, sizeof(delta.campos), 1, fp) == 1 &&
+                 fread(&delta.id, sizeof(delta.id), 1, fp) == 1 &&
+                 fread(&delta.tamanho, sizeof(delta.tamanho), 1, fp) == 1 &&
+                 delta.tipo >= OPERACAO_ADICAO && delta.tipo <= OPERACAO_ATRIBUTO &&
+                 (delta.dados = (unsigned char*)malloc(delta.tamanho > 0 ? delta.tamanho : 1)) != NULL &&
+                 fread(delta.dados, 1, delta.tamanho, fp) == delta.tamanho &&
+                 ler_imagens(&delta, &antes, &depois, NULL);
+        if (!ok) {
+            fprintf(stderr, "Aviso: histórico de desfazer corrompido; descartado\n");
+            free(delta.dados);
+            liberar_deltas(historico);
+            break;
+        }
+        historico->deltas[historico->quantidade++] = delta;
+    }
+    if (historico->quantidade == cabecalho.quantidade) {
+        historico->aplicados = cabecalho.aplicados;
+    }
+
+    fclose(fp);
+    return historico;
+}
@@ -0,0 +1,74 @@
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <stdint.h>
+#include "contato.h"
+
+#define ARQUIVO_HISTORICO_PADRAO "data/contatos.hist"
+#define ASSINATURA_HISTORICO "CHST"
+#define VERSAO_HISTORICO 2                 // 2: atributos nas exclusões e operação de atributo
+#define VERSAO_HISTORICO_SEM_ATRIBUTOS 1   // Ainda lida
+#define CAPACIDADE_HISTORICO 100
+
+#define OPERACAO_ADICAO 1
+#define OPERACAO_EDICAO 2
+#define OPERACAO_EXCLUSAO 3
+#define OPERACAO_ATRIBUTO 4
+
+#define CAMPO_NOME 1
+#define CAMPO_TELEFONE 2
+#define CAMPO_EMAIL 4
+#define CAMPO_ATRIBUTOS 8
+
+// Delta de uma operação: só as imagens antes/depois dos campos envolvidos
+// Adição guarda só o depois, exclusão só o antes e edição os campos alterados;
+// cada imagem é gravada como 1 byte de tamanho seguido do texto
+// Com CAMPO_ATRIBUTOS, a exclusão acrescenta os atributos do contato (quantidade
+// em 1 byte e, para cada um, chave e valor) e a operação de atributo guarda a
+// chave e os valores antes e depois (vazio = sem o atributo)
+typedef struct {
+    uint8_t tipo;
+    uint8_t campos;
+    int32_t id;
+    uint16_t tamanho;
+    unsigned char *dados;
+} DeltaContato;
+
+// Histórico de desfazer/refazer em anel: ao encher, os deltas mais antigos são descartados
+// Os primeiros "aplicados" deltas podem ser desfeitos, os seguintes refeitos
+typedef struct {
+    DeltaContato *deltas;
+    int capacidade;
+    int inicio;
+    int quantidade;
+    int aplicados;
+    unsigned long geracao;  // Geração da lista após a última operação registrada
+} Historico;
+
+Historico* criar_historico(int capacidade, ListaContatos *lista);
+void liberar_historico(Historico *historico);
+
+// Operações que registram seu delta (mesmos retornos de adicionar/editar/excluir_contato)
+int adicionar_com_historico(Historico *historico, ListaContatos *lista,
+                            const char *nome, const char *telefone, const char *email);
+int editar_com_historico(Historico *historico, ListaContatos *lista, int id,
+                         const char *nome, const char *telefone, const char *email);
+int excluir_com_historico(Historico *historico, ListaContatos *lista, int id);
+int definir_atributo_com_historico(Historico *historico, ListaContatos *lista, int id,
+                                   const char *chave, const char *valor);
+
+// Desfazer/refazer aplicando só o delta (sem recarregar a lista)
+// Retornam o delta aplicado, ou NULL se não há o que desfazer/refazer
+// Se a lista mudou por fora do histórico (recarga, mesclagem...), o histórico é descartado
+const DeltaContato* desfazer_operacao(Historico *historico, ListaContatos *lista);
+const DeltaContato* refazer_operacao(Historico *historico, ListaContatos *lista);
+int operacoes_para_desfazer(Historico *historico, ListaContatos *lista);
+int operacoes_para_refazer(Historico *historico, ListaContatos *lista);
+const char* nome_operacao(int tipo);
+
+// Persistência opcional: o histórico vale apenas para a versão do arquivo de
+// dados em que foi salvo (a assinatura é conferida ao carregar)
+int salvar_historico(Historico *historico, const char *arquivo, ListaContatos *lista);
+Historico* carregar_historico(const char *arquivo, ListaContatos *lista);
+
+#endif
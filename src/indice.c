@@ -0,0 +1,206 @@
+#include "indice.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BALDES_INICIAIS 64
+#define IDS_INICIAIS 2
+
+// Função de hash FNV-1a (rápida e com boa dispersão para chaves curtas)
+unsigned long hash_string(const char *str) {
+    unsigned long hash = 2166136261UL;
+    while (*str) {
+        hash ^= (unsigned char)*str++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// Criar índice vazio
+IndiceHash* criar_indice_hash(size_t num_baldes_inicial) {
+    if (num_baldes_inicial == 0) {
+        num_baldes_inicial = BALDES_INICIAIS;
+    }
+
+    IndiceHash *indice = (IndiceHash*)malloc(sizeof(IndiceHash));
+    if (!indice) {
+        fprintf(stderr, "Erro ao alocar memória para o índice\n");
+        return NULL;
+    }
+
+    indice->baldes = (EntradaIndice**)calloc(num_baldes_inicial, sizeof(EntradaIndice*));
+    if (!indice->baldes) {
+        fprintf(stderr, "Erro ao alocar baldes do índice\n");
+        free(indice);
+        return NULL;
+    }
+
+    indice->num_baldes = num_baldes_inicial;
+    indice->num_chaves = 0;
+    return indice;
+}
+
+// Liberar uma entrada e seus IDs
+static void liberar_entrada(EntradaIndice *entrada) {
+    free(entrada->chave);
+    free(entrada->ids);
+    free(entrada);
+}
+
+// Remover todas as entradas mantendo os baldes alocados
+void limpar_indice_hash(IndiceHash *indice) {
+    if (!indice) {
+        return;
+    }
+
+    for (size_t i = 0; i < indice->num_baldes; i++) {
+        EntradaIndice *entrada = indice->baldes[i];
+        while (entrada) {
+            EntradaIndice *proxima = entrada->proxima;
+            liberar_entrada(entrada);
+            entrada = proxima;
+        }
+        indice->baldes[i] = NULL;
+    }
+    indice->num_chaves = 0;
+}
+
+// Liberar memória do índice
+void liberar_indice_hash(IndiceHash *indice) {
+    if (indice) {
+        limpar_indice_hash(indice);
+        free(indice->baldes);
+        free(indice);
+    }
+}
+
+// Dobrar o número de baldes quando o fator de carga passa de 1
+static int redimensionar_indice(IndiceHash *indice) {
+    size_t novo_num = indice->num_baldes * 2;
+    EntradaIndice **novos = (EntradaIndice**)calloc(novo_num, sizeof(EntradaIndice*));
+    if (!novos) {
+        return 0;
+    }
+
+    // Redistribuir entradas sem realocar as entradas em si
+    for (size_t i = 0; i < indice->num_baldes; i++) {
+        EntradaIndice *entrada = indice->baldes[i];
+        while (entrada) {
+            EntradaIndice *proxima = entrada->proxima;
+            size_t pos = hash_string(entrada->chave) % novo_num;
+            entrada->proxima = novos[pos];
+            novos[pos] = entrada;
+            entrada = proxima;
+        }
+    }
+
+    free(indice->baldes);
+    indice->baldes = novos;
+    indice->num_baldes = novo_num;
+    return 1;
+}
+
+// Buscar entrada pela chave exata
+EntradaIndice* indice_buscar(IndiceHash *indice, const char *chave) {
+    if (!indice || !chave) {
+        return NULL;
+    }
+
+    size_t pos = hash_string(chave) % indice->num_baldes;
+    for (EntradaIndice *entrada = indice->baldes[pos]; entrada; entrada = entrada->proxima) {
+        if (strcmp(entrada->chave, chave) == 0) {
+            return entrada;
+        }
+    }
+    return NULL;
+}
+
+// Associar um ID a uma chave (cria a entrada se ainda não existir)
+int indice_inserir(IndiceHash *indice, const char *chave, int id) {
+    if (!indice || !chave || chave[0] == '\0') {
+        return 0;
+    }
+
+    EntradaIndice *entrada = indice_buscar(indice, chave);
+    if (!entrada) {
+        if (indice->num_chaves >= indice->num_baldes) {
+            redimensionar_indice(indice); // Falha apenas degrada o desempenho
+        }
+
+        entrada = (EntradaIndice*)malloc(sizeof(EntradaIndice));
+        if (!entrada) {
+            return 0;
+        }
+
+        size_t tamanho = strlen(chave) + 1;
+        entrada->chave = (char*)malloc(tamanho);
+        entrada->ids = (int*)malloc(IDS_INICIAIS * sizeof(int));
+        if (!entrada->chave || !entrada->ids) {
+            free(entrada->chave);
+            free(entrada->ids);
+            free(entrada);
+            return 0;
+        }
+        memcpy(entrada->chave, chave, tamanho);
+        entrada->quantidade = 0;
+        entrada->capacidade = IDS_INICIAIS;
+
+        size_t pos = hash_string(chave) % indice->num_baldes;
+        entrada->proxima = indice->baldes[pos];
+        indice->baldes[pos] = entrada;
+        indice->num_chaves++;
+    }
+
+    if (entrada->quantidade >= entrada->capacidade) {
+        int nova_capacidade = entrada->capacidade * 2;
+        int *novos_ids = (int*)realloc(entrada->ids, nova_capacidade * sizeof(int));
+        if (!novos_ids) {
+            return 0;
+        }
+        entrada->ids = novos_ids;
+        entrada->capacidade = nova_capacidade;
+    }
+
+    // Manter IDs ordenados; o caso comum (ID novo, maior que todos) é O(1)
+    int pos = entrada->quantidade;
+    while (pos > 0 && entrada->ids[pos - 1] > id) {
+        entrada->ids[pos] = entrada->ids[pos - 1];
+        pos--;
+    }
+    entrada->ids[pos] = id;
+    entrada->quantidade++;
+    return 1;
+}
+
+// Desassociar um ID de uma chave (remove a entrada quando fica vazia)
+int indice_remover(IndiceHash *indice, const char *chave, int id) {
+    if (!indice || !chave) {
+        return 0;
+    }
+
+    size_t pos = hash_string(chave) % indice->num_baldes;
+    EntradaIndice **ref = &indice->baldes[pos];
+
+    while (*ref) {
+        EntradaIndice *entrada = *ref;
+        if (strcmp(entrada->chave, chave) == 0) {
+            for (int i = 0; i < entrada->quantidade; i++) {
+                if (entrada->ids[i] == id) {
+                    memmove(&entrada->ids[i], &entrada->ids[i + 1],
+                            (entrada->quantidade - i - 1) * sizeof(int));
+                    entrada->quantidade--;
+                    break;
+                }
+            }
+
+            if (entrada->quantidade == 0) {
+                *ref = entrada->proxima;
+                liberar_entrada(entrada);
+                indice->num_chaves--;
+            }
+            return 1;
+        }
+        ref = &entrada->proxima;
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef INDICE_H
+#define INDICE_H
+
+#include <stddef.h>
+
+// Entrada do índice: uma chave normalizada e os IDs dos contatos que a possuem
+typedef struct EntradaIndice {
+    char *chave;
+    int *ids;
+    int quantidade;
+    int capacidade;
+    struct EntradaIndice *proxima; // Encadeamento para colisões
+} EntradaIndice;
+
+// Tabela hash com encadeamento: chave (string) -> lista de IDs
+typedef struct {
+    EntradaIndice **baldes;
+    size_t num_baldes;
+    size_t num_chaves;
+} IndiceHash;
+
+// Funções de gerenciamento do índice
+IndiceHash* criar_indice_hash(size_t num_baldes_inicial);
+void liberar_indice_hash(IndiceHash *indice);
+void limpar_indice_hash(IndiceHash *indice);
+
+// Operações sobre o índice
+int indice_inserir(IndiceHash *indice, const char *chave, int id);
+int indice_remover(IndiceHash *indice, const char *chave, int id);
+EntradaIndice* indice_buscar(IndiceHash *indice, const char *chave);
+
+// Função de hash para strings (FNV-1a)
+unsigned long hash_string(const char *str);
+
+#endif
@@ -1,11 +1,85 @@
 #include "menu.h"
+#include "duplicados.h"
+#include "snapshot.h"
+#include "bloqueio.h"
+#include "salvamento.h"
+#include "historico.h"
+#include "alteracoes.h"
+#include "comparacao.h"
+#include "gerador.h"
+#include "paginado.h"
+#include "exportacao.h"
 #include "utils/string_utils.h"
+#include "utils/terminal_utils.h"
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
 #define ARQUIVO_DADOS "data/contatos.bin"
+#define ARQUIVO_TRACE "data/trace.tsv"
+#define MAX_SUGESTOES 5
+
+// Salvamento em segundo plano do menu interativo (NULL = salvar na hora)
+static SalvamentoAutomatico *salvamento = NULL;
+
+// Histórico de desfazer/refazer do menu interativo
+static Historico *historico = NULL;
+
+// Trecho que altera a base: as entradas do usuário são lidas antes, e só
+// recarregar -> alterar -> salvar fica sob o bloqueio entre processos, para que
+// um prompt esperando o usuário não segure a base (nem a thread de salvamento)
+// Sob o bloqueio, a lista é recarregada se outro processo salvou desde a última
+// leitura, evitando que um salvamento sobrescreva contatos gravados por outro
+static int fd_escrita = -1;
+static unsigned long geracao_escrita = 0;
+
+// Retorna 0 se o bloqueio não pôde ser obtido: a operação deve ser abandonada
+static int iniciar_escrita(ListaContatos *lista) {
+    if (salvamento) {
+        if (!iniciar_alteracao(salvamento)) {
+            printf("❌ Não foi possível bloquear a base de dados; nada foi alterado.\n");
+            return 0;
+        }
+    } else {
+        fd_escrita = bloquear_escrita(ARQUIVO_DADOS);
+        if (fd_escrita < 0) {
+            printf("❌ Não foi possível bloquear a base de dados; nada foi alterado.\n");
+            return 0;
+        }
+        recarregar_se_alterada(lista, ARQUIVO_DADOS);
+    }
+    geracao_escrita = lista->geracao;
+    return 1;
+}
+
+// Persistir o que mudou (agendado para a thread de salvamento ou feito na hora)
+// e liberar o bloqueio
+static void concluir_escrita(ListaContatos *lista) {
+    int alterou = lista->geracao != geracao_escrita;
+    
+    // Os excluídos saem antes de salvar, ainda com a lista sob o bloqueio:
+    // a thread de salvamento só lê a lista
+    compactar_lista(lista);
+    if (salvamento) {
+        concluir_alteracao(salvamento, geracao_escrita);
+        if (alterou) {
+            printf("✅ Alteração registrada (salvamento automático em segundo plano).\n");
+        }
+        return;
+    }
+    
+    if (alterou) {
+        if (salvar_contatos(lista, ARQUIVO_DADOS)) {
+            printf("✅ Dados salvos com sucesso.\n");
+        } else {
+            printf("⚠️  Aviso: Erro ao salvar dados.\n");
+        }
+    }
+    liberar_bloqueio(fd_escrita);
+    fd_escrita = -1;
+}
 
 void limpar_tela() {
     #ifdef _WIN32
@@ -21,6 +95,63 @@ void aguardar_enter() {
     limpar_buffer_entrada();
 }
 
+// Exibir sugestões de contatos para o texto digitado (autocompletar)
+static int exibir_sugestoes_contatos(const char *entrada, void *contexto) {
+    ListaContatos *lista = (ListaContatos*)contexto;
+    int ids[MAX_SUGESTOES];
+    int n;
+    
+    // Texto numérico: mostrar o contato com esse ID
+    const char *p = entrada;
+    while (isdigit((unsigned char)*p)) p++;
+    if (*p == '\0') {
+        n = buscar_contato_por_id(lista, atoi(entrada)) ? 1 : 0;
+        ids[0] = atoi(entrada);
+    } else {
+        n = sugerir_contatos(lista, entrada, ids, MAX_SUGESTOES);
+    }
+    
+    for (int i = 0; i < n; i++) {
+        Contato *contato = buscar_contato_por_id(lista, ids[i]);
+        printf("\n   %-5d %-30s %s", contato->id, contato->nome, contato->email);
+    }
+    return n;
+}
+
+// Converter o texto digitado em ID: número do ID ou o único contato cujo nome/email
+// começa com o texto; com mais de um, lista os candidatos e pede o ID
+// Retorna 0 se o usuário cancelou e -1 se nenhum contato corresponde
+static int resolver_id_digitado(ListaContatos *lista, char *texto) {
+    trim_string(texto);
+    
+    const char *p = texto;
+    while (isdigit((unsigned char)*p)) p++;
+    if (*p == '\0') {
+        return atoi(texto);
+    }
+    
+    // Um a mais que o exibido: saber se a lista de candidatos está completa
+    int ids[MAX_SUGESTOES + 1];
+    int n = sugerir_contatos(lista, texto, ids, MAX_SUGESTOES + 1);
+    if (n <= 1) {
+        return n == 1 ? ids[0] : -1;
+    }
+    
+    printf("\n⚠️  '%s' corresponde a mais de um contato:\n", texto);
+    for (int i = 0; i < n && i < MAX_SUGESTOES; i++) {
+        Contato *contato = buscar_contato_por_id(lista, ids[i]);
+        printf("   %-5d %-30s %s\n", contato->id, contato->nome, contato->email);
+    }
+    if (n > MAX_SUGESTOES) {
+        printf("   ... e outros (digite mais do nome ou o ID)\n");
+    }
+    
+    char *escolha = ler_string("ID do contato (0 para cancelar): ", 20);
+    int id = escolha ? atoi(escolha) : 0;
+    if (escolha) liberar_buffer(escolha);
+    return id > 0 ? id : 0;
+}
+
 void exibir_menu_principal() {
     printf("\n");
     printf("╔═══════════════════════════════════════════════╗\n");
@@ -34,6 +165,7 @@ void exibir_menu_principal() {
     printf("║  6. Exportar para CSV                         ║\n");
     printf("║  7. Análise de Memória                        ║\n");
     printf("║  8. Teste de Stress                           ║\n");
+    printf("║  9. Ferramentas                               ║\n");
     printf("║  0. Sair                                      ║\n");
     printf("╚═══════════════════════════════════════════════╝\n");
     printf("\nEscolha uma opção: ");
@@ -73,17 +205,33 @@ void menu_adicionar_contato(ListaContatos *lista) {
     }
     trim_string(email);
     
-    int id = adicionar_contato(lista, nome, telefone, email);
+    // Telefone ou email já cadastrado: pedir confirmação antes de duplicar
+    int existente = buscar_duplicado(lista, telefone, email);
+    if (existente > 0) {
+        Contato *contato = buscar_contato_por_id(lista, existente);
+        printf("\n⚠️  Telefone ou email já cadastrado no contato ID %d (%s, %s, %s)\n",
+               existente, contato->nome, contato->telefone, contato->email);
+        char *confirma = ler_string("Adicionar mesmo assim? (s/n): ", 10);
+        int adicionar = confirma && (confirma[0] == 's' || confirma[0] == 'S');
+        if (confirma) liberar_buffer(confirma);
+        if (!adicionar) {
+            printf("Contato não adicionado.\n");
+            liberar_buffer(nome);
+            liberar_buffer(telefone);
+            liberar_buffer(email);
+            aguardar_enter();
+            return;
+        }
+    }
     
-    if (id > 0) {
-        printf("\n✅ Contato adicionado com sucesso! ID: %d\n", id);
-        if (salvar_contatos(lista, ARQUIVO_DADOS)) {
-            printf("✅ Dados salvos com sucesso.\n");
+    if (iniciar_escrita(lista)) {
+        int id = adicionar_com_historico(historico, lista, nome, telefone, email);
+        if (id > 0) {
+            printf("\n✅ Contato adicionado com sucesso! ID: %d\n", id);
         } else {
-            printf("⚠️  Aviso: Erro ao salvar dados.\n");
+            printf("❌ Erro ao adicionar contato.\n");
         }
-    } else {
-        printf("❌ Erro ao adicionar contato.\n");
+        concluir_escrita(lista);
     }
     
     liberar_buffer(nome);
@@ -103,8 +251,36 @@ void menu_listar_contatos(ListaContatos *lista) {
 void menu_buscar_contatos(ListaContatos *lista) {
     limpar_tela();
     printf("\n=== BUSCAR CONTATOS ===\n\n");
+    printf("1. Por termo (nome, telefone ou email)\n");
+    printf("2. Por telefone exato (qualquer formatação)\n");
+    printf("3. Por domínio de email\n");
+    printf("4. Aproximada por nome (tolera erros de digitação)\n");
+    printf("5. Por atributo extra (empresa, endereco, ...)\n");
+    
+    char *tipo_str = ler_string("\nTipo de busca: ", 10);
+    int tipo = tipo_str ? atoi(tipo_str) : 0;
+    if (tipo_str) liberar_buffer(tipo_str);
+    
+    if (tipo < 1 || tipo > 5) {
+        printf("❌ Tipo de busca inválido!\n");
+        aguardar_enter();
+        return;
+    }
     
-    char *termo = ler_string("Digite o termo de busca (nome, telefone ou email): ", 100);
+    const char *prompt = "Digite o termo de busca (nome, telefone ou email): ";
+    if (tipo == 2) {
+        prompt = "Digite o telefone: ";
+    } else if (tipo == 3) {
+        prompt = "Digite o domínio (ex: cliente.com): ";
+    } else if (tipo == 4) {
+        prompt = "Digite o nome (ex: Slva): ";
+    } else if (tipo == 5) {
+        prompt = "Digite o atributo (ex: empresa): ";
+    }
+    
+    // Busca por termo sugere contatos a cada tecla digitada
+    char *termo = tipo == 1 ? ler_string_com_sugestoes(prompt, 100, exibir_sugestoes_contatos, lista)
+                            : ler_string(prompt, 100);
     if (!termo || string_vazia(termo)) {
         printf("❌ Termo de busca não pode ser vazio!\n");
         if (termo) liberar_buffer(termo);
@@ -114,8 +290,33 @@ void menu_buscar_contatos(ListaContatos *lista) {
     trim_string(termo);
     
     printf("\n");
-    buscar_contatos(lista, termo);
-    
+    if (tipo == 2) {
+        buscar_por_telefone(lista, termo);
+    } else if (tipo == 3) {
+        buscar_por_dominio(lista, termo);
+    } else if (tipo == 4) {
+        char *dist_str = ler_string("Distância máxima de edição (1-3, ENTER = 2): ", 10);
+        int distancia = (dist_str && !string_vazia(dist_str)) ? atoi(dist_str) : 2;
+        if (dist_str) liberar_buffer(dist_str);
+        if (distancia < 1 || distancia > 3) {
+            distancia = 2;
+        }
+        buscar_aproximado(lista, termo, distancia);
+    } else if (tipo == 5) {
+        char *trecho = ler_string("Trecho do valor (ENTER = todos com o atributo): ", 200);
+        buscar_por_atributo(lista, termo, trecho ? trim_string(trecho) : "");
+        if (trecho) liberar_buffer(trecho);
+    } else {
+        char *top_str = ler_string("Mostrar só os N mais relevantes (ENTER = todos): ", 10);
+        int top = (top_str && !string_vazia(top_str)) ? atoi(top_str) : 0;
+        if (top_str) liberar_buffer(top_str);
+        if (top > 0) {
+            buscar_contatos_relevantes(lista, termo, top);
+        } else {
+            buscar_contatos(lista, termo);
+        }
+    }
+
     liberar_buffer(termo);
     aguardar_enter();
 }
@@ -124,16 +325,19 @@ void menu_editar_contato(ListaContatos *lista) {
     limpar_tela();
     printf("\n=== EDITAR CONTATO ===\n\n");
     
-    // Listar contatos para referência
-    listar_contatos(lista);
+    // Sem terminal interativo (sem sugestões), listar contatos para referência
+    if (!terminal_interativo()) {
+        listar_contatos(lista);
+    }
     
-    char *id_str = ler_string("\nDigite o ID do contato a editar (0 para cancelar): ", 20);
+    printf("\nDigite o ID do contato a editar ou o início do nome/email (0 para cancelar)\n");
+    char *id_str = ler_string_com_sugestoes("> ", 100, exibir_sugestoes_contatos, lista);
     if (!id_str || string_vazia(id_str)) {
         if (id_str) liberar_buffer(id_str);
         return;
     }
     
-    int id = atoi(id_str);
+    int id = resolver_id_digitado(lista, id_str);
     liberar_buffer(id_str);
     
     if (id == 0) {
@@ -142,6 +346,12 @@ void menu_editar_contato(ListaContatos *lista) {
         return;
     }
     
+    if (id < 0) {
+        printf("❌ Nenhum contato corresponde ao texto digitado.\n");
+        aguardar_enter();
+        return;
+    }
+    
     Contato *contato = buscar_contato_por_id(lista, id);
     if (!contato) {
         printf("❌ Contato com ID %d não encontrado.\n", id);
@@ -165,18 +375,17 @@ void menu_editar_contato(ListaContatos *lista) {
     if (novo_telefone && !string_vazia(novo_telefone)) trim_string(novo_telefone);
     if (novo_email && !string_vazia(novo_email)) trim_string(novo_email);
     
-    if (editar_contato(lista, id, 
-                       (novo_nome && !string_vazia(novo_nome)) ? novo_nome : "",
-                       (novo_telefone && !string_vazia(novo_telefone)) ? novo_telefone : "",
-                       (novo_email && !string_vazia(novo_email)) ? novo_email : "")) {
-        printf("\n✅ Contato %d editado com sucesso!\n", id);
-        if (salvar_contatos(lista, ARQUIVO_DADOS)) {
-            printf("✅ Dados salvos com sucesso.\n");
+    // Outro processo pode ter excluído o contato enquanto os dados eram digitados
+    if (iniciar_escrita(lista)) {
+        if (editar_com_historico(historico, lista, id, 
+                           (novo_nome && !string_vazia(novo_nome)) ? novo_nome : "",
+                           (novo_telefone && !string_vazia(novo_telefone)) ? novo_telefone : "",
+                           (novo_email && !string_vazia(novo_email)) ? novo_email : "")) {
+            printf("\n✅ Contato %d editado com sucesso!\n", id);
         } else {
-            printf("⚠️  Aviso: Erro ao salvar dados.\n");
+            printf("❌ Erro ao editar contato.\n");
         }
-    } else {
-        printf("❌ Erro ao editar contato.\n");
+        concluir_escrita(lista);
     }
     
     if (novo_nome) liberar_buffer(novo_nome);
@@ -190,16 +399,19 @@ void menu_excluir_contato(ListaContatos *lista) {
     limpar_tela();
     printf("\n=== EXCLUIR CONTATO ===\n\n");
     
-    // Listar contatos para referência
-    listar_contatos(lista);
+    // Sem terminal interativo (sem sugestões), listar contatos para referência
+    if (!terminal_interativo()) {
+        listar_contatos(lista);
+    }
     
-    char *id_str = ler_string("\nDigite o ID do contato a excluir (0 para cancelar): ", 20);
+    printf("\nDigite o ID do contato a excluir ou o início do nome/email (0 para cancelar)\n");
+    char *id_str = ler_string_com_sugestoes("> ", 100, exibir_sugestoes_contatos, lista);
     if (!id_str || string_vazia(id_str)) {
         if (id_str) liberar_buffer(id_str);
         return;
     }
     
-    int id = atoi(id_str);
+    int id = resolver_id_digitado(lista, id_str);
     liberar_buffer(id_str);
     
     if (id == 0) {
@@ -208,6 +420,12 @@ void menu_excluir_contato(ListaContatos *lista) {
         return;
     }
     
+    if (id < 0) {
+        printf("❌ Nenhum contato corresponde ao texto digitado.\n");
+        aguardar_enter();
+        return;
+    }
+    
     Contato *contato = buscar_contato_por_id(lista, id);
     if (!contato) {
         printf("❌ Contato com ID %d não encontrado.\n", id);
@@ -222,15 +440,13 @@ void menu_excluir_contato(ListaContatos *lista) {
     
     char *confirma = ler_string("\nTem certeza? (s/n): ", 10);
     if (confirma && (confirma[0] == 's' || confirma[0] == 'S')) {
-        if (excluir_contato(lista, id)) {
-            printf("\n✅ Contato %d excluído com sucesso!\n", id);
-            if (salvar_contatos(lista, ARQUIVO_DADOS)) {
-                printf("✅ Dados salvos com sucesso.\n");
+        if (iniciar_escrita(lista)) {
+            if (excluir_com_historico(historico, lista, id)) {
+                printf("\n✅ Contato %d excluído com sucesso!\n", id);
             } else {
-                printf("⚠️  Aviso: Erro ao salvar dados.\n");
+                printf("❌ Erro ao excluir contato.\n");
             }
-        } else {
-            printf("❌ Erro ao excluir contato.\n");
+            concluir_escrita(lista);
         }
     } else {
         printf("Operação cancelada.\n");
@@ -261,9 +477,34 @@ void menu_exportar_csv(ListaContatos *lista) {
         snprintf(arquivo_completo, sizeof(arquivo_completo), "data/%s", arquivo);
     }
     
-    if (exportar_csv(lista, arquivo_completo)) {
+    char *ordem_str = ler_string("Ordenar por (id, nome, email) [id]: ", 20);
+    int ordem = ORDEM_ID;
+    if (ordem_str && !string_vazia(ordem_str)) {
+        trim_string(ordem_str);
+        ordem = ordem_exportacao(ordem_str);
+    }
+    if (ordem_str) liberar_buffer(ordem_str);
+    if (ordem < 0) {
+        printf("❌ Ordem inválida! Use id, nome ou email.\n");
+        liberar_buffer(arquivo);
+        aguardar_enter();
+        return;
+    }
+    
+    // Outro arquivo é lido bloco a bloco, então pode ser maior que a memória
+    char *origem = ler_string("Arquivo de origem (Enter = contatos em uso): ", 256);
+    long exportados;
+    if (origem && !string_vazia(origem)) {
+        trim_string(origem);
+        exportados = exportar_arquivo_csv_ordenado(origem, arquivo_completo, ordem, MEMORIA_EXPORTACAO_PADRAO);
+    } else {
+        exportados = exportar_csv_ordenado(lista, arquivo_completo, ordem, MEMORIA_EXPORTACAO_PADRAO);
+    }
+    if (origem) liberar_buffer(origem);
+    
+    if (exportados >= 0) {
         printf("\n✅ Contatos exportados com sucesso para: %s\n", arquivo_completo);
-        printf("Total de contatos exportados: %d\n", lista->quantidade);
+        printf("Total de contatos exportados: %ld\n", exportados);
     } else {
         printf("❌ Erro ao exportar contatos.\n");
     }
@@ -290,35 +531,66 @@ void menu_teste_stress(ListaContatos *lista) {
         return;
     }
     
-    int quantidade = atoi(qtd_str);
+    long quantidade = strtol(qtd_str, NULL, 10);
     liberar_buffer(qtd_str);
     
-    if (quantidade <= 0 || quantidade > 100000) {
-        printf("❌ Quantidade deve estar entre 1 e 100000!\n");
+    // Sem teto fixo: o limite é o maior ID representável
+    if (quantidade <= 0 || quantidade > (long)(INT32_MAX - TAMANHO_SEGMENTO) - lista->quantidade) {
+        printf("❌ Quantidade inválida!\n");
         aguardar_enter();
         return;
     }
     
-    printf("\nGerando %d contatos...\n", quantidade);
+    char *realista = ler_string("Dados realistas (nomes acentuados, domínios variados, duplicados)? (s/n): ", 10);
+    int dados_realistas = realista && (realista[0] == 's' || realista[0] == 'S');
+    if (realista) liberar_buffer(realista);
+    
+    ConfiguracaoGerador configuracao;
+    if (dados_realistas) {
+        char *semente_str = ler_string("Semente (mesma semente = mesmos dados): ", 30);
+        configuracao_gerador_padrao(&configuracao, semente_str ? strtoull(semente_str, NULL, 10) : 0);
+        if (semente_str) liberar_buffer(semente_str);
+        
+        char *taxa_str = ler_string("Percentual de duplicados (padrão 5): ", 10);
+        if (taxa_str && !string_vazia(taxa_str)) {
+            configuracao.taxa_duplicados = atof(taxa_str) / 100.0;
+        }
+        if (taxa_str) liberar_buffer(taxa_str);
+    }
+    
+    if (!iniciar_escrita(lista)) {
+        aguardar_enter();
+        return;
+    }
+    printf("\nGerando %ld contatos...\n", quantidade);
     
     // Medir tempo
     clock_t inicio = clock();
-    gerar_contatos_teste(lista, quantidade);
+    if (dados_realistas) {
+        quantidade = gerar_contatos_realistas(lista, quantidade, &configuracao);
+    } else {
+        gerar_contatos_teste(lista, (int)quantidade);
+    }
     clock_t fim = clock();
     
     double tempo_geracao = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
     
-    printf("✅ %d contatos gerados em %.3f segundos\n", quantidade, tempo_geracao);
+    if (quantidade < 0) {
+        printf("❌ Erro ao gerar contatos\n");
+    } else {
+        printf("✅ %ld contatos gerados em %.3f segundos\n", quantidade, tempo_geracao);
+    }
     
-    // Salvar
-    printf("\nSalvando em arquivo...\n");
+    // Salvar (com o salvamento automático, fica para a thread de salvamento)
+    printf("\n");
     inicio = clock();
-    if (salvar_contatos(lista, ARQUIVO_DADOS)) {
-        fim = clock();
-        double tempo_salvamento = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
-        printf("✅ Dados salvos em %.3f segundos\n", tempo_salvamento);
-    } else {
-        printf("❌ Erro ao salvar dados\n");
+    concluir_escrita(lista);
+    if (!salvamento && quantidade >= 0) {
+        printf("Tempo de salvamento: %.3f segundos\n", ((double)(clock() - inicio)) / CLOCKS_PER_SEC);
+    }
+    if (quantidade < 0) {
+        aguardar_enter();
+        return;
     }
     
     // Análise de memória
@@ -328,6 +600,764 @@ void menu_teste_stress(ListaContatos *lista) {
     aguardar_enter();
 }
 
+void menu_relatorio_dominios(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== CONTATOS POR DOMÍNIO ===\n");
+    listar_dominios(lista);
+    aguardar_enter();
+}
+
+void menu_duplicados(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== CONTATOS DUPLICADOS ===\n");
+    
+    int duplicados = detectar_duplicados(lista, DISTANCIA_NOME_PADRAO, 0);
+    if (duplicados > 0) {
+        char *confirma = ler_string("\nMesclar duplicados mantendo o contato mais antigo? (s/n): ", 10);
+        if (confirma && (confirma[0] == 's' || confirma[0] == 'S')) {
+            printf("\n");
+            // A mesclagem detecta de novo sob o bloqueio (a lista pode ter sido recarregada)
+            if (iniciar_escrita(lista)) {
+                detectar_duplicados(lista, DISTANCIA_NOME_PADRAO, 1);
+                concluir_escrita(lista);
+            }
+        } else {
+            printf("Operação cancelada.\n");
+        }
+        if (confirma) liberar_buffer(confirma);
+    }
+    
+    aguardar_enter();
+}
+
+// Ler nome de arquivo de snapshot (Enter usa o padrão)
+static char* ler_arquivo_snapshot() {
+    char *arquivo = ler_string("Arquivo do snapshot [" ARQUIVO_SNAPSHOT_PADRAO "]: ", 256);
+    if (arquivo && string_vazia(arquivo)) {
+        liberar_buffer(arquivo);
+        arquivo = NULL;
+    }
+    return arquivo ? arquivo : copiar_string(ARQUIVO_SNAPSHOT_PADRAO);
+}
+
+void menu_criar_snapshot(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== CRIAR SNAPSHOT ===\n\n");
+    
+    char *arquivo = ler_arquivo_snapshot();
+    if (!arquivo) {
+        return;
+    }
+    
+    clock_t inicio = clock();
+    if (criar_snapshot(lista, arquivo)) {
+        double tempo = ((double)(clock() - inicio)) / CLOCKS_PER_SEC;
+        AssinaturaArquivo dados, snapshot;
+        obter_assinatura_arquivo(ARQUIVO_DADOS, &dados);
+        obter_assinatura_arquivo(arquivo, &snapshot);
+        printf("✅ Snapshot salvo em '%s' (%.3f segundos)\n", arquivo, tempo);
+        printf("Tamanho: %lld bytes", (long long)snapshot.tamanho);
+        if (dados.existe && snapshot.tamanho > 0) {
+            printf(" (%.1fx menor que %s)", (double)dados.tamanho / snapshot.tamanho, ARQUIVO_DADOS);
+        }
+        printf("\n");
+    } else {
+        printf("❌ Erro ao criar snapshot\n");
+    }
+    
+    liberar_buffer(arquivo);
+    aguardar_enter();
+}
+
+void menu_restaurar_snapshot(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== RESTAURAR SNAPSHOT ===\n\n");
+    
+    char *arquivo = ler_arquivo_snapshot();
+    if (!arquivo) {
+        return;
+    }
+    
+    char *confirma = ler_string("Substituir todos os contatos atuais pelo snapshot? (s/n): ", 10);
+    if (confirma && (confirma[0] == 's' || confirma[0] == 'S')) {
+        clock_t inicio = clock();
+        ListaContatos *restaurada = restaurar_snapshot(arquivo);
+        if (restaurada && iniciar_escrita(lista)) {
+            double tempo = ((double)(clock() - inicio)) / CLOCKS_PER_SEC;
+            substituir_lista(lista, restaurada);
+            printf("✅ %d contato(s) restaurado(s) em %.3f segundos\n", CONTATOS_ATIVOS(lista), tempo);
+            concluir_escrita(lista);
+        } else if (restaurada) {
+            liberar_lista(restaurada);
+        } else {
+            printf("❌ Erro ao restaurar snapshot\n");
+        }
+    } else {
+        printf("Operação cancelada.\n");
+    }
+    
+    if (confirma) liberar_buffer(confirma);
+    liberar_buffer(arquivo);
+    aguardar_enter();
+}
+
+static char* ler_arquivo_com_padrao(const char *padrao) {
+    char prompt[300];
+    snprintf(prompt, sizeof(prompt), "Arquivo [%s]: ", padrao);
+    char *arquivo = ler_string(prompt, 256);
+    if (arquivo && string_vazia(arquivo)) {
+        liberar_buffer(arquivo);
+        arquivo = NULL;
+    }
+    return arquivo ? trim_string(arquivo) : copiar_string(padrao);
+}
+
+static void exibir_resultado_importacao(int ok, const ResultadoImportacao *resultado, const char *registros,
+                                        double tempo, long long tamanho) {
+    if (ok) {
+        printf("✅ %ld contato(s) importado(s) de %ld %s em %.3f segundos",
+               resultado->importados, resultado->registros, registros, tempo);
+        if (tempo > 0) {
+            printf(" (%.0f MB/s)", tamanho / tempo / (1024.0 * 1024.0));
+        }
+        printf("\n");
+    } else {
+        printf("❌ Importação interrompida: %ld contato(s) importado(s) antes do erro\n", resultado->importados);
+    }
+    if (resultado->rejeitados > 0) {
+        printf("⚠️  %ld %s rejeitado(s) (detalhes acima)\n", resultado->rejeitados, registros);
+    }
+    if (resultado->duplicados > 0) {
+        printf("⚠️  %ld %s pulado(s): telefone ou email já cadastrado\n", resultado->duplicados, registros);
+    }
+}
+
+static int perguntar_somente_novos(void) {
+    char *resposta = ler_string("Pular contatos com telefone ou email já cadastrado? (s/n): ", 10);
+    int somente_novos = resposta && (resposta[0] == 's' || resposta[0] == 'S');
+    if (resposta) liberar_buffer(resposta);
+    return somente_novos;
+}
+
+void menu_exportar_ndjson(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== EXPORTAR NDJSON ===\n\n");
+    
+    char *arquivo = ler_arquivo_com_padrao(ARQUIVO_NDJSON_PADRAO);
+    if (!arquivo) {
+        return;
+    }
+    
+    clock_t inicio = clock();
+    long exportados = exportar_ndjson(lista, arquivo);
+    if (exportados >= 0) {
+        double tempo = ((double)(clock() - inicio)) / CLOCKS_PER_SEC;
+        AssinaturaArquivo saida;
+        obter_assinatura_arquivo(arquivo, &saida);
+        printf("✅ %ld contato(s) exportado(s) para '%s' em %.3f segundos", exportados, arquivo, tempo);
+        if (tempo > 0) {
+            printf(" (%.0f MB/s)", saida.tamanho / tempo / (1024.0 * 1024.0));
+        }
+        printf("\n");
+    } else {
+        printf("❌ Erro ao exportar contatos\n");
+    }
+    
+    liberar_buffer(arquivo);
+    aguardar_enter();
+}
+
+void menu_importar_ndjson(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== IMPORTAR NDJSON ===\n\n");
+    printf("Cada linha: {\"nome\":\"...\",\"telefone\":\"...\",\"email\":\"...\"}\n\n");
+    
+    char *arquivo = ler_arquivo_com_padrao(ARQUIVO_NDJSON_PADRAO);
+    if (!arquivo) {
+        return;
+    }
+    
+    int somente_novos = perguntar_somente_novos();
+    
+    ResultadoImportacao resultado;
+    AssinaturaArquivo entrada;
+    obter_assinatura_arquivo(arquivo, &entrada);
+    if (iniciar_escrita(lista)) {
+        clock_t inicio = clock();
+        int ok = importar_ndjson(lista, arquivo, somente_novos, &resultado);
+        double tempo = ((double)(clock() - inicio)) / CLOCKS_PER_SEC;
+        concluir_escrita(lista);
+        exibir_resultado_importacao(ok, &resultado, "linha(s)", tempo, entrada.tamanho);
+    }
+    
+    liberar_buffer(arquivo);
+    aguardar_enter();
+}
+
+void menu_exportar_vcard(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== EXPORTAR VCARD ===\n\n");
+    
+    char *arquivo = ler_arquivo_com_padrao(ARQUIVO_VCARD_PADRAO);
+    if (!arquivo) {
+        return;
+    }
+    char *versao_str = ler_string("Versão (3 = 3.0, 4 = 4.0) [3]: ", 10);
+    int versao = versao_str && !string_vazia(versao_str) ? atoi(versao_str) : 3;
+    if (versao_str) liberar_buffer(versao_str);
+    
+    clock_t inicio = clock();
+    long exportados = exportar_vcard(lista, arquivo, versao);
+    if (exportados >= 0) {
+        double tempo = ((double)(clock() - inicio)) / CLOCKS_PER_SEC;
+        printf("✅ %ld cartão(ões) vCard %d.0 exportado(s) para '%s' em %.3f segundos\n",
+               exportados, versao, arquivo, tempo);
+    } else {
+        printf("❌ Erro ao exportar contatos\n");
+    }
+    
+    liberar_buffer(arquivo);
+    aguardar_enter();
+}
+
+// Um .vcf inteiro (ex.: exportado do celular) em uma passada e um único salvamento
+void menu_importar_vcard(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== IMPORTAR VCARD ===\n\n");
+    
+    char *arquivo = ler_arquivo_com_padrao(ARQUIVO_VCARD_PADRAO);
+    if (!arquivo) {
+        return;
+    }
+    
+    int somente_novos = perguntar_somente_novos();
+    
+    ResultadoImportacao resultado;
+    AssinaturaArquivo entrada;
+    obter_assinatura_arquivo(arquivo, &entrada);
+    if (iniciar_escrita(lista)) {
+        clock_t inicio = clock();
+        int ok = importar_vcard(lista, arquivo, somente_novos, &resultado);
+        double tempo = ((double)(clock() - inicio)) / CLOCKS_PER_SEC;
+        concluir_escrita(lista);
+        exibir_resultado_importacao(ok, &resultado, "cartão(ões)", tempo, entrada.tamanho);
+    }
+    
+    liberar_buffer(arquivo);
+    aguardar_enter();
+}
+
+// Excluir ou editar todos os contatos que atendem a um critério: uma passada
+// sobre a lista e um único salvamento, em vez de uma operação por ID
+void menu_alterar_em_lote(ListaContatos *lista, int excluir) {
+    limpar_tela();
+    printf(excluir ? "\n=== EXCLUIR EM LOTE ===\n\n" : "\n=== EDITAR EM LOTE ===\n\n");
+    printf("Critério: nome:trecho, telefone:trecho, email:trecho ou dominio:nome\n");
+    printf("Exemplo: email:@antiga.com\n\n");
+    
+    char *texto = ler_string("Critério: ", 120);
+    CriterioContatos criterio;
+    if (!texto || !analisar_criterio(trim_string(texto), &criterio)) {
+        printf("❌ Critério inválido!\n");
+        if (texto) liberar_buffer(texto);
+        aguardar_enter();
+        return;
+    }
+    
+    int encontrados = contar_onde(lista, &criterio);
+    if (encontrados == 0) {
+        printf("Nenhum contato atende ao critério '%s'.\n", texto);
+        liberar_buffer(texto);
+        aguardar_enter();
+        return;
+    }
+    printf("%d contato(s) atendem ao critério.\n", encontrados);
+    liberar_buffer(texto);
+    
+    char *novo_nome = NULL;
+    char *novo_telefone = NULL;
+    char *novo_email = NULL;
+    if (!excluir) {
+        printf("\n--- Novos Dados (deixe em branco para manter) ---\n");
+        novo_nome = ler_string("Novo nome: ", 100);
+        novo_telefone = ler_string("Novo telefone: ", 20);
+        novo_email = ler_string("Novo email: ", 100);
+        if (novo_nome && !string_vazia(novo_nome)) trim_string(novo_nome);
+        if (novo_telefone && !string_vazia(novo_telefone)) trim_string(novo_telefone);
+        if (novo_email && !string_vazia(novo_email)) trim_string(novo_email);
+    }
+    int sem_campos = !excluir && (!novo_nome || string_vazia(novo_nome)) &&
+                     (!novo_telefone || string_vazia(novo_telefone)) &&
+                     (!novo_email || string_vazia(novo_email));
+    
+    char *confirma = NULL;
+    if (sem_campos) {
+        printf("❌ Nenhum campo para alterar.\n");
+    } else {
+        printf("⚠️  A operação em lote não entra no histórico de desfazer.\n");
+        confirma = ler_string(excluir ? "Excluir esses contatos? (s/n): " : "Editar esses contatos? (s/n): ", 10);
+    }
+    if (confirma && (confirma[0] == 's' || confirma[0] == 'S') && iniciar_escrita(lista)) {
+        // O critério é reavaliado sob o bloqueio: a contagem acima pode ter mudado
+        clock_t inicio = clock();
+        int alterados = excluir ? excluir_onde(lista, &criterio)
+                                : editar_onde(lista, &criterio, novo_nome, novo_telefone, novo_email);
+        double tempo = ((double)(clock() - inicio)) / CLOCKS_PER_SEC;
+        if (alterados >= 0) {
+            printf("✅ %d contato(s) %s em %.3f segundos\n", alterados, excluir ? "excluído(s)" : "editado(s)", tempo);
+        } else {
+            printf("❌ Erro na operação em lote.\n");
+        }
+        concluir_escrita(lista);
+    } else if (confirma && (confirma[0] == 's' || confirma[0] == 'S')) {
+        // Bloqueio não obtido: a mensagem já foi exibida
+    } else if (!sem_campos) {
+        printf("Operação cancelada.\n");
+    }
+    
+    if (confirma) liberar_buffer(confirma);
+    if (novo_nome) liberar_buffer(novo_nome);
+    if (novo_telefone) liberar_buffer(novo_telefone);
+    if (novo_email) liberar_buffer(novo_email);
+    aguardar_enter();
+}
+
+// Atributos opcionais de um contato: definir, trocar ou remover (valor vazio)
+void menu_atributos(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== ATRIBUTOS EXTRAS ===\n\n");
+    
+    char *id_str = ler_string("ID do contato: ", 20);
+    int id = id_str ? atoi(id_str) : 0;
+    if (id_str) liberar_buffer(id_str);
+    Contato *contato = buscar_contato_por_id(lista, id);
+    if (!contato) {
+        printf("❌ Contato não encontrado!\n");
+        aguardar_enter();
+        return;
+    }
+    printf("\n%s (%s, %s)\n", contato->nome, contato->telefone, contato->email);
+    listar_atributos(lista, id);
+    
+    // Os pares são lidos primeiro e aplicados juntos sob o bloqueio
+    printf("\nAtributos comuns: empresa, endereco, aniversario, notas\n");
+    char *chaves[MAX_CHAVES_EXTENSAO];
+    char *valores[MAX_CHAVES_EXTENSAO];
+    int num_pares = 0;
+    while (num_pares < MAX_CHAVES_EXTENSAO) {
+        char *chave = ler_string("\nAtributo (ENTER = concluir): ", MAX_CHAVE_EXTENSAO + 10);
+        if (!chave || string_vazia(chave)) {
+            if (chave) liberar_buffer(chave);
+            break;
+        }
+        trim_string(chave);
+        char normalizada[MAX_CHAVE_EXTENSAO];
+        if (!normalizar_chave_extensao(chave, normalizada, sizeof(normalizada))) {
+            printf("❌ Atributo inválido (use letras, dígitos e '_').\n");
+            liberar_buffer(chave);
+            continue;
+        }
+        char *valor = ler_string("Valor (ENTER = remover): ", MAX_VALOR_EXTENSAO);
+        if (valor && !string_vazia(valor)) trim_string(valor);
+        chaves[num_pares] = chave;
+        valores[num_pares] = valor;
+        num_pares++;
+    }
+    
+    if (num_pares > 0 && iniciar_escrita(lista)) {
+        // O contato pode ter sido excluído por outro processo enquanto os valores eram digitados
+        if (!buscar_contato_por_id(lista, id)) {
+            printf("❌ Contato não encontrado!\n");
+        } else {
+            printf("\n");
+            for (int i = 0; i < num_pares; i++) {
+                int definido = valores[i] && !string_vazia(valores[i]);
+                if (definir_atributo_com_historico(historico, lista, id, chaves[i], valores[i])) {
+                    printf("✅ Atributo '%s' %s.\n", chaves[i], definido ? "definido" : "removido");
+                } else {
+                    printf("❌ Atributo '%s' não gravado (valor até %d caracteres).\n",
+                           chaves[i], MAX_VALOR_EXTENSAO - 1);
+                }
+            }
+            printf("\n");
+            listar_atributos(lista, id);
+        }
+        concluir_escrita(lista);
+    }
+    for (int i = 0; i < num_pares; i++) {
+        liberar_buffer(chaves[i]);
+        if (valores[i]) liberar_buffer(valores[i]);
+    }
+    aguardar_enter();
+}
+
+// Listar o registro de alterações a partir de uma sequência
+void menu_alteracoes(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== ALTERAÇÕES DESDE UMA SEQUÊNCIA ===\n\n");
+    // Com o salvamento automático, a thread pode estar gravando as pendentes
+    uint64_t sequencia;
+    int pendentes;
+    if (salvamento) {
+        pendentes = consultar_alteracoes_pendentes(salvamento, &sequencia);
+    } else {
+        sequencia = lista->sequencia;
+        pendentes = lista->num_alteracoes;
+    }
+    printf("Sequência atual: %llu", (unsigned long long)sequencia);
+    if (pendentes > 0) {
+        printf(" (%d alteração(ões) ainda não salva(s))", pendentes);
+    }
+    printf("\n");
+    
+    char *desde_str = ler_string("Listar alterações após a sequência (0 = todas): ", 30);
+    if (!desde_str) {
+        return;
+    }
+    uint64_t desde = strtoull(desde_str, NULL, 10);
+    liberar_buffer(desde_str);
+    
+    printf("\nSEQ\tTIPO\tID\tNOME\tTELEFONE\tEMAIL\n");
+    long total = salvamento ? listar_alteracoes_salvas(salvamento, desde, stdout)
+                            : listar_alteracoes(ARQUIVO_DADOS, desde, stdout);
+    if (total >= 0) {
+        printf("\nTotal: %ld alteração(ões)\n", total);
+    } else {
+        printf("❌ Erro ao ler o registro de alterações\n");
+    }
+    aguardar_enter();
+}
+
+// Comparar dois arquivos de contatos e, opcionalmente, gravar a mesclagem
+void menu_comparar_arquivos(void) {
+    limpar_tela();
+    printf("\n=== COMPARAR/MESCLAR ARQUIVOS ===\n\n");
+    
+    char *arquivo_a = ler_string("Arquivo A (base): ", 256);
+    char *arquivo_b = arquivo_a ? ler_string("Arquivo B (prevalece na mesclagem): ", 256) : NULL;
+    if (!arquivo_a || !arquivo_b) {
+        if (arquivo_a) liberar_buffer(arquivo_a);
+        return;
+    }
+    
+    printf("\n");
+    ResultadoComparacao resultado;
+    clock_t inicio = clock();
+    if (comparar_arquivos(arquivo_a, arquivo_b, stdout, &resultado)) {
+        double tempo = ((double)(clock() - inicio)) / CLOCKS_PER_SEC;
+        printf("\n✅ Comparação concluída em %.3f segundos\n", tempo);
+        printf("   Iguais: %ld | Alterados: %ld | Adicionados: %ld | Removidos: %ld\n",
+               resultado.iguais, resultado.alterados, resultado.adicionados, resultado.removidos);
+        printf("   Colisões de ID: %ld | Casados por email: %ld\n",
+               resultado.colisoes, resultado.casados_por_email);
+        
+        char *destino = ler_string("\nGravar mesclagem em (vazio = não mesclar): ", 256);
+        if (destino && destino[0]) {
+            // A base aberta no menu tem alterações em memória: mesclar nela as perderia
+            if (strcmp(destino, ARQUIVO_DADOS) == 0) {
+                printf("⚠️  Escolha outro destino; a base em uso não pode ser sobrescrita daqui.\n");
+            } else if (mesclar_arquivos(arquivo_a, arquivo_b, destino, &resultado)) {
+                printf("✅ %ld contato(s) gravado(s) em %s\n", resultado.total_mesclado, destino);
+            } else {
+                printf("❌ Erro ao mesclar arquivos\n");
+            }
+        }
+        if (destino) liberar_buffer(destino);
+    } else {
+        printf("❌ Erro ao comparar arquivos\n");
+    }
+    
+    liberar_buffer(arquivo_a);
+    liberar_buffer(arquivo_b);
+    aguardar_enter();
+}
+
+// Medir vazão com um trace de operações mistas sobre uma base sintética separada
+// (a base do menu não é tocada)
+void menu_carga_sintetica(void) {
+    limpar_tela();
+    printf("\n=== CARGA SINTÉTICA (TRACE DE OPERAÇÕES) ===\n\n");
+    
+    char *base_str = ler_string("Contatos na base sintética: ", 20);
+    char *ops_str = base_str ? ler_string("Operações no trace: ", 20) : NULL;
+    char *leitura_str = ops_str ? ler_string("Percentual de leituras (0-100): ", 10) : NULL;
+    char *semente_str = leitura_str ? ler_string("Semente: ", 30) : NULL;
+    if (!semente_str) {
+        if (base_str) liberar_buffer(base_str);
+        if (ops_str) liberar_buffer(ops_str);
+        if (leitura_str) liberar_buffer(leitura_str);
+        return;
+    }
+    long base = strtol(base_str, NULL, 10);
+    long operacoes = strtol(ops_str, NULL, 10);
+    int percentual_leitura = atoi(leitura_str);
+    uint64_t semente = strtoull(semente_str, NULL, 10);
+    liberar_buffer(base_str);
+    liberar_buffer(ops_str);
+    liberar_buffer(leitura_str);
+    liberar_buffer(semente_str);
+    
+    if (base <= 0 || operacoes <= 0 || percentual_leitura < 0 || percentual_leitura > 100) {
+        printf("❌ Valores inválidos!\n");
+        aguardar_enter();
+        return;
+    }
+    
+    ListaContatos *sintetica = criar_lista();
+    ConfiguracaoGerador configuracao;
+    configuracao_gerador_padrao(&configuracao, semente);
+    if (!sintetica || gerar_contatos_realistas(sintetica, base, &configuracao) != base) {
+        printf("❌ Erro ao gerar a base sintética\n");
+        liberar_lista(sintetica);
+        aguardar_enter();
+        return;
+    }
+    
+    ResultadoTrace resultado;
+    if (gerar_trace(sintetica, ARQUIVO_TRACE, operacoes, percentual_leitura, semente) &&
+        reproduzir_trace(sintetica, ARQUIVO_TRACE, &resultado)) {
+        printf("\nTrace gravado em %s\n\n", ARQUIVO_TRACE);
+        imprimir_resultado_trace(&resultado);
+    } else {
+        printf("❌ Erro ao gerar ou reproduzir o trace\n");
+    }
+    
+    liberar_lista(sintetica);
+    aguardar_enter();
+}
+
+static int imprimir_contato_paginado(const Contato *contato, void *contexto) {
+    (void)contexto;
+    printf("%-8d %-30s %-20s %-30s\n", contato->id, contato->nome, contato->telefone, contato->email);
+    return 1;
+}
+
+// Buscar, editar e excluir direto em um arquivo maior que a memória
+void menu_modo_paginado(void) {
+    limpar_tela();
+    printf("\n=== MODO PAGINADO (ARQUIVOS MAIORES QUE A MEMÓRIA) ===\n\n");
+    
+    char *arquivo = ler_string("Arquivo de contatos: ", 256);
+    if (!arquivo) {
+        return;
+    }
+    // A base do menu já está carregada por este processo
+    if (strcmp(arquivo, ARQUIVO_DADOS) == 0) {
+        printf("⚠️  A base em uso já está carregada; escolha outro arquivo.\n");
+        liberar_buffer(arquivo);
+        aguardar_enter();
+        return;
+    }
+    char *memoria_str = ler_string("Memória para páginas em MB (padrão 64): ", 20);
+    size_t memoria = MEMORIA_PAGINADA_PADRAO;
+    if (memoria_str && !string_vazia(memoria_str) && atol(memoria_str) > 0) {
+        memoria = (size_t)atol(memoria_str) * 1024 * 1024;
+    }
+    if (memoria_str) liberar_buffer(memoria_str);
+    
+    clock_t inicio = clock();
+    BasePaginada *base = abrir_base_paginada(arquivo, memoria, 1);
+    if (!base) {
+        printf("❌ Erro ao abrir %s no modo paginado\n", arquivo);
+        liberar_buffer(arquivo);
+        aguardar_enter();
+        return;
+    }
+    printf("✅ %d contato(s) abertos em %.3f segundos\n", base->cabecalho.quantidade,
+           ((double)(clock() - inicio)) / CLOCKS_PER_SEC);
+    
+    int opcao;
+    do {
+        printf("\n1. Buscar por ID\n2. Buscar por telefone\n3. Buscar por termo\n");
+        printf("4. Editar contato\n5. Excluir contato\n6. Estatísticas do pool\n0. Fechar\n");
+        char *opcao_str = ler_string("\nEscolha uma opção: ", 10);
+        opcao = opcao_str ? atoi(opcao_str) : 0;
+        if (opcao_str) liberar_buffer(opcao_str);
+        
+        Contato contato;
+        char *entrada = NULL;
+        switch (opcao) {
+            case 1:
+                entrada = ler_string("ID: ", 20);
+                if (entrada && buscar_paginado_por_id(base, atoi(entrada), &contato)) {
+                    imprimir_contato_paginado(&contato, NULL);
+                } else {
+                    printf("Nenhum contato encontrado.\n");
+                }
+                break;
+            case 2: {
+                entrada = ler_string("Telefone: ", MAX_TELEFONE);
+                Contato encontrados[MAX_SUGESTOES * 4];
+                int n = entrada ? buscar_paginado_por_telefone(base, entrada, encontrados, MAX_SUGESTOES * 4) : 0;
+                for (int i = 0; i < n; i++) {
+                    imprimir_contato_paginado(&encontrados[i], NULL);
+                }
+                printf("Total: %d contato(s)\n", n);
+                break;
+            }
+            case 3:
+                entrada = ler_string("Termo: ", MAX_NOME);
+                if (entrada && !string_vazia(entrada)) {
+                    long total = buscar_paginado(base, entrada, imprimir_contato_paginado, NULL);
+                    printf("Total: %ld contato(s)\n", total);
+                }
+                break;
+            case 4: {
+                entrada = ler_string("ID do contato: ", 20);
+                if (!entrada || !buscar_paginado_por_id(base, atoi(entrada), &contato)) {
+                    printf("❌ Contato não encontrado!\n");
+                    break;
+                }
+                imprimir_contato_paginado(&contato, NULL);
+                printf("(Enter para manter o valor atual)\n");
+                char *nome = ler_string("Novo nome: ", MAX_NOME);
+                char *telefone = ler_string("Novo telefone: ", MAX_TELEFONE);
+                char *email = ler_string("Novo email: ", MAX_EMAIL);
+                if (editar_paginado(base, atoi(entrada), nome, telefone, email)) {
+                    printf("✅ Contato atualizado (gravado ao fechar ou quando a página sair do pool).\n");
+                }
+                if (nome) liberar_buffer(nome);
+                if (telefone) liberar_buffer(telefone);
+                if (email) liberar_buffer(email);
+                break;
+            }
+            case 5:
+                entrada = ler_string("ID do contato: ", 20);
+                if (entrada && excluir_paginado(base, atoi(entrada))) {
+                    printf("✅ Contato excluído.\n");
+                } else {
+                    printf("❌ Contato não encontrado!\n");
+                }
+                break;
+            case 6:
+                imprimir_estatisticas_paginada(base);
+                break;
+            case 0:
+                break;
+            default:
+                printf("❌ Opção inválida!\n");
+                break;
+        }
+        if (entrada) liberar_buffer(entrada);
+    } while (opcao != 0);
+    
+    if (fechar_base_paginada(base)) {
+        printf("✅ Alterações gravadas em %s\n", arquivo);
+    } else {
+        printf("❌ Erro ao gravar alterações em %s\n", arquivo);
+    }
+    liberar_buffer(arquivo);
+    aguardar_enter();
+}
+
+// Desfazer (ou refazer) a última operação aplicando só o seu delta
+void menu_desfazer(ListaContatos *lista, int desfazer) {
+    limpar_tela();
+    printf("\n=== %s ===\n\n", desfazer ? "DESFAZER" : "REFAZER");
+    
+    if (!iniciar_escrita(lista)) {
+        aguardar_enter();
+        return;
+    }
+    const DeltaContato *delta = desfazer ? desfazer_operacao(historico, lista)
+                                         : refazer_operacao(historico, lista);
+    if (delta) {
+        printf("✅ %s da %s do contato %d\n", desfazer ? "Desfeita" : "Refeita",
+               nome_operacao(delta->tipo), delta->id);
+    } else {
+        printf("⚠️  Nada para %s.\n", desfazer ? "desfazer" : "refazer");
+    }
+    concluir_escrita(lista);
+    aguardar_enter();
+}
+
+void menu_ferramentas(ListaContatos *lista) {
+    limpar_tela();
+    printf("\n=== FERRAMENTAS ===\n\n");
+    printf("1. Relatório de domínios\n");
+    printf("2. Detectar contatos duplicados\n");
+    printf("3. Criar snapshot comprimido\n");
+    printf("4. Restaurar snapshot\n");
+    printf("5. Desfazer última alteração (%d disponível(is))\n", operacoes_para_desfazer(historico, lista));
+    printf("6. Refazer alteração desfeita (%d disponível(is))\n", operacoes_para_refazer(historico, lista));
+    printf("7. Alterações desde uma sequência\n");
+    printf("8. Comparar/mesclar arquivos\n");
+    printf("9. Carga sintética (vazão com trace de operações)\n");
+    printf("10. Modo paginado (arquivos maiores que a memória)\n");
+    printf("11. Exportar NDJSON\n");
+    printf("12. Importar NDJSON\n");
+    printf("13. Exportar vCard (.vcf)\n");
+    printf("14. Importar vCard (.vcf)\n");
+    printf("15. Excluir em lote (por critério)\n");
+    printf("16. Editar em lote (por critério)\n");
+    printf("17. Atributos extras de um contato\n");
+    printf("0. Voltar\n");
+    
+    char *opcao_str = ler_string("\nEscolha uma opção: ", 10);
+    int opcao = opcao_str ? atoi(opcao_str) : 0;
+    if (opcao_str) liberar_buffer(opcao_str);
+    
+    switch (opcao) {
+        case 1:
+            menu_relatorio_dominios(lista);
+            break;
+        case 2:
+            menu_duplicados(lista);
+            break;
+        case 3:
+            menu_criar_snapshot(lista);
+            break;
+        case 4:
+            menu_restaurar_snapshot(lista);
+            break;
+        case 5:
+            menu_desfazer(lista, 1);
+            break;
+        case 6:
+            menu_desfazer(lista, 0);
+            break;
+        case 7:
+            menu_alteracoes(lista);
+            break;
+        case 8:
+            menu_comparar_arquivos();
+            break;
+        case 9:
+            menu_carga_sintetica();
+            break;
+        case 10:
+            menu_modo_paginado();
+            break;
+        case 11:
+            menu_exportar_ndjson(lista);
+            break;
+        case 12:
+            menu_importar_ndjson(lista);
+            break;
+        case 13:
+            menu_exportar_vcard(lista);
+            break;
+        case 14:
+            menu_importar_vcard(lista);
+            break;
+        case 15:
+            menu_alterar_em_lote(lista, 1);
+            break;
+        case 16:
+            menu_alterar_em_lote(lista, 0);
+            break;
+        case 17:
+            menu_atributos(lista);
+            break;
+        case 0:
+            break;
+        default:
+            printf("❌ Opção inválida!\n");
+            aguardar_enter();
+            break;
+    }
+}
+
 void executar_menu_interativo() {
     ListaContatos *lista = carregar_contatos(ARQUIVO_DADOS);
     
@@ -336,10 +1366,23 @@ void executar_menu_interativo() {
         return;
     }
     
+    // Salvamentos em segundo plano: a interface não espera o disco a cada alteração
+    salvamento = iniciar_salvamento_automatico(lista, ARQUIVO_DADOS);
+    historico = carregar_historico(ARQUIVO_HISTORICO_PADRAO, lista);
+    
     int opcao = -1;
     
     while (opcao != 0) {
         limpar_tela();
+        
+        // Falhas do salvamento automático aparecem no próximo prompt
+        char erro[TAMANHO_MENSAGEM_SALVAMENTO];
+        int falhas = salvamento ? consultar_falhas_salvamento(salvamento, erro, sizeof(erro)) : 0;
+        if (falhas > 0) {
+            printf("⚠️  Salvamento automático falhou (%d vez(es)): %s\n", falhas, erro);
+            printf("   As alterações continuam em memória; nova tentativa em breve.\n");
+        }
+        
         exibir_menu_principal();
         
         char *opcao_str = ler_linha(10);
@@ -350,6 +1393,13 @@ void executar_menu_interativo() {
             opcao = -1;
         }
         
+        // Leituras usam a versão mais recente publicada, sem bloquear
+        if (salvamento) {
+            sincronizar_lista(salvamento);
+        } else {
+            recarregar_se_alterada(lista, ARQUIVO_DADOS);
+        }
+        
         switch (opcao) {
             case 1:
                 menu_adicionar_contato(lista);
@@ -375,8 +1425,19 @@ void executar_menu_interativo() {
             case 8:
                 menu_teste_stress(lista);
                 break;
+            case 9:
+                menu_ferramentas(lista);
+                break;
             case 0:
                 limpar_tela();
+                // Gravar o que ainda estiver pendente antes de sair
+                if (!encerrar_salvamento_automatico(salvamento)) {
+                    printf("\n⚠️  Aviso: Erro ao salvar dados ao sair.\n");
+                } else if (historico) {
+                    // O histórico vale para a versão do arquivo que acabou de ser salva
+                    salvar_historico(historico, ARQUIVO_HISTORICO_PADRAO, lista);
+                }
+                salvamento = NULL;
                 printf("\n✅ Saindo do sistema...\n");
                 printf("Obrigado por usar o Sistema de Gerenciamento de Contatos!\n\n");
                 break;
@@ -387,5 +1448,7 @@ void executar_menu_interativo() {
         }
     }
     
+    liberar_historico(historico);
+    historico = NULL;
     liberar_lista(lista);
 }
@@ -18,5 +18,21 @@ void menu_excluir_contato(ListaContatos *lista);
 void menu_exportar_csv(ListaContatos *lista);
 void menu_analisar_memoria(ListaContatos *lista);
 void menu_teste_stress(ListaContatos *lista);
+void menu_ferramentas(ListaContatos *lista);
+void menu_relatorio_dominios(ListaContatos *lista);
+void menu_duplicados(ListaContatos *lista);
+void menu_criar_snapshot(ListaContatos *lista);
+void menu_restaurar_snapshot(ListaContatos *lista);
+void menu_desfazer(ListaContatos *lista, int desfazer);
+void menu_alteracoes(ListaContatos *lista);
+void menu_comparar_arquivos(void);
+void menu_carga_sintetica(void);
+void menu_modo_paginado(void);
+void menu_exportar_ndjson(ListaContatos *lista);
+void menu_importar_ndjson(ListaContatos *lista);
+void menu_exportar_vcard(ListaContatos *lista);
+void menu_importar_vcard(ListaContatos *lista);
+void menu_alterar_em_lote(ListaContatos *lista, int excluir);
+void menu_atributos(ListaContatos *lista);
 
 #endif
@@ -0,0 +1,301 @@
+#include "ordenacao_externa.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_REGISTROS_CORRIDA 1024
+#define MIN_REGISTROS_FUSAO 64
+#define MAX_VIAS_FUSAO 4096     // Teto de vias mesmo com muita memória
+
+OrdenacaoExterna* iniciar_ordenacao_externa(size_t tamanho_registro, ComparadorRegistros comparar,
+                                            size_t memoria, const char *temporario) {
+    if (tamanho_registro == 0 || !comparar || !temporario) {
+        return NULL;
+    }
+    OrdenacaoExterna *ordenacao = (OrdenacaoExterna*)calloc(1, sizeof(OrdenacaoExterna));
+    if (!ordenacao) {
+        fprintf(stderr, "Erro ao alocar memória para ordenação\n");
+        return NULL;
+    }
+    ordenacao->tamanho_registro = tamanho_registro;
+    ordenacao->comparar = comparar;
+    ordenacao->memoria = memoria;
+    ordenacao->capacidade = (long)(memoria / tamanho_registro);
+    if (ordenacao->capacidade < MIN_REGISTROS_CORRIDA) {
+        ordenacao->capacidade = MIN_REGISTROS_CORRIDA;
+    }
+    snprintf(ordenacao->caminho, sizeof(ordenacao->caminho), "%s.corridas", temporario);
+    ordenacao->buffer = (unsigned char*)malloc((size_t)ordenacao->capacidade * tamanho_registro);
+    if (!ordenacao->buffer) {
+        fprintf(stderr, "Erro ao alocar memória para ordenação\n");
+        free(ordenacao);
+        return NULL;
+    }
+    ordenacao->ok = 1;
+    return ordenacao;
+}
+
+// Ordenar o buffer e acrescentá-lo ao arquivo das corridas
+static int gravar_corrida(OrdenacaoExterna *ordenacao) {
+    if (!ordenacao->fp) {
+        ordenacao->fp = fopen(ordenacao->caminho, "w+b");
+        if (!ordenacao->fp) {
+            fprintf(stderr, "Erro ao criar arquivo temporário: %s\n", ordenacao->caminho);
+            return 0;
+        }
+    }
+    if (ordenacao->num_corridas >= ordenacao->capacidade_corridas) {
+        int nova_capacidade = ordenacao->capacidade_corridas > 0 ? ordenacao->capacidade_corridas * 2 : 16;
+        long *inicios = (long*)realloc(ordenacao->inicios, nova_capacidade * sizeof(long));
+        if (!inicios) {
+            return 0;
+        }
+        ordenacao->inicios = inicios;
+        long *tamanhos = (long*)realloc(ordenacao->tamanhos, nova_capacidade * sizeof(long));
+        if (!tamanhos) {
+            return 0;
+        }
+        ordenacao->tamanhos = tamanhos;
+        ordenacao->capacidade_corridas = nova_capacidade;
+    }
+    size_t n = (size_t)ordenacao->no_buffer;
+    qsort(ordenacao->buffer, n, ordenacao->tamanho_registro, ordenacao->comparar);
+    if (fwrite(ordenacao->buffer, ordenacao->tamanho_registro, n, ordenacao->fp) != n) {
+        fprintf(stderr, "Erro ao gravar arquivo temporário: %s\n", ordenacao->caminho);
+        return 0;
+    }
+    ordenacao->inicios[ordenacao->num_corridas] = ordenacao->gravados;
+    ordenacao->tamanhos[ordenacao->num_corridas] = ordenacao->no_buffer;
+    ordenacao->num_corridas++;
+    ordenacao->gravados += ordenacao->no_buffer;
+    ordenacao->no_buffer = 0;
+    return 1;
+}
+
+int acrescentar_registro(OrdenacaoExterna *ordenacao, const void *registro) {
+    if (!ordenacao || !registro || !ordenacao->ok || !ordenacao->buffer) {
+        return 0;
+    }
+    if (ordenacao->no_buffer == ordenacao->capacidade) {
+        // Memória cheia: gravar uma corrida ordenada
+        ordenacao->ok = gravar_corrida(ordenacao);
+        if (!ordenacao->ok) {
+            return 0;
+        }
+    }
+    memcpy(ordenacao->buffer + (size_t)ordenacao->no_buffer * ordenacao->tamanho_registro,
+           registro, ordenacao->tamanho_registro);
+    ordenacao->no_buffer++;
+    ordenacao->total++;
+    return 1;
+}
+
+// Cursor de uma corrida na fusão (buffer próprio, recarregado do arquivo)
+typedef struct {
+    unsigned char *buffer;
+    long no_buffer;
+    long posicao_buffer;
+    long proxima;               // Próximo registro da corrida a ler do arquivo
+    long fim;
+} CursorCorrida;
+
+static const void* atual_corrida(OrdenacaoExterna *ordenacao, FILE *fp, CursorCorrida *cursor, long capacidade) {
+    size_t tamanho = ordenacao->tamanho_registro;
+    if (cursor->posicao_buffer < cursor->no_buffer) {
+        return cursor->buffer + (size_t)cursor->posicao_buffer * tamanho;
+    }
+    long restante = cursor->fim - cursor->proxima;
+    if (restante <= 0) {
+        return NULL;
+    }
+    long n = restante < capacidade ? restante : capacidade;
+    if (fseek(fp, cursor->proxima * (long)tamanho, SEEK_SET) != 0 ||
+        fread(cursor->buffer, tamanho, (size_t)n, fp) != (size_t)n) {
+        return NULL;
+    }
+    cursor->proxima += n;
+    cursor->no_buffer = n;
+    cursor->posicao_buffer = 0;
+    return cursor->buffer;
+}
+
+// Fusão de k corridas consecutivas (a partir de "primeira") com um heap de mínimo
+// sobre o registro atual de cada uma
+static int fundir_corridas(OrdenacaoExterna *ordenacao, int primeira, int k, EmissorRegistros emitir, void *contexto) {
+    FILE *fp = ordenacao->fp;
+    ComparadorRegistros comparar = ordenacao->comparar;
+    long capacidade = (long)(ordenacao->memoria / ((size_t)k * ordenacao->tamanho_registro));
+    if (capacidade < MIN_REGISTROS_FUSAO) {
+        capacidade = MIN_REGISTROS_FUSAO;
+    }
+    CursorCorrida *cursores = (CursorCorrida*)calloc((size_t)k, sizeof(CursorCorrida));
+    int *heap = (int*)malloc((size_t)k * sizeof(int));
+    const void **atuais = (const void**)calloc((size_t)k, sizeof(*atuais));
+    int ok = cursores && heap && atuais;
+    for (int i = 0; i < k && ok; i++) {
+        cursores[i].buffer = (unsigned char*)malloc((size_t)capacidade * ordenacao->tamanho_registro);
+        cursores[i].proxima = ordenacao->inicios[primeira + i];
+        cursores[i].fim = ordenacao->inicios[primeira + i] + ordenacao->tamanhos[primeira + i];
+        ok = cursores[i].buffer != NULL;
+    }
+    if (!ok) {
+        fprintf(stderr, "Erro ao alocar memória para fusão das corridas\n");
+    }
+
+    int tamanho_heap = 0;
+    for (int i = 0; i < k && ok; i++) {
+        atuais[i] = atual_corrida(ordenacao, fp, &cursores[i], capacidade);
+        if (atuais[i]) {
+            // Subir no heap
+            int posicao = tamanho_heap++;
+            heap[posicao] = i;
+            while (posicao > 0 && comparar(atuais[heap[(posicao - 1) / 2]], atuais[heap[posicao]]) > 0) {
+                int pai = (posicao - 1) / 2;
+                int t = heap[pai];
+                heap[pai] = heap[posicao];
+                heap[posicao] = t;
+                posicao = pai;
+            }
+        }
+    }
+
+    while (ok && tamanho_heap > 0) {
+        int menor = heap[0];
+        ok = emitir(atuais[menor], contexto);
+        cursores[menor].posicao_buffer++;
+        atuais[menor] = atual_corrida(ordenacao, fp, &cursores[menor], capacidade);
+        if (!atuais[menor]) {
+            ok = ok && cursores[menor].proxima >= cursores[menor].fim; // NULL antes do fim = erro de leitura
+            heap[0] = heap[--tamanho_heap];
+        }
+
+        // Descer a raiz
+        int posicao = 0;
+        while (tamanho_heap > 0) {
+            int esquerda = 2 * posicao + 1;
+            int direita = esquerda + 1;
+            int escolhido = posicao;
+            if (esquerda < tamanho_heap && comparar(atuais[heap[esquerda]], atuais[heap[escolhido]]) < 0) {
+                escolhido = esquerda;
+            }
+            if (direita < tamanho_heap && comparar(atuais[heap[direita]], atuais[heap[escolhido]]) < 0) {
+                escolhido = direita;
+            }
+            if (escolhido == posicao) {
+                break;
+            }
+            int t = heap[escolhido];
+            heap[escolhido] = heap[posicao];
+            heap[posicao] = t;
+            posicao = escolhido;
+        }
+    }
+
+    for (int i = 0; cursores && i < k; i++) {
+        free(cursores[i].buffer);
+    }
+    free(cursores);
+    free(heap);
+    free(atuais);
+    return ok;
+}
+
+// Passada intermediária: grava as corridas fundidas em outro arquivo
+typedef struct {
+    FILE *fp;
+    size_t tamanho_registro;
+} SaidaFusao;
+
+static int gravar_registro_fundido(const void *registro, void *contexto) {
+    SaidaFusao *saida = (SaidaFusao*)contexto;
+    return fwrite(registro, saida->tamanho_registro, 1, saida->fp) == 1;
+}
+
+// Fundir grupos de até max_vias corridas em corridas maiores até que todas
+// caibam em uma única fusão com ao menos MIN_REGISTROS_FUSAO registros por via
+static int reduzir_corridas(OrdenacaoExterna *ordenacao, int max_vias) {
+    char intermediario[660];
+    snprintf(intermediario, sizeof(intermediario), "%s.2", ordenacao->caminho);
+
+    while (ordenacao->num_corridas > max_vias) {
+        SaidaFusao saida = { fopen(intermediario, "w+b"), ordenacao->tamanho_registro };
+        if (!saida.fp) {
+            fprintf(stderr, "Erro ao criar arquivo temporário: %s\n", intermediario);
+            return 0;
+        }
+        int novas = 0;
+        long gravados = 0;
+        int ok = 1;
+        for (int primeira = 0; primeira < ordenacao->num_corridas && ok; primeira += max_vias) {
+            int k = ordenacao->num_corridas - primeira < max_vias ? ordenacao->num_corridas - primeira : max_vias;
+            long registros = 0;
+            for (int i = 0; i < k; i++) {
+                registros += ordenacao->tamanhos[primeira + i];
+            }
+            ok = fundir_corridas(ordenacao, primeira, k, gravar_registro_fundido, &saida);
+            // Cada grupo vira uma corrida; a posição "novas" nunca passa de "primeira"
+            ordenacao->inicios[novas] = gravados;
+            ordenacao->tamanhos[novas] = registros;
+            novas++;
+            gravados += registros;
+        }
+        ok = ok && fflush(saida.fp) == 0;
+        fclose(ordenacao->fp);
+        ordenacao->fp = saida.fp;
+        if (!ok || rename(intermediario, ordenacao->caminho) != 0) {
+            fprintf(stderr, "Erro ao gravar arquivo temporário: %s\n", intermediario);
+            remove(intermediario);
+            return 0;
+        }
+        ordenacao->num_corridas = novas;
+    }
+    return 1;
+}
+
+int concluir_ordenacao_externa(OrdenacaoExterna *ordenacao, EmissorRegistros emitir, void *contexto) {
+    if (!ordenacao || !emitir || !ordenacao->ok) {
+        return 0;
+    }
+    if (!ordenacao->fp) {
+        // Tudo coube na memória
+        qsort(ordenacao->buffer, (size_t)ordenacao->no_buffer, ordenacao->tamanho_registro, ordenacao->comparar);
+        for (long i = 0; i < ordenacao->no_buffer; i++) {
+            if (!emitir(ordenacao->buffer + (size_t)i * ordenacao->tamanho_registro, contexto)) {
+                ordenacao->ok = 0;
+                break;
+            }
+        }
+        ordenacao->no_buffer = 0;
+        return ordenacao->ok;
+    }
+
+    ordenacao->ok = (ordenacao->no_buffer == 0 || gravar_corrida(ordenacao)) && fflush(ordenacao->fp) == 0;
+    // A memória do buffer de acumulação passa para os cursores da fusão
+    free(ordenacao->buffer);
+    ordenacao->buffer = NULL;
+    // Vias limitadas pela memória: cada uma precisa de MIN_REGISTROS_FUSAO registros
+    // de buffer; com mais corridas, passadas intermediárias as fundem em grupos
+    long max_vias = (long)(ordenacao->memoria / ((size_t)MIN_REGISTROS_FUSAO * ordenacao->tamanho_registro));
+    if (max_vias < 2) {
+        max_vias = 2;
+    }
+    if (max_vias > MAX_VIAS_FUSAO) {
+        max_vias = MAX_VIAS_FUSAO;
+    }
+    ordenacao->ok = ordenacao->ok && reduzir_corridas(ordenacao, (int)max_vias) &&
+                    fundir_corridas(ordenacao, 0, ordenacao->num_corridas, emitir, contexto);
+    return ordenacao->ok;
+}
+
+void liberar_ordenacao_externa(OrdenacaoExterna *ordenacao) {
+    if (!ordenacao) {
+        return;
+    }
+    if (ordenacao->fp) {
+        fclose(ordenacao->fp);
+        remove(ordenacao->caminho);
+    }
+    free(ordenacao->inicios);
+    free(ordenacao->tamanhos);
+    free(ordenacao->buffer);
+    free(ordenacao);
+}
@@ -0,0 +1,50 @@
+#ifndef ORDENACAO_EXTERNA_H
+#define ORDENACAO_EXTERNA_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Ordenação de registros de tamanho fixo com memória limitada: os registros
+// acumulam em um buffer do tamanho da memória configurada; se tudo couber, são
+// ordenados em memória. Senão, cada buffer cheio vira uma corrida ordenada em um
+// arquivo temporário e, no final, as corridas são fundidas em k vias com um heap
+// As vias são limitadas a memória / (64 registros), para que cada uma leia em
+// blocos razoáveis; com mais corridas, passadas intermediárias fundem grupos de
+// corridas em um segundo arquivo ("<corridas>.2") até sobrarem poucas
+typedef int (*ComparadorRegistros)(const void *a, const void *b);
+
+// Recebe os registros em ordem; retorna 0 para interromper com erro
+typedef int (*EmissorRegistros)(const void *registro, void *contexto);
+
+typedef struct {
+    size_t tamanho_registro;
+    ComparadorRegistros comparar;
+    size_t memoria;
+    char caminho[640];          // Arquivo temporário das corridas (criado só se necessário)
+    FILE *fp;
+    unsigned char *buffer;
+    long capacidade;            // Registros por corrida
+    long no_buffer;
+    long *inicios;              // Em registros
+    long *tamanhos;
+    int num_corridas;
+    int capacidade_corridas;
+    long gravados;              // Registros já gravados em corridas
+    long total;
+    int ok;
+} OrdenacaoExterna;
+
+// "temporario" é o prefixo do arquivo das corridas (recebe ".corridas")
+OrdenacaoExterna* iniciar_ordenacao_externa(size_t tamanho_registro, ComparadorRegistros comparar,
+                                            size_t memoria, const char *temporario);
+
+// Copiar um registro para a ordenação; retorna 1 em sucesso
+int acrescentar_registro(OrdenacaoExterna *ordenacao, const void *registro);
+
+// Emitir todos os registros em ordem (uma única vez); retorna 1 se todos foram emitidos
+int concluir_ordenacao_externa(OrdenacaoExterna *ordenacao, EmissorRegistros emitir, void *contexto);
+
+// Liberar a memória e remover o arquivo das corridas
+void liberar_ordenacao_externa(OrdenacaoExterna *ordenacao);
+
+#endif
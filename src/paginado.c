@@ -0,0 +1,1085 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // flock()
+
+#include "paginado.h"
+#include "alteracoes.h"
+#include "bloqueio.h"
+#include "ordenacao_externa.h"
+#include "utils/crc32c.h"
+#include "utils/string_utils.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TAMANHO_PAGINA ((size_t)CONTATOS_POR_BLOCO * sizeof(Contato))
+
+static int ler_completo(int fd, void *destino, size_t tamanho, off_t posicao) {
+    unsigned char *p = (unsigned char*)destino;
+    while (tamanho > 0) {
+        ssize_t lidos = pread(fd, p, tamanho, posicao);
+        if (lidos <= 0) {
+            return 0;
+        }
+        p += lidos;
+        tamanho -= (size_t)lidos;
+        posicao += lidos;
+    }
+    return 1;
+}
+
+static int escrever_completo(int fd, const void *origem, size_t tamanho, off_t posicao) {
+    const unsigned char *p = (const unsigned char*)origem;
+    while (tamanho > 0) {
+        ssize_t escritos = pwrite(fd, p, tamanho, posicao);
+        if (escritos <= 0) {
+            return 0;
+        }
+        p += escritos;
+        tamanho -= (size_t)escritos;
+        posicao += escritos;
+    }
+    return 1;
+}
+
+static void travar(int fd, int operacao) {
+    while (flock(fd, operacao) != 0 && errno == EINTR) {
+    }
+}
+
+// Chave do índice: FNV-1a de 64 bits do telefone normalizado (0 = sem telefone)
+static uint64_t chave_telefone(const char *telefone) {
+    char normalizado[MAX_TELEFONE];
+    normalizar_telefone(telefone, normalizado, sizeof(normalizado));
+    if (!normalizado[0]) {
+        return 0;
+    }
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char *p = (const unsigned char*)normalizado; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash ? hash : 1;
+}
+
+static int contatos_no_bloco(const BasePaginada *base, uint32_t bloco) {
+    int restante = base->cabecalho.quantidade - (int)bloco * CONTATOS_POR_BLOCO;
+    return restante < CONTATOS_POR_BLOCO ? restante : CONTATOS_POR_BLOCO;
+}
+
+static off_t posicao_bloco(const BasePaginada *base, uint32_t bloco) {
+    return base->inicio_dados + (off_t)bloco * (off_t)TAMANHO_PAGINA;
+}
+
+// Ler um bloco do arquivo verificando o CRC
+static int ler_bloco(BasePaginada *base, uint32_t bloco, Contato *destino) {
+    size_t tamanho = (size_t)contatos_no_bloco(base, bloco) * sizeof(Contato);
+    if (!ler_completo(base->fd, destino, tamanho, posicao_bloco(base, bloco))) {
+        fprintf(stderr, "Erro ao ler bloco %u de %s\n", bloco, base->arquivo);
+        return 0;
+    }
+    if (crc32c(0, destino, tamanho) != base->crcs[bloco]) {
+        fprintf(stderr, "Erro: bloco %u de %s corrompido (CRC divergente)\n", bloco, base->arquivo);
+        return 0;
+    }
+    return 1;
+}
+
+// ==================== Pool de páginas ====================
+
+static void lru_remover(BasePaginada *base, int q) {
+    QuadroPagina *quadro = &base->quadros[q];
+    if (quadro->anterior >= 0) {
+        base->quadros[quadro->anterior].proximo = quadro->proximo;
+    } else {
+        base->mais_recente = quadro->proximo;
+    }
+    if (quadro->proximo >= 0) {
+        base->quadros[quadro->proximo].anterior = quadro->anterior;
+    } else {
+        base->menos_recente = quadro->anterior;
+    }
+    quadro->anterior = quadro->proximo = -1;
+}
+
+static void lru_inserir_frente(BasePaginada *base, int q) {
+    QuadroPagina *quadro = &base->quadros[q];
+    quadro->anterior = -1;
+    quadro->proximo = base->mais_recente;
+    if (base->mais_recente >= 0) {
+        base->quadros[base->mais_recente].anterior = q;
+    }
+    base->mais_recente = q;
+    if (base->menos_recente < 0) {
+        base->menos_recente = q;
+    }
+}
+
+static void nome_arquivo_diario(const char *arquivo, char *destino, size_t tamanho) {
+    snprintf(destino, tamanho, "%s.diario", arquivo);
+}
+
+static uint64_t inode_dados(int fd) {
+    struct stat st;
+    return fstat(fd, &st) == 0 ? (uint64_t)st.st_ino : 0;
+}
+
+static off_t posicao_crc(const BasePaginada *base, uint32_t bloco) {
+    return (off_t)base->tamanho_cabecalho + (off_t)bloco * (off_t)sizeof(uint32_t);
+}
+
+// Gravar no diário o cabeçalho novo e as páginas, e levá-lo ao disco
+static int gravar_diario(BasePaginada *base, const CabecalhoBlocos *cabecalho,
+                         QuadroPagina **quadros, uint32_t num_quadros) {
+    char caminho[520];
+    nome_arquivo_diario(base->arquivo, caminho, sizeof(caminho));
+    int fd = open(caminho, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Erro ao criar o diário %s\n", caminho);
+        return 0;
+    }
+
+    CabecalhoDiarioPaginado diario;
+    memset(&diario, 0, sizeof(diario));
+    memcpy(diario.assinatura, ASSINATURA_DIARIO_PAGINADO, sizeof(diario.assinatura));
+    diario.versao = VERSAO_DIARIO_PAGINADO;
+    diario.inode = inode_dados(base->fd);
+    diario.num_paginas = num_quadros;
+
+    off_t posicao = (off_t)sizeof(diario);
+    int ok = escrever_completo(fd, cabecalho, sizeof(*cabecalho), posicao);
+    uint32_t crc = crc32c(0, cabecalho, sizeof(*cabecalho));
+    posicao += (off_t)sizeof(*cabecalho);
+    for (uint32_t i = 0; ok && i < num_quadros; i++) {
+        uint32_t bloco = (uint32_t)quadros[i]->bloco;
+        size_t tamanho = (size_t)contatos_no_bloco(base, bloco) * sizeof(Contato);
+        ok = escrever_completo(fd, &bloco, sizeof(bloco), posicao) &&
+             escrever_completo(fd, quadros[i]->contatos, tamanho, posicao + (off_t)sizeof(bloco));
+        crc = crc32c(crc, &bloco, sizeof(bloco));
+        crc = crc32c(crc, quadros[i]->contatos, tamanho);
+        posicao += (off_t)sizeof(bloco) + (off_t)tamanho;
+    }
+    diario.crc = crc;
+    // Cabeçalho por último: um diário sem ele (ou com CRC divergente) é ignorado
+    ok = ok && escrever_completo(fd, &diario, sizeof(diario), 0) && fsync(fd) == 0;
+    close(fd);
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar o diário %s\n", caminho);
+        remove(caminho);
+    }
+    return ok;
+}
+
+static size_t bytes_no_bloco(int32_t quantidade, uint32_t bloco) {
+    int32_t restante = quantidade - (int32_t)bloco * CONTATOS_POR_BLOCO;
+    return (size_t)(restante < CONTATOS_POR_BLOCO ? restante : CONTATOS_POR_BLOCO) * sizeof(Contato);
+}
+
+// Aplicar o diário deixado por uma gravação interrompida, antes de validar o
+// cabeçalho (a queda pode ter sido entre a tabela de CRCs e o cabeçalho). Só em
+// escrita, com o bloqueio de escrita retido. Um diário incompleto ou de outra
+// versão do arquivo é descartado: os dados ainda não tinham sido tocados
+// Retorna 0 só se o diário é válido e não pôde ser aplicado
+static int recuperar_diario(int fd_dados, const char *arquivo) {
+    char caminho[520];
+    nome_arquivo_diario(arquivo, caminho, sizeof(caminho));
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return 1;
+    }
+
+    CabecalhoDiarioPaginado diario;
+    CabecalhoBlocos cabecalho;
+    struct stat info;
+    int valido = fstat(fd_dados, &info) == 0 &&
+                 ler_completo(fd, &diario, sizeof(diario), 0) &&
+                 memcmp(diario.assinatura, ASSINATURA_DIARIO_PAGINADO, sizeof(diario.assinatura)) == 0 &&
+                 diario.versao == VERSAO_DIARIO_PAGINADO &&
+                 diario.inode == (uint64_t)info.st_ino &&
+                 ler_completo(fd, &cabecalho, sizeof(cabecalho), (off_t)sizeof(diario)) &&
+                 cabecalho.versao == VERSAO_BLOCOS && cabecalho.quantidade >= 0 &&
+                 cabecalho.contatos_por_bloco == CONTATOS_POR_BLOCO &&
+                 cabecalho.num_blocos ==
+                     (uint32_t)((cabecalho.quantidade + CONTATOS_POR_BLOCO - 1) / CONTATOS_POR_BLOCO) &&
+                 diario.num_paginas <= cabecalho.num_blocos;
+    off_t tamanho_cabecalho = (off_t)sizeof(CabecalhoBlocos);
+    off_t inicio_dados = tamanho_cabecalho + (off_t)cabecalho.num_blocos * (off_t)sizeof(uint32_t);
+    // O modo paginado não muda o tamanho do arquivo
+    valido = valido && info.st_size == inicio_dados + (off_t)cabecalho.quantidade * (off_t)sizeof(Contato);
+
+    Contato *pagina = valido ? (Contato*)malloc(TAMANHO_PAGINA) : NULL;
+    uint32_t *crcs = valido ? (uint32_t*)malloc((cabecalho.num_blocos > 0 ? cabecalho.num_blocos : 1) *
+                                                sizeof(uint32_t)) : NULL;
+    if (valido && (!pagina || !crcs)) {
+        fprintf(stderr, "Erro ao alocar memória para aplicar o diário %s\n", caminho);
+        free(pagina);
+        free(crcs);
+        close(fd);
+        return 0;
+    }
+
+    // Primeira passada só verifica: nada é aplicado de um diário corrompido
+    uint32_t crc = crc32c(0, &cabecalho, sizeof(cabecalho));
+    off_t inicio = (off_t)sizeof(diario) + (off_t)sizeof(cabecalho);
+    off_t posicao = inicio;
+    for (uint32_t i = 0; valido && i < diario.num_paginas; i++) {
+        uint32_t bloco;
+        valido = ler_completo(fd, &bloco, sizeof(bloco), posicao) && bloco < cabecalho.num_blocos &&
+                 ler_completo(fd, pagina, bytes_no_bloco(cabecalho.quantidade, bloco),
+                              posicao + (off_t)sizeof(bloco));
+        if (valido) {
+            crc = crc32c(crc, &bloco, sizeof(bloco));
+            crc = crc32c(crc, pagina, bytes_no_bloco(cabecalho.quantidade, bloco));
+            posicao += (off_t)sizeof(bloco) + (off_t)bytes_no_bloco(cabecalho.quantidade, bloco);
+        }
+    }
+    if (!valido || crc != diario.crc) {
+        free(pagina);
+        free(crcs);
+        close(fd);
+        remove(caminho);
+        return 1;
+    }
+
+    // Mesma ordem da gravação: blocos e fsync, depois tabela e cabeçalho
+    int ok = ler_completo(fd_dados, crcs, cabecalho.num_blocos * sizeof(uint32_t), tamanho_cabecalho);
+    posicao = inicio;
+    for (uint32_t i = 0; ok && i < diario.num_paginas; i++) {
+        uint32_t bloco;
+        ok = ler_completo(fd, &bloco, sizeof(bloco), posicao);
+        size_t tamanho = bytes_no_bloco(cabecalho.quantidade, bloco);
+        ok = ok && ler_completo(fd, pagina, tamanho, posicao + (off_t)sizeof(bloco)) &&
+             escrever_completo(fd_dados, pagina, tamanho, inicio_dados + (off_t)bloco * (off_t)TAMANHO_PAGINA);
+        if (ok) {
+            crcs[bloco] = crc32c(0, pagina, tamanho);
+            posicao += (off_t)sizeof(bloco) + (off_t)tamanho;
+        }
+    }
+    close(fd);
+    cabecalho.crc_tabela = crc32c(0, crcs, cabecalho.num_blocos * sizeof(uint32_t));
+    ok = ok && fsync(fd_dados) == 0 &&
+         escrever_completo(fd_dados, crcs, cabecalho.num_blocos * sizeof(uint32_t), tamanho_cabecalho) &&
+         escrever_completo(fd_dados, &cabecalho, sizeof(cabecalho), 0) && fsync(fd_dados) == 0;
+    free(pagina);
+    free(crcs);
+    if (!ok) {
+        fprintf(stderr, "Erro ao aplicar o diário %s\n", caminho);
+        return 0;
+    }
+    remove(caminho);
+    printf("⚠️  Gravação interrompida de %s concluída a partir do diário.\n", arquivo);
+    return 1;
+}
+
+// Gravar as páginas alteradas de volta, com seus CRCs na tabela e o CRC da
+// tabela no cabeçalho. Ordem: diário em disco, blocos no lugar e fsync, só
+// então tabela e cabeçalho e outro fsync; o diário é removido no fim. Tudo
+// sob bloqueio exclusivo do arquivo: quem o lê (bloqueio compartilhado) sempre
+// vê blocos e tabela coerentes
+static int gravar_sujas(BasePaginada *base) {
+    QuadroPagina **sujos = (QuadroPagina**)malloc((size_t)(base->quadros_usados > 0 ? base->quadros_usados : 1) *
+                                                  sizeof(QuadroPagina*));
+    if (!sujos) {
+        fprintf(stderr, "Erro ao alocar memória para gravar %s\n", base->arquivo);
+        return 0;
+    }
+    uint32_t num_sujos = 0;
+    for (int q = 0; q < base->quadros_usados; q++) {
+        if (base->quadros[q].sujo && base->quadros[q].bloco >= 0) {
+            sujos[num_sujos++] = &base->quadros[q];
+        }
+    }
+
+    // Tabela nova calculada antes de tocar o arquivo; a atual fica se algo falhar
+    uint32_t num_blocos = base->cabecalho.num_blocos;
+    uint32_t *crcs = (uint32_t*)malloc((num_blocos > 0 ? num_blocos : 1) * sizeof(uint32_t));
+    if (!crcs) {
+        fprintf(stderr, "Erro ao alocar memória para gravar %s\n", base->arquivo);
+        free(sujos);
+        return 0;
+    }
+    memcpy(crcs, base->crcs, num_blocos * sizeof(uint32_t));
+    for (uint32_t i = 0; i < num_sujos; i++) {
+        uint32_t bloco = (uint32_t)sujos[i]->bloco;
+        crcs[bloco] = crc32c(0, sujos[i]->contatos, (size_t)contatos_no_bloco(base, bloco) * sizeof(Contato));
+    }
+    CabecalhoBlocos cabecalho = base->cabecalho;
+    cabecalho.sequencia = base->sequencia_gravada;
+    cabecalho.crc_tabela = crc32c(0, crcs, num_blocos * sizeof(uint32_t));
+
+    travar(base->fd, LOCK_EX);
+    int ok = gravar_diario(base, &cabecalho, sujos, num_sujos);
+    for (uint32_t i = 0; ok && i < num_sujos; i++) {
+        uint32_t bloco = (uint32_t)sujos[i]->bloco;
+        ok = escrever_completo(base->fd, sujos[i]->contatos,
+                               (size_t)contatos_no_bloco(base, bloco) * sizeof(Contato), posicao_bloco(base, bloco));
+    }
+    ok = ok && fsync(base->fd) == 0;
+    for (uint32_t i = 0; ok && i < num_sujos; i++) {
+        uint32_t bloco = (uint32_t)sujos[i]->bloco;
+        ok = escrever_completo(base->fd, &crcs[bloco], sizeof(uint32_t), posicao_crc(base, bloco));
+    }
+    ok = ok && escrever_completo(base->fd, &cabecalho, sizeof(cabecalho), 0) && fsync(base->fd) == 0;
+    travar(base->fd, LOCK_UN);
+
+    if (ok) {
+        char caminho[520];
+        nome_arquivo_diario(base->arquivo, caminho, sizeof(caminho));
+        remove(caminho);
+        free(base->crcs);
+        base->crcs = crcs;
+        base->cabecalho.crc_tabela = cabecalho.crc_tabela;
+        for (uint32_t i = 0; i < num_sujos; i++) {
+            sujos[i]->sujo = 0;
+        }
+        base->estatisticas.gravacoes += num_sujos;
+    } else {
+        // Um diário já gravado fica: a próxima abertura para escrita o aplica
+        fprintf(stderr, "Erro ao gravar páginas de %s\n", base->arquivo);
+        free(crcs);
+    }
+    free(sujos);
+    return ok;
+}
+
+// Página do bloco no pool (lida do arquivo se preciso, despejando a menos usada)
+// O ponteiro vale até a próxima chamada
+static Contato* obter_pagina(BasePaginada *base, uint32_t bloco) {
+    int q = base->quadro_do_bloco[bloco];
+    if (q >= 0) {
+        base->estatisticas.acertos++;
+        if (base->mais_recente != q) {
+            lru_remover(base, q);
+            lru_inserir_frente(base, q);
+        }
+        return base->quadros[q].contatos;
+    }
+    base->estatisticas.faltas++;
+
+    if (base->quadros_usados < base->num_quadros) {
+        q = base->quadros_usados;
+        base->quadros[q].contatos = (Contato*)malloc(TAMANHO_PAGINA);
+        if (!base->quadros[q].contatos) {
+            fprintf(stderr, "Erro ao alocar página do pool\n");
+            return NULL;
+        }
+        base->quadros[q].bloco = -1;
+        base->quadros[q].anterior = base->quadros[q].proximo = -1;
+        base->quadros_usados++;
+    } else {
+        q = base->menos_recente;
+        QuadroPagina *vitima = &base->quadros[q];
+        // Um despejo sujo grava todas as alteradas: um só diário para o lote
+        if (vitima->sujo && !gravar_sujas(base)) {
+            return NULL;
+        }
+        lru_remover(base, q);
+        if (vitima->bloco >= 0) {
+            base->quadro_do_bloco[vitima->bloco] = -1;
+            vitima->bloco = -1;
+            base->estatisticas.despejos++;
+        }
+    }
+
+    QuadroPagina *quadro = &base->quadros[q];
+    if (!ler_bloco(base, bloco, quadro->contatos)) {
+        // Quadro sem bloco volta ao fim da fila, para ser o próximo reutilizado
+        quadro->sujo = 0;
+        if (base->menos_recente >= 0) {
+            base->quadros[base->menos_recente].proximo = q;
+        } else {
+            base->mais_recente = q;
+        }
+        quadro->anterior = base->menos_recente;
+        quadro->proximo = -1;
+        base->menos_recente = q;
+        return NULL;
+    }
+    quadro->bloco = (int32_t)bloco;
+    quadro->sujo = 0;
+    base->quadro_do_bloco[bloco] = q;
+    lru_inserir_frente(base, q);
+    return quadro->contatos;
+}
+
+// Contato com o ID (ativo ou não) no pool; bloco da página em *bloco
+static Contato* localizar_contato(BasePaginada *base, int id, uint32_t *bloco) {
+    if (base->cabecalho.num_blocos == 0 || id < base->primeiro_id[0]) {
+        return NULL;
+    }
+
+    // Último bloco cujo primeiro ID é <= id
+    uint32_t inicio = 0;
+    uint32_t fim = base->cabecalho.num_blocos - 1;
+    while (inicio < fim) {
+        uint32_t meio = inicio + (fim - inicio + 1) / 2;
+        if (base->primeiro_id[meio] <= id) {
+            inicio = meio;
+        } else {
+            fim = meio - 1;
+        }
+    }
+
+    Contato *pagina = obter_pagina(base, inicio);
+    if (!pagina) {
+        return NULL;
+    }
+    int esquerda = 0;
+    int direita = contatos_no_bloco(base, inicio) - 1;
+    while (esquerda <= direita) {
+        int meio = esquerda + (direita - esquerda) / 2;
+        if (pagina[meio].id == id) {
+            if (bloco) {
+                *bloco = inicio;
+            }
+            return &pagina[meio];
+        }
+        if (pagina[meio].id < id) {
+            esquerda = meio + 1;
+        } else {
+            direita = meio - 1;
+        }
+    }
+    return NULL;
+}
+
+static void marcar_sujo(BasePaginada *base, uint32_t bloco) {
+    int q = base->quadro_do_bloco[bloco];
+    if (q >= 0) {
+        base->quadros[q].sujo = 1;
+    }
+}
+
+// ==================== Índice em disco ====================
+
+static void caminho_indice(const BasePaginada *base, char *destino, size_t tamanho) {
+    snprintf(destino, tamanho, "%s.idx", base->arquivo);
+}
+
+static int comparar_entradas(const void *a, const void *b) {
+    const EntradaTelefone *ea = (const EntradaTelefone*)a;
+    const EntradaTelefone *eb = (const EntradaTelefone*)b;
+    if (ea->chave != eb->chave) {
+        return ea->chave < eb->chave ? -1 : 1;
+    }
+    return (ea->id > eb->id) - (ea->id < eb->id);
+}
+
+// Saída do índice: entradas em ordem, com uma cerca a cada página
+typedef struct {
+    FILE *fp;
+    uint64_t escritas;
+    uint64_t *cercas;
+    uint64_t num_cercas;
+    uint64_t capacidade_cercas;
+} SaidaIndice;
+
+static int emitir_entrada(const void *registro, void *contexto) {
+    SaidaIndice *saida = (SaidaIndice*)contexto;
+    const EntradaTelefone *entrada = (const EntradaTelefone*)registro;
+    if (saida->escritas % ENTRADAS_POR_PAGINA_INDICE == 0) {
+        if (saida->num_cercas >= saida->capacidade_cercas) {
+            uint64_t nova_capacidade = saida->capacidade_cercas > 0 ? saida->capacidade_cercas * 2 : 256;
+            uint64_t *novas = (uint64_t*)realloc(saida->cercas, nova_capacidade * sizeof(uint64_t));
+            if (!novas) {
+                return 0;
+            }
+            saida->cercas = novas;
+            saida->capacidade_cercas = nova_capacidade;
+        }
+        saida->cercas[saida->num_cercas++] = entrada->chave;
+    }
+    if (fwrite(entrada, sizeof(*entrada), 1, saida->fp) != 1) {
+        return 0;
+    }
+    saida->escritas++;
+    return 1;
+}
+
+// Construir o índice: uma passada sobre os blocos e ordenação externa dos
+// telefones (corridas do tamanho da memória configurada e fusão em k vias)
+static int construir_indice(BasePaginada *base, size_t memoria) {
+    char caminho[550];
+    char temporario[600];
+    caminho_indice(base, caminho, sizeof(caminho));
+    nome_arquivo_temporario(caminho, temporario, sizeof(temporario));
+
+    uint32_t num_blocos = base->cabecalho.num_blocos;
+    OrdenacaoExterna *ordenacao = iniciar_ordenacao_externa(sizeof(EntradaTelefone), comparar_entradas,
+                                                            memoria, temporario);
+    int32_t *primeiro_id = (int32_t*)malloc((num_blocos > 0 ? num_blocos : 1) * sizeof(int32_t));
+    FILE *fp = fopen(temporario, "wb");
+    if (!ordenacao || !primeiro_id || !fp) {
+        fprintf(stderr, "Erro ao preparar a construção do índice: %s\n", caminho);
+        liberar_ordenacao_externa(ordenacao);
+        free(primeiro_id);
+        if (fp) {
+            fclose(fp);
+            remove(temporario);
+        }
+        return 0;
+    }
+
+    int ok = 1;
+    for (uint32_t b = 0; b < num_blocos && ok; b++) {
+        ok = ler_bloco(base, b, base->pagina_varredura);
+        int n = contatos_no_bloco(base, b);
+        primeiro_id[b] = base->pagina_varredura[0].id;
+        for (int i = 0; i < n && ok; i++) {
+            const Contato *contato = &base->pagina_varredura[i];
+            uint64_t chave = contato->ativo ? chave_telefone(contato->telefone) : 0;
+            if (!chave) {
+                continue;
+            }
+            EntradaTelefone entrada = { chave, contato->id, 0 };
+            ok = acrescentar_registro(ordenacao, &entrada);
+        }
+    }
+
+    CabecalhoIndicePaginado cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, ASSINATURA_INDICE_PAGINADO, sizeof(cabecalho.assinatura));
+    cabecalho.versao = VERSAO_INDICE_PAGINADO;
+    cabecalho.sequencia = base->sequencia_gravada;
+    struct stat info;
+    cabecalho.inode = fstat(base->fd, &info) == 0 ? (uint64_t)info.st_ino : 0;
+    cabecalho.quantidade = base->cabecalho.quantidade;
+    cabecalho.num_blocos = num_blocos;
+
+    SaidaIndice saida;
+    memset(&saida, 0, sizeof(saida));
+    saida.fp = fp;
+    ok = ok && fwrite(&cabecalho, sizeof(cabecalho), 1, fp) == 1 &&
+         (num_blocos == 0 || fwrite(primeiro_id, sizeof(int32_t), num_blocos, fp) == num_blocos) &&
+         concluir_ordenacao_externa(ordenacao, emitir_entrada, &saida);
+
+    cabecalho.num_telefones = saida.escritas;
+    ok = ok &&
+         (saida.num_cercas == 0 || fwrite(saida.cercas, sizeof(uint64_t), saida.num_cercas, fp) == saida.num_cercas) &&
+         fseek(fp, 0, SEEK_SET) == 0 && fwrite(&cabecalho, sizeof(cabecalho), 1, fp) == 1 &&
+         gravar_em_disco(fp);
+    ok = fclose(fp) == 0 && ok;
+    if (ok && rename(temporario, caminho) != 0) {
+        ok = 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "Erro ao construir índice: %s\n", caminho);
+        remove(temporario);
+    }
+
+    liberar_ordenacao_externa(ordenacao);
+    free(saida.cercas);
+    free(primeiro_id);
+    return ok;
+}
+
+// Abrir o índice se corresponde ao arquivo de dados atual; 0 se ausente, antigo ou inválido
+static int carregar_indice(BasePaginada *base) {
+    char caminho[550];
+    caminho_indice(base, caminho, sizeof(caminho));
+    int fd = open(caminho, base->escrita ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    CabecalhoIndicePaginado cabecalho;
+    struct stat info_dados, info;
+    uint32_t num_blocos = base->cabecalho.num_blocos;
+    if (!ler_completo(fd, &cabecalho, sizeof(cabecalho), 0) || fstat(fd, &info) != 0 ||
+        fstat(base->fd, &info_dados) != 0 ||
+        memcmp(cabecalho.assinatura, ASSINATURA_INDICE_PAGINADO, sizeof(cabecalho.assinatura)) != 0 ||
+        cabecalho.versao != VERSAO_INDICE_PAGINADO || cabecalho.sequencia != base->sequencia_gravada ||
+        cabecalho.inode != (uint64_t)info_dados.st_ino || cabecalho.quantidade != base->cabecalho.quantidade ||
+        cabecalho.num_blocos != num_blocos || cabecalho.num_extras > LIMITE_EXTRAS_INDICE) {
+        close(fd);
+        return 0;
+    }
+
+    uint64_t num_cercas = (cabecalho.num_telefones + ENTRADAS_POR_PAGINA_INDICE - 1) / ENTRADAS_POR_PAGINA_INDICE;
+    off_t inicio_telefones = (off_t)sizeof(cabecalho) + (off_t)num_blocos * (off_t)sizeof(int32_t);
+    off_t inicio_cercas = inicio_telefones + (off_t)cabecalho.num_telefones * (off_t)sizeof(EntradaTelefone);
+    off_t inicio_extras = inicio_cercas + (off_t)num_cercas * (off_t)sizeof(uint64_t);
+    if (info.st_size != inicio_extras + (off_t)cabecalho.num_extras * (off_t)sizeof(EntradaTelefone)) {
+        close(fd);
+        return 0;
+    }
+
+    uint32_t capacidade_extras = cabecalho.num_extras > 64 ? cabecalho.num_extras : 64;
+    int32_t *primeiro_id = (int32_t*)malloc((num_blocos > 0 ? num_blocos : 1) * sizeof(int32_t));
+    uint64_t *cercas = (uint64_t*)malloc((num_cercas > 0 ? num_cercas : 1) * sizeof(uint64_t));
+    EntradaTelefone *extras = (EntradaTelefone*)malloc(capacidade_extras * sizeof(EntradaTelefone));
+    if (!primeiro_id || !cercas || !extras ||
+        !ler_completo(fd, primeiro_id, num_blocos * sizeof(int32_t), (off_t)sizeof(cabecalho)) ||
+        !ler_completo(fd, cercas, num_cercas * sizeof(uint64_t), inicio_cercas) ||
+        !ler_completo(fd, extras, cabecalho.num_extras * sizeof(EntradaTelefone), inicio_extras)) {
+        free(primeiro_id);
+        free(cercas);
+        free(extras);
+        close(fd);
+        return 0;
+    }
+
+    base->fd_indice = fd;
+    base->primeiro_id = primeiro_id;
+    base->inicio_telefones = inicio_telefones;
+    base->num_telefones = cabecalho.num_telefones;
+    base->cercas = cercas;
+    base->num_cercas = num_cercas;
+    base->extras = extras;
+    base->num_extras = base->extras_gravados = cabecalho.num_extras;
+    base->capacidade_extras = capacidade_extras;
+    return 1;
+}
+
+// Acrescentar ao índice os telefones editados e a sequência atual
+static int atualizar_indice(BasePaginada *base) {
+    CabecalhoIndicePaginado cabecalho;
+    if (!ler_completo(base->fd_indice, &cabecalho, sizeof(cabecalho), 0)) {
+        return 0;
+    }
+    off_t fim = (off_t)sizeof(cabecalho) + (off_t)base->cabecalho.num_blocos * (off_t)sizeof(int32_t) +
+                (off_t)base->num_telefones * (off_t)sizeof(EntradaTelefone) +
+                (off_t)base->num_cercas * (off_t)sizeof(uint64_t) +
+                (off_t)base->extras_gravados * (off_t)sizeof(EntradaTelefone);
+    cabecalho.sequencia = base->sequencia_gravada;
+    cabecalho.num_extras = base->num_extras;
+    int ok = escrever_completo(base->fd_indice, &base->extras[base->extras_gravados],
+                               (base->num_extras - base->extras_gravados) * sizeof(EntradaTelefone), fim) &&
+             escrever_completo(base->fd_indice, &cabecalho, sizeof(cabecalho), 0) &&
+             fsync(base->fd_indice) == 0;
+    if (ok) {
+        base->extras_gravados = base->num_extras;
+    }
+    return ok;
+}
+
+static int acrescentar_extra(BasePaginada *base, uint64_t chave, int id) {
+    if (base->num_extras >= base->capacidade_extras) {
+        uint32_t nova_capacidade = base->capacidade_extras * 2;
+        EntradaTelefone *novos = (EntradaTelefone*)realloc(base->extras, nova_capacidade * sizeof(EntradaTelefone));
+        if (!novos) {
+            return 0;
+        }
+        base->extras = novos;
+        base->capacidade_extras = nova_capacidade;
+    }
+    EntradaTelefone *entrada = &base->extras[base->num_extras++];
+    entrada->chave = chave;
+    entrada->id = id;
+    entrada->reservado = 0;
+    return 1;
+}
+
+// ==================== Abertura e fechamento ====================
+
+static void liberar_base(BasePaginada *base) {
+    for (int q = 0; q < base->quadros_usados; q++) {
+        free(base->quadros[q].contatos);
+    }
+    free(base->quadros);
+    free(base->quadro_do_bloco);
+    free(base->crcs);
+    free(base->primeiro_id);
+    free(base->cercas);
+    free(base->extras);
+    free(base->alteracoes);
+    free(base->pagina_varredura);
+    liberar_extensoes(base->extensoes);
+    if (base->fd_indice >= 0) {
+        close(base->fd_indice);
+    }
+    if (base->fd >= 0) {
+        close(base->fd);
+    }
+    liberar_bloqueio(base->fd_bloqueio);
+    free(base);
+}
+
+BasePaginada* abrir_base_paginada(const char *arquivo, size_t memoria, int escrita) {
+    if (!arquivo) {
+        return NULL;
+    }
+    BasePaginada *base = (BasePaginada*)calloc(1, sizeof(BasePaginada));
+    if (!base) {
+        fprintf(stderr, "Erro ao alocar memória para a base paginada\n");
+        return NULL;
+    }
+    snprintf(base->arquivo, sizeof(base->arquivo), "%s", arquivo);
+    base->escrita = escrita;
+    base->fd_indice = -1;
+    base->fd_bloqueio = -1;
+    base->mais_recente = base->menos_recente = -1;
+
+    if (escrita && (base->fd_bloqueio = bloquear_escrita(arquivo)) < 0) {
+        liberar_base(base);
+        return NULL;
+    }
+    base->fd = open(arquivo, escrita ? O_RDWR : O_RDONLY);
+    if (base->fd < 0) {
+        fprintf(stderr, "Erro ao abrir %s\n", arquivo);
+        liberar_base(base);
+        return NULL;
+    }
+    // Leitores retêm o bloqueio compartilhado: uma base paginada em escrita
+    // só grava páginas no arquivo quando nenhum deles está lendo
+    if (!escrita) {
+        travar(base->fd, LOCK_SH);
+    } else if (!recuperar_diario(base->fd, arquivo)) {
+        liberar_base(base);
+        return NULL;
+    }
+
+    char assinatura[4];
+    if (!ler_completo(base->fd, assinatura, sizeof(assinatura), 0) ||
+        memcmp(assinatura, ASSINATURA_BLOCOS, sizeof(assinatura)) != 0) {
+        fprintf(stderr, "Erro: %s não está no formato em blocos (salve a base uma vez para convertê-la)\n", arquivo);
+        liberar_base(base);
+        return NULL;
+    }
+    base->crcs = ler_cabecalho_blocos(base->fd, &base->cabecalho, &base->inicio_dados);
+    if (!base->crcs) {
+        liberar_base(base);
+        return NULL;
+    }
+    if (escrita && base->cabecalho.versao != VERSAO_BLOCOS) {
+        fprintf(stderr, "Erro: %s está em uma versão antiga do formato (salve a base uma vez para convertê-la)\n", arquivo);
+        liberar_base(base);
+        return NULL;
+    }
+    base->tamanho_cabecalho = (size_t)(base->inicio_dados -
+                                       (off_t)base->cabecalho.num_blocos * (off_t)sizeof(uint32_t));
+    base->sequencia_gravada = base->cabecalho.sequencia;
+
+    // Quadros pela memória configurada (nunca mais que os blocos do arquivo)
+    size_t quadros = memoria / TAMANHO_PAGINA;
+    if (quadros < MIN_QUADROS_PAGINA) {
+        quadros = MIN_QUADROS_PAGINA;
+    }
+    if (quadros > base->cabecalho.num_blocos) {
+        quadros = base->cabecalho.num_blocos > 0 ? base->cabecalho.num_blocos : 1;
+    }
+    base->num_quadros = (int)quadros;
+    uint32_t num_blocos = base->cabecalho.num_blocos > 0 ? base->cabecalho.num_blocos : 1;
+    base->quadros = (QuadroPagina*)calloc(quadros, sizeof(QuadroPagina));
+    base->quadro_do_bloco = (int32_t*)malloc(num_blocos * sizeof(int32_t));
+    base->pagina_varredura = (Contato*)malloc(TAMANHO_PAGINA);
+    if (!base->quadros || !base->quadro_do_bloco || !base->pagina_varredura) {
+        fprintf(stderr, "Erro ao alocar memória para a base paginada\n");
+        liberar_base(base);
+        return NULL;
+    }
+    for (uint32_t b = 0; b < num_blocos; b++) {
+        base->quadro_do_bloco[b] = -1;
+    }
+    // Atributos corrompidos não são descartados em silêncio, como em carregar_contatos
+    if (escrita && !carregar_extensoes(arquivo, &base->extensoes)) {
+        liberar_base(base);
+        return NULL;
+    }
+
+    if (!carregar_indice(base) && (!construir_indice(base, memoria) || !carregar_indice(base))) {
+        fprintf(stderr, "Erro: índice de %s indisponível\n", arquivo);
+        liberar_base(base);
+        return NULL;
+    }
+    return base;
+}
+
+int sincronizar_base_paginada(BasePaginada *base) {
+    if (!base) {
+        return 0;
+    }
+    if (!base->escrita) {
+        return 1;
+    }
+
+    int sujas = 0;
+    for (int q = 0; q < base->quadros_usados; q++) {
+        sujas += base->quadros[q].sujo;
+    }
+    if (sujas > 0 || base->sequencia_gravada != base->cabecalho.sequencia) {
+        uint64_t anterior = base->sequencia_gravada;
+        base->sequencia_gravada = base->cabecalho.sequencia;
+        if (!gravar_sujas(base)) {
+            base->sequencia_gravada = anterior;
+            fprintf(stderr, "Erro ao sincronizar %s\n", base->arquivo);
+            return 0;
+        }
+    }
+
+    // Atributos depois dos dados: uma queda entre os dois deixa atributos de
+    // contatos já excluídos, e esses são descartados na carga
+    if (base->extensoes_alteradas) {
+        if (!salvar_extensoes(base->extensoes, base->arquivo)) {
+            fprintf(stderr, "Erro ao gravar atributos de %s\n", base->arquivo);
+            return 0;
+        }
+        base->extensoes_alteradas = 0;
+    }
+
+    // Registro de alterações depois dos dados, como em salvar_contatos
+    if (base->num_alteracoes > 0) {
+        if (acrescentar_alteracoes(base->arquivo, base->alteracoes, base->num_alteracoes)) {
+            base->num_alteracoes = 0;
+        } else {
+            fprintf(stderr, "Aviso: registro de alterações de %s não atualizado\n", base->arquivo);
+        }
+    }
+    if (!atualizar_indice(base)) {
+        // Dados já gravados: um índice defasado só é reconstruído na próxima abertura
+        fprintf(stderr, "Aviso: índice de %s não atualizado\n", base->arquivo);
+    }
+    return 1;
+}
+
+int fechar_base_paginada(BasePaginada *base) {
+    if (!base) {
+        return 0;
+    }
+    int ok = sincronizar_base_paginada(base);
+    liberar_base(base);
+    return ok;
+}
+
+// ==================== Consultas ====================
+
+int buscar_paginado_por_id(BasePaginada *base, int id, Contato *destino) {
+    if (!base) {
+        return 0;
+    }
+    Contato *contato = localizar_contato(base, id, NULL);
+    if (!contato || !contato->ativo) {
+        return 0;
+    }
+    if (destino) {
+        *destino = *contato;
+    }
+    return 1;
+}
+
+// Confirmar um candidato do índice (a chave pode colidir ou estar defasada)
+static int confirmar_telefone(BasePaginada *base, int id, const char *normalizado,
+                              Contato *destino, int *encontrados, int max) {
+    for (int i = 0; i < *encontrados; i++) {
+        if (destino[i].id == id) {
+            return 1;
+        }
+    }
+    Contato *contato = localizar_contato(base, id, NULL);
+    char chave[MAX_TELEFONE];
+    if (contato && contato->ativo &&
+        strcmp(normalizar_telefone(contato->telefone, chave, sizeof(chave)), normalizado) == 0) {
+        destino[(*encontrados)++] = *contato;
+    }
+    return *encontrados < max;
+}
+
+int buscar_paginado_por_telefone(BasePaginada *base, const char *telefone, Contato *destino, int max) {
+    if (!base || !telefone || !destino || max <= 0) {
+        return 0;
+    }
+    uint64_t chave = chave_telefone(telefone);
+    if (!chave) {
+        return 0;
+    }
+    char normalizado[MAX_TELEFONE];
+    normalizar_telefone(telefone, normalizado, sizeof(normalizado));
+
+    int encontrados = 0;
+    if (base->num_cercas > 0) {
+        // Primeira cerca >= chave; entradas iguais podem começar na página anterior
+        uint64_t inicio = 0;
+        uint64_t fim = base->num_cercas;
+        while (inicio < fim) {
+            uint64_t meio = inicio + (fim - inicio) / 2;
+            if (base->cercas[meio] < chave) {
+                inicio = meio + 1;
+            } else {
+                fim = meio;
+            }
+        }
+        uint64_t pagina = inicio > 0 ? inicio - 1 : 0;
+
+        EntradaTelefone entradas[ENTRADAS_POR_PAGINA_INDICE];
+        int continuar = 1;
+        for (; pagina < base->num_cercas && continuar; pagina++) {
+            if (base->cercas[pagina] > chave) {
+                break;
+            }
+            uint64_t primeira = pagina * ENTRADAS_POR_PAGINA_INDICE;
+            uint64_t n = base->num_telefones - primeira;
+            if (n > ENTRADAS_POR_PAGINA_INDICE) {
+                n = ENTRADAS_POR_PAGINA_INDICE;
+            }
+            if (!ler_completo(base->fd_indice, entradas, n * sizeof(EntradaTelefone),
+                              base->inicio_telefones + (off_t)primeira * (off_t)sizeof(EntradaTelefone))) {
+                fprintf(stderr, "Erro ao ler índice de telefones de %s\n", base->arquivo);
+                return encontrados;
+            }
+            base->estatisticas.leituras_indice++;
+            for (uint64_t i = 0; i < n && continuar; i++) {
+                if (entradas[i].chave > chave) {
+                    continuar = 0;
+                } else if (entradas[i].chave == chave) {
+                    continuar = confirmar_telefone(base, entradas[i].id, normalizado, destino, &encontrados, max);
+                }
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < base->num_extras && encontrados < max; i++) {
+        if (base->extras[i].chave == chave) {
+            confirmar_telefone(base, base->extras[i].id, normalizado, destino, &encontrados, max);
+        }
+    }
+    return encontrados;
+}
+
+long buscar_paginado(BasePaginada *base, const char *termo,
+                     int (*visitar)(const Contato *contato, void *contexto), void *contexto) {
+    if (!base || !termo || !visitar) {
+        return -1;
+    }
+
+    long visitados = 0;
+    for (uint32_t b = 0; b < base->cabecalho.num_blocos; b++) {
+        // Página no pool (talvez alterada) ou lida no buffer da varredura
+        const Contato *pagina;
+        int q = base->quadro_do_bloco[b];
+        if (q >= 0) {
+            pagina = base->quadros[q].contatos;
+        } else if (ler_bloco(base, b, base->pagina_varredura)) {
+            pagina = base->pagina_varredura;
+        } else {
+            return -1;
+        }
+
+        int n = contatos_no_bloco(base, b);
+        for (int i = 0; i < n; i++) {
+            const Contato *contato = &pagina[i];
+            if (contato->ativo &&
+                (strstr(contato->nome, termo) || strstr(contato->telefone, termo) || strstr(contato->email, termo))) {
+                visitados++;
+                if (!visitar(contato, contexto)) {
+                    return visitados;
+                }
+            }
+        }
+    }
+    return visitados;
+}
+
+// ==================== Alterações ====================
+
+// Mesma numeração de registrar_alteracao em contato.c, gravada em sincronizar
+static void registrar_paginado(BasePaginada *base, int tipo, const Contato *contato) {
+    if (base->num_alteracoes >= base->capacidade_alteracoes) {
+        int nova_capacidade = base->capacidade_alteracoes > 0 ? base->capacidade_alteracoes * 2 : 16;
+        RegistroAlteracao *novas = (RegistroAlteracao*)realloc(base->alteracoes,
+                                                               nova_capacidade * sizeof(RegistroAlteracao));
+        if (!novas) {
+            fprintf(stderr, "Aviso: sem memória para o registro de alterações\n");
+            base->num_alteracoes = 0;
+            if (base->capacidade_alteracoes == 0) {
+                return;
+            }
+            tipo = ALTERACAO_REINICIO;
+            contato = NULL;
+        } else {
+            base->alteracoes = novas;
+            base->capacidade_alteracoes = nova_capacidade;
+        }
+    }
+
+    RegistroAlteracao *registro = &base->alteracoes[base->num_alteracoes++];
+    memset(registro, 0, sizeof(RegistroAlteracao));
+    registro->sequencia = ++base->cabecalho.sequencia;
+    registro->tipo = tipo;
+    if (contato) {
+        registro->id = contato->id;
+        if (tipo != ALTERACAO_EXCLUSAO) {
+            memcpy(registro->nome, contato->nome, MAX_NOME);
+            memcpy(registro->telefone, contato->telefone, MAX_TELEFONE);
+            memcpy(registro->email, contato->email, MAX_EMAIL);
+        }
+    }
+}
+
+int editar_paginado(BasePaginada *base, int id, const char *nome, const char *telefone, const char *email) {
+    if (!base || !base->escrita) {
+        return 0;
+    }
+    uint32_t bloco;
+    Contato *contato = localizar_contato(base, id, &bloco);
+    if (!contato || !contato->ativo) {
+        printf("Contato com ID %d não encontrado para edição.\n", id);
+        return 0;
+    }
+
+    if (nome && strlen(nome) > 0) {
+        strncpy(contato->nome, nome, MAX_NOME - 1);
+        contato->nome[MAX_NOME - 1] = '\0';
+    }
+    if (telefone && strlen(telefone) > 0) {
+        strncpy(contato->telefone, telefone, MAX_TELEFONE - 1);
+        contato->telefone[MAX_TELEFONE - 1] = '\0';
+        // A entrada antiga fica no índice e é descartada na verificação
+        uint64_t chave = chave_telefone(contato->telefone);
+        if (chave && !acrescentar_extra(base, chave, id)) {
+            fprintf(stderr, "Aviso: sem memória para o índice de telefones\n");
+        }
+    }
+    if (email && strlen(email) > 0) {
+        strncpy(contato->email, email, MAX_EMAIL - 1);
+        contato->email[MAX_EMAIL - 1] = '\0';
+    }
+
+    marcar_sujo(base, bloco);
+    registrar_paginado(base, ALTERACAO_EDICAO, contato);
+    return 1;
+}
+
+int excluir_paginado(BasePaginada *base, int id) {
+    if (!base || !base->escrita) {
+        return 0;
+    }
+    uint32_t bloco;
+    Contato *contato = localizar_contato(base, id, &bloco);
+    if (!contato || !contato->ativo) {
+        return 0;
+    }
+    contato->ativo = 0;
+    marcar_sujo(base, bloco);
+    registrar_paginado(base, ALTERACAO_EXCLUSAO, contato);
+    if (base->extensoes && remover_extensoes_contato(base->extensoes, id) > 0) {
+        base->extensoes_alteradas = 1;
+    }
+    return 1;
+}
+
+void imprimir_estatisticas_paginada(const BasePaginada *base) {
+    if (!base) {
+        return;
+    }
+    const EstatisticasPaginada *e = &base->estatisticas;
+    long acessos = e->acertos + e->faltas;
+    int sujas = 0;
+    for (int q = 0; q < base->quadros_usados; q++) {
+        sujas += base->quadros[q].sujo;
+    }
+
+    printf("\n=== Base Paginada ===\n");
+    printf("Arquivo:               %s (%s)\n", base->arquivo, base->escrita ? "leitura e escrita" : "somente leitura");
+    printf("Contatos no arquivo:   %d em %u bloco(s)\n", base->cabecalho.quantidade, base->cabecalho.num_blocos);
+    printf("Pool:                  %d de %d página(s) de %zu KB (%d alterada(s))\n",
+           base->quadros_usados, base->num_quadros, TAMANHO_PAGINA / 1024, sujas);
+    printf("Acertos no pool:       %ld de %ld (%.1f%%)\n", e->acertos, acessos,
+           acessos > 0 ? e->acertos * 100.0 / acessos : 0.0);
+    printf("Despejos:              %ld | Páginas gravadas: %ld\n", e->despejos, e->gravacoes);
+    printf("Índice de telefones:   %llu entrada(s) ordenada(s), %u editada(s), %ld página(s) lida(s)\n",
+           (unsigned long long)base->num_telefones, base->num_extras, e->leituras_indice);
+    printf("Alterações pendentes:  %d\n", base->num_alteracoes);
+}
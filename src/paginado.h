@@ -0,0 +1,144 @@
+#ifndef PAGINADO_H
+#define PAGINADO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "contato.h"
+#include "arquivo_blocos.h"
+#include "extensoes.h"
+
+// Modo paginado: busca, edição e exclusão direto no arquivo em blocos, sem
+// carregar a lista. Os blocos (páginas) passam por um pool de tamanho fixo com
+// despejo LRU, então a memória usada é a configurada, não o tamanho da base.
+// Índices em disco, em "<arquivo>.idx":
+//   IDs       - primeiro ID de cada bloco (os IDs são crescentes no arquivo)
+//   Telefones - pares (hash do telefone normalizado, ID) ordenados, com uma
+//               cerca por página do índice e, no fim, os telefones editados
+//               desde a construção (não ordenados, mantidos também em memória)
+// O índice é reconstruído (uma passada + ordenação externa) quando a base foi
+// salva por outro caminho desde a última vez
+// As páginas alteradas passam antes por um diário, "<arquivo>.diario", com a
+// imagem nova de cada bloco e do cabeçalho: uma queda no meio da gravação no
+// lugar é refeita a partir dele na próxima abertura para escrita
+#define MEMORIA_PAGINADA_PADRAO ((size_t)64 * 1024 * 1024)
+#define MIN_QUADROS_PAGINA 4
+#define ASSINATURA_INDICE_PAGINADO "CIDX"
+#define VERSAO_INDICE_PAGINADO 1
+#define ENTRADAS_POR_PAGINA_INDICE 256      // 4 KB de entradas por leitura
+#define LIMITE_EXTRAS_INDICE 65536          // Acima disso o índice é reconstruído ao abrir
+
+#define ASSINATURA_DIARIO_PAGINADO "CDIA"
+#define VERSAO_DIARIO_PAGINADO 1
+
+// Seguido do cabeçalho novo do arquivo de dados e, por página, do número do
+// bloco (uint32_t) e do conteúdo do bloco
+typedef struct {
+    char assinatura[4];
+    uint32_t versao;
+    uint64_t inode;             // Do arquivo de dados: um salvamento completo o invalida
+    uint32_t num_paginas;
+    uint32_t crc;               // CRC32C de tudo o que segue este cabeçalho
+} CabecalhoDiarioPaginado;
+
+typedef struct {
+    uint64_t chave;             // FNV-1a do telefone normalizado (colisões são descartadas na verificação)
+    int32_t id;
+    int32_t reservado;
+} EntradaTelefone;
+
+typedef struct {
+    char assinatura[4];
+    uint32_t versao;
+    uint64_t sequencia;         // Do arquivo de dados quando o índice foi atualizado
+    uint64_t inode;             // Um rename() por outro salvamento troca o inode
+    int32_t quantidade;
+    uint32_t num_blocos;
+    uint64_t num_telefones;     // Entradas ordenadas
+    uint32_t num_extras;        // Entradas não ordenadas no final
+    uint32_t reservado;
+} CabecalhoIndicePaginado;
+
+typedef struct {
+    Contato *contatos;          // Um bloco do arquivo
+    int32_t bloco;
+    int sujo;
+    int anterior;               // Lista LRU (índices de quadros; -1 = nenhum)
+    int proximo;
+} QuadroPagina;
+
+typedef struct {
+    long acertos;
+    long faltas;
+    long despejos;
+    long gravacoes;             // Páginas gravadas de volta no arquivo
+    long leituras_indice;       // Páginas do índice de telefones lidas
+} EstatisticasPaginada;
+
+typedef struct {
+    char arquivo[512];
+    int fd;
+    int fd_bloqueio;            // Bloqueio de escrita entre processos (-1 em somente leitura)
+    int escrita;
+    CabecalhoBlocos cabecalho;
+    size_t tamanho_cabecalho;
+    off_t inicio_dados;
+    uint64_t sequencia_gravada; // Sequência no cabeçalho do arquivo (avança em sincronizar)
+    uint32_t *crcs;
+    int32_t *primeiro_id;       // Índice de IDs
+    int32_t *quadro_do_bloco;   // Bloco -> quadro no pool (-1 = fora)
+    QuadroPagina *quadros;
+    int num_quadros;            // Máximo pela memória configurada
+    int quadros_usados;
+    int mais_recente;
+    int menos_recente;
+    Contato *pagina_varredura;  // Buffer da busca por termo, que não passa pelo pool
+    int fd_indice;
+    off_t inicio_telefones;
+    uint64_t num_telefones;
+    uint64_t *cercas;           // Primeira chave de cada página do índice de telefones
+    uint64_t num_cercas;
+    EntradaTelefone *extras;
+    uint32_t num_extras;
+    uint32_t extras_gravados;
+    uint32_t capacidade_extras;
+    ExtensoesContatos *extensoes;  // Atributos de "<arquivo>.ext" (só em escrita; NULL = nenhum)
+    int extensoes_alteradas;
+    RegistroAlteracao *alteracoes; // Ainda não acrescentadas ao registro de alterações
+    int num_alteracoes;
+    int capacidade_alteracoes;
+    EstatisticasPaginada estatisticas;
+} BasePaginada;
+
+// Abrir um arquivo em blocos (versão 3 para escrita) com "memoria" bytes de pool
+// Em modo escrita, o bloqueio de escrita entre processos fica retido até fechar
+// e um diário deixado por uma queda é aplicado antes de tudo
+BasePaginada* abrir_base_paginada(const char *arquivo, size_t memoria, int escrita);
+
+// Gravar páginas alteradas, cabeçalho, registro de alterações e índice; retorna 1 em sucesso
+int sincronizar_base_paginada(BasePaginada *base);
+
+// Sincronizar (em modo escrita) e liberar; retorna 1 se tudo foi gravado
+int fechar_base_paginada(BasePaginada *base);
+
+// Copiar o contato ativo com o ID; retorna 1 se encontrado
+int buscar_paginado_por_id(BasePaginada *base, int id, Contato *destino);
+
+// Contatos ativos com o telefone (qualquer formatação); retorna quantos foram copiados
+int buscar_paginado_por_telefone(BasePaginada *base, const char *telefone, Contato *destino, int max);
+
+// Visitar os contatos ativos que contêm o termo no nome, telefone ou email
+// Varredura sequencial com um buffer próprio (não expulsa as páginas do pool)
+// O visitante retorna 0 para parar (e não deve usar a base durante a varredura);
+// retorna quantos foram visitados ou -1 em erro
+long buscar_paginado(BasePaginada *base, const char *termo,
+                     int (*visitar)(const Contato *contato, void *contexto), void *contexto);
+
+// Mesma semântica de editar_contato (campo vazio = manter) e excluir_contato
+// (que também remove os atributos do contato)
+int editar_paginado(BasePaginada *base, int id, const char *nome, const char *telefone, const char *email);
+int excluir_paginado(BasePaginada *base, int id);
+
+void imprimir_estatisticas_paginada(const BasePaginada *base);
+
+#endif
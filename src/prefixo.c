@@ -0,0 +1,313 @@
+#include "prefixo.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Criar índice com espaço exato para as entradas e para as chaves
+IndicePrefixo* criar_indice_prefixo(int max_entradas, size_t tamanho_area) {
+    IndicePrefixo *indice = (IndicePrefixo*)malloc(sizeof(IndicePrefixo));
+    if (!indice) {
+        fprintf(stderr, "Erro ao alocar memória para o índice de prefixos\n");
+        return NULL;
+    }
+
+    indice->entradas = (EntradaPrefixo*)malloc((max_entradas > 0 ? max_entradas : 1) * sizeof(EntradaPrefixo));
+    indice->area = (char*)malloc(tamanho_area > 0 ? tamanho_area : 1);
+    if (!indice->entradas || !indice->area) {
+        fprintf(stderr, "Erro ao alocar memória para o índice de prefixos\n");
+        free(indice->entradas);
+        free(indice->area);
+        free(indice);
+        return NULL;
+    }
+
+    indice->quantidade = 0;
+    indice->tamanho_area = 0;
+    indice->geracao = 0;
+    indice->novas = NULL;
+    indice->num_novas = 0;
+    indice->capacidade_novas = 0;
+    indice->blocos = NULL;
+    indice->num_blocos = 0;
+    indice->capacidade_blocos = 0;
+    indice->obsoletos = NULL;
+    indice->num_obsoletos = 0;
+    indice->capacidade_obsoletos = 0;
+    return indice;
+}
+
+// Liberar memória do índice
+void liberar_indice_prefixo(IndicePrefixo *indice) {
+    if (indice) {
+        for (int i = 0; i < indice->num_blocos; i++) {
+            free(indice->blocos[i].chaves);
+        }
+        free(indice->blocos);
+        free(indice->novas);
+        free(indice->obsoletos);
+        free(indice->entradas);
+        free(indice->area);
+        free(indice);
+    }
+}
+
+// Copiar uma chave para a área do índice (o chamador dimensiona a área)
+const char* indice_prefixo_guardar(IndicePrefixo *indice, const char *chave) {
+    size_t tamanho = strlen(chave) + 1;
+    char *destino = indice->area + indice->tamanho_area;
+    memcpy(destino, chave, tamanho);
+    indice->tamanho_area += tamanho;
+    return destino;
+}
+
+// Adicionar entrada apontando para uma chave já guardada na área
+int indice_prefixo_adicionar(IndicePrefixo *indice, const char *chave, int id) {
+    if (!indice || !chave || chave[0] == '\0') {
+        return 0;
+    }
+    indice->entradas[indice->quantidade].chave = chave;
+    indice->entradas[indice->quantidade].id = id;
+    indice->quantidade++;
+    return 1;
+}
+
+static int comparar_entradas_prefixo(const void *a, const void *b) {
+    const EntradaPrefixo *ea = (const EntradaPrefixo*)a;
+    const EntradaPrefixo *eb = (const EntradaPrefixo*)b;
+    int cmp = strcmp(ea->chave, eb->chave);
+    if (cmp != 0) {
+        return cmp;
+    }
+    return ea->id - eb->id;
+}
+
+// Ordenar as entradas (uma vez, após adicionar todas)
+void indice_prefixo_ordenar(IndicePrefixo *indice) {
+    if (indice && indice->quantidade > 1) {
+        qsort(indice->entradas, indice->quantidade, sizeof(EntradaPrefixo), comparar_entradas_prefixo);
+    }
+}
+
+// Faixa das entradas com o prefixo: duas buscas binárias, O(log n)
+static int faixa_prefixo(const EntradaPrefixo *entradas, int quantidade, const char *prefixo, int *inicio) {
+    // Primeira entrada >= prefixo (lower bound)
+    int baixo = 0;
+    int alto = quantidade;
+    while (baixo < alto) {
+        int meio = baixo + (alto - baixo) / 2;
+        if (strcmp(entradas[meio].chave, prefixo) < 0) {
+            baixo = meio + 1;
+        } else {
+            alto = meio;
+        }
+    }
+    *inicio = baixo;
+
+    // Primeira entrada depois dela que não começa com o prefixo
+    size_t tamanho = strlen(prefixo);
+    alto = quantidade;
+    while (baixo < alto) {
+        int meio = baixo + (alto - baixo) / 2;
+        if (strncmp(entradas[meio].chave, prefixo, tamanho) <= 0) {
+            baixo = meio + 1;
+        } else {
+            alto = meio;
+        }
+    }
+    return baixo;
+}
+
+// Posição do ID nos obsoletos ou, se ausente, onde entraria (com *encontrado = 0)
+static int localizar_obsoleto(const IndicePrefixo *indice, int id, int *encontrado) {
+    int baixo = 0;
+    int alto = indice->num_obsoletos;
+    while (baixo < alto) {
+        int meio = baixo + (alto - baixo) / 2;
+        if (indice->obsoletos[meio] < id) {
+            baixo = meio + 1;
+        } else {
+            alto = meio;
+        }
+    }
+    *encontrado = baixo < indice->num_obsoletos && indice->obsoletos[baixo] == id;
+    return baixo;
+}
+
+// Garantir espaço para "necessario" itens num array que cresce dobrando
+static int reservar(void **itens, int *capacidade, int necessario, size_t tamanho_item) {
+    if (necessario <= *capacidade) {
+        return 1;
+    }
+    int nova_capacidade = *capacidade > 0 ? *capacidade : 16;
+    while (nova_capacidade < necessario) {
+        nova_capacidade *= 2;
+    }
+    void *novos = realloc(*itens, (size_t)nova_capacidade * tamanho_item);
+    if (!novos) {
+        fprintf(stderr, "Erro ao alocar memória para o índice de prefixos\n");
+        return 0;
+    }
+    *itens = novos;
+    *capacidade = nova_capacidade;
+    return 1;
+}
+
+int indice_prefixo_remover_id(IndicePrefixo *indice, int id) {
+    if (!indice) {
+        return 0;
+    }
+
+    // Entradas novas do ID e o bloco com as chaves delas
+    int mantidas = 0;
+    for (int i = 0; i < indice->num_novas; i++) {
+        if (indice->novas[i].id != id) {
+            indice->novas[mantidas++] = indice->novas[i];
+        }
+    }
+    indice->num_novas = mantidas;
+    for (int i = 0; i < indice->num_blocos; i++) {
+        if (indice->blocos[i].id == id) {
+            free(indice->blocos[i].chaves);
+            indice->blocos[i] = indice->blocos[--indice->num_blocos];
+            break;
+        }
+    }
+
+    // Entradas da base do ID (se houver) passam a ser ignoradas
+    int encontrado;
+    int posicao = localizar_obsoleto(indice, id, &encontrado);
+    if (encontrado) {
+        return 1;
+    }
+    if (!reservar((void**)&indice->obsoletos, &indice->capacidade_obsoletos, indice->num_obsoletos + 1, sizeof(int))) {
+        return 0;
+    }
+    memmove(&indice->obsoletos[posicao + 1], &indice->obsoletos[posicao],
+            (size_t)(indice->num_obsoletos - posicao) * sizeof(int));
+    indice->obsoletos[posicao] = id;
+    indice->num_obsoletos++;
+    return 1;
+}
+
+// Inserir uma entrada nova na posição ordenada
+static void inserir_nova(IndicePrefixo *indice, const char *chave, int id) {
+    if (chave[0] == '\0') {
+        return;
+    }
+    EntradaPrefixo entrada = { chave, id };
+    int baixo = 0;
+    int alto = indice->num_novas;
+    while (baixo < alto) {
+        int meio = baixo + (alto - baixo) / 2;
+        if (comparar_entradas_prefixo(&indice->novas[meio], &entrada) < 0) {
+            baixo = meio + 1;
+        } else {
+            alto = meio;
+        }
+    }
+    memmove(&indice->novas[baixo + 1], &indice->novas[baixo],
+            (size_t)(indice->num_novas - baixo) * sizeof(EntradaPrefixo));
+    indice->novas[baixo] = entrada;
+    indice->num_novas++;
+}
+
+// Como na construção: uma entrada pelo nome, uma por palavra seguinte e uma pelo email
+int indice_prefixo_inserir(IndicePrefixo *indice, int id, const char *nome, const char *email) {
+    if (!indice || !nome || !email) {
+        return 0;
+    }
+    int palavras = 1;
+    for (const char *p = nome; *p; p++) {
+        palavras += *p == ' ';
+    }
+    size_t tamanho_nome = strlen(nome) + 1;
+    char *chaves = (char*)malloc(tamanho_nome + strlen(email) + 1);
+    if (!chaves ||
+        !reservar((void**)&indice->novas, &indice->capacidade_novas, indice->num_novas + palavras + 1, sizeof(EntradaPrefixo)) ||
+        !reservar((void**)&indice->blocos, &indice->capacidade_blocos, indice->num_blocos + 1, sizeof(BlocoPrefixo))) {
+        free(chaves);
+        return 0;
+    }
+    memcpy(chaves, nome, tamanho_nome);
+    strcpy(chaves + tamanho_nome, email);
+    indice->blocos[indice->num_blocos].id = id;
+    indice->blocos[indice->num_blocos].chaves = chaves;
+    indice->num_blocos++;
+
+    inserir_nova(indice, chaves, id);
+    for (const char *p = chaves; *p; p++) {
+        if (*p == ' ') {
+            inserir_nova(indice, p + 1, id);
+        }
+    }
+    inserir_nova(indice, chaves + tamanho_nome, id);
+    return 1;
+}
+
+int indice_prefixo_precisa_reconstruir(const IndicePrefixo *indice) {
+    return indice && indice->num_novas + indice->num_obsoletos >
+                     MIN_PENDENCIAS_PREFIXO + indice->quantidade / FRACAO_PENDENCIAS_PREFIXO;
+}
+
+void indice_prefixo_iniciar(const IndicePrefixo *indice, const char *prefixo, CursorPrefixo *cursor) {
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->indice = indice;
+    if (!indice || !prefixo || prefixo[0] == '\0') {
+        return;
+    }
+    cursor->fim_base = faixa_prefixo(indice->entradas, indice->quantidade, prefixo, &cursor->base);
+    cursor->fim_novas = indice->num_novas > 0
+                        ? faixa_prefixo(indice->novas, indice->num_novas, prefixo, &cursor->nova) : 0;
+}
+
+// Próxima entrada em ordem de (chave, ID); entradas da base de IDs obsoletos são puladas
+const EntradaPrefixo* indice_prefixo_proxima(CursorPrefixo *cursor) {
+    const IndicePrefixo *indice = cursor->indice;
+    if (!indice) {
+        return NULL;
+    }
+    while (cursor->base < cursor->fim_base) {
+        int encontrado = 0;
+        if (indice->num_obsoletos > 0) {
+            localizar_obsoleto(indice, indice->entradas[cursor->base].id, &encontrado);
+        }
+        if (!encontrado) {
+            break;
+        }
+        cursor->base++;
+    }
+    int tem_base = cursor->base < cursor->fim_base;
+    int tem_nova = cursor->nova < cursor->fim_novas;
+    if (tem_base && (!tem_nova ||
+                     comparar_entradas_prefixo(&indice->entradas[cursor->base], &indice->novas[cursor->nova]) <= 0)) {
+        return &indice->entradas[cursor->base++];
+    }
+    return tem_nova ? &indice->novas[cursor->nova++] : NULL;
+}
+
+// Buscar IDs cujas chaves começam com o prefixo: O(log n + k)
+int indice_prefixo_sugerir(const IndicePrefixo *indice, const char *prefixo, int *ids, int max) {
+    if (!indice || !prefixo || !ids || max <= 0 || prefixo[0] == '\0') {
+        return 0;
+    }
+
+    CursorPrefixo cursor;
+    indice_prefixo_iniciar(indice, prefixo, &cursor);
+    int encontrados = 0;
+    const EntradaPrefixo *entrada;
+    while (encontrados < max && (entrada = indice_prefixo_proxima(&cursor)) != NULL) {
+        // Um contato pode casar pelo nome e pelo email: evitar repetição
+        int id = entrada->id;
+        int repetido = 0;
+        for (int j = 0; j < encontrados; j++) {
+            if (ids[j] == id) {
+                repetido = 1;
+                break;
+            }
+        }
+        if (!repetido) {
+            ids[encontrados++] = id;
+        }
+    }
+    return encontrados;
+}
@@ -0,0 +1,79 @@
+#ifndef PREFIXO_H
+#define PREFIXO_H
+
+#include <stddef.h>
+
+// Entrada do índice: ponteiro para uma chave (ou sufixo a partir de uma palavra) e o ID
+typedef struct {
+    const char *chave;
+    int id;
+} EntradaPrefixo;
+
+// Chaves de um contato inserido depois da construção (nome e email no mesmo bloco)
+typedef struct {
+    int id;
+    char *chaves;
+} BlocoPrefixo;
+
+// Índice de prefixos em array ordenado (busca binária pelo início do prefixo)
+// As chaves normalizadas ficam todas em uma única área contígua
+// Alterações depois da construção não reordenam a base: os contatos inseridos ou
+// editados ganham entradas num segundo array ordenado, pequeno, e os IDs cujas
+// entradas da base não valem mais ficam numa lista ordenada de obsoletos. As
+// consultas fundem os dois arrays; quando as pendências passam do limite, quem
+// mantém o índice o reconstrói
+#define MIN_PENDENCIAS_PREFIXO 4096  // Pendências toleradas antes de reconstruir,
+#define FRACAO_PENDENCIAS_PREFIXO 32 // mais 1/32 das entradas da base
+
+typedef struct {
+    EntradaPrefixo *entradas;
+    int quantidade;
+    char *area;
+    size_t tamanho_area;
+    unsigned long geracao; // Geração da lista com que o índice está em dia
+    EntradaPrefixo *novas;  // Entradas inseridas depois da construção, ordenadas
+    int num_novas;
+    int capacidade_novas;
+    BlocoPrefixo *blocos;   // Donos das chaves das entradas novas
+    int num_blocos;
+    int capacidade_blocos;
+    int *obsoletos;         // IDs (ordenados) cujas entradas da base são ignoradas
+    int num_obsoletos;
+    int capacidade_obsoletos;
+} IndicePrefixo;
+
+// Percurso das entradas com um prefixo, em ordem de chave, fundindo base e novas
+typedef struct {
+    const IndicePrefixo *indice;
+    int base;
+    int fim_base;
+    int nova;
+    int fim_novas;
+} CursorPrefixo;
+
+// Funções de gerenciamento do índice
+IndicePrefixo* criar_indice_prefixo(int max_entradas, size_t tamanho_area);
+void liberar_indice_prefixo(IndicePrefixo *indice);
+
+// Construção: adicionar chaves e depois ordenar uma única vez
+const char* indice_prefixo_guardar(IndicePrefixo *indice, const char *chave);
+int indice_prefixo_adicionar(IndicePrefixo *indice, const char *chave, int id);
+void indice_prefixo_ordenar(IndicePrefixo *indice);
+
+// Atualização incremental: tirar as entradas do ID (a base passa a ignorá-las) e
+// inserir as chaves atuais de um contato (nome e email já normalizados)
+// Retornam 0 sem memória: o índice deve então ser reconstruído
+int indice_prefixo_remover_id(IndicePrefixo *indice, int id);
+int indice_prefixo_inserir(IndicePrefixo *indice, int id, const char *nome, const char *email);
+
+// Pendências acima do limite: reconstruir sai mais barato que fundir nas consultas
+int indice_prefixo_precisa_reconstruir(const IndicePrefixo *indice);
+
+// Consulta: até max IDs distintos cujas chaves começam com o prefixo
+int indice_prefixo_sugerir(const IndicePrefixo *indice, const char *prefixo, int *ids, int max);
+
+// Percorrer as entradas válidas cujas chaves começam com o prefixo
+void indice_prefixo_iniciar(const IndicePrefixo *indice, const char *prefixo, CursorPrefixo *cursor);
+const EntradaPrefixo* indice_prefixo_proxima(CursorPrefixo *cursor);
+
+#endif
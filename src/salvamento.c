@@ -0,0 +1,206 @@
+#define _POSIX_C_SOURCE 200809L
+#include "salvamento.h"
+#include "alteracoes.h"
+#include "bloqueio.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static struct timespec agora() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t;
+}
+
+static struct timespec somar_ms(struct timespec t, long ms) {
+    t.tv_sec += ms / 1000;
+    t.tv_nsec += (ms % 1000) * 1000000L;
+    if (t.tv_nsec >= 1000000000L) {
+        t.tv_sec++;
+        t.tv_nsec -= 1000000000L;
+    }
+    return t;
+}
+
+static int antes(struct timespec a, struct timespec b) {
+    return a.tv_sec < b.tv_sec || (a.tv_sec == b.tv_sec && a.tv_nsec < b.tv_nsec);
+}
+
+// Momento de salvar: um intervalo após a última alteração, sem passar do adiamento
+// máximo desde a primeira, e nunca antes da próxima tentativa após uma falha
+static struct timespec prazo_salvamento(SalvamentoAutomatico *s) {
+    struct timespec prazo = somar_ms(s->ultima_alteracao, ATRASO_SALVAMENTO_MS);
+    struct timespec limite = somar_ms(s->primeira_alteracao, ADIAMENTO_MAXIMO_MS);
+    if (antes(limite, prazo)) {
+        prazo = limite;
+    }
+    if (antes(prazo, s->proxima_tentativa)) {
+        prazo = s->proxima_tentativa;
+    }
+    return prazo;
+}
+
+// Salvar as alterações pendentes (com a trava obtida)
+static void salvar_pendentes(SalvamentoAutomatico *s) {
+    errno = 0;
+    int ok = salvar_contatos(s->lista, s->arquivo);
+    if (ok) {
+        s->pendente = 0;
+        liberar_bloqueio(s->fd_bloqueio);
+        s->fd_bloqueio = -1;
+        return;
+    }
+
+    s->falhas++;
+    snprintf(s->mensagem, sizeof(s->mensagem), "não foi possível salvar em %s%s%s",
+             s->arquivo, errno ? ": " : "", errno ? strerror(errno) : "");
+    s->proxima_tentativa = somar_ms(agora(), ATRASO_NOVA_TENTATIVA_MS);
+}
+
+// Thread de salvamento: espera alterações e salva quando o prazo vence
+static void* executar_salvamentos(void *arg) {
+    SalvamentoAutomatico *s = (SalvamentoAutomatico*)arg;
+
+    pthread_mutex_lock(&s->trava);
+    while (!s->encerrar || s->pendente) {
+        if (!s->pendente) {
+            pthread_cond_wait(&s->condicao, &s->trava);
+            continue;
+        }
+
+        if (!s->encerrar) {
+            struct timespec prazo = prazo_salvamento(s);
+            if (antes(agora(), prazo)) {
+                // Novas alterações ou o encerramento acordam a thread antes do prazo
+                pthread_cond_timedwait(&s->condicao, &s->trava, &prazo);
+                continue;
+            }
+        }
+
+        salvar_pendentes(s);
+        if (s->encerrar) {
+            break; // Salvamento final: o resultado é informado por encerrar_salvamento_automatico
+        }
+    }
+    pthread_mutex_unlock(&s->trava);
+    return NULL;
+}
+
+SalvamentoAutomatico* iniciar_salvamento_automatico(ListaContatos *lista, const char *arquivo) {
+    if (!lista || !arquivo) {
+        return NULL;
+    }
+
+    SalvamentoAutomatico *s = (SalvamentoAutomatico*)calloc(1, sizeof(SalvamentoAutomatico));
+    if (!s) {
+        fprintf(stderr, "Erro ao alocar memória para o salvamento automático\n");
+        return NULL;
+    }
+    s->lista = lista;
+    snprintf(s->arquivo, sizeof(s->arquivo), "%s", arquivo);
+    s->fd_bloqueio = -1;
+
+    // Prazos no relógio monotônico (ajustes da hora do sistema não os afetam)
+    pthread_condattr_t atributos;
+    pthread_condattr_init(&atributos);
+    pthread_condattr_setclock(&atributos, CLOCK_MONOTONIC);
+    pthread_mutex_init(&s->trava, NULL);
+    pthread_cond_init(&s->condicao, &atributos);
+    pthread_condattr_destroy(&atributos);
+
+    if (pthread_create(&s->thread, NULL, executar_salvamentos, s) != 0) {
+        fprintf(stderr, "Erro ao iniciar thread de salvamento automático\n");
+        pthread_cond_destroy(&s->condicao);
+        pthread_mutex_destroy(&s->trava);
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+int iniciar_alteracao(SalvamentoAutomatico *s) {
+    pthread_mutex_lock(&s->trava);
+    // Com o bloqueio já retido (alterações pendentes), ninguém mais salvou o arquivo
+    if (s->fd_bloqueio < 0) {
+        s->fd_bloqueio = bloquear_escrita(s->arquivo);
+        if (s->fd_bloqueio < 0) {
+            pthread_mutex_unlock(&s->trava);
+            return 0;
+        }
+        recarregar_se_alterada(s->lista, s->arquivo);
+    }
+    return 1;
+}
+
+void concluir_alteracao(SalvamentoAutomatico *s, unsigned long geracao_anterior) {
+    if (s->lista->geracao != geracao_anterior) {
+        struct timespec t = agora();
+        if (!s->pendente) {
+            s->pendente = 1;
+            s->primeira_alteracao = t;
+        }
+        s->ultima_alteracao = t;
+        pthread_cond_signal(&s->condicao);
+    } else if (!s->pendente) {
+        // Nada mudou: outros processos podem escrever
+        liberar_bloqueio(s->fd_bloqueio);
+        s->fd_bloqueio = -1;
+    }
+    pthread_mutex_unlock(&s->trava);
+}
+
+void sincronizar_lista(SalvamentoAutomatico *s) {
+    pthread_mutex_lock(&s->trava);
+    if (!s->pendente) {
+        recarregar_se_alterada(s->lista, s->arquivo);
+    }
+    pthread_mutex_unlock(&s->trava);
+}
+
+int consultar_falhas_salvamento(SalvamentoAutomatico *s, char *mensagem, size_t tamanho) {
+    pthread_mutex_lock(&s->trava);
+    int falhas = s->falhas;
+    if (falhas > 0 && mensagem && tamanho > 0) {
+        snprintf(mensagem, tamanho, "%s", s->mensagem);
+    }
+    s->falhas = 0;
+    pthread_mutex_unlock(&s->trava);
+    return falhas;
+}
+
+int consultar_alteracoes_pendentes(SalvamentoAutomatico *s, uint64_t *sequencia) {
+    pthread_mutex_lock(&s->trava);
+    int pendentes = s->lista->num_alteracoes;
+    if (sequencia) {
+        *sequencia = s->lista->sequencia;
+    }
+    pthread_mutex_unlock(&s->trava);
+    return pendentes;
+}
+
+long listar_alteracoes_salvas(SalvamentoAutomatico *s, uint64_t desde, FILE *saida) {
+    pthread_mutex_lock(&s->trava);
+    long total = listar_alteracoes(s->arquivo, desde, saida);
+    pthread_mutex_unlock(&s->trava);
+    return total;
+}
+
+int encerrar_salvamento_automatico(SalvamentoAutomatico *s) {
+    if (!s) {
+        return 1;
+    }
+
+    pthread_mutex_lock(&s->trava);
+    s->encerrar = 1;
+    pthread_cond_signal(&s->condicao);
+    pthread_mutex_unlock(&s->trava);
+    pthread_join(s->thread, NULL);
+
+    int ok = !s->pendente;
+    liberar_bloqueio(s->fd_bloqueio);
+    pthread_cond_destroy(&s->condicao);
+    pthread_mutex_destroy(&s->trava);
+    free(s);
+    return ok;
+}
@@ -0,0 +1,65 @@
+#ifndef SALVAMENTO_H
+#define SALVAMENTO_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "contato.h"
+
+#define ATRASO_SALVAMENTO_MS 500        // Espera sem novas alterações antes de salvar
+#define ADIAMENTO_MAXIMO_MS 5000        // Alterações contínuas não adiam o salvamento além disso
+#define ATRASO_NOVA_TENTATIVA_MS 5000   // Espera após uma falha antes de tentar de novo
+#define TAMANHO_MENSAGEM_SALVAMENTO 512
+
+// Salvamento automático em segundo plano
+// O menu altera a lista e só marca que há alterações; uma thread agrupa as
+// alterações em sequência e salva depois de um intervalo sem novas alterações.
+// O bloqueio de escrita entre processos fica retido da primeira alteração até o
+// salvamento dela, então outro processo nunca salva por cima de dados pendentes
+typedef struct {
+    ListaContatos *lista;
+    char arquivo[256];
+    pthread_t thread;
+    pthread_mutex_t trava;          // Protege a lista durante alterações e salvamentos
+    pthread_cond_t condicao;
+    int fd_bloqueio;                // Bloqueio entre processos (-1 = não retido)
+    int pendente;                   // Há alterações ainda não salvas
+    int encerrar;
+    struct timespec primeira_alteracao;
+    struct timespec ultima_alteracao;
+    struct timespec proxima_tentativa;
+    int falhas;                     // Falhas ainda não informadas ao usuário
+    char mensagem[TAMANHO_MENSAGEM_SALVAMENTO];
+} SalvamentoAutomatico;
+
+// Iniciar a thread de salvamento (NULL em erro: o chamador salva de forma síncrona)
+SalvamentoAutomatico* iniciar_salvamento_automatico(ListaContatos *lista, const char *arquivo);
+
+// Envolver uma alteração: trava a lista, obtém o bloqueio entre processos e
+// recarrega a lista se outro processo salvou; concluir agenda o salvamento se
+// a geração da lista mudou. Só o trecho recarregar -> alterar deve ficar entre
+// as duas chamadas (nunca a leitura de entradas do usuário)
+// iniciar retorna 0, sem nada travado, se o bloqueio não pôde ser obtido
+int iniciar_alteracao(SalvamentoAutomatico *salvamento);
+void concluir_alteracao(SalvamentoAutomatico *salvamento, unsigned long geracao_anterior);
+
+// Recarregar a lista se outro processo salvou (sem alterações pendentes próprias)
+void sincronizar_lista(SalvamentoAutomatico *salvamento);
+
+// Consultar falhas desde a última consulta; retorna o número e copia a última mensagem
+int consultar_falhas_salvamento(SalvamentoAutomatico *salvamento, char *mensagem, size_t tamanho);
+
+// Sequência atual e número de alterações ainda não gravadas no registro, lidos
+// sob a trava (a thread de salvamento esvazia as pendentes ao salvar)
+int consultar_alteracoes_pendentes(SalvamentoAutomatico *salvamento, uint64_t *sequencia);
+
+// listar_alteracoes do arquivo sob a trava: nenhum salvamento acrescenta ao
+// registro durante a leitura
+long listar_alteracoes_salvas(SalvamentoAutomatico *salvamento, uint64_t desde, FILE *saida);
+
+// Salvar o que estiver pendente, parar a thread e liberar a estrutura
+// Retorna 1 se não ficou nada sem salvar, 0 se o salvamento final falhou
+int encerrar_salvamento_automatico(SalvamentoAutomatico *salvamento);
+
+#endif
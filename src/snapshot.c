@@ -0,0 +1,439 @@
+#include "snapshot.h"
+#include "utils/compressao.h"
+#include "utils/memory_utils.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Chave de ordenação: texto e a posição (entre os contatos ativos) a que pertence
+typedef struct {
+    const char *chave;
+    int posicao;
+} EntradaOrdenada;
+
+static int comparar_entradas_ordenadas(const void *a, const void *b) {
+    const EntradaOrdenada *ea = (const EntradaOrdenada*)a;
+    const EntradaOrdenada *eb = (const EntradaOrdenada*)b;
+    int cmp = strcmp(ea->chave, eb->chave);
+    return cmp != 0 ? cmp : ea->posicao - eb->posicao;
+}
+
+// FNV-1a sobre bytes
+static uint32_t calcular_verificacao(const unsigned char *dados, size_t tamanho) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < tamanho; i++) {
+        hash ^= dados[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Inteiro sem sinal em 7 bits por byte (valores pequenos ocupam 1 byte)
+static int gravar_varint(BufferDinamico *buffer, uint32_t valor) {
+    char bytes[5];
+    size_t n = 0;
+    while (valor >= 0x80) {
+        bytes[n++] = (char)((valor & 0x7F) | 0x80);
+        valor >>= 7;
+    }
+    bytes[n++] = (char)valor;
+    return adicionar_ao_buffer(buffer, bytes, n);
+}
+
+static int ler_varint(const unsigned char **p, const unsigned char *fim, uint32_t *valor) {
+    uint32_t resultado = 0;
+    for (int deslocamento = 0; deslocamento < 35; deslocamento += 7) {
+        if (*p >= fim) {
+            return 0;
+        }
+        unsigned char byte = *(*p)++;
+        resultado |= (uint32_t)(byte & 0x7F) << deslocamento;
+        if (!(byte & 0x80)) {
+            *valor = resultado;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int gravar_texto(BufferDinamico *buffer, const char *texto, size_t tamanho) {
+    return gravar_varint(buffer, (uint32_t)tamanho) &&
+           (tamanho == 0 || adicionar_ao_buffer(buffer, texto, tamanho));
+}
+
+// Gravar uma coluna de texto ordenada: para cada entrada, a posição do contato,
+// quantos bytes repete da entrada anterior e o sufixo que muda
+static int gravar_coluna_ordenada(BufferDinamico *buffer, EntradaOrdenada *entradas, int quantidade) {
+    qsort(entradas, quantidade, sizeof(EntradaOrdenada), comparar_entradas_ordenadas);
+
+    const char *anterior = "";
+    for (int i = 0; i < quantidade; i++) {
+        const char *atual = entradas[i].chave;
+        size_t comum = 0;
+        while (anterior[comum] && anterior[comum] == atual[comum]) {
+            comum++;
+        }
+        if (!gravar_varint(buffer, (uint32_t)entradas[i].posicao) ||
+            !gravar_varint(buffer, (uint32_t)comum) ||
+            !gravar_texto(buffer, atual + comum, strlen(atual + comum))) {
+            return 0;
+        }
+        anterior = atual;
+    }
+    return 1;
+}
+
+// Seção de atributos dos contatos ativos: nomes das chaves, quantidade e, para
+// cada atributo (em ordem de ID), o ID como diferença, a chave e o valor
+static int gravar_atributos(BufferDinamico *buffer, ListaContatos *lista, const int *ativos, int n) {
+    const ExtensoesContatos *extensoes = lista->extensoes;
+    if (!extensoes) {
+        return gravar_varint(buffer, 0) && gravar_varint(buffer, 0);
+    }
+
+    int ok = gravar_varint(buffer, (uint32_t)extensoes->num_chaves);
+    for (int k = 0; k < extensoes->num_chaves && ok; k++) {
+        ok = gravar_texto(buffer, extensoes->nomes_chaves[k], strlen(extensoes->nomes_chaves[k]));
+    }
+
+    // Duas passadas com o cursor andando junto com os contatos (ambos em ordem
+    // de ID): contar e depois gravar os atributos de quem está ativo
+    for (int passada = 0; passada < 2 && ok; passada++) {
+        uint32_t total = 0;
+        int id_anterior = 0;
+        int a = 0;
+        for (int j = 0; j < n && ok; j++) {
+            int id = CONTATO_EM(lista, ativos[j])->id;
+            while (a < extensoes->quantidade && extensoes->atributos[a].id < id) {
+                a++;
+            }
+            for (; a < extensoes->quantidade && extensoes->atributos[a].id == id && ok; a++) {
+                const AtributoExtensao *atributo = &extensoes->atributos[a];
+                total++;
+                if (passada == 1) {
+                    ok = gravar_varint(buffer, (uint32_t)(id - id_anterior)) &&
+                         gravar_varint(buffer, atributo->chave) &&
+                         gravar_texto(buffer, VALOR_EXTENSAO(extensoes, atributo), atributo->tamanho);
+                    id_anterior = id;
+                }
+            }
+        }
+        if (passada == 0) {
+            ok = gravar_varint(buffer, total);
+        }
+    }
+    return ok;
+}
+
+// Serializar os contatos ativos em colunas
+static BufferDinamico* serializar_contatos(ListaContatos *lista, int *quantidade) {
+    int *ativos = (int*)malloc((lista->quantidade > 0 ? lista->quantidade : 1) * sizeof(int));
+    EntradaOrdenada *entradas = (EntradaOrdenada*)malloc((lista->quantidade > 0 ? lista->quantidade : 1) * sizeof(EntradaOrdenada));
+    BufferDinamico *buffer = criar_buffer_dinamico((size_t)lista->quantidade * 48 + 64);
+    if (!ativos || !entradas || !buffer) {
+        free(ativos);
+        free(entradas);
+        liberar_buffer_dinamico(buffer);
+        return NULL;
+    }
+
+    int n = 0;
+    for (int i = 0; i < lista->quantidade; i++) {
+        if (CONTATO_EM(lista, i)->ativo) {
+            ativos[n++] = i;
+        }
+    }
+
+    int ok = 1;
+
+    // IDs: crescentes, gravados como diferença para o anterior
+    int id_anterior = 0;
+    for (int j = 0; j < n && ok; j++) {
+        const Contato *contato = CONTATO_EM(lista, ativos[j]);
+        ok = gravar_varint(buffer, (uint32_t)(contato->id - id_anterior));
+        id_anterior = contato->id;
+    }
+
+    // Telefones na ordem dos IDs
+    for (int j = 0; j < n && ok; j++) {
+        const Contato *contato = CONTATO_EM(lista, ativos[j]);
+        ok = gravar_texto(buffer, contato->telefone, strlen(contato->telefone));
+    }
+
+    // Nomes e emails ordenados, com prefixo comum
+    for (int j = 0; j < n; j++) {
+        entradas[j].chave = CONTATO_EM(lista, ativos[j])->nome;
+        entradas[j].posicao = j;
+    }
+    ok = ok && gravar_coluna_ordenada(buffer, entradas, n);
+
+    for (int j = 0; j < n; j++) {
+        entradas[j].chave = CONTATO_EM(lista, ativos[j])->email;
+        entradas[j].posicao = j;
+    }
+    ok = ok && gravar_coluna_ordenada(buffer, entradas, n);
+    ok = ok && gravar_atributos(buffer, lista, ativos, n);
+
+    free(ativos);
+    free(entradas);
+    if (!ok) {
+        liberar_buffer_dinamico(buffer);
+        return NULL;
+    }
+    *quantidade = n;
+    return buffer;
+}
+
+// Criar snapshot comprimido (publicado com rename, como salvar_contatos)
+int criar_snapshot(ListaContatos *lista, const char *arquivo) {
+    if (!lista || !arquivo) {
+        return 0;
+    }
+
+    int quantidade = 0;
+    BufferDinamico *bruto = serializar_contatos(lista, &quantidade);
+    if (!bruto) {
+        fprintf(stderr, "Erro ao serializar contatos para o snapshot\n");
+        return 0;
+    }
+
+    size_t capacidade = limite_compressao(bruto->tamanho);
+    unsigned char *comprimido = (unsigned char*)malloc(capacidade);
+    if (!comprimido) {
+        fprintf(stderr, "Erro ao alocar memória para o snapshot\n");
+        liberar_buffer_dinamico(bruto);
+        return 0;
+    }
+    size_t tamanho_comprimido = comprimir_lz((const unsigned char*)bruto->dados, bruto->tamanho,
+                                             comprimido, capacidade);
+
+    CabecalhoSnapshot cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, ASSINATURA_SNAPSHOT, sizeof(cabecalho.assinatura));
+    cabecalho.versao = VERSAO_SNAPSHOT;
+    cabecalho.quantidade = quantidade;
+    cabecalho.verificacao = calcular_verificacao((const unsigned char*)bruto->dados, bruto->tamanho);
+    cabecalho.tamanho_bruto = bruto->tamanho;
+    cabecalho.tamanho_comprimido = tamanho_comprimido;
+    cabecalho.sequencia = lista->sequencia;
+    liberar_buffer_dinamico(bruto);
+
+    if (tamanho_comprimido == 0) {
+        fprintf(stderr, "Erro ao comprimir o snapshot\n");
+        free(comprimido);
+        return 0;
+    }
+
+    char temporario[512];
+    nome_arquivo_temporario(arquivo, temporario, sizeof(temporario));
+    FILE *fp = fopen(temporario, "wb");
+    if (!fp) {
+        fprintf(stderr, "Erro ao abrir arquivo para escrita: %s\n", temporario);
+        free(comprimido);
+        return 0;
+    }
+
+    int ok = fwrite(&cabecalho, sizeof(cabecalho), 1, fp) == 1 &&
+             fwrite(comprimido, 1, tamanho_comprimido, fp) == tamanho_comprimido &&
+             gravar_em_disco(fp);
+    fclose(fp);
+    free(comprimido);
+
+    if (!ok) {
+        fprintf(stderr, "Erro ao escrever o snapshot\n");
+        remove(temporario);
+        return 0;
+    }
+    if (rename(temporario, arquivo) != 0) {
+        fprintf(stderr, "Erro ao publicar arquivo: %s\n", arquivo);
+        remove(temporario);
+        return 0;
+    }
+    return 1;
+}
+
+// Ler uma coluna ordenada, reconstruindo cada texto a partir do anterior
+static int ler_coluna_ordenada(const unsigned char **p, const unsigned char *fim, ListaContatos *lista,
+                               int quantidade, size_t deslocamento_campo, size_t tamanho_campo) {
+    char anterior[MAX_EMAIL > MAX_NOME ? MAX_EMAIL : MAX_NOME] = "";
+    size_t tamanho_anterior = 0;
+
+    for (int i = 0; i < quantidade; i++) {
+        uint32_t posicao, comum, tamanho;
+        if (!ler_varint(p, fim, &posicao) || !ler_varint(p, fim, &comum) || !ler_varint(p, fim, &tamanho) ||
+            posicao >= (uint32_t)quantidade || comum > tamanho_anterior ||
+            comum + tamanho >= tamanho_campo || (size_t)(fim - *p) < tamanho) {
+            return 0;
+        }
+        memcpy(anterior + comum, *p, tamanho);
+        tamanho_anterior = comum + tamanho;
+        anterior[tamanho_anterior] = '\0';
+        *p += tamanho;
+
+        char *campo = (char*)CONTATO_EM(lista, (int)posicao) + deslocamento_campo;
+        memcpy(campo, anterior, tamanho_anterior + 1);
+    }
+    return 1;
+}
+
+// Ler a seção de atributos (versão 2); sem atributos, a lista fica sem extensões
+static int ler_atributos(const unsigned char **p, const unsigned char *fim, ListaContatos *lista) {
+    char nomes[MAX_CHAVES_EXTENSAO][MAX_CHAVE_EXTENSAO];
+    uint32_t num_chaves, quantidade;
+    if (!ler_varint(p, fim, &num_chaves) || num_chaves > MAX_CHAVES_EXTENSAO) {
+        return 0;
+    }
+    for (uint32_t k = 0; k < num_chaves; k++) {
+        uint32_t n;
+        if (!ler_varint(p, fim, &n) || n >= MAX_CHAVE_EXTENSAO || (size_t)(fim - *p) < n) {
+            return 0;
+        }
+        memcpy(nomes[k], *p, n);
+        nomes[k][n] = '\0';
+        *p += n;
+    }
+    if (!ler_varint(p, fim, &quantidade)) {
+        return 0;
+    }
+    if (quantidade == 0) {
+        return 1;
+    }
+
+    ExtensoesContatos *extensoes = criar_extensoes();
+    if (!extensoes) {
+        return 0;
+    }
+    lista->extensoes = extensoes;
+
+    // Os atributos chegam em ordem de (ID, chave): cada definição vai para o fim
+    uint32_t id = 0;
+    char valor[MAX_VALOR_EXTENSAO];
+    for (uint32_t i = 0; i < quantidade; i++) {
+        uint32_t delta, chave, n;
+        if (!ler_varint(p, fim, &delta) || !ler_varint(p, fim, &chave) || !ler_varint(p, fim, &n) ||
+            chave >= num_chaves || n == 0 || n >= MAX_VALOR_EXTENSAO || (size_t)(fim - *p) < n) {
+            return 0;
+        }
+        id += delta;
+        memcpy(valor, *p, n);
+        valor[n] = '\0';
+        *p += n;
+        if (!definir_extensao(extensoes, (int)id, nomes[chave], valor)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Reconstruir os contatos a partir das colunas
+static int desserializar_contatos(const unsigned char *dados, size_t tamanho, ListaContatos *lista, int quantidade,
+                                  uint32_t versao) {
+    const unsigned char *p = dados;
+    const unsigned char *fim = dados + tamanho;
+
+    if (!reservar_contatos(lista, quantidade)) {
+        return 0;
+    }
+    for (int j = 0; j < quantidade; j++) {
+        memset(CONTATO_EM(lista, j), 0, sizeof(Contato));
+        CONTATO_EM(lista, j)->ativo = 1;
+    }
+    lista->quantidade = quantidade;
+
+    uint32_t id = 0;
+    for (int j = 0; j < quantidade; j++) {
+        uint32_t delta;
+        if (!ler_varint(&p, fim, &delta)) {
+            return 0;
+        }
+        id += delta;
+        CONTATO_EM(lista, j)->id = (int)id;
+    }
+
+    for (int j = 0; j < quantidade; j++) {
+        uint32_t n;
+        if (!ler_varint(&p, fim, &n) || n >= MAX_TELEFONE || (size_t)(fim - p) < n) {
+            return 0;
+        }
+        memcpy(CONTATO_EM(lista, j)->telefone, p, n);
+        p += n;
+    }
+
+    return ler_coluna_ordenada(&p, fim, lista, quantidade, offsetof(Contato, nome), MAX_NOME) &&
+           ler_coluna_ordenada(&p, fim, lista, quantidade, offsetof(Contato, email), MAX_EMAIL) &&
+           (versao == VERSAO_SNAPSHOT_SEM_EXTRAS || ler_atributos(&p, fim, lista)) &&
+           p == fim;
+}
+
+// Restaurar snapshot: descomprime em um único buffer e preenche os segmentos
+// diretamente, já na ordem dos IDs
+ListaContatos* restaurar_snapshot(const char *arquivo) {
+    if (!arquivo) {
+        return NULL;
+    }
+
+    FILE *fp = fopen(arquivo, "rb");
+    if (!fp) {
+        fprintf(stderr, "Erro ao abrir snapshot: %s\n", arquivo);
+        return NULL;
+    }
+
+    // A versão 1 tem o cabeçalho sem a sequência
+    CabecalhoSnapshot cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    int valido = fread(&cabecalho, TAMANHO_CABECALHO_SNAPSHOT_V1, 1, fp) == 1 &&
+                 memcmp(cabecalho.assinatura, ASSINATURA_SNAPSHOT, sizeof(cabecalho.assinatura)) == 0 &&
+                 (cabecalho.versao == VERSAO_SNAPSHOT || cabecalho.versao == VERSAO_SNAPSHOT_SEM_EXTRAS) &&
+                 cabecalho.quantidade >= 0;
+    if (valido && cabecalho.versao == VERSAO_SNAPSHOT) {
+        valido = fread(&cabecalho.sequencia, sizeof(cabecalho.sequencia), 1, fp) == 1;
+    }
+    if (!valido) {
+        fprintf(stderr, "Erro: %s não é um snapshot válido\n", arquivo);
+        fclose(fp);
+        return NULL;
+    }
+
+    unsigned char *comprimido = (unsigned char*)malloc(cabecalho.tamanho_comprimido > 0 ? cabecalho.tamanho_comprimido : 1);
+    unsigned char *bruto = (unsigned char*)malloc(cabecalho.tamanho_bruto > 0 ? cabecalho.tamanho_bruto : 1);
+    if (!comprimido || !bruto) {
+        fprintf(stderr, "Erro ao alocar memória para o snapshot\n");
+        free(comprimido);
+        free(bruto);
+        fclose(fp);
+        return NULL;
+    }
+
+    int ok = fread(comprimido, 1, cabecalho.tamanho_comprimido, fp) == cabecalho.tamanho_comprimido;
+    fclose(fp);
+    ok = ok && descomprimir_lz(comprimido, cabecalho.tamanho_comprimido, bruto, cabecalho.tamanho_bruto) ==
+               cabecalho.tamanho_bruto;
+    free(comprimido);
+    ok = ok && calcular_verificacao(bruto, cabecalho.tamanho_bruto) == cabecalho.verificacao;
+    if (!ok) {
+        fprintf(stderr, "Erro: snapshot corrompido: %s\n", arquivo);
+        free(bruto);
+        return NULL;
+    }
+
+    ListaContatos *lista = criar_lista();
+    if (!lista) {
+        free(bruto);
+        return NULL;
+    }
+    if (!desserializar_contatos(bruto, cabecalho.tamanho_bruto, lista, cabecalho.quantidade, cabecalho.versao)) {
+        fprintf(stderr, "Erro: snapshot corrompido: %s\n", arquivo);
+        free(bruto);
+        liberar_lista(lista);
+        return NULL;
+    }
+    free(bruto);
+    lista->sequencia = cabecalho.sequencia;
+
+    if (!reconstruir_indices(lista)) {
+        liberar_lista(lista);
+        return NULL;
+    }
+    return lista;
+}
@@ -0,0 +1,37 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "contato.h"
+
+#define ARQUIVO_SNAPSHOT_PADRAO "data/contatos.snap"
+#define ASSINATURA_SNAPSHOT "CSNP"
+#define VERSAO_SNAPSHOT 2          // 2: sequência de alterações e seção de atributos
+#define VERSAO_SNAPSHOT_SEM_EXTRAS 1 // Ainda lida: só as colunas dos contatos
+
+// Cabeçalho do snapshot (sem compressão, seguido dos dados comprimidos)
+typedef struct {
+    char assinatura[4];
+    uint32_t versao;
+    int32_t quantidade;
+    uint32_t verificacao;        // FNV-1a dos dados antes da compressão
+    uint64_t tamanho_bruto;
+    uint64_t tamanho_comprimido;
+    uint64_t sequencia;          // Última sequência de alteração (ausente na versão 1)
+} CabecalhoSnapshot;
+
+// Bytes do cabeçalho da versão 1, que termina antes da sequência
+#define TAMANHO_CABECALHO_SNAPSHOT_V1 offsetof(CabecalhoSnapshot, sequencia)
+
+// Snapshot comprimido dos contatos ativos
+// Os dados são gravados em colunas: IDs (deltas), telefones, e nomes e emails
+// ordenados com codificação de prefixo comum (front-coding), seguidos da seção de
+// atributos (nomes das chaves, depois ID em delta, chave e valor de cada atributo),
+// tudo comprimido com LZ
+// Restaurar devolve a lista com a sequência do snapshot; substituir_lista não deixa
+// a numeração voltar e registra um reinício para quem sincroniza pelo registro
+int criar_snapshot(ListaContatos *lista, const char *arquivo);
+ListaContatos* restaurar_snapshot(const char *arquivo);
+
+#endif
@@ -0,0 +1,182 @@
+#include "compressao.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BITS_HASH 16
+#define CASAMENTO_MINIMO 4
+#define JANELA_MAXIMA 65535
+#define COMPRIMENTO_NO_TOKEN 15
+
+static uint32_t ler32(const unsigned char *p) {
+    uint32_t valor;
+    memcpy(&valor, p, sizeof(valor));
+    return valor;
+}
+
+// Hash multiplicativo dos 4 próximos bytes
+static uint32_t hash4(uint32_t valor) {
+    return (valor * 2654435761u) >> (32 - BITS_HASH);
+}
+
+size_t limite_compressao(size_t tamanho) {
+    return tamanho + tamanho / 255 + 16;
+}
+
+// Comprimento acima do que cabe no token: bytes 255 seguidos do resto
+static unsigned char* gravar_comprimento(unsigned char *saida, size_t resto) {
+    while (resto >= 255) {
+        *saida++ = 255;
+        resto -= 255;
+    }
+    *saida++ = (unsigned char)resto;
+    return saida;
+}
+
+// Gravar uma sequência: literais pendentes e (se comprimento > 0) um casamento
+static unsigned char* gravar_sequencia(unsigned char *saida, const unsigned char *literais, size_t num_literais,
+                                       size_t deslocamento, size_t comprimento) {
+    size_t extra = comprimento > 0 ? comprimento - CASAMENTO_MINIMO : 0;
+    unsigned char *token = saida++;
+    *token = (unsigned char)(((num_literais >= COMPRIMENTO_NO_TOKEN ? COMPRIMENTO_NO_TOKEN : num_literais) << 4) |
+                             (extra >= COMPRIMENTO_NO_TOKEN ? COMPRIMENTO_NO_TOKEN : extra));
+    if (num_literais >= COMPRIMENTO_NO_TOKEN) {
+        saida = gravar_comprimento(saida, num_literais - COMPRIMENTO_NO_TOKEN);
+    }
+    memcpy(saida, literais, num_literais);
+    saida += num_literais;
+
+    if (comprimento > 0) {
+        *saida++ = (unsigned char)(deslocamento & 0xFF);
+        *saida++ = (unsigned char)(deslocamento >> 8);
+        if (extra >= COMPRIMENTO_NO_TOKEN) {
+            saida = gravar_comprimento(saida, extra - COMPRIMENTO_NO_TOKEN);
+        }
+    }
+    return saida;
+}
+
+// Comprimir com busca gulosa: uma tabela hash guarda a última posição de cada
+// sequência de 4 bytes; em trechos sem casamento o passo aumenta (dados aleatórios
+// são atravessados rapidamente)
+size_t comprimir_lz(const unsigned char *origem, size_t tamanho, unsigned char *destino, size_t capacidade) {
+    if (!origem || !destino || capacidade < limite_compressao(tamanho) || tamanho >= UINT32_MAX) {
+        return 0;
+    }
+
+    uint32_t *tabela = (uint32_t*)calloc((size_t)1 << BITS_HASH, sizeof(uint32_t)); // posição + 1 (0 = vazio)
+    if (!tabela) {
+        return 0;
+    }
+
+    unsigned char *saida = destino;
+    size_t inicio_literais = 0;
+    size_t pos = 0;
+    while (pos + CASAMENTO_MINIMO <= tamanho) {
+        uint32_t valor = ler32(origem + pos);
+        uint32_t h = hash4(valor);
+        size_t candidato = tabela[h];
+        tabela[h] = (uint32_t)(pos + 1);
+
+        if (candidato > 0 && pos - (candidato - 1) <= JANELA_MAXIMA && ler32(origem + candidato - 1) == valor) {
+            size_t referencia = candidato - 1;
+            size_t comprimento = CASAMENTO_MINIMO;
+            while (pos + comprimento < tamanho && origem[referencia + comprimento] == origem[pos + comprimento]) {
+                comprimento++;
+            }
+
+            saida = gravar_sequencia(saida, origem + inicio_literais, pos - inicio_literais,
+                                     pos - referencia, comprimento);
+            pos += comprimento;
+            inicio_literais = pos;
+
+            // Registrar a posição anterior ao fim do casamento melhora os próximos
+            if (pos - 2 + CASAMENTO_MINIMO <= tamanho) {
+                tabela[hash4(ler32(origem + pos - 2))] = (uint32_t)(pos - 1);
+            }
+        } else {
+            pos += 1 + ((pos - inicio_literais) >> 6);
+        }
+    }
+
+    // Última sequência: apenas os literais restantes
+    saida = gravar_sequencia(saida, origem + inicio_literais, tamanho - inicio_literais, 0, 0);
+
+    free(tabela);
+    return (size_t)(saida - destino);
+}
+
+// Ler extensão de comprimento; retorna 0 se a entrada terminar no meio
+static int ler_comprimento(const unsigned char **entrada, const unsigned char *fim, size_t *comprimento) {
+    unsigned char byte;
+    do {
+        if (*entrada >= fim) {
+            return 0;
+        }
+        byte = *(*entrada)++;
+        *comprimento += byte;
+    } while (byte == 255);
+    return 1;
+}
+
+// Descomprimir validando todos os limites (arquivo corrompido não escreve fora do destino)
+size_t descomprimir_lz(const unsigned char *origem, size_t tamanho, unsigned char *destino, size_t capacidade) {
+    if (!origem || !destino) {
+        return 0;
+    }
+
+    const unsigned char *entrada = origem;
+    const unsigned char *fim_entrada = origem + tamanho;
+    unsigned char *saida = destino;
+    unsigned char *fim_saida = destino + capacidade;
+
+    while (entrada < fim_entrada) {
+        unsigned char token = *entrada++;
+
+        size_t literais = token >> 4;
+        if (literais == COMPRIMENTO_NO_TOKEN && !ler_comprimento(&entrada, fim_entrada, &literais)) {
+            return 0;
+        }
+        if ((size_t)(fim_entrada - entrada) < literais || (size_t)(fim_saida - saida) < literais) {
+            return 0;
+        }
+        memcpy(saida, entrada, literais);
+        saida += literais;
+        entrada += literais;
+
+        if (entrada == fim_entrada) {
+            break; // Última sequência
+        }
+
+        if (fim_entrada - entrada < 2) {
+            return 0;
+        }
+        size_t deslocamento = (size_t)entrada[0] | ((size_t)entrada[1] << 8);
+        entrada += 2;
+        if (deslocamento == 0 || deslocamento > (size_t)(saida - destino)) {
+            return 0;
+        }
+
+        size_t comprimento = token & 0x0F;
+        if (comprimento == COMPRIMENTO_NO_TOKEN && !ler_comprimento(&entrada, fim_entrada, &comprimento)) {
+            return 0;
+        }
+        comprimento += CASAMENTO_MINIMO;
+        if ((size_t)(fim_saida - saida) < comprimento) {
+            return 0;
+        }
+
+        // Casamentos podem sobrepor a própria saída (repetições curtas)
+        const unsigned char *referencia = saida - deslocamento;
+        if (deslocamento >= comprimento) {
+            memcpy(saida, referencia, comprimento);
+        } else {
+            for (size_t i = 0; i < comprimento; i++) {
+                saida[i] = referencia[i];
+            }
+        }
+        saida += comprimento;
+    }
+
+    return (size_t)(saida - destino);
+}
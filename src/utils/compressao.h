@@ -0,0 +1,18 @@
+#ifndef COMPRESSAO_H
+#define COMPRESSAO_H
+
+#include <stddef.h>
+
+// Compressão LZ77 rápida (formato de sequências no estilo LZ4, janela de 64 KB)
+// Cada sequência: token (4 bits literais | 4 bits casamento - 4), literais,
+// deslocamento de 2 bytes e extensões de comprimento em bytes de 255.
+// A última sequência tem apenas literais.
+
+// Tamanho máximo da saída comprimida para uma entrada de 'tamanho' bytes
+size_t limite_compressao(size_t tamanho);
+
+// Retornam o tamanho gravado em destino, ou 0 em erro (destino pequeno ou dados corrompidos)
+size_t comprimir_lz(const unsigned char *origem, size_t tamanho, unsigned char *destino, size_t capacidade);
+size_t descomprimir_lz(const unsigned char *origem, size_t tamanho, unsigned char *destino, size_t capacidade);
+
+#endif
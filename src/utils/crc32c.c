@@ -0,0 +1,50 @@
+#define _POSIX_C_SOURCE 200809L
+#include "crc32c.h"
+#include <pthread.h>
+#include <string.h>
+
+#define POLINOMIO_CRC32C 0x82F63B78u // Castagnoli, forma refletida
+
+// Tabelas para processar 8 bytes por iteração (slicing-by-8)
+static uint32_t tabelas[8][256];
+static pthread_once_t tabelas_geradas = PTHREAD_ONCE_INIT;
+
+static void gerar_tabelas(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ POLINOMIO_CRC32C : crc >> 1;
+        }
+        tabelas[0][i] = crc;
+    }
+    for (int i = 0; i < 256; i++) {
+        for (int k = 1; k < 8; k++) {
+            tabelas[k][i] = (tabelas[k - 1][i] >> 8) ^ tabelas[0][tabelas[k - 1][i] & 0xFF];
+        }
+    }
+}
+
+uint32_t crc32c(uint32_t crc, const void *dados, size_t tamanho) {
+    pthread_once(&tabelas_geradas, gerar_tabelas);
+
+    const unsigned char *p = (const unsigned char*)dados;
+    crc = ~crc;
+
+    // Leitura em palavras de 32 bits assume little-endian (como o restante do formato)
+    while (tamanho >= 8) {
+        uint32_t baixo, alto;
+        memcpy(&baixo, p, 4);
+        memcpy(&alto, p + 4, 4);
+        baixo ^= crc;
+        crc = tabelas[7][baixo & 0xFF] ^ tabelas[6][(baixo >> 8) & 0xFF] ^
+              tabelas[5][(baixo >> 16) & 0xFF] ^ tabelas[4][baixo >> 24] ^
+              tabelas[3][alto & 0xFF] ^ tabelas[2][(alto >> 8) & 0xFF] ^
+              tabelas[1][(alto >> 16) & 0xFF] ^ tabelas[0][alto >> 24];
+        p += 8;
+        tamanho -= 8;
+    }
+    while (tamanho--) {
+        crc = tabelas[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
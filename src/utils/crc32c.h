@@ -0,0 +1,11 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC32C (Castagnoli), usado para verificar blocos do arquivo de contatos
+// Para calcular em partes, passe o CRC anterior (comece com 0)
+uint32_t crc32c(uint32_t crc, const void *dados, size_t tamanho);
+
+#endif
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 
 // Alocar buffer com tamanho específico
 char* alocar_buffer(size_t tamanho) {
@@ -144,3 +145,268 @@ int string_vazia(const char *str) {
     
     return 1;
 }
+
+// Normalizar telefone para chave canônica contendo apenas dígitos
+// Ex: "+55 (11) 98765-1111" e "11-98765-1111" geram "11987651111"
+char* normalizar_telefone(const char *telefone, char *destino, size_t tamanho) {
+    if (!destino || tamanho == 0) {
+        return NULL;
+    }
+    destino[0] = '\0';
+    if (!telefone) {
+        return destino;
+    }
+    
+    size_t len = 0;
+    for (const char *p = telefone; *p && len < tamanho - 1; p++) {
+        if (isdigit((unsigned char)*p)) {
+            destino[len++] = *p;
+        }
+    }
+    destino[len] = '\0';
+    
+    // Remover código do país (55) quando o número vem completo: DDI + DDD + número
+    if ((len == 12 || len == 13) && destino[0] == '5' && destino[1] == '5') {
+        memmove(destino, destino + 2, len - 1);
+        len -= 2;
+    }
+    
+    // Remover prefixo de operadora/tronco (0) antes do DDD
+    if ((len == 11 || len == 12) && destino[0] == '0') {
+        memmove(destino, destino + 1, len);
+    }
+    
+    return destino;
+}
+
+// Extrair domínio do email em minúsculas (parte após o último '@')
+// Ex: "Ana@Cliente.COM " gera "cliente.com"; sem '@' gera string vazia
+char* normalizar_dominio(const char *email, char *destino, size_t tamanho) {
+    if (!destino || tamanho == 0) {
+        return NULL;
+    }
+    destino[0] = '\0';
+    if (!email) {
+        return destino;
+    }
+    
+    const char *arroba = strrchr(email, '@');
+    if (!arroba) {
+        return destino;
+    }
+    
+    size_t len = 0;
+    for (const char *p = arroba + 1; *p && len < tamanho - 1; p++) {
+        if (!isspace((unsigned char)*p)) {
+            destino[len++] = (char)tolower((unsigned char)*p);
+        }
+    }
+    destino[len] = '\0';
+    return destino;
+}
+
+// Normalizar email: minúsculas e sem espaços
+char* normalizar_email(const char *email, char *destino, size_t tamanho) {
+    if (!destino || tamanho == 0) {
+        return NULL;
+    }
+    
+    size_t len = 0;
+    for (const char *p = email; p && *p && len < tamanho - 1; p++) {
+        if (!isspace((unsigned char)*p)) {
+            destino[len++] = (char)tolower((unsigned char)*p);
+        }
+    }
+    destino[len] = '\0';
+    return destino;
+}
+
+// Letra base de um caractere acentuado Latin-1 codificado em UTF-8 (segundo byte após 0xC3)
+static char letra_sem_acento(unsigned char c) {
+    static const char tabela[65] =
+        "aaaaaaaceeeeiiiidnoooooxouuuuyts"   // 0x80-0x9F (maiúsculas)
+        "aaaaaaaceeeeiiiidnooooo/ouuuuyty";  // 0xA0-0xBF (minúsculas)
+    if (c >= 0x80 && c <= 0xBF) {
+        return tabela[c - 0x80];
+    }
+    return 0;
+}
+
+// Normalizar nome para comparação: minúsculas, sem acentos e com espaços simples
+// Ex: "  JOSÉ   da Conceição " gera "jose da conceicao"
+char* normalizar_nome(const char *nome, char *destino, size_t tamanho) {
+    if (!destino || tamanho == 0) {
+        return NULL;
+    }
+    
+    size_t len = 0;
+    int espaco_pendente = 0;
+    for (const unsigned char *p = (const unsigned char*)nome; p && *p && len < tamanho - 1; p++) {
+        char c;
+        if (*p == 0xC3 && letra_sem_acento(p[1])) {
+            c = letra_sem_acento(p[1]);
+            p++;
+        } else if (isspace(*p)) {
+            espaco_pendente = len > 0;
+            continue;
+        } else {
+            c = (char)tolower(*p);
+        }
+        
+        if (espaco_pendente) {
+            if (len >= tamanho - 2) {
+                break;
+            }
+            destino[len++] = ' ';
+            espaco_pendente = 0;
+        }
+        destino[len++] = c;
+    }
+    destino[len] = '\0';
+    return destino;
+}
+
+// Distância de edição (Levenshtein) por programação dinâmica com uma linha
+static int distancia_levenshtein_dp(const char *a, int la, const char *b, int lb) {
+    int *linha = (int*)malloc((lb + 1) * sizeof(int));
+    if (!linha) {
+        return la > lb ? la : lb;
+    }
+    
+    for (int j = 0; j <= lb; j++) {
+        linha[j] = j;
+    }
+    for (int i = 1; i <= la; i++) {
+        int diagonal = linha[0];
+        linha[0] = i;
+        for (int j = 1; j <= lb; j++) {
+            int valor = diagonal + (a[i - 1] == b[j - 1] ? 0 : 1);
+            if (linha[j] + 1 < valor) valor = linha[j] + 1;
+            if (linha[j - 1] + 1 < valor) valor = linha[j - 1] + 1;
+            diagonal = linha[j];
+            linha[j] = valor;
+        }
+    }
+    
+    int resultado = linha[lb];
+    free(linha);
+    return resultado;
+}
+
+// Distância de edição (Levenshtein) exata
+// Usa o algoritmo bit-paralelo de Myers/Hyyrö quando uma das strings cabe em 64 bits:
+// cada coluna da matriz de DP é representada por vetores de deltas (+1/-1) e atualizada
+// com poucas operações lógicas, resultando em O(n) palavras em vez de O(m*n) células
+int distancia_levenshtein(const char *a, const char *b) {
+    if (!a || !b) {
+        return 0;
+    }
+    
+    int la = (int)strlen(a);
+    int lb = (int)strlen(b);
+    
+    // O padrão (codificado em bits) é a menor string
+    if (la > lb) {
+        const char *tmp = a; a = b; b = tmp;
+        int t = la; la = lb; lb = t;
+    }
+    if (la == 0) {
+        return lb;
+    }
+    if (la > 64) {
+        return distancia_levenshtein_dp(a, la, b, lb);
+    }
+    
+    uint64_t peq[256] = {0}; // Máscara de posições de cada caractere no padrão
+    for (int i = 0; i < la; i++) {
+        peq[(unsigned char)a[i]] |= (uint64_t)1 << i;
+    }
+    
+    uint64_t pv = ~(uint64_t)0; // Deltas verticais positivos
+    uint64_t mv = 0;            // Deltas verticais negativos
+    uint64_t ultimo = (uint64_t)1 << (la - 1);
+    int distancia = la;
+    
+    for (int j = 0; j < lb; j++) {
+        uint64_t eq = peq[(unsigned char)b[j]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        
+        if (ph & ultimo) {
+            distancia++;
+        } else if (mh & ultimo) {
+            distancia--;
+        }
+        
+        ph = (ph << 1) | 1; // Linha 0 da matriz cresce 1 por coluna
+        mh = mh << 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    
+    return distancia;
+}
+
+// Distância de edição (Levenshtein) limitada: retorna limite + 1 se exceder o limite
+// Calcula apenas a faixa diagonal de largura 2*limite+1 (algoritmo de Ukkonen)
+int distancia_edicao_limitada(const char *a, const char *b, int limite) {
+    if (!a || !b || limite < 0) {
+        return limite + 1;
+    }
+    
+    int la = (int)strlen(a);
+    int lb = (int)strlen(b);
+    if (la - lb > limite || lb - la > limite) {
+        return limite + 1;
+    }
+    
+    // Strings curtas (caso comum): versão bit-paralela é mais rápida que a faixa
+    if (la <= 64 || lb <= 64) {
+        int distancia = distancia_levenshtein(a, b);
+        return distancia <= limite ? distancia : limite + 1;
+    }
+    
+    int *linha = (int*)malloc((lb + 1) * sizeof(int));
+    if (!linha) {
+        return limite + 1;
+    }
+    
+    int infinito = limite + 1;
+    for (int j = 0; j <= lb; j++) {
+        linha[j] = j <= limite ? j : infinito;
+    }
+    
+    for (int i = 1; i <= la; i++) {
+        int inicio = i - limite > 1 ? i - limite : 1;
+        int fim = i + limite < lb ? i + limite : lb;
+        int diagonal = linha[inicio - 1];
+        linha[inicio - 1] = inicio - 1 == 0 && i <= limite ? i : infinito;
+        int menor_da_linha = linha[inicio - 1];
+        
+        for (int j = inicio; j <= fim; j++) {
+            int custo = a[i - 1] == b[j - 1] ? 0 : 1;
+            int valor = diagonal + custo;
+            if (linha[j] + 1 < valor) valor = linha[j] + 1;
+            if (linha[j - 1] + 1 < valor) valor = linha[j - 1] + 1;
+            if (valor > infinito) valor = infinito;
+            diagonal = linha[j];
+            linha[j] = valor;
+            if (valor < menor_da_linha) menor_da_linha = valor;
+        }
+        if (fim < lb) {
+            linha[fim + 1] = infinito;
+        }
+        
+        // Nenhuma célula da faixa dentro do limite: não há como voltar a ficar
+        if (menor_da_linha > limite) {
+            free(linha);
+            return infinito;
+        }
+    }
+    
+    int resultado = linha[lb];
+    free(linha);
+    return resultado <= limite ? resultado : infinito;
+}
@@ -18,4 +18,14 @@ char* trim_string(char *str);
 char* copiar_string(const char *src);
 int string_vazia(const char *str);
 
+// Funções de normalização (chaves canônicas para índices)
+char* normalizar_telefone(const char *telefone, char *destino, size_t tamanho);
+char* normalizar_dominio(const char *email, char *destino, size_t tamanho);
+char* normalizar_email(const char *email, char *destino, size_t tamanho);
+char* normalizar_nome(const char *nome, char *destino, size_t tamanho);
+
+// Funções de comparação aproximada
+int distancia_levenshtein(const char *a, const char *b);
+int distancia_edicao_limitada(const char *a, const char *b, int limite);
+
 #endif
@@ -0,0 +1,123 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "terminal_utils.h"
+#include "string_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define TECLA_ENTER '\n'
+#define TECLA_RETORNO '\r'
+#define TECLA_BACKSPACE 127
+#define TECLA_CTRL_H 8
+#define TECLA_ESC 27
+
+// Verificar se entrada e saída são um terminal (modo raw só faz sentido nesse caso)
+int terminal_interativo() {
+    return isatty(STDIN_FILENO) && isatty(STDOUT_FILENO);
+}
+
+// Redesenhar linha do prompt e as sugestões abaixo dela
+static void redesenhar(const char *prompt, const char *buffer, ExibirSugestoes exibir, void *contexto) {
+    printf("\r\033[J%s%s", prompt ? prompt : "", buffer); // Limpa até o fim da tela
+    int linhas = exibir && buffer[0] ? exibir(buffer, contexto) : 0;
+    if (linhas > 0) {
+        // Voltar o cursor para o fim do texto digitado
+        printf("\033[%dA\r%s%s", linhas, prompt ? prompt : "", buffer);
+    }
+    fflush(stdout);
+}
+
+// Ler string em modo raw, exibindo sugestões a cada tecla
+// Sem terminal (entrada redirecionada, scripts), comporta-se como ler_string
+char* ler_string_com_sugestoes(const char *prompt, size_t max_size,
+                               ExibirSugestoes exibir, void *contexto) {
+    if (!terminal_interativo() || max_size == 0) {
+        return ler_string(prompt, max_size);
+    }
+
+    struct termios original;
+    if (tcgetattr(STDIN_FILENO, &original) != 0) {
+        return ler_string(prompt, max_size);
+    }
+
+    // Desligar modo canônico e eco; sinais (Ctrl+C) continuam funcionando
+    struct termios raw = original;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) {
+        return ler_string(prompt, max_size);
+    }
+
+    char *buffer = alocar_buffer(max_size);
+    if (!buffer) {
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &original);
+        return NULL;
+    }
+
+    size_t len = 0;
+    int pendentes = 0; // Bytes de continuação UTF-8 ainda não lidos
+    redesenhar(prompt, buffer, exibir, contexto);
+
+    while (1) {
+        int c = getchar();
+        if (c == EOF) {
+            if (len == 0) {
+                liberar_buffer(buffer);
+                buffer = NULL;
+            }
+            break;
+        }
+
+        if (c == TECLA_ENTER || c == TECLA_RETORNO) {
+            break;
+        } else if (c == TECLA_BACKSPACE || c == TECLA_CTRL_H) {
+            // Remover um caractere UTF-8 inteiro (bytes de continuação 10xxxxxx)
+            while (len > 0 && ((unsigned char)buffer[len - 1] & 0xC0) == 0x80) {
+                len--;
+            }
+            if (len > 0) {
+                len--;
+            }
+            buffer[len] = '\0';
+        } else if (c == TECLA_ESC) {
+            // Ignorar sequências de escape (setas etc.): ESC [ <letra>
+            int proximo = getchar();
+            if (proximo == '[') {
+                while ((proximo = getchar()) != EOF && (proximo < '@' || proximo > '~'));
+            }
+            continue;
+        } else if (c >= 32 || (c & 0x80)) {
+            if (len < max_size - 1) {
+                buffer[len++] = (char)c;
+                buffer[len] = '\0';
+            }
+            // Caractere UTF-8 multibyte: aguardar os bytes restantes antes de redesenhar
+            if ((c & 0xE0) == 0xC0) {
+                pendentes = 1;
+            } else if ((c & 0xF0) == 0xE0) {
+                pendentes = 2;
+            } else if ((c & 0xF8) == 0xF0) {
+                pendentes = 3;
+            } else if ((c & 0xC0) == 0x80 && pendentes > 0) {
+                pendentes--;
+            }
+            if (pendentes > 0) {
+                continue;
+            }
+        } else {
+            continue;
+        }
+
+        redesenhar(prompt, buffer, exibir, contexto);
+    }
+
+    // Limpar sugestões e restaurar o terminal
+    printf("\r\033[J%s%s\n", prompt ? prompt : "", buffer ? buffer : "");
+    fflush(stdout);
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &original);
+    return buffer;
+}
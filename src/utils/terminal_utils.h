@@ -0,0 +1,15 @@
+#ifndef TERMINAL_UTILS_H
+#define TERMINAL_UTILS_H
+
+#include <stddef.h>
+
+// Função chamada a cada tecla com o texto digitado até o momento
+// Deve imprimir as sugestões (cada uma iniciando com '\n') e retornar quantas linhas imprimiu
+typedef int (*ExibirSugestoes)(const char *entrada, void *contexto);
+
+// Funções de terminal
+int terminal_interativo();
+char* ler_string_com_sugestoes(const char *prompt, size_t max_size,
+                               ExibirSugestoes exibir, void *contexto);
+
+#endif
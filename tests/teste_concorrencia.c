@@ -0,0 +1,152 @@
+// Teste de estresse da lista concorrente: leitores sem bloqueio enquanto
+// escritores adicionam, editam e excluem. Executar com make teste-concorrencia
+// (compilado com -fsanitize=thread).
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "contato_concorrente.h"
+
+#define CONTATOS_INICIAIS 2000
+#define NUM_LEITORES 6
+#define NUM_ESCRITORES 2
+#define OPERACOES_POR_ESCRITOR 3000
+
+static ListaConcorrente *lista;
+static atomic_int escritores_ativos;
+static atomic_long leituras;
+static atomic_long falhas;
+
+// Cada versão de contato tem o mesmo número no nome, no telefone e no email:
+// uma leitura que misture versões ou veja memória liberada quebra essa relação
+static int contato_consistente(const Contato *contato) {
+    int n_nome, n_telefone, n_email;
+    if (sscanf(contato->nome, "Contato %d", &n_nome) != 1 ||
+        sscanf(contato->telefone, "%d", &n_telefone) != 1 ||
+        sscanf(contato->email, "c%d@teste.com", &n_email) != 1) {
+        return 0;
+    }
+    return n_nome == n_telefone && n_nome == n_email;
+}
+
+static void* leitor(void *arg) {
+    (void)arg;
+    LeitorConcorrente *registro = registrar_leitor(lista);
+    if (!registro) {
+        atomic_fetch_add(&falhas, 1);
+        return NULL;
+    }
+
+    int ids[64];
+    unsigned semente = (unsigned)(size_t)&ids;
+    do {
+        const InstantaneoContatos *instantaneo = iniciar_leitura(lista, registro);
+
+        int anterior = 0;
+        for (int i = 0; i < instantaneo->quantidade; i++) {
+            const Contato *contato = atomic_load(&instantaneo->itens[i]);
+            if (contato->id <= anterior || !contato_consistente(contato)) {
+                atomic_fetch_add(&falhas, 1);
+            }
+            anterior = contato->id;
+        }
+
+        semente = semente * 1103515245u + 12345u;
+        const Contato *contato = buscar_id_instantaneo(instantaneo, (int)(semente % CONTATOS_INICIAIS) + 1);
+        if (contato && !contato_consistente(contato)) {
+            atomic_fetch_add(&falhas, 1);
+        }
+        buscar_termo_instantaneo(instantaneo, "Contato 7", ids, 64);
+
+        finalizar_leitura(registro);
+        atomic_fetch_add(&leituras, 1);
+    } while (atomic_load(&escritores_ativos) > 0);
+
+    remover_leitor(registro);
+    return NULL;
+}
+
+static void* escritor(void *arg) {
+    unsigned semente = (unsigned)(size_t)arg;
+    char nome[MAX_NOME], telefone[MAX_TELEFONE], email[MAX_EMAIL];
+
+    for (int i = 0; i < OPERACOES_POR_ESCRITOR; i++) {
+        semente = semente * 1103515245u + 12345u;
+        int valor = (int)(semente % 1000000);
+        snprintf(nome, sizeof(nome), "Contato %d", valor);
+        snprintf(telefone, sizeof(telefone), "%d", valor);
+        snprintf(email, sizeof(email), "c%d@teste.com", valor);
+
+        int id = (int)((semente >> 8) % CONTATOS_INICIAIS) + 1;
+        switch (i % 4) {
+            case 0:
+                adicionar_contato_concorrente(lista, nome, telefone, email);
+                break;
+            case 3:
+                excluir_contato_concorrente(lista, id);
+                break;
+            default:
+                editar_contato_concorrente(lista, id, nome, telefone, email);
+                break;
+        }
+    }
+
+    atomic_fetch_sub(&escritores_ativos, 1);
+    return NULL;
+}
+
+int main() {
+    lista = criar_lista_concorrente(NULL);
+    if (!lista) {
+        return 1;
+    }
+
+    char nome[MAX_NOME], telefone[MAX_TELEFONE], email[MAX_EMAIL];
+    for (int i = 1; i <= CONTATOS_INICIAIS; i++) {
+        snprintf(nome, sizeof(nome), "Contato %d", i);
+        snprintf(telefone, sizeof(telefone), "%d", i);
+        snprintf(email, sizeof(email), "c%d@teste.com", i);
+        adicionar_contato_concorrente(lista, nome, telefone, email);
+    }
+
+    pthread_t leitores[NUM_LEITORES];
+    pthread_t escritores[NUM_ESCRITORES];
+    atomic_store(&escritores_ativos, NUM_ESCRITORES);
+
+    for (int i = 0; i < NUM_LEITORES; i++) {
+        pthread_create(&leitores[i], NULL, leitor, NULL);
+    }
+    for (int i = 0; i < NUM_ESCRITORES; i++) {
+        pthread_create(&escritores[i], NULL, escritor, (void*)(size_t)(i + 1));
+    }
+    for (int i = 0; i < NUM_ESCRITORES; i++) {
+        pthread_join(escritores[i], NULL);
+    }
+    for (int i = 0; i < NUM_LEITORES; i++) {
+        pthread_join(leitores[i], NULL);
+    }
+
+    // A cópia para a lista comum deve manter os IDs crescentes
+    ListaContatos *copia = exportar_lista_concorrente(lista);
+    int ordenada = copia != NULL;
+    for (int i = 1; copia && i < copia->quantidade; i++) {
+        if (CONTATO_EM(copia, i - 1)->id >= CONTATO_EM(copia, i)->id) {
+            ordenada = 0;
+        }
+    }
+
+    printf("Leituras: %ld | Contatos ao final: %d | Falhas: %ld\n",
+           atomic_load(&leituras), copia ? copia->quantidade : 0, atomic_load(&falhas));
+
+    liberar_lista(copia);
+    liberar_lista_concorrente(lista);
+
+    if (atomic_load(&falhas) > 0 || !ordenada) {
+        printf("❌ Teste de concorrência falhou\n");
+        return 1;
+    }
+    printf("✅ Teste de concorrência concluído\n");
+    return 0;
+}